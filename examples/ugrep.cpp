@@ -42,7 +42,9 @@ For the latest fully-featured high-performance version of ugrep, please visit:
 
 This simple version features:
 
-  - Searches the specified files only, no directory recursion.
+  - Searches the specified files, or directories recursively with option -r.
+  - Searches files in parallel with a pool of worker threads, see option -J.
+  - Detects binary files with NUL bytes or invalid UTF-8, see options -a and -I.
   - Patterns are ERE POSIX syntax compliant, extended with RE/flex pattern syntax.
   - Unicode support for \p{} character categories, bracket list classes, etc.
   - File encoding support for UTF-8/16/32, EBCDIC, and many other code pages.
@@ -77,9 +79,15 @@ Examples:
   # count the number of occurrences of the names Gödel (or Goedel), Escher, or Bach in GEB.txt and wiki.txt
   ugrep -c -u 'G(ö|oe)del|Escher|Bach' GEB.txt wiki.txt
 
+  # list the files in the working directory and below that contain 'TODO', skipping binary files
+  ugrep -r -l -I 'TODO'
+
   # check if some.txt file contains any non-ASCII (i.e. Unicode) characters
   ugrep -q '[^[:ascii:]]' some.txt && echo "some.txt contains Unicode"
 
+  # recursively search the current directory for lines with 'TODO' using 8 worker threads
+  ugrep -r -n -J8 'TODO'
+
   # display word-anchored 'lorem' in UTF-16 formatted file utf16lorem.txt that contains a UTF-16 BOM
   ugrep -w -i 'lorem' utf16lorem.txt
 
@@ -94,11 +102,18 @@ Examples:
 
 Compile:
 
-  c++ -std=c++11 -o ugrep ugrep.cpp -lreflex
+  c++ -std=c++11 -pthread -o ugrep ugrep.cpp -lreflex
 
 */
 
 #include <reflex/matcher.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
 
 // check if we are on a windows OS
 #if defined(__WIN32__) || defined(_WIN32) || defined(WIN32) || defined(__CYGWIN__) || defined(__MINGW32__) || defined(__MINGW64__) || defined(__BORLANDC__)
@@ -107,9 +122,12 @@ Compile:
 
 // windows has no isatty()
 #ifdef OS_WIN
+#include <windows.h>
 #define isatty(fildes) ((fildes) == 1)
 #else
 #include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
 #endif
 
 // ugrep version
@@ -133,7 +151,9 @@ Compile:
 const char *grep_color = NULL;
 
 // ugrep command-line options
+bool flag_binary_without_match = false;
 bool flag_filename           = false;
+bool flag_files_with_matches = false;
 bool flag_no_filename        = false;
 bool flag_no_messages        = false;
 bool flag_byte_offset        = false;
@@ -150,15 +170,246 @@ bool flag_quiet              = false;
 bool flag_ungroup            = false;
 bool flag_word_regexp        = false;
 bool flag_line_regexp        = false;
+bool flag_recursive          = false;
+bool flag_text               = false;
 const char *flag_color       = NULL;
 const char *flag_file_format = NULL;
 int flag_tabs                = 8;
+size_t flag_jobs             = 0;
 
 // function protos
-bool ugrep(reflex::Pattern& pattern, FILE *file, reflex::Input::file_encoding_type encoding, const char *infile);
+bool ugrep(reflex::Matcher& matcher, reflex::Matcher& line_matcher, FILE *file, reflex::Input::file_encoding_type encoding, const char *infile, std::ostream& out);
+bool read_line(reflex::Matcher& matcher, std::string& line);
+bool unmatched_line(reflex::Matcher& matcher, reflex::Matcher& line_matcher);
 void help(const char *message = NULL, const char *arg = NULL);
 void version();
 
+// a file to search, slot is the position of the file's output in the output order
+struct Job {
+  size_t      slot;
+  std::string pathname;
+};
+
+// a pool of worker threads, each worker owns a matcher for the shared pattern and a queue of jobs, idle workers steal jobs from other workers
+class Pool {
+ public:
+  Pool(const reflex::Pattern& pattern, reflex::Input::file_encoding_type encoding, size_t jobs)
+    :
+      encoding_(encoding),
+      workers_(jobs),
+      queued_(0),
+      slots_(0),
+      next_(0),
+      closed_(false),
+      found_(false),
+      error_(false)
+  {
+    for (size_t i = 0; i < workers_.size(); ++i)
+    {
+      workers_[i].matcher.pattern(pattern);
+      workers_[i].line_matcher.pattern(pattern);
+    }
+    for (size_t i = 0; i < workers_.size(); ++i)
+      threads_.push_back(std::thread(&Pool::work, this, i));
+  }
+  // submit a file to search, files are distributed round-robin over the worker queues
+  void submit(const std::string& pathname)
+  {
+    size_t slot = slots_++;
+    Worker& worker = workers_[slot % workers_.size()];
+    {
+      std::lock_guard<std::mutex> lock(worker.mutex);
+      worker.jobs.push_back(Job{slot, pathname});
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++queued_;
+    wakeup_.notify_one();
+  }
+  // no more files to submit, wait for the workers to finish
+  void close()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      closed_ = true;
+      wakeup_.notify_all();
+    }
+    for (size_t i = 0; i < threads_.size(); ++i)
+      threads_[i].join();
+    std::cout.flush();
+  }
+  // true if a pattern match was found in any of the files
+  bool found() const
+  {
+    return found_;
+  }
+  // true if a file could not be opened
+  bool error() const
+  {
+    return error_;
+  }
+  // true if the search can stop early: -q quiet mode found a match
+  bool done() const
+  {
+    return flag_quiet && found_;
+  }
+ private:
+  struct Worker {
+    std::mutex       mutex;   // protects jobs
+    std::deque<Job>  jobs;    // jobs are taken from the front by the worker and stolen from the back
+    reflex::Matcher  matcher;      // the worker's matcher to search files, reused for all the files it searches
+    reflex::Matcher  line_matcher; // the worker's matcher to search lines read from files
+  };
+  // take a job from the worker's own queue, or steal a job from another worker
+  bool take(size_t id, Job& job)
+  {
+    for (size_t i = 0; i < workers_.size(); ++i)
+    {
+      Worker& worker = workers_[(id + i) % workers_.size()];
+      std::lock_guard<std::mutex> lock(worker.mutex);
+      if (!worker.jobs.empty())
+      {
+        if (i == 0)
+        {
+          job = worker.jobs.front();
+          worker.jobs.pop_front();
+        }
+        else
+        {
+          job = worker.jobs.back();
+          worker.jobs.pop_back();
+        }
+        --queued_;
+        return true;
+      }
+    }
+    return false;
+  }
+  // the worker thread loop
+  void work(size_t id)
+  {
+    Job job;
+    while (true)
+    {
+      if (!take(id, job))
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (closed_ && queued_ == 0)
+          break;
+        wakeup_.wait(lock, [this]() { return queued_ > 0 || closed_; });
+        continue;
+      }
+      std::ostringstream out;
+      if (!done())
+      {
+        FILE *file = fopen(job.pathname.c_str(), "r");
+        if (file == NULL)
+        {
+          if (!flag_no_messages)
+            out << "ugrep: cannot open file for reading: " << job.pathname << std::endl;
+          error_ = true;
+        }
+        else
+        {
+          if (ugrep(workers_[id].matcher, workers_[id].line_matcher, file, encoding_, job.pathname.c_str(), out))
+            found_ = true;
+          fclose(file);
+        }
+      }
+      output(job.slot, out.str());
+    }
+  }
+  // buffer the output of a file and write the buffered output of files in order
+  void output(size_t slot, const std::string& text)
+  {
+    std::lock_guard<std::mutex> lock(output_mutex_);
+    outputs_[slot] = text;
+    while (!outputs_.empty() && outputs_.begin()->first == next_)
+    {
+      if (!flag_quiet)
+        std::cout << outputs_.begin()->second;
+      outputs_.erase(outputs_.begin());
+      ++next_;
+    }
+  }
+  reflex::Input::file_encoding_type encoding_;
+  std::vector<Worker>               workers_;
+  std::vector<std::thread>          threads_;
+  std::mutex                        mutex_;         // protects queued_ and closed_ to wake up idle workers
+  std::condition_variable           wakeup_;
+  std::atomic<size_t>               queued_;        // number of jobs in the queues
+  size_t                            slots_;         // number of jobs submitted
+  std::mutex                        output_mutex_;  // protects outputs_ and next_
+  std::map<size_t,std::string>      outputs_;       // buffered output of files searched out of order
+  size_t                            next_;          // slot of the next output to write
+  bool                              closed_;
+  std::atomic<bool>                 found_;
+  std::atomic<bool>                 error_;
+};
+
+// submit the file, or the files in the directory and its subdirectories with -r, returns false if the file does not exist
+bool submit(Pool& pool, const std::string& pathname, bool top)
+{
+  if (pool.done())
+    return true;
+#ifdef OS_WIN
+  DWORD attr = GetFileAttributesA(pathname.c_str());
+  if (attr == INVALID_FILE_ATTRIBUTES)
+    return false;
+  if ((attr & FILE_ATTRIBUTE_DIRECTORY) == 0)
+  {
+    pool.submit(pathname);
+    return true;
+  }
+  if (!flag_recursive)
+  {
+    if (!flag_no_messages)
+      std::cerr << "ugrep: " << pathname << " is a directory" << std::endl;
+    return true;
+  }
+  WIN32_FIND_DATAA data;
+  HANDLE handle = FindFirstFileA((pathname + "\\*").c_str(), &data);
+  if (handle == INVALID_HANDLE_VALUE)
+    return true;
+  do
+  {
+    if (strcmp(data.cFileName, ".") != 0 && strcmp(data.cFileName, "..") != 0 && (data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) == 0)
+      submit(pool, pathname + "\\" + data.cFileName, false);
+  } while (FindNextFileA(handle, &data));
+  FindClose(handle);
+#else
+  struct stat buf;
+  // follow symbolic links to files and directories specified on the command line only
+  if ((top ? stat(pathname.c_str(), &buf) : lstat(pathname.c_str(), &buf)) != 0)
+    return false;
+  if (S_ISREG(buf.st_mode))
+  {
+    pool.submit(pathname);
+    return true;
+  }
+  if (!S_ISDIR(buf.st_mode))
+    return true;
+  if (!flag_recursive)
+  {
+    if (!flag_no_messages)
+      std::cerr << "ugrep: " << pathname << " is a directory" << std::endl;
+    return true;
+  }
+  DIR *dir = opendir(pathname.c_str());
+  if (dir == NULL)
+  {
+    if (!flag_no_messages)
+      std::cerr << "ugrep: cannot open directory: " << pathname << std::endl;
+    return true;
+  }
+  struct dirent *entry;
+  while ((entry = readdir(dir)) != NULL)
+    if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0)
+      submit(pool, pathname + (pathname.back() == '/' ? "" : "/") + entry->d_name, false);
+  closedir(dir);
+#endif
+  return true;
+}
+
 // table of file formats for ugrep option --file-format
 const struct { const char *format; reflex::Input::file_encoding_type encoding; } format_table[] = {
   { "binary",      reflex::Input::file_encoding::plain      },
@@ -241,7 +492,13 @@ int main(int argc, char **argv)
         {
           case '-':
             ++arg;
-            if (strcmp(arg, "byte-offset") == 0)
+            if (strcmp(arg, "binary-files=binary") == 0)
+              flag_binary_without_match = flag_text = false;
+            else if (strcmp(arg, "binary-files=text") == 0)
+              flag_text = true;
+            else if (strcmp(arg, "binary-files=without-match") == 0)
+              flag_binary_without_match = true;
+            else if (strcmp(arg, "byte-offset") == 0)
               flag_byte_offset = true;
             else if (strcmp(arg, "color") == 0 || strcmp(arg, "colour") == 0)
               flag_color = "auto";
@@ -257,6 +514,8 @@ int main(int argc, char **argv)
               ;
             else if (strncmp(arg, "file-format=", 12) == 0)
               flag_file_format = arg + 12;
+            else if (strcmp(arg, "files-with-matches") == 0)
+              flag_files_with_matches = true;
             else if (strcmp(arg, "fixed-strings") == 0)
               flag_fixed_strings = true;
             else if (strcmp(arg, "free-space") == 0)
@@ -267,6 +526,8 @@ int main(int argc, char **argv)
               flag_ignore_case = true;
             else if (strcmp(arg, "invert-match") == 0)
               flag_invert_match = true;
+            else if (strncmp(arg, "jobs=", 5) == 0)
+              flag_jobs = strtoul(arg + 5, NULL, 10);
             else if (strcmp(arg, "line-number") == 0)
               flag_line_number = true;
             else if (strcmp(arg, "line-regexp") == 0)
@@ -281,6 +542,10 @@ int main(int argc, char **argv)
               flag_only_matching = true;
             else if (strcmp(arg, "quiet") == 0 || strcmp(arg, "silent") == 0)
               flag_quiet = true;
+            else if (strcmp(arg, "recursive") == 0)
+              flag_recursive = true;
+            else if (strcmp(arg, "text") == 0)
+              flag_text = true;
             else if (strncmp(arg, "regexp=", 7) == 0)
               regex.append(arg + 7).push_back('|');
             else if (strncmp(arg, "tabs=", 5) == 0)
@@ -294,6 +559,10 @@ int main(int argc, char **argv)
             is_grouped = false;
             break;
 
+          case 'a':
+            flag_text = true;
+            break;
+
           case 'b':
             flag_byte_offset = true;
             break;
@@ -330,14 +599,33 @@ int main(int argc, char **argv)
             flag_no_filename = true;
             break;
 
+          case 'I':
+            flag_binary_without_match = true;
+            break;
+
           case 'i':
             flag_ignore_case = true;
             break;
 
+          case 'J':
+            ++arg;
+            if (*arg)
+              flag_jobs = strtoul(&arg[*arg == '='], NULL, 10);
+            else if (++i < argc)
+              flag_jobs = strtoul(argv[i], NULL, 10);
+            else
+              help("missing number of threads for option -J");
+            is_grouped = false;
+            break;
+
           case 'k':
             flag_column_number = true;
             break;
 
+          case 'l':
+            flag_files_with_matches = true;
+            break;
+
           case 'n':
             flag_line_number = true;
             break;
@@ -350,6 +638,10 @@ int main(int argc, char **argv)
             flag_quiet = true;
             break;
 
+          case 'r':
+            flag_recursive = true;
+            break;
+
           case 's':
             flag_no_messages = true;
             break;
@@ -431,14 +723,22 @@ int main(int argc, char **argv)
     flag_only_matching = false;
   }
 
-  // input is line-buffered if options -c --count -o --only-matching -q --quiet are not specified
-  if (!flag_count && !flag_only_matching && !flag_quiet)
+  // input is line-buffered if options -c --count -l --files-with-matches -o --only-matching -q --quiet are not specified
+  if (!flag_count && !flag_files_with_matches && !flag_only_matching && !flag_quiet)
     flag_line_buffered = true;
 
-  // display file name if more than one input file is specified and option -h --no-filename is not specified
-  if (infiles.size() > 1 && !flag_no_filename)
+  // -r recursive without files searches the working directory
+  if (flag_recursive && infiles.empty())
+    infiles.push_back(".");
+
+  // display file name if more than one input file or -r is specified and option -h --no-filename is not specified
+  if ((infiles.size() > 1 || flag_recursive) && !flag_no_filename)
     flag_filename = true;
 
+  // use a worker thread per core by default
+  if (flag_jobs == 0)
+    flag_jobs = std::max(std::thread::hardware_concurrency(), 1U);
+
   // (re)set grep_color depending on color_term, isatty(), and the ugrep --color option
   if (!flag_color || strcmp(flag_color, "never") == 0)
   {
@@ -464,6 +764,9 @@ int main(int argc, char **argv)
   // if any match was found in any of the input files then we set found==true
   bool found = false;
 
+  // if a file could not be opened then we set error==true
+  bool error = false;
+
   try
   {
     reflex::Input::file_encoding_type encoding = reflex::Input::file_encoding::plain;
@@ -506,28 +809,29 @@ int main(int argc, char **argv)
     if (infiles.empty())
     {
       // read standard input to find pattern matches
-      found |= ugrep(pattern, stdin, encoding, "(standard input)");
+      reflex::Matcher matcher(pattern);
+      reflex::Matcher line_matcher(pattern);
+      found = ugrep(matcher, line_matcher, stdin, encoding, "(standard input)", std::cout);
     }
     else
     {
-      // read each file to find pattern matches
+      // search the files and directories with the worker threads, the output of each file is written in order
+      Pool pool(pattern, encoding, flag_jobs);
+
       for (auto infile : infiles)
       {
-        FILE *file = fopen(infile, "r");
-
-        if (file == NULL)
+        if (!submit(pool, infile, true))
         {
-          if (flag_no_messages)
-            continue;
-
-          perror("Cannot open file for reading");
-          exit(EXIT_ERROR);
+          if (!flag_no_messages)
+            std::cerr << "ugrep: cannot open file for reading: " << infile << std::endl;
+          error = true;
         }
+      }
 
-        found |= ugrep(pattern, file, encoding, infile);
+      pool.close();
 
-        fclose(file);
-      }
+      found = pool.found();
+      error |= pool.error();
     }
   }
   catch (reflex::regex_error& error)
@@ -536,11 +840,14 @@ int main(int argc, char **argv)
     exit(EXIT_ERROR);
   }
 
+  if (error && !(flag_quiet && found))
+    exit(EXIT_ERROR);
+
   exit(found ? EXIT_OK : EXIT_FAIL);
 }
 
-// Search file, display pattern matches, return true when pattern matched anywhere
-bool ugrep(reflex::Pattern& pattern, FILE *file, reflex::Input::file_encoding_type encoding, const char *infile)
+// Search file with the matcher or search the lines read from the file with the line matcher, write pattern matches to out, return true when pattern matched anywhere
+bool ugrep(reflex::Matcher& matcher, reflex::Matcher& line_matcher, FILE *file, reflex::Input::file_encoding_type encoding, const char *infile, std::ostream& out)
 {
   bool found = false;
 
@@ -558,14 +865,31 @@ bool ugrep(reflex::Pattern& pattern, FILE *file, reflex::Input::file_encoding_ty
   // create an input object to read the file (or stdin) using the given file format encoding
   reflex::Input input(file, encoding);
 
-  if (flag_quiet)
-  {
-    // -q quiet mode: report if a single pattern match was found in the input
+  matcher.input(input);
+
+  // check if the first block of the input contains a NUL or invalid UTF-8, unless -a --text
+  bool binary = !flag_text && matcher.binary();
+
+  // -I --binary-files=without-match: skip binary files
+  if (binary && flag_binary_without_match)
+    return false;
 
-    found = reflex::Matcher(pattern, input).find();
+  if (flag_quiet || flag_files_with_matches || (binary && !flag_count))
+  {
+    // -q quiet mode, -l files with matches mode, or binary file: stop at the first (non-)matching line
 
     if (flag_invert_match)
-      found = !found;
+      found = unmatched_line(matcher, line_matcher);
+    else
+      found = matcher.count(1) > 0;
+
+    if (found && !flag_quiet)
+    {
+      if (flag_files_with_matches)
+        out << infile << std::endl;
+      else
+        out << "Binary file " << infile << " matches" << std::endl;
+    }
   }
   else if (flag_count)
   {
@@ -577,55 +901,34 @@ bool ugrep(reflex::Pattern& pattern, FILE *file, reflex::Input::file_encoding_ty
       std::string line;
 
       // -c count mode w/ -v: count the number of non-matching lines
-      while (input)
+      while (read_line(matcher, line))
       {
-        int ch;
-
-        // read the next line
-        line.clear();
-        while ((ch = input.get()) != EOF && ch != '\n')
-          line.push_back(ch);
-        if (ch == EOF && line.empty())
-          break;
-
         // count this line if not matched
-        if (!reflex::Matcher(pattern, line).find())
+        if (!line_matcher.input(line).find())
         {
           found = true;
           ++lines;
         }
       }
 
-      std::cout << label << lines << std::endl;
+      out << label << lines << std::endl;
     }
     else if (flag_ungroup)
     {
       // -c count mode w/ -u: count the number of patterns matched in the file
 
-      reflex::Matcher matcher(pattern, input);
-      size_t matches = std::distance(matcher.find.begin(), matcher.find.end());
+      size_t matches = matcher.count();
 
-      std::cout << label << matches << std::endl;
+      out << label << matches << std::endl;
       found = matches > 0;
     }
     else
     {
       // -c count mode w/o -u: count the number of matching lines
 
-      size_t lineno = 0;
-      size_t lines = 0;
+      size_t lines = matcher.count(0, true);
 
-      reflex::Matcher matcher(pattern, input);
-      for (auto& match : matcher.find)
-      {
-        if (lineno != match.lineno())
-        {
-          lineno = match.lineno();
-          ++lines;
-        }
-      }
-
-      std::cout << label << lines << std::endl;
+      out << label << lines << std::endl;
       found = lines > 0;
     }
   }
@@ -638,20 +941,19 @@ bool ugrep(reflex::Pattern& pattern, FILE *file, reflex::Input::file_encoding_ty
     {
       size_t lineno = 0;
 
-      reflex::Matcher matcher(pattern, input);
       for (auto& match : matcher.find)
       {
         if (lineno != match.lineno())
         {
           lineno = match.lineno();
-          std::cout << label;
+          out << label;
           if (flag_line_number)
-            std::cout << match.lineno() << ":";
+            out << match.lineno() << ":";
           if (flag_column_number)
-            std::cout << match.columno() + 1 << ":";
+            out << match.columno() + 1 << ":";
           if (flag_byte_offset)
-            std::cout << match.first() << ":";
-          std::cout << mark << match.span() << unmark << std::endl;
+            out << match.first() << ":";
+          out << mark << match.span() << unmark << std::endl;
           found = true;
         }
       }
@@ -663,29 +965,20 @@ bool ugrep(reflex::Pattern& pattern, FILE *file, reflex::Input::file_encoding_ty
       size_t lineno = 1;
       std::string line;
 
-      while (input)
+      while (read_line(matcher, line))
       {
-        int ch;
-
-        // read the next line
-        line.clear();
-        while ((ch = input.get()) != EOF && ch != '\n')
-          line.push_back(ch);
-        if (ch == EOF && line.empty())
-          break;
-
         if (flag_invert_match)
         {
           // -v invert match: display non-matching line
 
-          if (!reflex::Matcher(pattern, line).find())
+          if (!line_matcher.input(line).find())
           {
-            std::cout << label;
+            out << label;
             if (flag_line_number)
-              std::cout << lineno << ":";
+              out << lineno << ":";
             if (flag_byte_offset)
-              std::cout << byte_offset << ":";
-            std::cout << line << std::endl;
+              out << byte_offset << ":";
+            out << line << std::endl;
             found = true;
           }
         }
@@ -693,17 +986,17 @@ bool ugrep(reflex::Pattern& pattern, FILE *file, reflex::Input::file_encoding_ty
         {
           // search the line for pattern matches and display the line again (with exact offset) for each pattern match
 
-          reflex::Matcher matcher(pattern, line);
-          for (auto& match : matcher.find)
+          line_matcher.input(line);
+          for (auto& match : line_matcher.find)
           {
-            std::cout << label;
+            out << label;
             if (flag_line_number)
-              std::cout << lineno << ":";
+              out << lineno << ":";
             if (flag_column_number)
-              std::cout << match.columno() + 1 << ":";
+              out << match.columno() + 1 << ":";
             if (flag_byte_offset)
-              std::cout << byte_offset << ":";
-            std::cout << line.substr(0, match.first()) << mark << match.text() << unmark << line.substr(match.last()) << std::endl;
+              out << byte_offset << ":";
+            out << line.substr(0, match.first()) << mark << match.text() << unmark << line.substr(match.last()) << std::endl;
             found = true;
           }
         }
@@ -713,31 +1006,31 @@ bool ugrep(reflex::Pattern& pattern, FILE *file, reflex::Input::file_encoding_ty
 
           size_t last = 0;
 
-          reflex::Matcher matcher(pattern, line);
-          for (auto& match : matcher.find)
+          line_matcher.input(line);
+          for (auto& match : line_matcher.find)
           {
             if (last == 0)
             {
-              std::cout << label;
+              out << label;
               if (flag_line_number)
-                std::cout << lineno << ":";
+                out << lineno << ":";
               if (flag_column_number)
-                std::cout << match.columno() + 1 << ":";
+                out << match.columno() + 1 << ":";
               if (flag_byte_offset)
-                std::cout << byte_offset + match.first() << ":";
-              std::cout << line.substr(0, match.first()) << mark << match.text() << unmark;
+                out << byte_offset + match.first() << ":";
+              out << line.substr(0, match.first()) << mark << match.text() << unmark;
               last = match.last();
               found = true;
             }
             else
             {
-              std::cout << line.substr(last, match.first() - last) << mark << match.text() << unmark;
+              out << line.substr(last, match.first() - last) << mark << match.text() << unmark;
               last = match.last();
             }
           }
 
           if (last > 0)
-            std::cout << line.substr(last) << std::endl;
+            out << line.substr(last) << std::endl;
         }
 
         // update byte offset and line number
@@ -752,21 +1045,20 @@ bool ugrep(reflex::Pattern& pattern, FILE *file, reflex::Input::file_encoding_ty
 
     size_t lineno = 0;
 
-    reflex::Matcher matcher(pattern, input);
     for (auto& match : matcher.find)
     {
       if (flag_ungroup || lineno != match.lineno())
       {
         lineno = match.lineno();
-        std::cout << label;
+        out << label;
         if (flag_line_number)
-          std::cout << lineno << ":";
+          out << lineno << ":";
         if (flag_column_number)
-          std::cout << match.columno() + 1 << ":";
+          out << match.columno() + 1 << ":";
         if (flag_byte_offset)
-          std::cout << match.first() << ":";
+          out << match.first() << ":";
       }
-      std::cout << mark << match.text() << unmark << std::endl;
+      out << mark << match.text() << unmark << std::endl;
       found = true;
     }
   }
@@ -774,13 +1066,46 @@ bool ugrep(reflex::Pattern& pattern, FILE *file, reflex::Input::file_encoding_ty
   return found;
 }
 
+// Read the next line from the input of the matcher, return false when EOF
+bool read_line(reflex::Matcher& matcher, std::string& line)
+{
+  int ch;
+
+  line.clear();
+  while ((ch = matcher.input()) != EOF && ch != '\n')
+    line.push_back(ch);
+
+  return ch != EOF || !line.empty();
+}
+
+// Read lines from the input of the matcher until a line is not matched by the line matcher, return true when found
+bool unmatched_line(reflex::Matcher& matcher, reflex::Matcher& line_matcher)
+{
+  std::string line;
+
+  while (read_line(matcher, line))
+    if (!line_matcher.input(line).find())
+      return true;
+
+  return false;
+}
+
 // Display help information with an optional diagnostic message and exit
 void help(const char *message, const char *arg)
 {
   if (message)
     std::cout << "ugrep: " << message << (arg != NULL ? arg : "") << std::endl;
-  std::cout << "Usage: ugrep [-bcEFgHhiknoqsVvwx] [--colour[=when]|--color[=when]] [-e pattern] [pattern] [file ...]\n\
+  std::cout << "Usage: ugrep [-abcEFgHhIiklnoqrsVvwx] [--colour[=when]|--color[=when]] [-e pattern] [-J threads] [pattern] [file ...]\n\
 \n\
+    -a, --text\n\
+            Process a binary file as if it were text.  This is equivalent to\n\
+            the --binary-files=text option.\n\
+    --binary-files=type\n\
+            Controls searching binary files with a NUL or invalid UTF-8 in the\n\
+            first block of input.  The possible values of type can be\n\
+            `binary', to report matching binary files with a one-line message,\n\
+            `without-match', to skip binary files, and `text', to search binary\n\
+            files as text.  The default is `binary'.\n\
     -b, --byte-offset\n\
             The offset in bytes of a matched pattern is displayed in front of\n\
             the respective matched line.\n\
@@ -813,16 +1138,26 @@ void help(const char *message, const char *arg)
             Always print filename headers with output lines.\n\
     -h, --no-filename\n\
             Never print filename headers (i.e. filenames) with output lines.\n\
+    -I\n\
+            Ignore matches in binary files.  This option is equivalent to the\n\
+            --binary-files=without-match option.\n\
     -?, --help\n\
             Print a help message.\n\
     -i, --ignore-case\n\
             Perform case insensitive matching. This option applies\n\
             case-insensitive matching of ASCII characters in the input.\n\
             By default, ugrep is case sensitive.\n\
+    -J threads, --jobs=threads\n\
+            Specifies the number of worker threads that search files in\n\
+            parallel.  The default is the number of cores.  The output of each\n\
+            file is buffered and written in the order the files are found.\n\
     -k, --column-number\n\
             The column number of a matched pattern is displayed in front of\n\
             the respective matched line, starting at column 1.  Tabs are\n\
             expanded before columns are counted.\n\
+    -l, --files-with-matches\n\
+            Only the names of files containing selected lines are written to\n\
+            standard output.  The search of a file stops at the first match.\n\
     -n, --line-number\n\
             Each output line is preceded by its relative line number in the\n\
             file, starting at line 1.  The line number counter is reset for\n\
@@ -834,6 +1169,10 @@ void help(const char *message, const char *arg)
             Quiet mode: suppress normal output.  ugrep will only search a file\n\
             until a match has been found, making searches potentially less\n\
             expensive.  Allows a pattern match to span multiple lines.\n\
+    -r, --recursive\n\
+            Recursively search the directories specified, or the working\n\
+            directory when no files are specified.  Symbolic links are only\n\
+            followed when specified on the command line.\n\
     -s, --no-messages\n\
             Silent mode.  Nonexistent and unreadable files are ignored (i.e.\n\
             their error messages are suppressed).\n\
@@ -58,7 +58,9 @@ class FuzzyMatcher : public Matcher {
       err_(0),
       ins_(true),
       del_(true),
-      sub_(true)
+      sub_(true),
+      bpp_(NULL),
+      php_(NULL)
   {
     bpt_.resize(max_);
   }
@@ -74,7 +76,9 @@ class FuzzyMatcher : public Matcher {
       err_(0),
       ins_(true),
       del_(true),
-      sub_(true)
+      sub_(true),
+      bpp_(NULL),
+      php_(NULL)
   {
     bpt_.resize(max_);
   }
@@ -91,7 +95,9 @@ class FuzzyMatcher : public Matcher {
       err_(0),
       ins_(max <= 0xFF || (max & INS)),
       del_(max <= 0xFF || (max & DEL)),
-      sub_(max <= 0xFF || (max & SUB))
+      sub_(max <= 0xFF || (max & SUB)),
+      bpp_(NULL),
+      php_(NULL)
   {
     bpt_.resize(max_);
   }
@@ -107,7 +113,9 @@ class FuzzyMatcher : public Matcher {
       err_(0),
       ins_(true),
       del_(true),
-      sub_(true)
+      sub_(true),
+      bpp_(NULL),
+      php_(NULL)
   {
     bpt_.resize(max_);
   }
@@ -124,7 +132,9 @@ class FuzzyMatcher : public Matcher {
       err_(0),
       ins_(max <= 0xFF || (max & INS)),
       del_(max <= 0xFF || (max & DEL)),
-      sub_(max <= 0xFF || (max & SUB))
+      sub_(max <= 0xFF || (max & SUB)),
+      bpp_(NULL),
+      php_(NULL)
   {
     bpt_.resize(max_);
   }
@@ -136,7 +146,9 @@ class FuzzyMatcher : public Matcher {
       err_(0),
       ins_(true),
       del_(true),
-      sub_(true)
+      sub_(true),
+      bpp_(NULL),
+      php_(NULL)
   {
     DBGLOG("FuzzyMatcher::FuzzyMatcher(matcher)");
     bpt_.resize(max_);
@@ -150,6 +162,8 @@ class FuzzyMatcher : public Matcher {
     ins_ = matcher.ins_;
     del_ = matcher.del_;
     sub_ = matcher.sub_;
+    bpp_ = NULL;
+    php_ = NULL;
     return *this;
   }
   /// Polymorphic cloning.
@@ -157,7 +171,30 @@ class FuzzyMatcher : public Matcher {
   {
     return new FuzzyMatcher(*this);
   }
-  /// Returns the number of edits made for the match, edits() <= max, not guaranteed to be the minimum edit distance.
+  /// Reset this matcher's state to the initial state.
+  virtual void reset(const char *opt = NULL)
+  {
+    Matcher::reset(opt);
+    php_ = NULL;
+  }
+  using Matcher::pattern;
+  /// Set the pattern from a regex string to use with this matcher.
+  virtual PatternMatcher& pattern(const char *pattern) ///< regex string to instantiate internal pattern object
+    /// @returns this matcher
+  {
+    bpp_ = NULL;
+    php_ = NULL;
+    return Matcher::pattern(pattern);
+  }
+  /// Set the pattern from a regex string to use with this matcher.
+  virtual PatternMatcher& pattern(const std::string& pattern) ///< regex string to instantiate internal pattern object
+    /// @returns this matcher
+  {
+    bpp_ = NULL;
+    php_ = NULL;
+    return Matcher::pattern(pattern);
+  }
+  /// Returns the number of edits made for the match, edits() <= max, which is the minimum edit distance when find() matches a string pattern with the bit-parallel engine, otherwise not guaranteed to be the minimum edit distance.
   uint8_t edits()
     /// @returns 0 to max edit distance
     const
@@ -291,15 +328,341 @@ class FuzzyMatcher : public Matcher {
     }
     return pat_->opc_ + jump;
   }
+  /// Returns true if the pattern is an ASCII string of up to 255 bytes matched with the bit-parallel engine, building the character masks of the pattern when changed.
+  bool bit_parallel()
+    /// @returns true if the bit-parallel engine applies
+  {
+    if (bpp_ == pat_)
+      return bpw_ > 0;
+    bpp_ = pat_;
+    bpw_ = 0;
+    if (!pat_->one_ || pat_->len_ == 0)
+      return false;
+    size_t len = pat_->len_;
+    for (size_t i = 0; i < len; ++i)
+      if ((pat_->pre_[i] & 0x80) != 0)
+        return false;
+    bpw_ = (len + 63) / 64;
+    bpm_.assign(256 * bpw_, 0);
+    for (size_t i = 0; i < len; ++i)
+      bpm_[static_cast<uint8_t>(pat_->pre_[i]) * bpw_ + i / 64] |= static_cast<uint64_t>(1) << (i % 64);
+    return true;
+  }
+  /// Returns the length of the best fuzzy match of the string pattern starting at txt_[off], with the minimum edit distance err, using Wu-Manber shift-and with one bit vector row of bpw_ words per error.
+  size_t fuzzy_bit_parallel(
+      size_t   off, ///< offset from txt_ of the start of the match, txt_[off] matches the first pattern char
+      uint8_t& err) ///< minimum edit distance of the match returned
+    /// @returns length of the match or 0 when no match
+  {
+    const size_t w = bpw_;
+    const size_t k = max_;
+    const size_t top = (pat_->len_ - 1) % 64;
+    const uint64_t last = static_cast<uint64_t>(1) << top;
+    const uint64_t keep = top == 63 ? ~static_cast<uint64_t>(0) : (last << 1) - 1;
+    bps_.assign(2 * (k + 1) * w, 0);
+    uint64_t *old = &bps_[0];
+    uint64_t *cur = old + (k + 1) * w;
+    // initial states: up to d pattern chars deleted before the first text char
+    if (del_)
+      for (size_t d = 1; d <= k; ++d)
+        for (size_t i = 0; i < d && i < pat_->len_; ++i)
+          old[d * w + i / 64] |= static_cast<uint64_t>(1) << (i % 64);
+    size_t len = 0;
+    err = 0xFF;
+    pos_ = (txt_ - buf_) + off;
+    for (size_t t = 0; ; ++t)
+    {
+      int c = get();
+      if (c == EOF)
+        break;
+      // a multibyte UTF-8 char or a NUL or LF never matches, NUL and LF are never inserted or substituted
+      const uint64_t *mask = c < 0x80 ? &bpm_[c * w] : NULL;
+      bool edit = c != '\0' && c != '\n';
+      if (c >= 0xC0)
+      {
+        int n = (c >= 0xE0) + (c >= 0xF0);
+        while (n-- >= 0)
+          if (get() == EOF)
+            break;
+      }
+      uint64_t inj = t == 0;
+      bool live = false;
+      size_t hit = k + 1;
+      for (size_t d = 0; d <= k; ++d)
+      {
+        const uint64_t *r = old + d * w;
+        const uint64_t *q = d > 0 ? r - w : r;
+        uint64_t *n = cur + d * w;
+        uint64_t rc = inj;
+        uint64_t qc = inj;
+        uint64_t nc = 0;
+        for (size_t i = 0; i < w; ++i)
+        {
+          uint64_t v = mask != NULL ? ((r[i] << 1) | rc) & mask[i] : 0;
+          rc = r[i] >> 63;
+          if (d > 0)
+          {
+            if (edit && sub_)
+              v |= (q[i] << 1) | qc;
+            if (edit && ins_ && t > 0)
+              v |= q[i];
+            qc = q[i] >> 63;
+            if (del_)
+            {
+              uint64_t p = n[i - w];
+              v |= (p << 1) | nc;
+              nc = p >> 63;
+            }
+          }
+          n[i] = v;
+        }
+        n[w - 1] &= keep;
+        for (size_t i = 0; i < w; ++i)
+          live |= n[i] != 0;
+        if (hit > k && (n[w - 1] & last) != 0)
+          hit = d;
+      }
+      // keep the longest match with the fewest edits
+      if (hit <= k && (err == 0xFF || hit <= err))
+      {
+        err = static_cast<uint8_t>(hit);
+        len = pos_ - (txt_ - buf_) - off;
+      }
+      if (err == 0 || !live)
+        break;
+      std::swap(old, cur);
+    }
+    return len;
+  }
+  /// Fuzzy find() with the bit-parallel engine, the first pattern char must match as with fuzzy find() of the backtracking engine, a fuzzy match with errors is replaced by a match with fewer errors that starts within the match.
+  size_t find_bit_parallel()
+    /// @returns nonzero if input matched the pattern
+  {
+    DBGLOG("BEGIN FuzzyMatcher::find_bit_parallel()");
+    const char pre = pat_->pre_[0];
+    while (true)
+    {
+      // this part is based on advance() in matcher.cpp, locate the next first pattern char
+      size_t loc = cur_;
+      if (pigeonhole())
+        loc = candidate(loc);
+      while (true)
+      {
+        const char *s = buf_ + loc;
+        const char *e = buf_ + end_;
+        s = static_cast<const char*>(std::memchr(s, pre, e - s));
+        if (s != NULL)
+        {
+          loc = s - buf_;
+          break;
+        }
+        set_current_match(end_);
+        if (peek_more() == EOF)
+        {
+          cap_ = 0;
+          len_ = 0;
+          DBGLOG("END FuzzyMatcher::find_bit_parallel()");
+          return 0;
+        }
+        loc = cur_;
+      }
+      set_current_match(loc);
+      uint8_t err;
+      size_t len = fuzzy_bit_parallel(0, err);
+      if (len > 0)
+      {
+        size_t off = 0;
+        for (size_t i = 1; err > 0 && i < off + len; ++i)
+        {
+          if (txt_[i] == pre)
+          {
+            uint8_t next_err;
+            size_t next_len = fuzzy_bit_parallel(i, next_err);
+            if (next_len > 0 && next_err < err)
+            {
+              off = i;
+              len = next_len;
+              err = next_err;
+            }
+          }
+        }
+        txt_ += off;
+        len_ = len;
+        err_ = err;
+        cap_ = 1;
+        set_current(txt_ - buf_ + len_);
+        DBGLOG("END FuzzyMatcher::find_bit_parallel()");
+        return cap_;
+      }
+      cur_ = txt_ - buf_ + 1;
+      txt_ = buf_ + cur_;
+    }
+  }
+  /// Piece of the pattern prefix searched by the pigeonhole prefilter, with the location of its next exact match in the input.
+  struct Piece {
+    size_t off;  ///< offset of the piece in the pattern prefix
+    size_t len;  ///< length of the piece
+    size_t from; ///< input position num_ + loc from where the piece was searched
+    size_t next; ///< input position num_ + loc of the next exact match of the piece when hit, otherwise up to where the piece was not found
+    bool   hit;  ///< true if the piece was found at next
+  };
+  /// Returns true if the pattern prefix is ASCII and can be split into max_ + 1 pieces of at least two bytes for the pigeonhole prefilter, splitting the prefix when the pattern changed.
+  bool pigeonhole()
+    /// @returns true if the pigeonhole prefilter applies
+  {
+    if (php_ == pat_)
+      return !phs_.empty();
+    php_ = pat_;
+    phs_.clear();
+    size_t len = pat_->len_;
+    size_t n = static_cast<size_t>(max_) + 1;
+    if (len < 2 * n)
+      return false;
+    for (size_t i = 0; i < len; ++i)
+      if ((pat_->pre_[i] & 0x80) != 0)
+        return false;
+    for (size_t i = 0; i < n; ++i)
+    {
+      Piece piece = { i * len / n, (i + 1) * len / n - i * len / n, static_cast<size_t>(-1), 0, false };
+      phs_.push_back(piece);
+    }
+    return true;
+  }
+  /// Returns the location in the buffer of the next exact match of the piece at or after loc, or end_ when not found in the buffer, resuming the search where the piece was last searched.
+  size_t search(
+      Piece& piece, ///< piece of the pattern prefix
+      size_t loc)   ///< location in the buffer to start searching
+    /// @returns location in the buffer or end_
+  {
+    size_t at = num_ + loc;
+    if (piece.from > at || (piece.hit && piece.next < at))
+    {
+      piece.from = at;
+      piece.next = at;
+      piece.hit = false;
+    }
+    else if (piece.hit)
+    {
+      return piece.next - num_;
+    }
+    if (piece.next > at)
+      loc = piece.next - num_;
+    const char *pre = pat_->pre_ + piece.off;
+    if (end_ >= loc + piece.len)
+    {
+      const char *s = buf_ + loc;
+      const char *e = buf_ + end_ - piece.len + 1;
+      while ((s = static_cast<const char*>(std::memchr(s, *pre, e - s))) != NULL)
+      {
+        if (std::memcmp(s + 1, pre + 1, piece.len - 1) == 0)
+        {
+          piece.next = num_ + (s - buf_);
+          piece.hit = true;
+          return s - buf_;
+        }
+        ++s;
+      }
+      loc = end_ - piece.len + 1;
+    }
+    piece.next = num_ + loc;
+    return end_;
+  }
+  /// Returns the location of the next fuzzy find() candidate at or after loc, where the first pattern char matches and one of the max_ + 1 pieces of the pattern prefix matches exactly, because max_ edits cannot change all of the pieces (pigeonhole principle), or end_ when there are no candidates.
+  size_t candidate(size_t loc) ///< location in the buffer
+    /// @returns location in the buffer or end_
+  {
+    DBGLOG("BEGIN FuzzyMatcher::candidate(%zu)", loc);
+    // a piece shifts by at most four bytes per edit, inserting or deleting a UTF-8 multibyte char
+    const size_t w = 4 * static_cast<size_t>(max_);
+    const char pre = pat_->pre_[0];
+    while (true)
+    {
+      // find the piece match closest to the start of a fuzzy match, key = start + w
+      size_t key = static_cast<size_t>(-1);
+      size_t hit = 0;
+      size_t more = static_cast<size_t>(-1);
+      for (std::vector<Piece>::iterator piece = phs_.begin(); piece != phs_.end(); ++piece)
+      {
+        size_t from = loc + (piece->off > w ? piece->off - w : 0);
+        size_t at = search(*piece, from);
+        if (at < end_)
+        {
+          if (at + w - piece->off < key)
+          {
+            key = at + w - piece->off;
+            hit = at;
+          }
+        }
+        else
+        {
+          // the piece may match later in the input when more input is read
+          at = end_ + 1 > piece->len ? end_ + 1 - piece->len : 0;
+          if (at < from)
+            at = from;
+          if (at + w - piece->off < more)
+            more = at + w - piece->off;
+        }
+      }
+      if (key != static_cast<size_t>(-1) && (eof_ || key <= more))
+      {
+        // a fuzzy match that contains this piece match starts within [key - 2w, key] but not after the piece match
+        size_t lo = key > 2 * w ? key - 2 * w : 0;
+        size_t hi = key < hit ? key : hit;
+        if (lo < loc)
+          lo = loc;
+        const char *s = static_cast<const char*>(std::memchr(buf_ + lo, pre, hi - lo + 1));
+        if (s != NULL)
+        {
+          DBGLOG("END FuzzyMatcher::candidate() at %zu", static_cast<size_t>(s - buf_));
+          return s - buf_;
+        }
+        loc = hi + 1;
+        continue;
+      }
+      if (eof_)
+        break;
+      // no fuzzy match starts before loc, read more input
+      if (key > more)
+        key = more;
+      if (key > 2 * w && key - 2 * w > loc)
+        loc = key - 2 * w;
+      // keep the char before loc in the buffer
+      if (loc > cur_ + 1)
+        set_current_match(loc - 1);
+      else
+        txt_ = buf_ + cur_;
+      size_t num = num_;
+      pos_ = end_;
+      int c = peek_more();
+      pos_ = cur_;
+      loc -= num_ - num;
+      if (c == EOF && !eof_)
+      {
+        // the buffer is full, let the matcher engine take over
+        DBGLOG("END FuzzyMatcher::candidate() at %zu", loc);
+        return loc;
+      }
+    }
+    DBGLOG("END FuzzyMatcher::candidate() none");
+    return end_;
+  }
   /// Returns true if input fuzzy-matched the pattern using method Const::SCAN, Const::FIND, Const::SPLIT, or Const::MATCH.
   virtual size_t match(Method method) ///< Const::SCAN, Const::FIND, Const::SPLIT, or Const::MATCH
     /// @returns nonzero if input matched the pattern
   {
     DBGLOG("BEGIN FuzzyMatcher::match()");
     reset_text();
+    if (method == Const::FIND && bit_parallel())
+      return find_bit_parallel();
     SaveState sst(ded_);
     len_ = 0; // split text length starts with 0
 scan:
+    if (method == Const::FIND && !sst.use && pigeonhole())
+    {
+      size_t loc = candidate(cur_);
+      if (loc != cur_)
+        set_current(loc);
+    }
     txt_ = buf_ + cur_;
 #if !defined(WITH_NO_INDENT)
     mrk_ = false;
@@ -364,6 +727,10 @@ redo:
                   ++pc;
                   continue;
                 }
+              case 0xF9: // SKIP
+              case 0xF8: // SPAN
+                ++pc; // fuzzy matching must visit every byte in the loop to branch on edits
+                continue;
 #if !defined(WITH_NO_INDENT)
               case Pattern::META_DED - Pattern::META_MIN:
                 if (ded_ > 0)
@@ -420,6 +787,8 @@ redo:
                       continue;
                     }
                   case 0xFB: // HEAD
+                  case 0xF9: // SKIP
+                  case 0xF8: // SPAN
                     opcode = *++pc;
                     continue;
 #if !defined(WITH_NO_INDENT)
@@ -1027,6 +1396,12 @@ unrolled:
   bool ins_;                        ///< fuzzy match inserted chars (extra chars)
   bool del_;                        ///< fuzzy match deleted chars (missing chars)
   bool sub_;                        ///< fuzzy match substituted chars
+  const Pattern *bpp_;              ///< pattern of the bit-parallel character masks bpm_
+  size_t bpw_;                      ///< number of 64-bit words per bit vector of the bit-parallel engine, zero if not applicable to the pattern
+  std::vector<uint64_t> bpm_;       ///< bit-parallel character masks, 256 bit vectors of bpw_ words
+  std::vector<uint64_t> bps_;       ///< bit-parallel states, two sets of max_ + 1 bit vectors of bpw_ words
+  const Pattern *php_;              ///< pattern of the pigeonhole prefilter pieces phs_
+  std::vector<Piece>    phs_;       ///< pigeonhole prefilter pieces of the pattern prefix, empty if not applicable to the pattern
 };
 
 } // namespace reflex
@@ -56,7 +56,7 @@ class AbstractLexer {
         const typename M::Pattern& pattern,    ///< regex pattern to instantiate matcher class M(pattern, input)
         const Input&               input,      ///< the reflex::Input to instantiate matcher class M(pattern, input)
         AbstractLexer             *lexer,      ///< points to the instantiating lexer class
-        const char                *opt = NULL) ///< option string of the form `(A|N|T(=[[:digit:]])?|;)*`
+        const char                *opt = NULL) ///< option string of the form `(A|N|R|T(=[[:digit:]])?|;)*`
       :
         M(pattern, input, opt),
         lexer_(lexer)
@@ -66,7 +66,7 @@ class AbstractLexer {
         const char    *pattern,    ///< regex pattern to instantiate matcher class M(pattern, input)
         const Input&   input,      ///< the reflex::Input to instantiate matcher class M(pattern, input)
         AbstractLexer *lexer,      ///< points to the instantiating lexer class
-        const char    *opt = NULL) ///< option string of the form `(A|N|T(=[[:digit:]])?|;)*`
+        const char    *opt = NULL) ///< option string of the form `(A|N|R|T(=[[:digit:]])?|;)*`
       :
         M(pattern, input, opt),
         lexer_(lexer)
@@ -408,6 +408,79 @@ class AbstractLexer {
   {
     return state_.empty();
   }
+#if defined(WITH_SPAN)
+  /// Lexer state recorded by checkpoint() at the end of a match, to resume scanning from there with restore() after the input is edited.
+  struct Checkpoint {
+    Checkpoint()
+      :
+        offset(0),
+        bol(0),
+        lineno(1),
+        start(0)
+    { }
+    /// Returns true if the lexer state of this checkpoint is the same as the given checkpoint's, regardless of their locations.
+    bool same_state(const Checkpoint& checkpoint) const
+      /// @returns true if the start condition states and indent stops are the same
+    {
+      return start == checkpoint.start && states == checkpoint.states && stops == checkpoint.stops;
+    }
+    size_t              offset; ///< byte offset in the input where scanning resumes
+    size_t              bol;    ///< byte offset in the input of the begin of the line of offset
+    size_t              lineno; ///< line number of offset
+    int                 start;  ///< the start condition state
+    std::stack<int>     states; ///< the stack of start condition states
+    std::vector<size_t> stops;  ///< the indent stops
+  };
+  /// Returns a checkpoint with the lexer state and location at the end of the last match.
+  Checkpoint checkpoint()
+    /// @returns checkpoint
+    /// @note Pending dedents and stacked indent stops are not recorded.
+  {
+    Checkpoint checkpoint;
+    if (has_matcher())
+    {
+      checkpoint.offset = matcher().last();
+      checkpoint.bol = matcher().first() - matcher().border();
+      checkpoint.lineno = matcher().lineno();
+      const char *s = matcher().begin();
+      const char *e = s + matcher().size();
+      while ((s = static_cast<const char*>(std::memchr(s, '\n', e - s))) != NULL)
+      {
+        checkpoint.bol = checkpoint.offset - (e - ++s);
+        ++checkpoint.lineno;
+      }
+      std::vector<size_t> *stops = matcher().indent_stops();
+      if (stops != NULL)
+        checkpoint.stops = *stops;
+    }
+    checkpoint.start = start_;
+    checkpoint.states = state_;
+    return checkpoint;
+  }
+  /// Restore the lexer state of a checkpoint to resume scanning at its location, given the (edited) input that starts at the begin of the line of the checkpoint.
+  bool restore(
+      const Checkpoint& checkpoint, ///< checkpoint returned by checkpoint()
+      const Input&      input)      ///< input character sequence that starts at byte offset checkpoint.bol
+    /// @returns true if restored, false if no matcher was assigned or if the input ends before the checkpoint
+  {
+    if (!has_matcher())
+      return false;
+    in(input);
+    matcher().set_offset(checkpoint.bol);
+    matcher().lineno(checkpoint.lineno);
+    if (checkpoint.bol > 0)
+      matcher().set_bol(true);
+    for (size_t n = checkpoint.offset - checkpoint.bol; n > 0; --n)
+      if (matcher().input() == EOF)
+        return false;
+    std::vector<size_t> *stops = matcher().indent_stops();
+    if (stops != NULL)
+      *stops = checkpoint.stops;
+    start_ = checkpoint.start;
+    state_ = checkpoint.states;
+    return true;
+  }
+#endif
   /// Lexer exceptions.
   virtual void lexer_error(const char *message = NULL)
   {
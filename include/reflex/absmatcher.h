@@ -46,6 +46,8 @@
 /// This compile-time option adds span(), line(), wline(), speeds up buffer shifting and lineno().
 #define WITH_SPAN
 
+// Compile with -DWITH_STATS to count buffer, get(), match() and advance() statistics, see AbstractMatcher::stats(), disabled by default to keep the hot paths lean.
+
 #include <reflex/convert.h>
 #include <reflex/debug.h>
 #include <reflex/input.h>
@@ -53,6 +55,19 @@
 #include <cstdlib>
 #include <cctype>
 #include <iterator>
+#include <vector>
+
+/// Add MatcherPool to reuse matchers across threads without locking; requires C++11 atomics.
+#if __cplusplus >= 201103L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201103L)
+# define WITH_MATCHER_POOL
+# include <atomic>
+#endif
+
+/// Add view() that returns the text matched as a std::string_view; requires C++17.
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+# define WITH_STRING_VIEW
+# include <string_view>
+#endif
 
 namespace reflex {
 
@@ -80,7 +95,7 @@ cur_ // current position in buf_ while matching text, cur_ = pos_ afterwards, ca
 pos_ // position in buf_ to start the next match
 end_ // position in buf_ that is free to fill with more input
 max_ // allocated size of buf_, must ensure that max_ > end_ for text() to add a final \0
-txt_ // points to the match, will be 0-terminated when text() or rest() are called
+txt_ // points to the match, will be 0-terminated when text() or rest() are called, unless option R is used
 len_ // length of the match
 chr_ // char located at txt_[len_] when txt_[len_] is set to \0 by text(), is \0 otherwise
 got_ // buf_[cur_-1] or txt_[-1] character before this match (assigned before each match), initially Const::BOB
@@ -104,6 +119,9 @@ class AbstractMatcher {
     static const size_t BLOCK = (256*1024); ///< buffer size and growth, buffer is initially 2*BLOCK size, at least 4096 bytes
     static const size_t REDO  = 0x7FFFFFFF; ///< reflex::Matcher::accept() returns "redo" with reflex::Matcher option "A"
     static const size_t EMPTY = 0xFFFFFFFF; ///< accept() returns "empty" last split at end of input
+    static const int TRUNCATE = 0;          ///< set_limit() policy to truncate a match that does not fit in the buffer, as if the input ended there
+    static const int DISCARD  = 1;          ///< set_limit() policy to always discard the line before a match when shifting the buffer, then truncate
+    static const int SIGNAL   = 2;          ///< set_limit() policy to truncate and to invoke the set_handler() event handler on the truncated match
   };
   /// Context returned by before() and after()
   struct Context {
@@ -125,6 +143,117 @@ class AbstractMatcher {
   };
   /// Event handler functor base class to invoke when the buffer contents are shifted out, e.g. for logging the data searched.
   struct Handler { virtual void operator()(AbstractMatcher&, const char*, size_t, size_t) = 0; };
+  /// Buffer allocator base class to allocate, reallocate and free the buffer of a matcher, see set_allocator().
+  struct Allocator {
+    virtual ~Allocator() { }
+    /// Allocate a buffer of the specified size in bytes, throws std::bad_alloc when out of memory.
+    virtual char *allocate(size_t size) = 0;
+    /// Reallocate a buffer to a larger size, keeping the first keep bytes, throws std::bad_alloc when out of memory.
+    virtual char *reallocate(
+        char  *buf,      ///< buffer allocated with this allocator
+        size_t size,     ///< size of the buffer
+        size_t new_size, ///< new size of the buffer
+        size_t keep)     ///< number of bytes at the start of the buffer to keep
+      /// @returns the reallocated buffer
+    {
+      char *newbuf = allocate(new_size);
+      std::memcpy(newbuf, buf, keep);
+      deallocate(buf, size);
+      return newbuf;
+    }
+    /// Free a buffer of the specified size allocated with this allocator.
+    virtual void deallocate(char *buf, size_t size) = 0;
+    /// Shift the buffer contents by gap bytes without moving them, when the buffer is a ring mapped twice in memory.
+    virtual char *rotate(
+        char  *buf,  ///< buffer allocated with this allocator
+        size_t size, ///< size of the buffer
+        size_t gap)  ///< number of bytes to shift out
+      /// @returns a pointer to buffer data starting at buf[gap], or NULL when the buffer contents must be moved to shift them
+    {
+      (void)buf;
+      (void)size;
+      (void)gap;
+      return NULL;
+    }
+  };
+  /// The default buffer allocator allocates page-aligned buffers on transparent huge pages when large enough, and reuses freed buffers from a per-thread pool with C++11 or greater.
+  struct DefaultAllocator : public Allocator {
+    /// The default allocator instance shared by all matchers.
+    static DefaultAllocator& instance();
+    virtual char *allocate(size_t size);
+    virtual char *reallocate(char *buf, size_t size, size_t new_size, size_t keep);
+    virtual void deallocate(char *buf, size_t size);
+  };
+  /// Ring buffer allocator maps each buffer twice back to back in virtual memory, so that shifting the buffer is a pointer adjustment instead of a memmove, falls back to the default allocator when not supported; not thread safe, use one RingAllocator per thread.
+  class RingAllocator : public Allocator {
+   public:
+    virtual ~RingAllocator();
+    virtual char *allocate(size_t size);
+    virtual void deallocate(char *buf, size_t size);
+    virtual char *rotate(char *buf, size_t size, size_t gap);
+   protected:
+    /// Return the ring that contains buf.
+    std::map<char*,size_t>::iterator ring(char *buf)
+      /// @returns iterator to the base and size of the ring, or rings_.end()
+      ;
+    std::map<char*,size_t> rings_; ///< base address and size of the rings allocated
+  };
+#if defined(WITH_STATS)
+  /// AbstractMatcher::Stats counters of the matcher hot paths, zero unless compiled with WITH_STATS.
+  struct Stats {
+    /// The search paths taken by Matcher::advance() to find a possible match.
+    enum Path {
+      PREFIX,   ///< search for the pattern prefix string
+      REQUIRED, ///< search for a required literal, then back up to the start of the match
+      LITERALS, ///< SIMD search for one of the literals of a pattern without a common prefix
+      WIDE,     ///< wide bitap of a pattern with a long minimum match length
+      BITAP,    ///< bitap with the pmh_ predictor for a minimum match length of 4 or more
+      PMA,      ///< bitap or pma_ predictor for a minimum match length of 1 to 3
+      PATHS     ///< number of paths
+    };
+    Stats()
+    {
+      reset();
+    }
+    /// Reset all counters to zero.
+    void reset()
+    {
+      bytes = 0;
+      fills = 0;
+      gets = 0;
+      peeks = 0;
+      grows = 0;
+      expands = 0;
+      moved = 0;
+      matches = 0;
+      misses = 0;
+      transitions = 0;
+      advances = 0;
+      skipped = 0;
+      candidates = 0;
+      rejects = 0;
+      false_positives = 0;
+      for (int i = 0; i < PATHS; ++i)
+        paths[i] = 0;
+    }
+    size_t bytes;           ///< number of bytes read into the buffer
+    size_t fills;           ///< number of reads to fill the buffer
+    size_t gets;            ///< number of get() calls
+    size_t peeks;           ///< number of peek_more() calls to peek past the buffered input
+    size_t grows;           ///< number of times the buffer was shifted or expanded by grow()
+    size_t expands;         ///< number of times the buffer was expanded by grow()
+    size_t moved;           ///< number of bytes moved with memmove by grow() to shift the buffer
+    size_t matches;         ///< number of times match() was entered
+    size_t misses;          ///< number of times match() returned without a match
+    size_t transitions;     ///< number of DFA transitions taken by the opcode interpreter
+    size_t advances;        ///< number of Matcher::advance() calls to search for a possible match
+    size_t skipped;         ///< number of bytes skipped by Matcher::advance()
+    size_t candidates;      ///< number of possible matches found by Matcher::advance()
+    size_t rejects;         ///< number of possible matches rejected by the pmh_ and pma_ predictors in Matcher::advance()
+    size_t false_positives; ///< number of possible matches found by Matcher::advance() that the DFA did not match
+    size_t paths[PATHS];    ///< number of Matcher::advance() calls per search path
+  };
+#endif
  protected:
   /// AbstractMatcher::Options for matcher engines.
   struct Option {
@@ -132,10 +261,12 @@ class AbstractMatcher {
       :
         A(false),
         N(false),
+        R(false),
         T(8)
     { }
     bool A; ///< accept any/all (?^X) negative patterns as Const::REDO accept index codes
     bool N; ///< nullable, find may return empty match (N/A to scan, split, matches)
+    bool R; ///< read-only buffer, text() returns a 0-terminated copy of the match instead of terminating the match in the buffer
     char T; ///< tab size, must be a power of 2, default is 8, for column count and indent \i, \j, and \k
   };
   /// AbstractMatcher::Iterator class for scanning, searching, and splitting input character sequences.
@@ -270,7 +401,7 @@ class AbstractMatcher {
   /// Construct a base abstract matcher.
   AbstractMatcher(
       const Input& input, ///< input character sequence for this matcher
-      const char  *opt)   ///< option string of the form `(A|N|T(=[[:digit:]])?|;)*`
+      const char  *opt)   ///< option string of the form `(A|N|R|T(=[[:digit:]])?|;)*`
     :
       scan(this, Const::SCAN),
       find(this, Const::FIND),
@@ -288,9 +419,9 @@ class AbstractMatcher {
       find(this, Const::FIND),
       split(this, Const::SPLIT)
   {
+    opt_ = opt;
     in = input;
     init();
-    opt_ = opt;
   }
   /// Delete abstract matcher, deletes this matcher's internal buffer.
   virtual ~AbstractMatcher()
@@ -298,15 +429,7 @@ class AbstractMatcher {
     DBGLOG("AbstractMatcher::~AbstractMatcher()");
     if (own_)
     {
-#if defined(WITH_REALLOC)
-#if (defined(__WIN32__) || defined(_WIN32) || defined(WIN32) || defined(_WIN64) || defined(__BORLANDC__)) && !defined(__CYGWIN__) && !defined(__MINGW32__) && !defined(__MINGW64__)
-      _aligned_free(static_cast<void*>(buf_));
-#else
-      std::free(static_cast<void*>(buf_));
-#endif
-#else
-      delete[] buf_;
-#endif
+      alc_->deallocate(buf_, max_);
     }
   }
   /// Polymorphic cloning.
@@ -319,6 +442,7 @@ class AbstractMatcher {
     {
       opt_.A = false; // when true: accept any/all (?^X) negative patterns as Const::REDO accept index codes
       opt_.N = false; // when true: find may return empty match (N/A to scan, split, matches)
+      opt_.R = false; // when true: never write to the buffer, text() returns a copy
       opt_.T = 8;     // tab size 1, 2, 4, or 8
       if (opt)
       {
@@ -332,6 +456,9 @@ class AbstractMatcher {
             case 'N':
               opt_.N = true;
               break;
+            case 'R':
+              opt_.R = true;
+              break;
             case 'T':
               opt_.T = isdigit(*(s += (s[1] == '=') + 1)) ? static_cast<char>(*s - '0') : 0;
               break;
@@ -341,20 +468,8 @@ class AbstractMatcher {
     }
     if (!own_)
     {
-      max_ = 2 * Const::BLOCK;
-#if defined(WITH_REALLOC)
-#if (defined(__WIN32__) || defined(_WIN32) || defined(WIN32) || defined(_WIN64) || defined(__BORLANDC__)) && !defined(__CYGWIN__) && !defined(__MINGW32__) && !defined(__MINGW64__)
-      buf_ = static_cast<char*>(_aligned_malloc(max_, 4096));
-      if (buf_ == NULL)
-        throw std::bad_alloc();
-#else
-      buf_ = NULL;
-      if (::posix_memalign(reinterpret_cast<void**>(&buf_), 4096, max_) != 0)
-        throw std::bad_alloc();
-#endif
-#else
-      buf_ = new char[max_];
-#endif
+      max_ = lim_ > 0 && lim_ < 2 * Const::BLOCK ? lim_ : 2 * Const::BLOCK;
+      buf_ = alc_->allocate(max_);
     }
     buf_[0] = '\0';
     txt_ = buf_;
@@ -365,6 +480,8 @@ class AbstractMatcher {
     end_ = 0;
     ind_ = 0;
     blk_ = 0;
+    tal_ = 0;
+    lnb_ = false;
     got_ = Const::BOB;
     chr_ = '\0';
 #if defined(WITH_SPAN)
@@ -373,13 +490,32 @@ class AbstractMatcher {
 #endif
     lpb_ = buf_;
     lno_ = 1;
-#if !defined(WITH_SPAN)
-    cno_ = 0;
+#if defined(WITH_SPAN)
+    cpb_ = buf_;
 #endif
+    cno_ = 0;
     num_ = 0;
     own_ = true;
     eof_ = false;
     mat_ = false;
+    ovf_ = false;
+    seg_ = false;
+    if (opt_.R)
+    {
+      // scan a memory-mapped file or segmented input in place, which is safe because this matcher never writes to the buffer with option R
+      size_t size;
+      const char *base = in.mapped(size);
+      if (base != NULL)
+      {
+        buffer(const_cast<char*>(base), size + 1);
+      }
+      else if ((base = in.segment(0, size)) != NULL)
+      {
+        buffer(const_cast<char*>(base), size + 1);
+        eof_ = false;
+        seg_ = true;
+      }
+    }
   }
   /// Set buffer block size for reading: use 0 (or omit argument) to buffer all input in which case returns true if all the data could be read and false if a read error occurred.
   bool buffer(size_t blk = 0) ///< new block size between 1 and Const::BLOCK, or 0 to buffer all input (default)
@@ -389,23 +525,91 @@ class AbstractMatcher {
       blk = Const::BLOCK;
     DBGLOG("AbstractMatcher::buffer(%zu)", blk);
     blk_ = blk;
-    if (blk > 0 || eof_ || in.eof())
+    if (blk > 0 || eof_ || seg_ || in.eof())
       return true;
+    end_ += tal_; // release the partial line read ahead with line_buffered()
+    tal_ = 0;
     size_t n = in.size(); // get the (rest of the) data size, which is 0 if unknown (e.g. reading input from a TTY or a pipe)
     if (n > 0)
     {
       (void)grow(n + 1); // now attempt to fetch all (remaining) data to store in the buffer, +1 for a final \0
+      if (n >= max_)
+        n = max_ - 1; // the buffer is limited in size with set_limit()
       end_ += get(buf_, n);
     }
-    while (in.good()) // there is more to get while good(), e.g. via wrap()
+    while (in.good() && !ovf_) // there is more to get while good(), e.g. via wrap()
     {
       (void)grow();
-      end_ += get(buf_ + end_, max_ - end_);
+      end_ += get(buf_ + end_, max_ - end_ - 1);
     }
     if (end_ == max_)
       (void)grow(1); // make sure we have room for a final \0
     return in.eof();
   }
+  /// Set the maximum buffer size to bound the memory used by this matcher, and the policy Const::TRUNCATE, Const::DISCARD, or Const::SIGNAL to apply when a match does not fit in the buffer, a maximum of 0 removes the limit (default).
+  void set_limit(
+      size_t max,                      ///< maximum buffer size in bytes (at least 4096), or 0 for no limit
+      int    policy = Const::TRUNCATE) ///< Const::TRUNCATE, Const::DISCARD, or Const::SIGNAL
+  {
+    DBGLOG("AbstractMatcher::set_limit(%zu, %d)", max, policy);
+    lim_ = max > 0 && max < 4096 ? 4096 : max;
+    pol_ = policy;
+    if (own_ && end_ == 0 && lim_ > 0 && max_ > lim_)
+    {
+      // nothing was read yet, so allocate a smaller buffer within the limit
+      alc_->deallocate(buf_, max_);
+#if defined(WITH_SPAN)
+      Handler *evh = evh_;
+#endif
+      own_ = false;
+      reset();
+#if defined(WITH_SPAN)
+      evh_ = evh;
+#endif
+    }
+  }
+  /// Returns true if the buffer is full at its size limit set with set_limit(), which means that the current match is truncated.
+  bool overflow() const
+    /// @returns true if the buffer size limit is reached
+  {
+    return ovf_;
+  }
+#if defined(WITH_STATS)
+  /// Returns the statistics counted since this matcher was created or since reset_stats(), requires compile-time option WITH_STATS.
+  const Stats& stats() const
+    /// @returns reference to the statistics counters
+  {
+    return sts_;
+  }
+  /// Reset the statistics counters, requires compile-time option WITH_STATS.
+  void reset_stats()
+  {
+    sts_.reset();
+  }
+#endif
+  /// Set the allocator of the buffer, moves the buffer contents to a new buffer allocated with the specified allocator.
+  void set_allocator(Allocator *alloc) ///< allocator, or NULL for the default allocator
+  {
+    DBGLOG("AbstractMatcher::set_allocator()");
+    if (alloc == NULL)
+      alloc = &DefaultAllocator::instance();
+    if (alloc == alc_)
+      return;
+    if (own_)
+    {
+      char *newbuf = alloc->allocate(max_);
+      std::memcpy(newbuf, buf_, end_ + tal_ + 1);
+      txt_ = newbuf + (txt_ - buf_);
+#if defined(WITH_SPAN)
+      bol_ = newbuf + (bol_ - buf_);
+      cpb_ = newbuf + (cpb_ - buf_);
+#endif
+      lpb_ = newbuf + (lpb_ - buf_);
+      alc_->deallocate(buf_, max_);
+      buf_ = newbuf;
+    }
+    alc_ = alloc;
+  }
 #if defined(WITH_SPAN)
   /// Set event handler functor to invoke when the buffer contents are shifted out, e.g. for logging the data searched.
   void set_handler(Handler *handler)
@@ -439,6 +643,18 @@ class AbstractMatcher {
     DBGLOG("AbstractMatcher::interactive()");
     (void)buffer(1);
   }
+  /// Set line-buffered input to read data up to and including the last newline of each block read, keeping the partial line after it in the buffer until the next read, such that input is matched in batches of whole lines.
+  void line_buffered(bool flag = true) ///< true to read whole lines, false to read blocks of bytes (default)
+    /// @note Use this method before any matching is done and before any input is read since the last time input was (re)set.
+  {
+    DBGLOG("AbstractMatcher::line_buffered(%d)", flag);
+    if (!flag)
+    {
+      end_ += tal_;
+      tal_ = 0;
+    }
+    lnb_ = flag;
+  }
   /// Flush the buffer's remaining content.
   void flush()
   {
@@ -453,6 +669,12 @@ class AbstractMatcher {
   {
     return in.get(s, n);
   }
+  /// Returns pointer to the indent stop positions of this matcher, NULL if this matcher does not support indent stops.
+  virtual std::vector<size_t> *indent_stops()
+    /// @returns pointer to vector of size_t or NULL
+  {
+    return NULL;
+  }
   /// Returns true if wrapping of input after EOF is supported.
   virtual bool wrap()
     /// @returns true if input was succesfully wrapped
@@ -468,7 +690,7 @@ class AbstractMatcher {
     reset();
     return *this;
   }
-  /// Set the buffer base containing 0-terminated character data to scan in place (data may be modified), reset/restart the matcher.
+  /// Set the buffer base containing 0-terminated character data to scan in place (data may be modified, unless option R is used), reset/restart the matcher.
   AbstractMatcher& buffer(
       char *base,  ///< base of the buffer containing 0-terminated character data
       size_t size) ///< nonzero size of the buffer
@@ -478,15 +700,7 @@ class AbstractMatcher {
     {
       if (own_)
       {
-#if defined(WITH_REALLOC)
-#if (defined(__WIN32__) || defined(_WIN32) || defined(WIN32) || defined(_WIN64) || defined(__BORLANDC__)) && !defined(__CYGWIN__) && !defined(__MINGW32__) && !defined(__MINGW64__)
-        _aligned_free(static_cast<void*>(buf_));
-#else
-        std::free(static_cast<void*>(buf_));
-#endif
-#else
-        delete[] buf_;
-#endif
+        alc_->deallocate(buf_, max_);
       }
       buf_ = base;
       txt_ = buf_;
@@ -498,6 +712,8 @@ class AbstractMatcher {
       max_ = size;
       ind_ = 0;
       blk_ = 0;
+      tal_ = 0;
+      lnb_ = false;
       got_ = Const::BOB;
       chr_ = '\0';
 #if defined(WITH_SPAN)
@@ -506,13 +722,15 @@ class AbstractMatcher {
 #endif
       lpb_ = buf_;
       lno_ = 1;
-#if !defined(WITH_SPAN)
-      cno_ = 0;
+#if defined(WITH_SPAN)
+      cpb_ = buf_;
 #endif
+      cno_ = 0;
       num_ = 0;
       own_ = false;
       eof_ = true;
       mat_ = false;
+      seg_ = false;
     }
     return *this;
   }
@@ -543,10 +761,15 @@ class AbstractMatcher {
   {
     return txt_ + len_;
   }
-  /// Returns 0-terminated string of the text matched, does not include matched \0s, this is a constant-time operation.
+  /// Returns 0-terminated string of the text matched, does not include matched \0s, this is a constant-time operation, except with option R that copies the text matched to keep the buffer read-only.
   inline const char *text()
     /// @returns 0-terminated const char* string with text matched
   {
+    if (opt_.R)
+    {
+      cpy_.assign(txt_, len_);
+      return cpy_.c_str();
+    }
     if (chr_ == '\0')
     {
       chr_ = txt_[len_];
@@ -554,6 +777,14 @@ class AbstractMatcher {
     }
     return txt_;
   }
+#if defined(WITH_STRING_VIEW)
+  /// Returns the text matched as a string view of the buffer, never writes to the buffer, may include matched \0s, this is a constant-time operation.
+  inline std::string_view view() const
+    /// @returns string view of the text matched, valid until the next match or until the buffer is shifted
+  {
+    return std::string_view(txt_, len_);
+  }
+#endif
   /// Returns the text matched as a string, a copy of text(), may include matched \0s.
   inline std::string str() const
     /// @returns string with text matched
@@ -576,11 +807,7 @@ class AbstractMatcher {
   inline size_t wsize() const
     /// @returns the length of the match in number of wide (multibyte UTF-8) characters
   {
-    size_t n = 0;
-    const char *e = txt_ + len_;
-    for (const char *s = txt_; s < e; ++s)
-      n += (*s & 0xC0) != 0x80;
-    return n;
+    return count_columns(txt_, txt_ + len_, 0, false);
   }
   /// Returns the first 8-bit character of the text matched.
   inline int chr() const
@@ -608,7 +835,8 @@ class AbstractMatcher {
 #if defined(WITH_SPAN)
     if (lpb_ < txt_)
     {
-      char *s = bol_;
+      // the newlines before lpb_ are counted, search back from txt_ to lpb_ for a newline
+      char *s = lpb_ > bol_ ? lpb_ : bol_;
       char *t = txt_;
       // clang/gcc 4-way vectorizable loop
       while (t - 4 >= s)
@@ -622,7 +850,8 @@ class AbstractMatcher {
         if (--t >= s && *t != '\n')
           if (--t >= s && *t != '\n')
             --t;
-      bol_ = t + 1;
+      if (t >= s)
+        bol_ = t + 1;
       lpb_ = txt_;
       size_t n = lno_;
 #if defined(HAVE_AVX512BW) && (!defined(_MSC_VER) || defined(_WIN64))
@@ -701,7 +930,20 @@ class AbstractMatcher {
       }
 #elif defined(HAVE_NEON)
       {
-        // ARM AArch64/NEON SIMD optimized loop? - no code found yet that runs faster than the code below
+        // count newlines 16 at a time in byte counters that are added up before they overflow
+        uint8x16_t vlcn = vdupq_n_u8('\n');
+        while (s + 15 <= t)
+        {
+          uint8x16_t vcnt = vdupq_n_u8(0);
+          for (int i = 0; i < 255 && s + 15 <= t; ++i)
+          {
+            uint8x16_t vlcm = vld1q_u8(reinterpret_cast<const uint8_t*>(s));
+            vcnt = vsubq_u8(vcnt, vceqq_u8(vlcm, vlcn));
+            s += 16;
+          }
+          uint64x2_t vsum = vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(vcnt)));
+          n += vgetq_lane_u64(vsum, 0) + vgetq_lane_u64(vsum, 1);
+        }
       }
 #endif
       uint32_t n0 = 0, n1 = 0, n2 = 0, n3 = 0;
@@ -780,21 +1022,16 @@ class AbstractMatcher {
   {
     (void)lineno();
 #if defined(WITH_SPAN)
-    const char *s = bol_;
-    const char *e = txt_;
-    size_t k = 0;
-    while (s < e)
+    // count forward from the column of the previous call on the same line, or from the begin of the line
+    if (cpb_ < bol_ || cpb_ > txt_)
     {
-      if (*s == '\t')
-        k += 1 + (~k & (opt_.T - 1)); // count tab spacing
-      else
-        k += ((*s & 0xC0) != 0x80); // count column offset in UTF-8 chars
-      ++s;
+      cpb_ = bol_;
+      cno_ = 0;
     }
-    return k;
-#else
-    return cno_;
+    cno_ = count_columns(cpb_, txt_, cno_);
+    cpb_ = txt_;
 #endif
+    return cno_;
   }
   /// Returns the number of columns of the matched text, taking tab spacing into account and counting wide characters as one character each.
   inline size_t columns()
@@ -802,44 +1039,19 @@ class AbstractMatcher {
   {
     // count columns in tabs and UTF-8 chars
 #if defined(WITH_SPAN)
-    const char *s = txt_;
-    const char *e = txt_ + len_;
     size_t n = columno();
-    size_t k = n;
-    while (s < e)
-    {
-      if (*s == '\t')
-        k += 1 + (~k & (opt_.T - 1)); // count tab spacing
-      else if (*s != '\r' && *s != '\n')
-        k += ((*s & 0xC0) != 0x80); // count column offset in UTF-8 chars
-      ++s;
-    }
-    return k - n;
+    return count_columns(txt_, txt_ + len_, n, true, true) - n;
 #else
-    size_t n = cno_;
-    size_t m = 0;
-    const char *s;
-    const char *t = buf_;
-    for (s = txt_ + len_ - 1; s >= t; --s)
-    {
+    const char *e = txt_ + len_;
+    const char *s = e;
+    while (--s >= txt_)
       if (*s == '\n')
-      {
-        n = 0;
         break;
-      }
-    }
-    t = txt_;
-    const char *e = txt_ + len_;
-    for (++s; s < e; ++s)
-    {
-      if (s == t)
-        m = n;
-      if (*s == '\t')
-        n += 1 + (~n & (opt_.T - 1));
-      else
-        n += (*s & 0xC0) != 0x80;
-    }
-    return n - m;
+    // the columns of the last line of a match that spans multiple lines
+    if (s >= txt_)
+      return count_columns(s + 1, e, 0);
+    size_t n = columno();
+    return count_columns(txt_, e, n) - n;
 #endif
   }
 #if defined(WITH_SPAN)
@@ -849,21 +1061,13 @@ class AbstractMatcher {
   {
     if (len_ == 0)
       return columno();
-    (void)lineno();
     const char *e = txt_ + len_;
     const char *s = e;
-    const char *b = bol_;
-    while (--s >= b)
+    while (--s >= txt_)
       if (*s == '\n')
         break;
-    size_t k = 0;
-    while (++s < e)
-    {
-      if (*s == '\t')
-        k += 1 + (~k & (opt_.T - 1));
-      else
-        k += (*s & 0xC0) != 0x80;
-    }
+    // the match ends on its first line: count forward from the column of the match
+    size_t k = s < txt_ ? count_columns(txt_, e, columno()) : count_columns(s + 1, e, 0);
     return k > 0 ? k - 1 : 0;
   }
 #endif
@@ -925,6 +1129,12 @@ class AbstractMatcher {
     if (own_)
       eof_ = eof;
   }
+  /// Set the byte offset of the start of the input, so that first() and last() return offsets in a larger input when matching resumes in the middle of it.
+  inline void set_offset(size_t offset) ///< byte offset of the start of the input
+    /// @note Use this method before any matching is done and before any input is read since the last time input was (re)set.
+  {
+    num_ = offset;
+  }
   /// Returns true if this matcher reached the begin of a new line.
   inline bool at_bol() const
     /// @returns true if at begin of a new line
@@ -1005,9 +1215,11 @@ class AbstractMatcher {
     {
       txt_ = buf_;
       len_ = 0;
-      if (end_ + 1 >= max_)
+      if (end_ + tal_ + 1 >= max_)
         (void)grow();
-      std::memmove(buf_ + 1, buf_, end_);
+      if (end_ + tal_ + 1 >= max_)
+        return; // the buffer is full at its size limit set with set_limit()
+      std::memmove(buf_ + 1, buf_, end_ + tal_);
       ++end_;
     }
     buf_[pos_] = c;
@@ -1027,9 +1239,11 @@ class AbstractMatcher {
     {
       txt_ = buf_;
       len_ = 0;
-      if (end_ + n >= max_)
+      if (end_ + tal_ + n >= max_)
         (void)grow();
-      std::memmove(buf_ + n, buf_, end_);
+      if (end_ + tal_ + n >= max_)
+        return; // the buffer is full at its size limit set with set_limit()
+      std::memmove(buf_ + n, buf_, end_ + tal_);
       end_ += n;
     }
     std::memcpy(&buf_[pos_], tmp, n);
@@ -1049,11 +1263,13 @@ class AbstractMatcher {
       return EOF;
     while (true)
     {
-      if (end_ + blk_ + 1 >= max_)
+      if (end_ + tal_ + blk_ + 1 >= max_)
         (void)grow();
-      end_ += get(buf_ + end_, blk_ > 0 ? blk_ : max_ - end_ - 1);
+      end_ += fill();
       if (pos_ < end_)
         return static_cast<unsigned char>(buf_[pos_]);
+      if (ovf_)
+        return EOF; // the buffer is full at its size limit set with set_limit(), but this is not the end of the input
       DBGLOGN("peek(): EOF");
       if (!wrap())
       {
@@ -1090,7 +1306,9 @@ class AbstractMatcher {
         break;
       (void)grow();
       loc = end_;
-      end_ += get(buf_ + end_, blk_ > 0 ? blk_ : max_ - end_ - 1);
+      end_ += fill();
+      if (loc >= end_ && ovf_)
+        break; // the line does not fit in the buffer of limited size
       if (loc >= end_ && !wrap())
       {
         eof_ = true;
@@ -1144,6 +1362,31 @@ class AbstractMatcher {
     return wcs(b, e - b);
   }
 #endif
+  /// Returns true if the buffered input, or the first block of input when no input is buffered yet, contains a NUL or invalid UTF-8, i.e. the input is binary, the input is not consumed.
+  bool binary()
+    /// @returns true if the input is binary
+  {
+    DBGLOG("AbstractMatcher::binary()");
+    if (pos_ >= end_)
+      (void)peek_more();
+    return is_binary(buf_ + pos_, end_ - pos_);
+  }
+  /// Search the input and return the number of matches, stops after max matches when max > 0 such as max = 1 to stop at the first match, counts lines with matches instead when lines is true by skipping the rest of the line after each match, does not keep track of line numbers and columns.
+  size_t count(
+      size_t max = 0,      ///< stop after max matches, or 0 to search all input
+      bool   lines = false) ///< count the lines with matches instead of the matches
+    /// @returns the number of matches found or lines with matches
+  {
+    DBGLOG("AbstractMatcher::count()");
+    size_t n = 0;
+    while ((max == 0 || n < max) && match(Const::FIND) != 0)
+    {
+      ++n;
+      if (lines && (len_ == 0 || txt_[len_ - 1] != '\n') && !skip('\n'))
+        break;
+    }
+    return n;
+  }
   /// Skip input until the specified ASCII character is consumed and return true, or EOF is reached and return false.
   bool skip(char c) ///< ASCII character to skip to
     /// @returns true if skipped to c, false if EOF is reached
@@ -1165,7 +1408,7 @@ class AbstractMatcher {
       pos_ = cur_ = end_;
       txt_ = buf_ + end_;
       (void)grow();
-      end_ += get(buf_ + end_, blk_ > 0 ? blk_ : max_ - end_ - 1);
+      end_ += fill();
       if (pos_ >= end_ && !wrap())
       {
         eof_ = true;
@@ -1225,7 +1468,9 @@ class AbstractMatcher {
     {
       (void)grow();
       pos_ = end_;
-      end_ += get(buf_ + end_, blk_ > 0 ? blk_ : max_ - end_ - 1);
+      end_ += fill();
+      if (pos_ >= end_ && ovf_)
+        break; // the rest does not fit in the buffer of limited size
       if (pos_ >= end_ && !wrap())
         eof_ = true;
     }
@@ -1250,6 +1495,8 @@ class AbstractMatcher {
       DBGCHK(pos_ < max_);
       len_ = n;
       cur_ = pos_;
+      // the char before the next match, for anchors and word boundaries
+      got_ = pos_ > 0 ? static_cast<unsigned char>(buf_[pos_ - 1]) : num_ == 0 ? Const::BOB : '\n';
     }
   }
   /// Cast this matcher to positive integer indicating the nonzero capture index of the matched text in the pattern, same as AbstractMatcher::accept.
@@ -1364,26 +1611,148 @@ class AbstractMatcher {
   {
     DBGLOG("AbstractMatcher::init(%s)", opt ? opt : "");
     own_ = false; // require allocation of a buffer
+    alc_ = &DefaultAllocator::instance();
+    lim_ = 0;
+    pol_ = Const::TRUNCATE;
     reset(opt);
   }
   /// The abstract match operation implemented by pattern matching engines derived from AbstractMatcher.
   virtual size_t match(Method method)
     /// @returns nonzero when input matched the pattern using method Const::SCAN, Const::FIND, Const::SPLIT, or Const::MATCH
     = 0;
+  /// Returns column k advanced over the text from s to e, taking tab spacing into account when tabs is true, not counting \r and \n when crlf is true, and counting wide characters as one character each.
+  inline size_t count_columns(
+      const char *s,             ///< begin of the text
+      const char *e,             ///< end of the text
+      size_t      k,             ///< column at s
+      bool        tabs = true,   ///< count tab spacing
+      bool        crlf = false)  ///< do not count \r and \n
+    const
+    /// @returns column at e
+  {
+    while (s < e)
+    {
+      // count the bytes that are not UTF-8 continuation bytes in blocks that have no tab or \r and \n to check
+#if defined(HAVE_AVX512BW) || defined(HAVE_AVX2)
+      if (have_HW_AVX2())
+      {
+        const __m256i vc = _mm256_set1_epi8(-0x40);
+        const __m256i vt = _mm256_set1_epi8('\t');
+        const __m256i vr = _mm256_set1_epi8('\r');
+        const __m256i vn = _mm256_set1_epi8('\n');
+        while (s + 32 <= e)
+        {
+          __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s));
+          __m256i vs = _mm256_setzero_si256();
+          if (tabs)
+            vs = _mm256_cmpeq_epi8(v, vt);
+          if (crlf)
+            vs = _mm256_or_si256(vs, _mm256_or_si256(_mm256_cmpeq_epi8(v, vr), _mm256_cmpeq_epi8(v, vn)));
+          if (_mm256_movemask_epi8(vs) != 0)
+            break;
+          k += 32 - popcount(_mm256_movemask_epi8(_mm256_cmpgt_epi8(vc, v)));
+          s += 32;
+        }
+      }
+      else if (have_HW_SSE2())
+#elif defined(HAVE_SSE2)
+      if (have_HW_SSE2())
+#endif
+#if defined(HAVE_AVX512BW) || defined(HAVE_AVX2) || defined(HAVE_SSE2)
+      {
+        const __m128i vc = _mm_set1_epi8(-0x40);
+        const __m128i vt = _mm_set1_epi8('\t');
+        const __m128i vr = _mm_set1_epi8('\r');
+        const __m128i vn = _mm_set1_epi8('\n');
+        while (s + 16 <= e)
+        {
+          __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+          __m128i vs = _mm_setzero_si128();
+          if (tabs)
+            vs = _mm_cmpeq_epi8(v, vt);
+          if (crlf)
+            vs = _mm_or_si128(vs, _mm_or_si128(_mm_cmpeq_epi8(v, vr), _mm_cmpeq_epi8(v, vn)));
+          if (_mm_movemask_epi8(vs) != 0)
+            break;
+          k += 16 - popcount(_mm_movemask_epi8(_mm_cmpgt_epi8(vc, v)));
+          s += 16;
+        }
+      }
+#elif defined(HAVE_NEON)
+      {
+        const int8x16_t vc = vdupq_n_s8(-0x40);
+        const uint8x16_t vt = vdupq_n_u8('\t');
+        const uint8x16_t vr = vdupq_n_u8('\r');
+        const uint8x16_t vn = vdupq_n_u8('\n');
+        while (s + 16 <= e)
+        {
+          uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(s));
+          uint8x16_t vs = vdupq_n_u8(0);
+          if (tabs)
+            vs = vceqq_u8(v, vt);
+          if (crlf)
+            vs = vorrq_u8(vs, vorrq_u8(vceqq_u8(v, vr), vceqq_u8(v, vn)));
+          uint64x2_t vs64 = vreinterpretq_u64_u8(vs);
+          if ((vgetq_lane_u64(vs64, 0) | vgetq_lane_u64(vs64, 1)) != 0)
+            break;
+          uint64x2_t vcnt = vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(vshrq_n_u8(vcltq_s8(vreinterpretq_s8_u8(v), vc), 7))));
+          k += 16 - vgetq_lane_u64(vcnt, 0) - vgetq_lane_u64(vcnt, 1);
+          s += 16;
+        }
+      }
+#endif
+      // count the next block one byte at a time
+      const char *t = e - s > 32 ? s + 32 : e;
+      while (s < t)
+      {
+        if (*s == '\t' && tabs)
+          k += 1 + (~k & (opt_.T - 1)); // count tab spacing
+        else if ((*s != '\r' && *s != '\n') || !crlf)
+          k += ((*s & 0xC0) != 0x80); // count column offset in UTF-8 chars
+        ++s;
+      }
+    }
+    return k;
+  }
   /// Shift or expand the internal buffer when it is too small to accommodate more input, where the buffer size is doubled when needed, change cur_, pos_, end_, max_, ind_, buf_, bol_, lpb_, and txt_.
   inline bool grow(size_t need = Const::BLOCK) ///< optional needed space = Const::BLOCK size by default
     /// @returns true if buffer was shifted or enlarged
   {
-    if (max_ - end_ >= need + 1)
+    ovf_ = false;
+    if (seg_)
+      return stitch();
+    if (max_ - end_ - tal_ >= need + 1)
       return false;
+#if defined(WITH_STATS)
+    ++sts_.grows;
+#endif
+    size_t max = max_;
+    end_ += tal_; // the partial line read ahead with line_buffered() is moved along with the buffered input
 #if defined(WITH_SPAN)
     (void)lineno();
+    if (cpb_ > bol_ && cpb_ < txt_)
+    {
+      // columns are counted on this line, keep counting from the match so the column remains valid when bol_ moves
+      cno_ = count_columns(cpb_, txt_, cno_);
+      cpb_ = txt_;
+    }
     if (bol_ + Const::BLOCK < txt_ && evh_ == NULL)
     {
       // this line is very long, likely a binary file, so shift a block size away from the match instead
       DBGLOG("Line in buffer to long to shift, moving bol position to text match position minus %zu", Const::BLOCK);
       bol_ = txt_ - Const::BLOCK;
     }
+    if (lim_ > 0 && (pol_ == Const::DISCARD || end_ - (bol_ - buf_) + need >= lim_))
+    {
+      // the buffer is limited in size, so discard the line before the match
+      DBGLOG("Buffer limit, moving bol position to text match position");
+      bol_ = txt_;
+    }
+    if (cpb_ < bol_ || cpb_ > txt_)
+    {
+      cpb_ = bol_;
+      cno_ = 0;
+    }
     size_t gap = bol_ - buf_;
     if (gap > 0 && evh_ != NULL)
       (*evh_)(*this, buf_, gap, num_);
@@ -1394,39 +1763,55 @@ class AbstractMatcher {
     txt_ -= gap;
     bol_ -= gap;
     lpb_ -= gap;
+    cpb_ -= gap;
     num_ += gap;
-    std::memmove(buf_, buf_ + gap, end_);
+    char *rotbuf = gap > 0 ? alc_->rotate(buf_, max_, gap) : NULL;
+    if (rotbuf != NULL)
+    {
+      // the buffer is a ring, the data was not moved
+      txt_ = rotbuf + (txt_ - buf_);
+      bol_ = rotbuf + (bol_ - buf_);
+      lpb_ = rotbuf + (lpb_ - buf_);
+      cpb_ = rotbuf + (cpb_ - buf_);
+      buf_ = rotbuf;
+    }
+    else
+    {
+      std::memmove(buf_, buf_ + gap, end_);
+#if defined(WITH_STATS)
+      sts_.moved += end_;
+#endif
+    }
     if (max_ - end_ >= need)
     {
       DBGLOG("Shift buffer to close gap of %zu bytes", gap);
     }
+    else if (!expand(end_ + need))
+    {
+      DBGLOG("Buffer limit of %zu bytes reached", lim_);
+      if (max_ - end_ <= 1)
+      {
+        ovf_ = true;
+        if (pol_ == Const::SIGNAL && evh_ != NULL)
+          (*evh_)(*this, txt_, end_ - (txt_ - buf_), num_ + (txt_ - buf_));
+      }
+    }
     else
     {
-      size_t newmax = end_ + need;
-      while (max_ < newmax)
-        max_ *= 2;
       DBGLOG("Expand buffer to %zu bytes", max_);
-#if defined(WITH_REALLOC)
-#if (defined(__WIN32__) || defined(_WIN32) || defined(WIN32) || defined(_WIN64) || defined(__BORLANDC__)) && !defined(__CYGWIN__) && !defined(__MINGW32__) && !defined(__MINGW64__)
-      char *newbuf = static_cast<char*>(_aligned_realloc(static_cast<void*>(buf_), max_, 4096));
-#else
-      char *newbuf = static_cast<char*>(std::realloc(static_cast<void*>(buf_), max_));
-#endif
-      if (newbuf == NULL)
-        throw std::bad_alloc();
-#else
-      char *newbuf = new char[max_];
-      std::memcpy(newbuf, buf_, end_);
-      delete[] buf_;
+#if defined(WITH_STATS)
+      ++sts_.expands;
 #endif
+      char *newbuf = alc_->reallocate(buf_, max, max_, end_);
       txt_ = newbuf + (txt_ - buf_);
       lpb_ = newbuf + (lpb_ - buf_);
+      cpb_ = newbuf + (cpb_ - buf_);
       buf_ = newbuf;
     }
     bol_ = buf_;
 #else
     size_t gap = txt_ - buf_;
-    if (max_ - end_ + gap >= need)
+    if (max_ - end_ + gap >= need || !expand(end_ - gap + need))
     {
       DBGLOG("Shift buffer to close gap of %zu bytes", gap);
       (void)lineno();
@@ -1435,53 +1820,189 @@ class AbstractMatcher {
       pos_ -= gap;
       end_ -= gap;
       num_ += gap;
-      if (end_ > 0)
+      char *rotbuf = gap > 0 ? alc_->rotate(buf_, max_, gap) : NULL;
+      if (rotbuf != NULL)
+      {
+        buf_ = rotbuf;
+      }
+      else if (end_ > 0)
+      {
         std::memmove(buf_, txt_, end_);
+#if defined(WITH_STATS)
+        sts_.moved += end_;
+#endif
+      }
       txt_ = buf_;
       lpb_ = buf_;
+      if (max_ - end_ <= 1)
+      {
+        DBGLOG("Buffer limit of %zu bytes reached", lim_);
+        ovf_ = true;
+      }
     }
     else
     {
-      size_t newmax = end_ - gap + need;
-      size_t oldmax = max_;
-      while (max_ < newmax)
-        max_ *= 2;
-      if (oldmax < max_)
-      {
-        DBGLOG("Expand buffer from %zu to %zu bytes", oldmax, max_);
-        (void)lineno();
-        cur_ -= gap;
-        ind_ -= gap;
-        pos_ -= gap;
-        end_ -= gap;
-        num_ += gap;
-#if defined(WITH_REALLOC)
-        std::memmove(buf_, txt_, end_);
-#if (defined(__WIN32__) || defined(_WIN32) || defined(WIN32) || defined(_WIN64) || defined(__BORLANDC__)) && !defined(__CYGWIN__) && !defined(__MINGW32__) && !defined(__MINGW64__)
-        char *newbuf = static_cast<char*>(_aligned_realloc(static_cast<void*>(buf_), max_, 4096));
-#else
-        char *newbuf = static_cast<char*>(std::realloc(static_cast<void*>(buf_), max_));
+      DBGLOG("Expand buffer to %zu bytes", max_);
+      (void)lineno();
+      cur_ -= gap;
+      ind_ -= gap;
+      pos_ -= gap;
+      end_ -= gap;
+      num_ += gap;
+      std::memmove(buf_, txt_, end_);
+#if defined(WITH_STATS)
+      ++sts_.expands;
+      sts_.moved += end_;
 #endif
-        if (newbuf == NULL)
-          throw std::bad_alloc();
-#else
-        char *newbuf = new char[max_];
-        std::memcpy(newbuf, txt_, end_);
-        delete[] buf_;
+      char *newbuf = alc_->reallocate(buf_, max, max_, end_);
+      buf_ = newbuf;
+      txt_ = buf_;
+      lpb_ = buf_;
+    }
+#endif
+    end_ -= tal_;
+    return true;
+  }
+  /// Called by grow() to continue scanning segmented input in place with the next segment when the rest of the current segment was added to the buffered input by fill(), only the match (and the bytes after it) are kept and copied to a small stitch buffer with the start of the next segment when the match straddles the segment boundary, change cur_, pos_, end_, max_, ind_, buf_, bol_, lpb_, and txt_.
+  inline bool stitch()
+    /// @returns true if the buffer was moved to the next segment or to the stitch buffer
+  {
+    if (end_ + 1 < max_)
+      return false;
+    const size_t STITCH = 256; // the minimum number of bytes of the next segment to stitch to the kept bytes
+#if defined(WITH_STATS)
+    ++sts_.grows;
+#endif
+    (void)lineno();
+#if defined(WITH_SPAN)
+    // the line before the match cannot be kept, because it is not contiguous with the next segment
+    (void)columno();
+    bol_ = txt_;
 #endif
-        buf_ = newbuf;
-        txt_ = buf_;
-        lpb_ = buf_;
+    size_t gap = txt_ - buf_;
+    size_t keep = end_ - gap;
+#if defined(WITH_SPAN)
+    if (gap > 0 && evh_ != NULL)
+      (*evh_)(*this, buf_, gap, num_);
+#endif
+    cur_ -= gap;
+    ind_ -= gap;
+    pos_ -= gap;
+    num_ += gap;
+    if (stb_.empty() || buf_ != &stb_[0])
+      in.skip_segment(); // the rest of the segment was scanned in place
+    size_t size;
+    const char *base = in.segment(keep, size);
+    if (base != NULL)
+    {
+      buf_ = const_cast<char*>(base);
+    }
+    else
+    {
+      size_t more = keep < STITCH ? STITCH : keep;
+      if (!stb_.empty() && buf_ == &stb_[0])
+      {
+        std::memmove(buf_, txt_, keep);
+        stb_.resize(keep + more + 1);
+      }
+      else
+      {
+        stb_.resize(keep + more + 1);
+        std::memcpy(&stb_[0], txt_, keep);
       }
+#if defined(WITH_STATS)
+      sts_.moved += keep;
+#endif
+      buf_ = &stb_[0];
+      size = keep + in.get(buf_ + keep, more);
+      buf_[size] = '\0';
     }
+    end_ = keep;
+    max_ = size + 1;
+    txt_ = buf_;
+    lpb_ = buf_;
+#if defined(WITH_SPAN)
+    bol_ = buf_;
+    cpb_ = buf_;
 #endif
     return true;
   }
+  /// Increase the buffer size max_ by doubling it to hold the needed number of bytes, but not beyond the buffer size limit set with set_limit().
+  inline bool expand(size_t need) ///< needed buffer size
+    /// @returns true if max_ was increased
+  {
+    size_t oldmax = max_;
+    while (max_ < need)
+      max_ *= 2;
+    if (lim_ > 0 && max_ > lim_)
+      max_ = lim_ > oldmax ? lim_ : oldmax;
+    return max_ > oldmax;
+  }
+  /// Returns the number of bytes to read into the free part of the buffer, at most the block size when set with buffer(blk).
+  inline size_t room() const
+    /// @returns number of bytes to read
+  {
+    size_t n = max_ - end_ - tal_ - 1;
+    return blk_ > 0 && blk_ < n ? blk_ : n;
+  }
+  /// Read more input into the free part of the buffer, when line_buffered() read up to and including the last newline and keep the partial line after it for the next read.
+  inline size_t fill()
+    /// @returns the number of bytes added to the buffered input, or zero when EOF
+  {
+    if (seg_)
+    {
+      // add the rest of the segment scanned in place, or of the stitch buffer, to the buffered input
+      size_t n = max_ - end_ - 1;
+#if defined(WITH_STATS)
+      ++sts_.fills;
+      sts_.bytes += n;
+#endif
+      return n;
+    }
+    if (!lnb_)
+    {
+      size_t n = get(buf_ + end_, room());
+#if defined(WITH_STATS)
+      ++sts_.fills;
+      sts_.bytes += n;
+#endif
+      return n;
+    }
+    while (true)
+    {
+      char *s = buf_ + end_ + tal_;
+      size_t n = get(s, room());
+#if defined(WITH_STATS)
+      ++sts_.fills;
+      sts_.bytes += n;
+#endif
+      if (n == 0)
+      {
+        // EOF or the buffer is full: release the partial line
+        n = tal_;
+        tal_ = 0;
+        return n;
+      }
+      tal_ += n;
+      char *t = s + n;
+      while (t > s && t[-1] != '\n')
+        --t;
+      if (t > s)
+      {
+        n = t - (buf_ + end_);
+        tal_ -= n;
+        return n;
+      }
+    }
+  }
   /// Returns the next character read from the current input source.
   inline int get()
     /// @returns the character read (unsigned char 0..255) or EOF (-1)
   {
     DBGLOG("AbstractMatcher::get()");
+#if defined(WITH_STATS)
+    ++sts_.gets;
+#endif
 #if defined(WITH_FAST_GET)
     return pos_ < end_ ? static_cast<unsigned char>(buf_[pos_++]) : get_more();
 #else
@@ -1491,11 +2012,13 @@ class AbstractMatcher {
       return EOF;
     while (true)
     {
-      if (end_ + blk_ + 1 >= max_)
+      if (end_ + tal_ + blk_ + 1 >= max_)
         (void)grow();
-      end_ += get(buf_ + end_, blk_ > 0 ? blk_ : max_ - end_ - 1);
+      end_ += fill();
       if (pos_ < end_)
         return static_cast<unsigned char>(buf_[pos_++]);
+      if (ovf_)
+        return EOF; // the buffer is full at its size limit set with set_limit(), but this is not the end of the input
       DBGLOGN("get(): EOF");
       if (!wrap())
       {
@@ -1540,11 +2063,13 @@ class AbstractMatcher {
       return EOF;
     while (true)
     {
-      if (end_ + blk_ + 1 >= max_)
+      if (end_ + tal_ + blk_ + 1 >= max_)
         (void)grow();
-      end_ += get(buf_ + end_, blk_ > 0 ? blk_ : max_ - end_ - 1);
+      end_ += fill();
       if (pos_ < end_)
         return static_cast<unsigned char>(buf_[pos_++]);
+      if (ovf_)
+        return EOF; // the buffer is full at its size limit set with set_limit(), but this is not the end of the input
       DBGLOGN("get_more(): EOF");
       if (!wrap())
       {
@@ -1558,15 +2083,20 @@ class AbstractMatcher {
     /// @returns the character (unsigned char 0..255) or EOF (-1)
   {
     DBGLOG("AbstractMatcher::peek_more()");
+#if defined(WITH_STATS)
+    ++sts_.peeks;
+#endif
     if (eof_)
       return EOF;
     while (true)
     {
-      if (end_ + blk_ + 1 >= max_)
+      if (end_ + tal_ + blk_ + 1 >= max_)
         (void)grow();
-      end_ += get(buf_ + end_, blk_ > 0 ? blk_ : max_ - end_ - 1);
+      end_ += fill();
       if (pos_ < end_)
         return static_cast<unsigned char>(buf_[pos_]);
+      if (ovf_)
+        return EOF; // the buffer is full at its size limit set with set_limit(), but this is not the end of the input
       DBGLOGN("peek_more(): EOF");
       if (!wrap())
       {
@@ -1586,6 +2116,7 @@ class AbstractMatcher {
   size_t    max_; ///< total buffer size and max position + 1 to fill
   size_t    ind_; ///< current indent position
   size_t    blk_; ///< block size for block-based input reading, as set by AbstractMatcher::buffer
+  size_t    tal_; ///< number of bytes of a partial line read ahead and stored after AbstractMatcher::end_, see AbstractMatcher::line_buffered
   int       got_; ///< last unsigned character we looked at (to determine anchors and boundaries)
   int       chr_; ///< the character located at AbstractMatcher::txt_[AbstractMatcher::len_]
 #if defined(WITH_SPAN)
@@ -1594,13 +2125,25 @@ class AbstractMatcher {
 #endif
   char     *lpb_; ///< line pointer in buffer, updated when counting line numbers with lineno()
   size_t    lno_; ///< line number count (cached)
-#if !defined(WITH_SPAN)
-  size_t    cno_; ///< column number count (cached)
+#if defined(WITH_SPAN)
+  char     *cpb_; ///< column pointer in buffer, updated when counting column numbers with columno()
 #endif
+  size_t    cno_; ///< column number count (cached)
   size_t    num_; ///< character count of the input till bol_
   bool      own_; ///< true if AbstractMatcher::buf_ was allocated and should be deleted
   bool      eof_; ///< input has reached EOF
   bool      mat_; ///< true if AbstractMatcher::matches() was successful
+  bool      ovf_; ///< true if the buffer is full at its size limit
+  bool      lnb_; ///< true if input is line buffered, as set by AbstractMatcher::line_buffered
+  bool      seg_; ///< true if segmented input is scanned in place with option R, AbstractMatcher::buf_ points into a segment or to AbstractMatcher::stb_
+  size_t    lim_; ///< buffer size limit set with set_limit(), or 0 when unlimited
+  int       pol_; ///< policy to apply when the buffer size limit is reached, Const::TRUNCATE, Const::DISCARD, or Const::SIGNAL
+#if defined(WITH_STATS)
+  Stats     sts_; ///< statistics counters, see AbstractMatcher::stats()
+#endif
+  Allocator *alc_; ///< allocator of AbstractMatcher::buf_ when AbstractMatcher::own_ is true
+  std::string cpy_; ///< copy of the text matched returned by text() with option R
+  std::vector<char> stb_; ///< stitch buffer with the bytes of a match straddling two segments of segmented input, see AbstractMatcher::stitch()
 };
 
 /// The pattern matcher class template extends abstract matcher base class.
@@ -1718,7 +2261,7 @@ class PatternMatcher : public AbstractMatcher {
   PatternMatcher(
       const Pattern *pattern = NULL,  ///< points to pattern object for this matcher
       const Input&   input = Input(), ///< input character sequence for this matcher
-      const char    *opt = NULL)      ///< option string of the form `(A|N|T(=[[:digit:]])?|;)*`
+      const char    *opt = NULL)      ///< option string of the form `(A|N|R|T(=[[:digit:]])?|;)*`
     :
       AbstractMatcher(input, opt),
       pat_(pattern),
@@ -1728,7 +2271,7 @@ class PatternMatcher : public AbstractMatcher {
   PatternMatcher(
       const Pattern& pattern,         ///< pattern object for this matcher
       const Input&   input = Input(), ///< input character sequence for this matcher
-      const char    *opt = NULL)      ///< option string of the form `(A|N|T(=[[:digit:]])?|;)*`
+      const char    *opt = NULL)      ///< option string of the form `(A|N|R|T(=[[:digit:]])?|;)*`
     :
       AbstractMatcher(input, opt),
       pat_(&pattern),
@@ -1738,7 +2281,7 @@ class PatternMatcher : public AbstractMatcher {
   PatternMatcher(
       const char  *pattern,         ///< regex string instantiates pattern object for this matcher
       const Input& input = Input(), ///< input character sequence for this matcher
-      const char  *opt = NULL)      ///< option string of the form `(A|N|T(=[[:digit:]])?|;)*`
+      const char  *opt = NULL)      ///< option string of the form `(A|N|R|T(=[[:digit:]])?|;)*`
     :
       AbstractMatcher(input, opt),
       pat_(new Pattern(pattern)),
@@ -1748,7 +2291,7 @@ class PatternMatcher : public AbstractMatcher {
   PatternMatcher(
       const std::string& pattern,         ///< regex string instantiates pattern object for this matcher
       const Input&       input = Input(), ///< input character sequence for this matcher
-      const char        *opt = NULL)      ///< option string of the form `(A|N|T(=[[:digit:]])?|;)*`
+      const char        *opt = NULL)      ///< option string of the form `(A|N|R|T(=[[:digit:]])?|;)*`
     :
       AbstractMatcher(input, opt),
       pat_(new Pattern(pattern)),
@@ -1857,7 +2400,7 @@ class PatternMatcher<std::string> : public AbstractMatcher {
   PatternMatcher(
       const Pattern *pattern = NULL,  ///< points to pattern string for this matcher
       const Input&   input = Input(), ///< input character sequence for this matcher
-      const char    *opt = NULL)      ///< option string of the form `(A|N|T(=[[:digit:]])?|;)*`
+      const char    *opt = NULL)      ///< option string of the form `(A|N|R|T(=[[:digit:]])?|;)*`
     :
       AbstractMatcher(input, opt),
       pat_(pattern),
@@ -1867,7 +2410,7 @@ class PatternMatcher<std::string> : public AbstractMatcher {
   PatternMatcher(
       const char  *pattern,         ///< regex string instantiates pattern string for this matcher
       const Input& input = Input(), ///< input character sequence for this matcher
-      const char  *opt = NULL)      ///< option string of the form `(A|N|T(=[[:digit:]])?|;)*`
+      const char  *opt = NULL)      ///< option string of the form `(A|N|R|T(=[[:digit:]])?|;)*`
     :
       AbstractMatcher(input, opt),
       pat_(new Pattern(pattern)),
@@ -1877,7 +2420,7 @@ class PatternMatcher<std::string> : public AbstractMatcher {
   PatternMatcher(
       const std::string& pattern,         ///< regex string instantiates pattern string for this matcher
       const Input&       input = Input(), ///< input character sequence for this matcher
-      const char        *opt = NULL)      ///< option string of the form `(A|N|T(=[[:digit:]])?|;)*`
+      const char        *opt = NULL)      ///< option string of the form `(A|N|R|T(=[[:digit:]])?|;)*`
     :
       AbstractMatcher(input, opt),
       pat_(new Pattern(pattern)),
@@ -1887,6 +2430,98 @@ class PatternMatcher<std::string> : public AbstractMatcher {
   bool           own_; ///< true if PatternMatcher::pat_ was allocated and should be deleted
 };
 
+#if defined(WITH_MATCHER_POOL)
+
+/// A pool of matchers bound to a shared pattern, to reuse idle matchers and their buffers in any thread without locking.
+/**
+A pattern is immutable once constructed and is safely shared by matchers that
+run concurrently, except when the pattern is constructed with the lazy DFA
+option `l`.  Acquire a matcher with `acquire(input)` and give it back with
+`release(matcher)`:
+
+```cpp
+static reflex::Pattern pattern("\\w+");
+static reflex::MatcherPool<reflex::Matcher> pool(pattern);
+
+void serve(const std::string& request)
+{
+  reflex::Matcher *matcher = pool.acquire(request);
+  while (matcher->find())
+    ...;
+  pool.release(matcher);
+}
+```
+
+Idle matchers are kept in a fixed number of slots that are atomically taken
+and filled, so acquiring and releasing a matcher never blocks.  A new matcher
+is constructed when all slots are empty and a released matcher is deleted when
+all slots are full.
+*/
+template<typename M> /// @tparam <M> matcher class derived from reflex::PatternMatcher
+class MatcherPool {
+ public:
+  /// Construct a pool of up to `size` idle matchers for the given pattern, the pattern must outlive the pool.
+  explicit MatcherPool(
+      const typename M::Pattern& pattern,   ///< the pattern shared by the matchers of this pool
+      size_t                     size = 16, ///< the max number of idle matchers kept
+      const char                *opt = NULL) ///< option string of the form `(A|N|R|T(=[[:digit:]])?|;)*`
+    :
+      pat_(&pattern),
+      opt_(opt != NULL ? opt : ""),
+      max_(size > 0 ? size : 1),
+      idl_(new std::atomic<M*>[max_])
+  {
+    for (size_t i = 0; i < max_; ++i)
+      idl_[i].store(NULL, std::memory_order_relaxed);
+  }
+  /// Delete the pool and its idle matchers, all matchers acquired should be released before.
+  ~MatcherPool()
+  {
+    for (size_t i = 0; i < max_; ++i)
+      delete idl_[i].load(std::memory_order_acquire);
+    delete[] idl_;
+  }
+  /// Returns a matcher that is reset to match the given input, reusing an idle matcher and its buffer when available.
+  M *acquire(const Input& input = Input()) ///< input character sequence to match
+    /// @returns pointer to matcher, give it back with release()
+  {
+    for (size_t i = 0; i < max_; ++i)
+    {
+      M *matcher = idl_[i].exchange(NULL, std::memory_order_acquire);
+      if (matcher != NULL)
+      {
+        matcher->pattern(*pat_);
+        matcher->input(input);
+        return matcher;
+      }
+    }
+    return new M(*pat_, input, opt_.empty() ? NULL : opt_.c_str());
+  }
+  /// Give back a matcher acquired from this pool, it is kept for reuse unless the pool is full.
+  void release(M *matcher) ///< matcher to release
+  {
+    if (matcher == NULL)
+      return;
+    for (size_t i = 0; i < max_; ++i)
+    {
+      M *idle = NULL;
+      if (idl_[i].compare_exchange_strong(idle, matcher, std::memory_order_release, std::memory_order_relaxed))
+        return;
+    }
+    delete matcher;
+  }
+ protected:
+  const typename M::Pattern *pat_; ///< the pattern shared by the matchers
+  std::string                opt_; ///< the matcher options
+  size_t                     max_; ///< the number of slots for idle matchers
+  std::atomic<M*>           *idl_; ///< the slots of idle matchers, NULL when empty
+ private:
+  MatcherPool(const MatcherPool&); ///< not copyable
+  MatcherPool& operator=(const MatcherPool&); ///< not assignable
+};
+
+#endif
+
 } // namespace reflex
 
 /// Write matched text to a stream.
@@ -39,6 +39,10 @@
 
 #include <cstring>
 
+#if defined(_MSC_VER) && defined(_WIN64)
+# include <intrin.h>
+#endif
+
 #if defined(__WIN32__) || defined(_WIN32) || defined(WIN32) || defined(_WIN64) || defined(__BORLANDC__)
 namespace reflex {
 typedef unsigned __int8  uint8_t;
@@ -155,6 +159,9 @@ class Bits {
   { }
   /// Copy constructor
   Bits(const Bits& bits) ///< bits to copy
+    :
+      len_(0),
+      vec_(NULL)
   {
     operator=(bits);
   }
@@ -186,11 +193,16 @@ class Bits {
   Bits& operator=(const Bits& bits) ///< bits to copy
     /// @returns reference to this object.
   {
-    len_ = bits.len_;
-    if (len_)
-      std::memcpy(vec_ = new uint64_t[len_], bits.vec_, len_ << 3);
-    else
-      vec_ = NULL;
+    if (this != &bits)
+    {
+      if (vec_)
+        delete[] vec_;
+      len_ = bits.len_;
+      if (len_)
+        std::memcpy(vec_ = new uint64_t[len_], bits.vec_, len_ << 3);
+      else
+        vec_ = NULL;
+    }
     return *this;
   }
   /// Reference n'th bit in the bit vector to assign a value to that bit.
@@ -237,9 +249,22 @@ class Bits {
       size_t n2) ///< last bit to set
     /// @returns reference to this object.
   {
-    alloc((n2 >> 6) + 1);
-    for (size_t i = n1; i <= n2; ++i)
-      vec_[i >> 6] |= 1ULL << (i & 0x3F);
+    if (n1 <= n2)
+    {
+      alloc((n2 >> 6) + 1);
+      size_t i = n1 >> 6, k = n2 >> 6;
+      if (i == k)
+      {
+        vec_[i] |= mask(n1, n2);
+      }
+      else
+      {
+        vec_[i] |= mask(n1, 63);
+        while (++i < k)
+          vec_[i] = ~0ULL;
+        vec_[k] |= mask(0, n2);
+      }
+    }
     return *this;
   }
   /// Erase a range of bits in the bit vector.
@@ -248,12 +273,22 @@ class Bits {
       size_t n2) ///< last bit to erase
     /// @returns reference to this object.
   {
-    if (n1 >> 6 < len_)
+    if (n1 <= n2 && n1 >> 6 < len_)
     {
       if (n2 >> 6 >= len_)
-        n2 = (len_ - 1) << 6;
-      for (size_t i = n1; i <= n2; ++i)
-        vec_[i >> 6] &= ~(1ULL << (i & 0x3F));
+        n2 = (len_ << 6) - 1;
+      size_t i = n1 >> 6, k = n2 >> 6;
+      if (i == k)
+      {
+        vec_[i] &= ~mask(n1, n2);
+      }
+      else
+      {
+        vec_[i] &= ~mask(n1, 63);
+        while (++i < k)
+          vec_[i] = 0;
+        vec_[k] &= ~mask(0, n2);
+      }
     }
     return *this;
   }
@@ -263,9 +298,22 @@ class Bits {
       size_t n2) ///< last bit to flip
     /// @returns reference to this object.
   {
-    alloc((n2 >> 6) + 1);
-    for (size_t i = n1; i <= n2; ++i)
-      vec_[i >> 6] ^= 1ULL << (i & 0x3F);
+    if (n1 <= n2)
+    {
+      alloc((n2 >> 6) + 1);
+      size_t i = n1 >> 6, k = n2 >> 6;
+      if (i == k)
+      {
+        vec_[i] ^= mask(n1, n2);
+      }
+      else
+      {
+        vec_[i] ^= mask(n1, 63);
+        while (++i < k)
+          vec_[i] = ~vec_[i];
+        vec_[k] ^= mask(0, n2);
+      }
+    }
     return *this;
   }
   /// Bit-shift left by one.
@@ -337,7 +385,7 @@ class Bits {
     if (bits.len_ < k)
       k = bits.len_;
     for (size_t i = 0; i < k; ++i)
-      vec_[i] = (vec_[i] | bits.vec_[i]) - bits.vec_[i];
+      vec_[i] &= ~bits.vec_[i];
     return *this;
   }
   /// Bit-or (set union) of two bit vectors.
@@ -496,9 +544,9 @@ class Bits {
   size_t count() const
     /// @returns number of 1 bits.
   {
-    size_t n = 0, k = 0;
-    while ((n = find_first(n)) != npos)
-      ++n, ++k;
+    size_t k = 0;
+    for (size_t i = 0; i < len_; ++i)
+      k += popcount(vec_[i]);
     return k;
   }
   /// Returns true if the bit vector intersects with the given bits, false if the bit vectors are disjoint.
@@ -536,16 +584,16 @@ class Bits {
     const
   {
     size_t i = n >> 6;
-    if (i < len_ && vec_[i])
-      for (size_t j = n & 0x3F; j < 64; ++j)
-        if (vec_[i] & 1ULL << j)
-          return (i << 6) + j;
-    for (i = i + 1; i < len_; ++i)
-      if (vec_[i])
-        for (size_t j = 0; j < 64; ++j)
-          if (vec_[i] & 1ULL << j)
-            return (i << 6) + j;
-    return npos;
+    if (i >= len_)
+      return npos;
+    uint64_t w = vec_[i] & (~0ULL << (n & 0x3F));
+    while (w == 0)
+    {
+      if (++i >= len_)
+        return npos;
+      w = vec_[i];
+    }
+    return (i << 6) + ctz(w);
   }
   /// Returns the next position of a bit set in the bit vector, or Bits::npos if none.
   size_t find_next(size_t n) ///< the current position to search from
@@ -564,6 +612,77 @@ class Bits {
     bits.len_ = k;
     bits.vec_ = p;
   }
+  /// Returns the number of trailing zero bits of a nonzero word.
+  static inline uint32_t ctz(uint64_t x) ///< nonzero word
+    /// @returns number of trailing zero bits.
+  {
+#if defined(__GNUC__)
+    return __builtin_ctzll(x);
+#elif defined(_MSC_VER) && defined(_WIN64)
+    unsigned long r;
+    _BitScanForward64(&r, x);
+    return r;
+#else
+    uint32_t n = 0;
+    if ((x & 0xFFFFFFFFULL) == 0)
+    {
+      n += 32;
+      x >>= 32;
+    }
+    while ((x & 1) == 0)
+    {
+      ++n;
+      x >>= 1;
+    }
+    return n;
+#endif
+  }
+  /// Returns the number of leading zero bits of a nonzero word.
+  static inline uint32_t clz(uint64_t x) ///< nonzero word
+    /// @returns number of leading zero bits.
+  {
+#if defined(__GNUC__)
+    return __builtin_clzll(x);
+#elif defined(_MSC_VER) && defined(_WIN64)
+    unsigned long r;
+    _BitScanReverse64(&r, x);
+    return 63 - r;
+#else
+    uint32_t n = 0;
+    if ((x >> 32) == 0)
+    {
+      n += 32;
+      x <<= 32;
+    }
+    while ((x >> 63) == 0)
+    {
+      ++n;
+      x <<= 1;
+    }
+    return n;
+#endif
+  }
+  /// Returns the number of bits set in a word.
+  static inline uint32_t popcount(uint64_t x) ///< word
+    /// @returns number of 1 bits.
+  {
+#if defined(__GNUC__)
+    return __builtin_popcountll(x);
+#else
+    x -= (x >> 1) & 0x5555555555555555ULL;
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<uint32_t>((x * 0x0101010101010101ULL) >> 56);
+#endif
+  }
+  /// Returns the word mask with bits n1 to n2 set, taken modulo 64.
+  static inline uint64_t mask(
+      size_t n1, ///< first bit
+      size_t n2) ///< last bit, n1 <= n2 modulo 64
+    /// @returns mask.
+  {
+    return (~0ULL << (n1 & 0x3F)) & (~0ULL >> (63 - (n2 & 0x3F)));
+  }
  private:
   /// On-demand allocator.
   void alloc(size_t len) ///< number of words required
@@ -38,6 +38,7 @@
 #define REFLEX_BOOSTMATCHER_H
 
 #include <reflex/absmatcher.h>
+#include <reflex/matcher.h>
 #include <boost/regex.hpp>
 
 namespace reflex {
@@ -55,7 +56,9 @@ class BoostMatcher : public PatternMatcher<boost::regex> {
   BoostMatcher()
     :
       PatternMatcher<boost::regex>(),
-      flg_(boost::regex_constants::match_partial | boost::regex_constants::match_not_dot_newline)
+      flg_(boost::regex_constants::match_partial | boost::regex_constants::match_not_dot_newline),
+      prp_(NULL),
+      prm_(NULL)
   {
     reset();
   }
@@ -64,10 +67,12 @@ class BoostMatcher : public PatternMatcher<boost::regex> {
   BoostMatcher(
       const P     *pattern,         ///< points to a boost::regex or a string regex for this matcher
       const Input& input = Input(), ///< input character sequence for this matcher
-      const char  *opt = NULL)      ///< option string of the form `(A|N|T(=[[:digit:]])?|;)*`
+      const char  *opt = NULL)      ///< option string of the form `(A|N|R|T(=[[:digit:]])?|;)*`
     :
       PatternMatcher(pattern, input, opt),
-      flg_(boost::regex_constants::match_partial | boost::regex_constants::match_not_dot_newline)
+      flg_(boost::regex_constants::match_partial | boost::regex_constants::match_not_dot_newline),
+      prp_(NULL),
+      prm_(NULL)
   {
     reset();
   }
@@ -76,10 +81,12 @@ class BoostMatcher : public PatternMatcher<boost::regex> {
   BoostMatcher(
       const P&     pattern,         ///< a boost::regex or a string regex for this matcher
       const Input& input = Input(), ///< input character sequence for this matcher
-      const char  *opt = NULL)      ///< option string of the form `(A|N|T(=[[:digit:]])?|;)*`
+      const char  *opt = NULL)      ///< option string of the form `(A|N|R|T(=[[:digit:]])?|;)*`
     :
       PatternMatcher(pattern, input, opt),
-      flg_(boost::regex_constants::match_partial | boost::regex_constants::match_not_dot_newline)
+      flg_(boost::regex_constants::match_partial | boost::regex_constants::match_not_dot_newline),
+      prp_(NULL),
+      prm_(NULL)
   {
     reset();
   }
@@ -87,13 +94,23 @@ class BoostMatcher : public PatternMatcher<boost::regex> {
   BoostMatcher(const BoostMatcher& matcher) ///< matcher to copy
     :
       PatternMatcher<boost::regex>(matcher),
-      flg_(matcher.flg_)
-  { }
+      flg_(matcher.flg_),
+      prp_(NULL),
+      prm_(NULL)
+  {
+    copy_prefilter(&matcher);
+  }
+  /// Delete matcher.
+  virtual ~BoostMatcher()
+  {
+    copy_prefilter(NULL);
+  }
   /// Assign a matcher.
   BoostMatcher& operator=(const BoostMatcher& matcher) ///< matcher to copy
   {
     PatternMatcher<boost::regex>::operator=(matcher);
     flg_ = matcher.flg_;
+    copy_prefilter(&matcher);
     return *this;
   }
   /// Polymorphic cloning.
@@ -108,6 +125,34 @@ class BoostMatcher : public PatternMatcher<boost::regex> {
     itr_ = fin_ = boost::cregex_iterator();
     grp_ = 0;
     PatternMatcher::reset(opt);
+    if (prm_ != NULL)
+      buffer(); // the prefilter predicts matches in the buffered input
+  }
+  /// Set a RE/flex regex to skip ahead with find() to possible matches predicted by the RE/flex pattern prefilter, the regex should match at least the strings matched by the boost::regex, or NULL to remove the prefilter, the prefilter buffers all input.
+  bool prefilter(const char *regex) ///< RE/flex regex or NULL
+    /// @returns true if the prefilter is used, false when the regex is NULL or not supported by RE/flex
+  {
+    itr_ = fin_;
+    copy_prefilter(NULL);
+    if (regex == NULL)
+      return false;
+    try
+    {
+      prp_ = new reflex::Pattern(reflex::Matcher::convert(regex, convert_flag::none), "r"); // throws on backreferences and other unsupported regex syntax
+    }
+    catch (const regex_error&)
+    {
+      return false;
+    }
+    prm_ = new reflex::Matcher(*prp_, Input(), "R");
+    buffer();
+    return true;
+  }
+  /// Set a RE/flex regex to skip ahead with find() to possible matches predicted by the RE/flex pattern prefilter, the regex should match at least the strings matched by the boost::regex, the prefilter buffers all input.
+  bool prefilter(const std::string& regex) ///< RE/flex regex
+    /// @returns true if the prefilter is used, false when the regex is not supported by RE/flex
+  {
+    return prefilter(regex.c_str());
   }
   using PatternMatcher::pattern;
   /// Set the pattern to use with this matcher as a shared pointer to another matcher pattern.
@@ -193,7 +238,7 @@ class BoostMatcher : public PatternMatcher<boost::regex> {
     cur_ = pos_;
     if (itr_ != fin_) // if regex iterator is still valid then
     {
-      if ((*itr_)[0].second == buf_ + pos_) // if last of regex iterator is still valid in buf_[] then
+      if ((*itr_)[0].second == buf_ + pos_ && !prefiltered(method)) // if last of regex iterator is still valid in buf_[] and not prefiltered then
       {
         DBGLOGN("Continue iterating, pos = %zu", pos_);
         ++itr_;
@@ -209,7 +254,7 @@ class BoostMatcher : public PatternMatcher<boost::regex> {
     {
       if (pos_ == end_ && !eof_)
       {
-        if (end_ + blk_ + 1 >= max_ && grow()) // make sure we have enough storage to read input
+        if (end_ + tal_ + blk_ + 1 >= max_ && grow()) // make sure we have enough storage to read input
           itr_ = fin_; // buffer shifting/growing invalidates iterator
         (void)peek_more();
         DBGLOGN("Got more input pos = %zu end = %zu max = %zu", pos_, end_, max_);
@@ -351,12 +396,56 @@ class BoostMatcher : public PatternMatcher<boost::regex> {
     else if (method == Const::MATCH)
       flg |= boost::regex_constants::match_continuous;
     ASSERT(pat_ != NULL);
+    if (prefiltered(method))
+    {
+      // match at the positions predicted by the prefilter, until a match is found
+      prm_->buffer(buf_, end_ + 1);
+      size_t loc = txt_ - buf_;
+      while ((loc = prm_->predict(loc)) < end_)
+      {
+        boost::match_flag_type f = flg | boost::regex_constants::match_continuous;
+        if (buf_ + loc > txt_)
+          f |= boost::regex_constants::match_prev_avail | boost::regex_constants::match_not_bob; // as if searched from txt_
+        itr_ = boost::cregex_iterator(buf_ + loc, buf_ + end_, *pat_, f);
+        if (itr_ != fin_ && (*itr_)[0].matched)
+          return;
+        ++loc;
+      }
+      itr_ = fin_;
+      return;
+    }
     itr_ = boost::cregex_iterator(txt_, buf_ + end_, *pat_, flg);
   }
+  /// Returns true if find() uses the prefilter, which requires all input in the buffer and nonempty matches.
+  bool prefiltered(Method method) const
+    /// @returns true if prefiltered
+  {
+    return prm_ != NULL && method == Const::FIND && !opt_.N && in.eof();
+  }
+  /// Copy the prefilter of the given matcher or remove the prefilter when NULL.
+  void copy_prefilter(const BoostMatcher *matcher) ///< matcher with prefilter or NULL
+  {
+    if (matcher == this)
+      return;
+    if (prm_ != NULL)
+      delete prm_;
+    if (prp_ != NULL)
+      delete prp_;
+    prp_ = NULL;
+    prm_ = NULL;
+    if (matcher != NULL && matcher->prp_ != NULL)
+    {
+      prp_ = new reflex::Pattern(*matcher->prp_);
+      prm_ = new reflex::Matcher(*prp_, Input(), "R");
+      buffer();
+    }
+  }
   boost::match_flag_type flg_; ///< boost::regex match flags
   boost::cregex_iterator itr_; ///< const boost::regex iterator
   boost::cregex_iterator fin_; ///< const boost::regex iterator final end
   size_t                 grp_; ///< last group index for group_next_id()
+  reflex::Pattern       *prp_; ///< RE/flex pattern of the prefilter or NULL
+  reflex::Matcher       *prm_; ///< RE/flex matcher to predict matches with the prefilter or NULL
 };
 
 /// Boost matcher engine class, extends reflex::BoostMatcher for Boost POSIX regex matching.
@@ -380,7 +469,7 @@ class BoostPosixMatcher : public BoostMatcher {
   BoostPosixMatcher(
       const P     *pattern,         ///< points to a boost::regex or a string regex for this matcher
       const Input& input = Input(), ///< input character sequence for this matcher
-      const char  *opt = NULL)      ///< option string of the form `(A|N|T(=[[:digit:]])?|;)*`
+      const char  *opt = NULL)      ///< option string of the form `(A|N|R|T(=[[:digit:]])?|;)*`
     :
       BoostMatcher(pattern, input, opt)
   {
@@ -391,7 +480,7 @@ class BoostPosixMatcher : public BoostMatcher {
   BoostPosixMatcher(
       const P&     pattern,         ///< a boost::regex or a string regex for this matcher
       const Input& input = Input(), ///< input character sequence for this matcher
-      const char  *opt = NULL)      ///< option string of the form `(A|N|T(=[[:digit:]])?|;)*`
+      const char  *opt = NULL)      ///< option string of the form `(A|N|R|T(=[[:digit:]])?|;)*`
     :
       BoostMatcher(pattern, input, opt)
   {
@@ -413,7 +502,7 @@ class BoostPerlMatcher : public BoostMatcher {
   BoostPerlMatcher(
       const P     *pattern,         ///< points to a boost::regex or a string regex for this matcher
       const Input& input = Input(), ///< input character sequence for this matcher
-      const char  *opt = NULL)      ///< option string of the form `(A|N|T(=[[:digit:]])?|;)*`
+      const char  *opt = NULL)      ///< option string of the form `(A|N|R|T(=[[:digit:]])?|;)*`
     :
       BoostMatcher(pattern, input, opt)
   {
@@ -424,7 +513,7 @@ class BoostPerlMatcher : public BoostMatcher {
   BoostPerlMatcher(
       const P&     pattern,         ///< a boost::regex or a string regex for this matcher
       const Input& input = Input(), ///< input character sequence for this matcher
-      const char  *opt = NULL)      ///< option string of the form `(A|N|T(=[[:digit:]])?|;)*`
+      const char  *opt = NULL)      ///< option string of the form `(A|N|R|T(=[[:digit:]])?|;)*`
     :
       BoostMatcher(pattern, input, opt)
   {
@@ -418,7 +418,7 @@ class FlexLexer : public AbstractLexer<M> {
         const typename M::Pattern& pattern, ///< regex pattern to instantiate matcher class M(pattern, input)
         const Input&               input,   ///< the reflex::Input to instantiate matcher class M(pattern, input)
         FlexLexer                 *lexer,   ///< points to the instantiating lexer class
-        const char                *opt = NULL) ///< option string of the form `(A|N|T(=[[:digit:]])?|;)*`
+        const char                *opt = NULL) ///< option string of the form `(A|N|R|T(=[[:digit:]])?|;)*`
       :
         AbstractBaseLexer::Matcher(pattern, input, lexer, opt)
     { }
@@ -427,7 +427,7 @@ class FlexLexer : public AbstractLexer<M> {
         const char    *pattern,    ///< regex pattern to instantiate matcher class M(pattern, input)
         const Input&   input,      ///< the reflex::Input to instantiate matcher class M(pattern, input)
         FlexLexer     *lexer,      ///< points to the instantiating lexer class
-        const char    *opt = NULL) ///< option string of the form `(A|N|T(=[[:digit:]])?|;)*`
+        const char    *opt = NULL) ///< option string of the form `(A|N|R|T(=[[:digit:]])?|;)*`
       :
         AbstractBaseLexer::Matcher(pattern, input, lexer, opt)
     { }
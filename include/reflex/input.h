@@ -55,7 +55,7 @@
 # include <arm_neon.h>
 #endif
 
-#if defined(HAVE_AVX512BW) || defined(HAVE_AVX2) || defined(HAVE_SSE2)
+#if defined(HAVE_AVX512BW) || defined(HAVE_AVX2) || defined(HAVE_SSE2) || defined(HAVE_NEON)
 # ifdef _MSC_VER
 #  include <intrin.h>
 # endif
@@ -332,6 +332,11 @@ class Input {
   };
   /// FILE* handler functor base class to handle FILE* errors and non-blocking FILE* reads
   struct Handler { virtual int operator()() = 0; };
+  /// A segment of input in memory, like a struct iovec, see Input(const Segment*, size_t).
+  struct Segment {
+    const char *data; ///< points to the bytes of this segment
+    size_t      size; ///< number of bytes of this segment
+  };
   /// Stream buffer for reflex::Input, derived from std::streambuf.
   class streambuf;
   /// Stream buffer for reflex::Input to read DOS files, replaces CRLF by LF, derived from std::streambuf.
@@ -344,7 +349,13 @@ class Input {
       file_(NULL),
       istream_(NULL),
       size_(0),
-      handler_(NULL)
+      handler_(NULL),
+      map_(NULL),
+      mof_(0),
+      rah_(NULL),
+      seg_(NULL),
+      sge_(NULL),
+      sof_(0)
   {
     init();
   }
@@ -358,9 +369,19 @@ class Input {
       size_(input.size_),
       uidx_(input.uidx_),
       utfx_(input.utfx_),
-      page_(input.page_)
+      page_(input.page_),
+      map_(input.map_),
+      mof_(input.mof_),
+      rah_(input.rah_),
+      seg_(input.seg_),
+      sge_(input.sge_),
+      sof_(input.sof_)
   {
     std::memcpy(utf8_, input.utf8_, sizeof(utf8_));
+    if (map_ != NULL)
+      map_acquire();
+    if (rah_ != NULL)
+      read_ahead_acquire();
   }
   /// Construct input character sequence from a char* string
   Input(
@@ -371,7 +392,13 @@ class Input {
       wstring_(NULL),
       file_(NULL),
       istream_(NULL),
-      size_(size)
+      size_(size),
+      map_(NULL),
+      mof_(0),
+      rah_(NULL),
+      seg_(NULL),
+      sge_(NULL),
+      sof_(0)
   {
     init();
   }
@@ -382,7 +409,13 @@ class Input {
       wstring_(NULL),
       file_(NULL),
       istream_(NULL),
-      size_(cstring != NULL ? std::strlen(cstring) : 0)
+      size_(cstring != NULL ? std::strlen(cstring) : 0),
+      map_(NULL),
+      mof_(0),
+      rah_(NULL),
+      seg_(NULL),
+      sge_(NULL),
+      sof_(0)
   {
     init();
   }
@@ -393,7 +426,13 @@ class Input {
       wstring_(NULL),
       file_(NULL),
       istream_(NULL),
-      size_(string.size())
+      size_(string.size()),
+      map_(NULL),
+      mof_(0),
+      rah_(NULL),
+      seg_(NULL),
+      sge_(NULL),
+      sof_(0)
   {
     init();
   }
@@ -404,7 +443,13 @@ class Input {
       wstring_(NULL),
       file_(NULL),
       istream_(NULL),
-      size_(string != NULL ? string->size() : 0)
+      size_(string != NULL ? string->size() : 0),
+      map_(NULL),
+      mof_(0),
+      rah_(NULL),
+      seg_(NULL),
+      sge_(NULL),
+      sof_(0)
   {
     init();
   }
@@ -415,7 +460,13 @@ class Input {
       wstring_(wstring),
       file_(NULL),
       istream_(NULL),
-      size_(0)
+      size_(0),
+      map_(NULL),
+      mof_(0),
+      rah_(NULL),
+      seg_(NULL),
+      sge_(NULL),
+      sof_(0)
   {
     init();
   }
@@ -426,7 +477,13 @@ class Input {
       wstring_(wstring.c_str()),
       file_(NULL),
       istream_(NULL),
-      size_(0)
+      size_(0),
+      map_(NULL),
+      mof_(0),
+      rah_(NULL),
+      seg_(NULL),
+      sge_(NULL),
+      sof_(0)
   {
     init();
   }
@@ -437,7 +494,13 @@ class Input {
       wstring_(wstring != NULL ? wstring->c_str() : NULL),
       file_(NULL),
       istream_(NULL),
-      size_(0)
+      size_(0),
+      map_(NULL),
+      mof_(0),
+      rah_(NULL),
+      seg_(NULL),
+      sge_(NULL),
+      sof_(0)
   {
     init();
   }
@@ -448,7 +511,13 @@ class Input {
       wstring_(NULL),
       file_(file),
       istream_(NULL),
-      size_(0)
+      size_(0),
+      map_(NULL),
+      mof_(0),
+      rah_(NULL),
+      seg_(NULL),
+      sge_(NULL),
+      sof_(0)
   {
     init();
   }
@@ -462,7 +531,13 @@ class Input {
       wstring_(NULL),
       file_(file),
       istream_(NULL),
-      size_(0)
+      size_(0),
+      map_(NULL),
+      mof_(0),
+      rah_(NULL),
+      seg_(NULL),
+      sge_(NULL),
+      sof_(0)
   {
     init();
     if (file_encoding() == file_encoding::plain)
@@ -475,7 +550,13 @@ class Input {
       wstring_(NULL),
       file_(NULL),
       istream_(&istream),
-      size_(0)
+      size_(0),
+      map_(NULL),
+      mof_(0),
+      rah_(NULL),
+      seg_(NULL),
+      sge_(NULL),
+      sof_(0)
   {
     init();
   }
@@ -486,10 +567,37 @@ class Input {
       wstring_(NULL),
       file_(NULL),
       istream_(istream),
-      size_(0)
+      size_(0),
+      map_(NULL),
+      mof_(0),
+      rah_(NULL),
+      seg_(NULL),
+      sge_(NULL),
+      sof_(0)
   {
     init();
   }
+  /// Construct input character sequence from a sequence of segments in memory, such as a chain of network buffers, the segments and their data must remain valid while reading this Input.
+  Input(
+      const Segment *segments, ///< array of segments
+      size_t         count)    ///< number of segments in the array
+    :
+      cstring_(NULL),
+      wstring_(NULL),
+      file_(NULL),
+      istream_(NULL),
+      size_(0),
+      map_(NULL),
+      mof_(0),
+      rah_(NULL),
+      seg_(segments),
+      sge_(segments + count),
+      sof_(0)
+  {
+    init();
+    for (size_t i = 0; i < count; ++i)
+      size_ += segments[i].size;
+  }
   /// Copy assignment operator.
   Input& operator=(const Input& input)
   {
@@ -502,8 +610,30 @@ class Input {
     utfx_ = input.utfx_;
     page_ = input.page_;
     std::memcpy(utf8_, input.utf8_, sizeof(utf8_));
+    if (input.map_ != NULL)
+      input.map_acquire();
+    if (map_ != NULL)
+      map_release();
+    map_ = input.map_;
+    mof_ = input.mof_;
+    if (input.rah_ != NULL)
+      input.read_ahead_acquire();
+    if (rah_ != NULL)
+      read_ahead_release();
+    rah_ = input.rah_;
+    seg_ = input.seg_;
+    sge_ = input.sge_;
+    sof_ = input.sof_;
     return *this;
   }
+  /// Delete this Input, unmaps the memory-mapped file and stops reading ahead when this is the last Input sharing them.
+  ~Input()
+  {
+    if (map_ != NULL)
+      map_release();
+    if (rah_ != NULL)
+      read_ahead_release();
+  }
   /// Cast this Input object to a string, returns NULL when this Input is not a string.
   operator const char *() const
     /// @returns remaining unbuffered part of a NUL-terminated string or NULL
@@ -562,7 +692,7 @@ class Input {
   size_t size()
     /// @returns the nonzero number of ASCII/UTF-8 bytes available to read, or zero when source is empty or if size is not determinable e.g. when reading from standard input
   {
-    if (cstring_)
+    if (cstring_ || seg_)
       return size_;
     if (wstring_)
     {
@@ -585,7 +715,7 @@ class Input {
   bool assigned() const
     /// @returns true if this Input object was assigned (not default constructed or cleared)
   {
-    return cstring_ || wstring_ || file_ || istream_;
+    return cstring_ || wstring_ || file_ || istream_ || seg_;
   }
   /// Clear this Input by unassigning it.
   void clear()
@@ -595,17 +725,24 @@ class Input {
     file_ = NULL;
     istream_ = NULL;
     size_ = 0;
+    seg_ = NULL;
+    sge_ = NULL;
+    sof_ = 0;
+    if (map_ != NULL)
+      map_release();
+    if (rah_ != NULL)
+      read_ahead_release();
   }
   /// Check if input is available.
   bool good() const
     /// @returns true if a non-empty sequence of characters is available to get
   {
-    if (cstring_)
+    if (cstring_ || seg_)
       return size_ > 0;
     if (wstring_)
       return *wstring_ != L'\0';
     if (file_)
-      return !::feof(file_) && !::ferror(file_);
+      return rah_ != NULL ? read_ahead_good() : !::feof(file_) && !::ferror(file_);
     if (istream_)
       return istream_->good();
     return false;
@@ -614,12 +751,12 @@ class Input {
   bool eof() const
     /// @returns true if input is at EOF and no characters are available
   {
-    if (cstring_)
+    if (cstring_ || seg_)
       return size_ == 0;
     if (wstring_)
       return *wstring_ == L'\0';
     if (file_)
-      return ::feof(file_) != 0;
+      return rah_ != NULL ? !read_ahead_good() : ::feof(file_) != 0;
     if (istream_)
       return istream_->eof();
     return true;
@@ -725,11 +862,31 @@ class Input {
     }
     if (istream_)
     {
-      size_t k = static_cast<size_t>(n == 1 ? istream_->get(s[0]).gcount() : istream_->read(s, static_cast<std::streamsize>(n)) ? n : istream_->gcount());
+      size_t k = n == 1 ? static_cast<size_t>(istream_->get(s[0]).gcount()) : istream_get(s, n);
       if (size_ >= k)
         size_ -= k;
       return k;
     }
+    if (seg_)
+    {
+      size_t k = 0;
+      while (k < n && seg_ < sge_)
+      {
+        size_t l = seg_->size - sof_;
+        if (l > n - k)
+          l = n - k;
+        std::memcpy(s + k, seg_->data + sof_, l);
+        k += l;
+        sof_ += l;
+        if (sof_ >= seg_->size)
+        {
+          ++seg_;
+          sof_ = 0;
+        }
+      }
+      size_ -= k;
+      return k;
+    }
     return 0;
   }
   /// Set encoding for `FILE*` input.
@@ -750,11 +907,37 @@ class Input {
     uidx_ = sizeof(utf8_);
     utfx_ = 0;
     page_ = NULL;
+    if (map_ != NULL)
+      map_release();
+    if (rah_ != NULL)
+      read_ahead_release();
     if (file_ != NULL)
       file_init();
   }
   /// Called by init() for a FILE*.
   void file_init();
+  /// Called by file_init() to memory-map a regular file with plain or UTF-8 content.
+  void file_map();
+  /// Stop reading the memory-mapped file and continue reading the FILE* after the part of the file consumed.
+  void file_unmap();
+  /// Share the memory-mapped file with another Input.
+  void map_acquire() const;
+  /// Release the memory-mapped file, unmaps the file when no other Input shares it.
+  void map_release();
+  /// Get the next bytes read ahead of the FILE* by the read-ahead thread, blocks until input is available or EOF.
+  size_t read_ahead_get(
+      char  *s, ///< points to the string buffer to fill with input
+      size_t n) ///< size of buffer pointed to by s
+    /// @returns the nonzero number of bytes (less or equal to n) added to buffer s, or zero when EOF or a read error occurred
+    ;
+  /// Check if more input was or will be read ahead of the FILE*.
+  bool read_ahead_good() const
+    /// @returns true if input is available or the read-ahead thread did not reach EOF yet
+    ;
+  /// Share the read-ahead state with another Input.
+  void read_ahead_acquire() const;
+  /// Release the read-ahead state, stops the read-ahead thread when no other Input shares it.
+  void read_ahead_release();
   /// Called by size() for a wstring.
   void wstring_size();
   /// Called by size() for a FILE*.
@@ -766,6 +949,27 @@ class Input {
       char  *s, ///< points to the string buffer to fill with input
       size_t n) ///< size of buffer pointed to by s
       ;
+  /// Implements get() on a std::istream by reading its stream buffer directly, sets eofbit and failbit like std::istream::read() when fewer than n bytes are read.
+  size_t istream_get(
+      char  *s, ///< points to the string buffer to fill with input
+      size_t n) ///< size of buffer pointed to by s
+      ;
+  /// Get the remaining memory-mapped `FILE*` input to scan in place without copying, returns NULL when the `FILE*` is not memory mapped (the file is not a regular file, is too small to map, or requires conversion to UTF-8), does not advance this Input.
+  const char *mapped(size_t& size) ///< set to the size of the remaining memory-mapped input in bytes
+    /// @returns pointer to the remaining memory-mapped file content or NULL
+    const;
+  /// Get the rest of the current segment of segmented input to scan in place without copying, preceded by the last keep bytes gotten from this segment, returns NULL when this Input is not segmented, is at the end, or fewer than keep bytes of the current segment were gotten, does not advance this Input.
+  const char *segment(
+      size_t  keep, ///< number of bytes gotten last that should precede the rest of the segment
+      size_t& size) ///< set to keep plus the size of the rest of the segment in bytes
+    /// @returns pointer to the last keep bytes gotten followed by the rest of the segment, or NULL
+    const;
+  /// Skip the rest of the current segment of segmented input after scanning it in place with segment().
+  void skip_segment();
+  /// Read the FILE* ahead in a helper thread that keeps up to two blocks of input in flight while the input is matched, has no effect on memory-mapped files, on FILE* input with UTF-16, UTF-32 or code page conversions, with a FILE* handler, or without C++11 threads.
+  Input& read_ahead()
+    /// @returns reference to this Input
+    ;
   /// Set FILE* handler
   void set_handler(Handler *handler)
   {
@@ -782,6 +986,14 @@ class Input {
   file_encoding_type    utfx_;    ///< file_encoding
   const unsigned short *page_;    ///< custom code page
   Handler              *handler_; ///< to handle FILE* errors and non-blocking FILE* reads
+  struct Mapping;
+  Mapping              *map_;     ///< memory-mapped FILE* regular file shared by copies of this Input, or NULL
+  size_t                mof_;     ///< offset in the memory-mapped file of the next byte to get
+  struct ReadAhead;
+  ReadAhead            *rah_;     ///< FILE* read-ahead state shared by copies of this Input, or NULL
+  const Segment        *seg_;     ///< current segment of segmented input (when non-null)
+  const Segment        *sge_;     ///< end of the segments of segmented input
+  size_t                sof_;     ///< offset in the current segment of the next byte to get
 };
 
 /// Stream buffer for reflex::Input, derived from std::streambuf.
@@ -862,14 +1074,49 @@ class Input::dos_streambuf : public std::streambuf {
   {
     if (n <= 0 || ch1_ == EOF)
       return 0;
-    std::streamsize k = n;
-    int c;
-    while (k > 0 && (c = get()) != EOF)
+    std::streamsize k = 0;
+    while (k < n && ch1_ != EOF)
     {
-      *s++ = c;
-      --k;
+      if (ch1_ == '\r' || ch2_ != EOF || k + 1 == n)
+      {
+        s[k++] = static_cast<char>(get());
+        continue;
+      }
+      // store the lookahead character followed by a block of input, then remove the CR of each CRLF in place
+      char *p = s + k;
+      char *q = p;
+      *p = static_cast<char>(ch1_);
+      size_t m = input_.get(p + 1, static_cast<size_t>(n - k - 1));
+      bool more = m == static_cast<size_t>(n - k - 1);
+      char *e = p + 1 + m;
+      bool cr = false;
+      while (p < e)
+      {
+        char *r = static_cast<char*>(std::memchr(p, '\r', e - p));
+        if (r == NULL)
+          r = e;
+        std::memmove(q, p, r - p);
+        q += r - p;
+        p = r + 1;
+        if (p == e)
+          cr = true;
+        else if (p < e && *p != '\n')
+          *q++ = '\r';
+      }
+      if (cr && more)
+      {
+        // a CR at the end of the block, check if the next character is a LF
+        ch1_ = '\r';
+      }
+      else
+      {
+        if (cr)
+          *q++ = '\r';
+        ch1_ = more ? input_.get() : EOF;
+      }
+      k = q - s;
     }
-    return n - k;
+    return k;
   }
   virtual std::streamsize showmanyc()
   {
@@ -1123,14 +1370,49 @@ class BufferedInput::dos_streambuf : public std::streambuf {
   {
     if (n <= 0 || ch1_ == EOF)
       return 0;
-    std::streamsize k = n;
-    int c;
-    while (k > 0 && (c = get()) != EOF)
+    std::streamsize k = 0;
+    while (k < n && ch1_ != EOF)
     {
-      *s++ = c;
-      --k;
+      if (ch1_ == '\r' || ch2_ != EOF || k + 1 == n)
+      {
+        s[k++] = static_cast<char>(get());
+        continue;
+      }
+      // store the lookahead character followed by a block of input, then remove the CR of each CRLF in place
+      char *p = s + k;
+      char *q = p;
+      *p = static_cast<char>(ch1_);
+      size_t m = input_.get(p + 1, static_cast<size_t>(n - k - 1));
+      bool more = m == static_cast<size_t>(n - k - 1);
+      char *e = p + 1 + m;
+      bool cr = false;
+      while (p < e)
+      {
+        char *r = static_cast<char*>(std::memchr(p, '\r', e - p));
+        if (r == NULL)
+          r = e;
+        std::memmove(q, p, r - p);
+        q += r - p;
+        p = r + 1;
+        if (p == e)
+          cr = true;
+        else if (p < e && *p != '\n')
+          *q++ = '\r';
+      }
+      if (cr && more)
+      {
+        // a CR at the end of the block, check if the next character is a LF
+        ch1_ = '\r';
+      }
+      else
+      {
+        if (cr)
+          *q++ = '\r';
+        ch1_ = more ? input_.get() : EOF;
+      }
+      k = q - s;
     }
-    return n - k;
+    return k;
   }
   virtual std::streamsize showmanyc()
   {
@@ -1167,7 +1449,7 @@ class BufferedInput::dos_streambuf : public std::streambuf {
   int ch2_;
 };
 
-#if defined(HAVE_AVX512BW) || defined(HAVE_AVX2) || defined(HAVE_SSE2)
+#if defined(HAVE_AVX512BW) || defined(HAVE_AVX2) || defined(HAVE_SSE2) || defined(HAVE_NEON)
 
 #ifdef _MSC_VER
 #pragma intrinsic(_BitScanForward)
@@ -1179,7 +1461,11 @@ inline uint32_t ctz(uint32_t x)
 }
 inline uint32_t popcount(uint32_t x)
 {
+#if defined(_M_ARM64)
+  return _CountOneBits(x);
+#else
   return __popcnt(x);
+#endif
 }
 #ifdef _WIN64
 #pragma intrinsic(_BitScanForward64)
@@ -1191,7 +1477,11 @@ inline uint32_t ctzl(uint64_t x)
 }
 inline uint32_t popcountl(uint64_t x)
 {
+#if defined(_M_ARM64)
+  return _CountOneBits64(x);
+#else
   return static_cast<uint32_t>(__popcnt64(x));
+#endif
 }
 #endif
 #else
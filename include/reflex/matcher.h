@@ -38,13 +38,24 @@
 #define REFLEX_MATCHER_H
 
 #include <reflex/absmatcher.h>
+#include <reflex/bits.h>
 #include <reflex/pattern.h>
 #include <stack>
 
 namespace reflex {
 
+/// Position, length and subpattern index of a match returned in bulk, see Matcher::find_all() and Matcher::scan_streams().
+struct MatchSpan {
+  MatchSpan() : first(0), size(0), accept(0) { }
+  MatchSpan(size_t f, size_t s, size_t a) : first(f), size(s), accept(a) { }
+  size_t first;  ///< position of the match in the input
+  size_t size;   ///< length of the match in bytes
+  size_t accept; ///< index of the subpattern matched, nonzero
+};
+
 /// RE/flex matcher engine class, implements reflex::PatternMatcher pattern matching interface with scan, find, split functors and iterators.
 class Matcher : public PatternMatcher<reflex::Pattern> {
+  friend class reflex::Pattern; ///< permit access by reflex::Pattern::jit() to the matcher state used by the native code
  public:
   /// Convert a regex to an acceptable form, given the specified regex library signature `"[decls:]escapes[?+]"`, see reflex::convert.
   template<typename T>
@@ -61,7 +72,7 @@ class Matcher : public PatternMatcher<reflex::Pattern> {
   Matcher(
       const Pattern *pattern,         ///< points to a reflex::Pattern
       const Input&   input = Input(), ///< input character sequence for this matcher
-      const char    *opt = NULL)      ///< option string of the form `(A|N|T(=[[:digit:]])?|;)*`
+      const char    *opt = NULL)      ///< option string of the form `(A|N|R|T(=[[:digit:]])?|;)*`
     :
       PatternMatcher<reflex::Pattern>(pattern, input, opt)
   {
@@ -71,7 +82,7 @@ class Matcher : public PatternMatcher<reflex::Pattern> {
   Matcher(
       const char   *pattern,         ///< a string regex for this matcher
       const Input&  input = Input(), ///< input character sequence for this matcher
-      const char   *opt = NULL)      ///< option string of the form `(A|N|T(=[[:digit:]])?|;)*`
+      const char   *opt = NULL)      ///< option string of the form `(A|N|R|T(=[[:digit:]])?|;)*`
     :
       PatternMatcher<reflex::Pattern>(pattern, input, opt)
   {
@@ -81,7 +92,7 @@ class Matcher : public PatternMatcher<reflex::Pattern> {
   Matcher(
       const Pattern& pattern,         ///< a reflex::Pattern
       const Input&   input = Input(), ///< input character sequence for this matcher
-      const char    *opt = NULL)      ///< option string of the form `(A|N|T(=[[:digit:]])?|;)*`
+      const char    *opt = NULL)      ///< option string of the form `(A|N|R|T(=[[:digit:]])?|;)*`
     :
       PatternMatcher<reflex::Pattern>(pattern, input, opt)
   {
@@ -91,7 +102,7 @@ class Matcher : public PatternMatcher<reflex::Pattern> {
   Matcher(
       const std::string& pattern,         ///< a reflex::Pattern or a string regex for this matcher
       const Input&       input = Input(), ///< input character sequence for this matcher
-      const char        *opt = NULL)      ///< option string of the form `(A|N|T(=[[:digit:]])?|;)*`
+      const char        *opt = NULL)      ///< option string of the form `(A|N|R|T(=[[:digit:]])?|;)*`
     :
       PatternMatcher<reflex::Pattern>(pattern, input, opt)
   {
@@ -133,6 +144,8 @@ class Matcher : public PatternMatcher<reflex::Pattern> {
     ded_ = 0;
     tab_.resize(0);
     bmd_ = 0;
+    if (pat_ != NULL)
+      lap_.reserve(pat_->nla_);
   }
   /// Returns captured text as a std::pair<const char*,size_t> with string pointer (non-0-terminated) and length.
   virtual std::pair<const char*,size_t> operator[](size_t n) const
@@ -207,6 +220,12 @@ class Matcher : public PatternMatcher<reflex::Pattern> {
   {
     return tab_;
   }
+  /// Returns pointer to vector of current indent stop positions.
+  virtual std::vector<size_t> *indent_stops()
+    /// @returns pointer to vector of size_t
+  {
+    return &tab_;
+  }
   /// Clear indent stop positions.
   void clear_stops()
   {
@@ -224,6 +243,32 @@ class Matcher : public PatternMatcher<reflex::Pattern> {
     stk_.top().swap(tab_);
     stk_.pop();
   }
+  /// Returns the set of indices of all subpatterns of the pattern that match anywhere in the remaining input, scanned once to the end with the set-matching DFA of the pattern constructed with Pattern option a, or constructed by each call without option a, throws regex_error for word boundaries, indent anchors and lookaheads.
+  Bits matching();
+  /// Find all remaining matches in the input at once, appending the position, length and subpattern index of each match to spans, which is faster than iterating find() for many short matches, line numbers of the matches are computed on request by counting the newlines in the input before the match positions.
+  size_t find_all(std::vector<MatchSpan>& spans) ///< vector to append the matches to
+    /// @returns number of matches appended
+    ;
+  /// Find all remaining matches in the input at once as with find_all(spans), searching chunks of lines of the input concurrently with the given number of threads when the input is buffered in full and the matches of the pattern cannot span lines, appending the line number of each match to lines when non-NULL, otherwise searching serially.
+  size_t find_all(
+      std::vector<MatchSpan>& spans,        ///< vector to append the matches to
+      size_t                  threads,      ///< max number of threads to use
+      std::vector<size_t>    *lines = NULL) ///< vector to append the line numbers of the matches to, or NULL
+    /// @returns number of matches appended
+    ;
+  /// Tokenize n independent buffers data[i] of size[i] bytes as if each is scanned with scan() until no more tokens match, storing the tokens of buffer i in spans[i], advancing up to eight DFA instances in lockstep with the dense transition table of the pattern compiled with Pattern option h, and falling back to a matcher per buffer without option h or when the dense table does not cover the matching.
+  static size_t scan_streams(
+      const Pattern&          pattern, ///< pattern to tokenize with
+      size_t                  n,       ///< number of buffers
+      const char *const      *data,    ///< n pointers to the buffers
+      const size_t           *size,    ///< n sizes of the buffers
+      std::vector<MatchSpan> *spans)   ///< n vectors to store the tokens of the buffers
+    /// @returns total number of tokens stored
+    ;
+  /// Returns the position of the next possible match at or after position loc in the buffer, predicted with the prefilter of the pattern when matching is not needed, such as to prefilter other regex engines over a buffer given with buffer(base, size).
+  size_t predict(size_t loc) ///< position in the buffer to predict from
+    /// @returns position of the next possible match, which may be a false positive, or the end of the buffer when no match is possible
+    ;
   /// FSM code INIT.
   inline void FSM_INIT(int& c1)
   {
@@ -273,6 +318,11 @@ class Matcher : public PatternMatcher<reflex::Pattern> {
     if (c1 != EOF)
       --cur_;
   }
+  /// FSM code SKIP.
+  inline void FSM_SKIP(Pattern::Opcode opcode)
+  {
+    skip_loop(opcode);
+  }
   /// FSM code HEAD.
   inline void FSM_HEAD(Pattern::Lookahead la)
   {
@@ -392,6 +442,13 @@ class Matcher : public PatternMatcher<reflex::Pattern> {
     DBGLOG("BEGIN Matcher::match()");
     reset_text();
     len_ = 0; // split text length starts with 0
+#if defined(WITH_STATS)
+    ++sts_.matches;
+    bool predicted = false; // true when matching from a possible match found by advance()
+#endif
+    // split at a literal delimiter with a memchr scan instead of matching each byte of a field with the DFA
+    if (method == Const::SPLIT && pat_->one_ && pat_->len_ > 0)
+      return split_literal();
 scan:
     txt_ = buf_ + cur_;
 #if !defined(WITH_NO_INDENT)
@@ -407,6 +464,9 @@ find:
 #if !defined(WITH_NO_INDENT)
 redo:
 #endif
+    // reserve the lookahead positions when the pattern changed after reset(), so matching does not allocate
+    if (lap_.capacity() < pat_->nla_)
+      lap_.reserve(pat_->nla_);
     lap_.resize(0);
     cap_ = 0;
     bool nul = method == Const::MATCH;
@@ -421,9 +481,26 @@ redo:
     }
     else if (pat_->opc_ != NULL)
     {
+      if (pat_->cache_ != NULL)
+        const_cast<Pattern*>(pat_)->cache_flush(); // flush the lazy DFA cache when full
       const Pattern::Opcode *pc = pat_->opc_;
+      const Pattern::Dense *dense = pat_->dns_;
       while (true)
       {
+        if (dense != NULL && static_cast<size_t>(pc - pat_->opc_) < dense->map.size())
+        {
+          Pattern::Index d = dense->map[pc - pat_->opc_];
+          if (d != Pattern::Const::IMAX)
+          {
+            Pattern::Index jump = match_dense(d, c1);
+            if (jump == Pattern::Const::IMAX)
+              break;
+#if defined(WITH_STATS)
+            ++sts_.transitions;
+#endif
+            pc = pat_->opc_ + jump;
+          }
+        }
         Pattern::Opcode opcode = *pc;
         DBGLOG("Fetch: code[%zu] = 0x%08X", pc - pat_->opc_, opcode);
         if (!Pattern::is_opcode_goto(opcode))
@@ -461,6 +538,19 @@ redo:
               ++pc;
               continue;
             }
+            case 0xFA: // MAKE
+            {
+              Pattern::Index jump = const_cast<Pattern*>(pat_)->cache_make(Pattern::long_index_of(opcode));
+              DBGLOG("Make: %u", jump);
+              pc = pat_->opc_ + jump;
+              continue;
+            }
+            case 0xF9: // SKIP
+            case 0xF8: // SPAN
+              skip_loop(opcode);
+              DBGLOG("Skip: pos = %zu", pos_);
+              ++pc;
+              continue;
 #if !defined(WITH_NO_INDENT)
             case Pattern::META_DED - Pattern::META_MIN:
               if (ded_ > 0)
@@ -517,6 +607,18 @@ redo:
                 case 0xFB: // HEAD
                   opcode = *++pc;
                   continue;
+                case 0xFA: // MAKE
+                {
+                  Pattern::Index index = const_cast<Pattern*>(pat_)->cache_make(Pattern::long_index_of(opcode));
+                  DBGLOG("Make: %u", index);
+                  pc = pat_->opc_ + index;
+                  opcode = *pc;
+                  continue;
+                }
+                case 0xF9: // SKIP
+                case 0xF8: // SPAN
+                  opcode = *++pc;
+                  continue;
 #if !defined(WITH_NO_INDENT)
                 case Pattern::META_DED - Pattern::META_MIN:
                   DBGLOG("DED? %d", c1);
@@ -738,6 +840,9 @@ unrolled:
             break;
           jump = Pattern::long_index_of(pc[1]);
         }
+#if defined(WITH_STATS)
+        ++sts_.transitions;
+#endif
         pc = pat_->opc_ + jump;
       }
     }
@@ -795,10 +900,16 @@ unrolled:
           cap_ = Const::EMPTY;
         else
           cap_ = 0;
+        // the last text split off includes a partial delimiter at the end of the input
+        len_ = end_ - (txt_ - buf_);
         set_current(end_);
         got_ = Const::EOB;
         DBGLOG("Split at eof: cap = %zu txt = '%s' len = %zu", cap_, std::string(txt_, len_).c_str(), len_);
         DBGLOG("END Matcher::match()");
+#if defined(WITH_STATS)
+        if (cap_ == 0)
+          ++sts_.misses;
+#endif
         return cap_;
       }
       if (cur_ == 0 && at_bob() && at_end())
@@ -816,6 +927,11 @@ unrolled:
     }
     if (cap_ == 0)
     {
+#if defined(WITH_STATS)
+      if (predicted)
+        ++sts_.false_positives;
+      predicted = false;
+#endif
       if (method == Const::FIND && !at_end())
       {
         if (pos_ == cur_ + 1)
@@ -824,6 +940,9 @@ unrolled:
           if (advance())
           {
             txt_ = buf_ + cur_;
+#if defined(WITH_STATS)
+            predicted = true;
+#endif
             if (!pat_->one_)
               goto find;
             len_ = pat_->len_;
@@ -837,6 +956,9 @@ unrolled:
           // we didn't fail on META alone
           if (advance())
           {
+#if defined(WITH_STATS)
+            predicted = true;
+#endif
             if (!pat_->one_)
               goto scan;
             len_ = pat_->len_;
@@ -901,12 +1023,78 @@ unrolled:
     }
     DBGLOG("Return: cap = %zu txt = '%s' len = %zu pos = %zu got = %d", cap_, std::string(txt_, len_).c_str(), len_, pos_, got_);
     DBGLOG("END match()");
+#if defined(WITH_STATS)
+    if (cap_ == 0)
+      ++sts_.misses;
+#endif
     return cap_;
   }
   /// Returns true if able to advance to next possible match
   bool advance()
     /// @returns true if possible match found
     ;
+#if defined(WITH_STATS)
+  /// Returns true if able to advance to next possible match, called by advance() to count the search statistics.
+  bool advance_search()
+    /// @returns true if possible match found
+    ;
+#endif
+  /// Returns true if the hashed predictor of the pattern predicts a possible match of n bytes at s.
+  bool predict_pmh(
+      const char *s, ///< points to the input to predict
+      size_t      n) ///< number of bytes to predict, the minimum match length
+    /// @returns true if possibly matching
+  {
+    bool ok = Pattern::predict_match(pat_->pmh_, s, n);
+#if defined(WITH_STATS)
+    if (!ok)
+      ++sts_.rejects;
+#endif
+    return ok;
+  }
+  /// Returns zero if the 4-byte predictor of the pattern predicts a possible match at s, or the number of bytes to shift.
+  size_t predict_pma(const char *s) ///< points to the input to predict, at least 4 bytes
+    /// @returns zero if possibly matching or the shift
+  {
+    size_t k = Pattern::predict_match(pat_->pma_, s);
+#if defined(WITH_STATS)
+    if (k != 0)
+      ++sts_.rejects;
+#endif
+    return k;
+  }
+  /// Skip input in a DFA state that loops back on all bytes but the one to three exit bytes of a SKIP opcode, or on the one to three bytes of a SPAN opcode.
+  void skip_loop(Pattern::Opcode opcode);
+  /// Returns true if the opcodes never match a newline and have no indent anchors, used by find_all() to search chunks of lines concurrently.
+  static bool is_line_local(
+      const Pattern::Opcode *opc,
+      size_t                 nop)
+    /// @returns true if no match spans lines
+    ;
+  /// Match input with the dense transition table of the pattern from dense state d on, see Pattern option h.
+  Pattern::Index match_dense(
+      Pattern::Index d,
+      int&           c1)
+    /// @returns opcode index of the next state that is not dense or Pattern::Const::IMAX to halt
+    ;
+  /// Returns true if able to advance to the next possible match predicted by the wide bitap prefilter of the pattern, when matches are longer than 8 bytes.
+  bool advance_wide(size_t loc)
+    /// @returns true if possible match found
+    ;
+  /// Returns true if able to advance to the next possible match that contains the required literal of the pattern, backing up from the literal to the earliest possible match start.
+  bool advance_required(size_t loc)
+    /// @returns true if possible match found
+    ;
+#if defined(HAVE_AVX512BW) || defined(HAVE_AVX2) || defined(HAVE_SSE2) || (defined(HAVE_NEON) && (defined(__aarch64__) || defined(_M_ARM64)))
+  /// Returns true if able to advance to the next literal prefix of the pattern's multi-literal prefilter
+  bool advance_literals(size_t loc)
+    /// @returns true if possible match found
+    ;
+#endif
+  /// Split the input at the next literal delimiter when the pattern matches just one literal string, without using the DFA.
+  size_t split_literal()
+    /// @returns 1 when the text up to the delimiter was split off, Const::EMPTY for the text after the last delimiter, or 0 when done
+    ;
 #if !defined(WITH_NO_INDENT)
   /// Update indentation column counter for indent() and dedent().
   inline void newline()
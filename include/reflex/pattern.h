@@ -45,7 +45,9 @@
 #include <reflex/setop.h>
 #include <cctype>
 #include <cstring>
+#include <algorithm>
 #include <iostream>
+#include <iterator>
 #include <string>
 #include <list>
 #include <map>
@@ -78,13 +80,24 @@ class Pattern {
     static const Index  LONG = 0xFFFE;     ///< LONG marker for 64 bit opcodes, must be HALT-1
     static const Index  HALT = 0xFFFF;     ///< HALT marker for GOTO opcodes, must be 16 bit max
     static const Hash   HASH = 0x1000;     ///< size of the predict match array
+    static const size_t LITS = 8;          ///< max number of literal prefixes in the multi-literal prefilter
+    static const size_t LLEN = 8;          ///< max length of literal prefixes in the multi-literal prefilter
+    static const size_t TESTS = 8;         ///< min number of edges of a state to dispatch on the target states in FSM code instead of testing the edges in order
+    static const size_t RUNS = 16;         ///< min number of runs of bytes with the same target state to dispatch with a jump table in FSM code instead of a binary search
   };
   /// Construct an unset pattern.
   Pattern()
     :
       opc_(NULL),
       nop_(0),
-      fsm_(NULL)
+      fsm_(NULL),
+      ext_(false),
+      cache_(NULL),
+      set_(NULL),
+      dns_(NULL),
+      rev_(NULL),
+      jit_(NULL),
+      jsz_(0)
   { }
   /// Construct a pattern object given a regex string.
   explicit Pattern(
@@ -93,7 +106,14 @@ class Pattern {
     :
       rex_(regex),
       opc_(NULL),
-      fsm_(NULL)
+      fsm_(NULL),
+      ext_(false),
+      cache_(NULL),
+      set_(NULL),
+      dns_(NULL),
+      rev_(NULL),
+      jit_(NULL),
+      jsz_(0)
   {
     init(options);
   }
@@ -104,7 +124,14 @@ class Pattern {
     :
       rex_(regex),
       opc_(NULL),
-      fsm_(NULL)
+      fsm_(NULL),
+      ext_(false),
+      cache_(NULL),
+      set_(NULL),
+      dns_(NULL),
+      rev_(NULL),
+      jit_(NULL),
+      jsz_(0)
   {
     init(options.c_str());
   }
@@ -115,7 +142,14 @@ class Pattern {
     :
       rex_(regex),
       opc_(NULL),
-      fsm_(NULL)
+      fsm_(NULL),
+      ext_(false),
+      cache_(NULL),
+      set_(NULL),
+      dns_(NULL),
+      rev_(NULL),
+      jit_(NULL),
+      jsz_(0)
   {
     init(options);
   }
@@ -126,7 +160,14 @@ class Pattern {
     :
       rex_(regex),
       opc_(NULL),
-      fsm_(NULL)
+      fsm_(NULL),
+      ext_(false),
+      cache_(NULL),
+      set_(NULL),
+      dns_(NULL),
+      rev_(NULL),
+      jit_(NULL),
+      jsz_(0)
   {
     init(options.c_str());
   }
@@ -137,7 +178,14 @@ class Pattern {
     :
       opc_(code),
       nop_(0),
-      fsm_(NULL)
+      fsm_(NULL),
+      ext_(false),
+      cache_(NULL),
+      set_(NULL),
+      dns_(NULL),
+      rev_(NULL),
+      jit_(NULL),
+      jsz_(0)
   {
     init(NULL, pred);
   }
@@ -148,12 +196,30 @@ class Pattern {
     :
       opc_(NULL),
       nop_(0),
-      fsm_(fsm)
+      fsm_(fsm),
+      ext_(false),
+      cache_(NULL),
+      set_(NULL),
+      dns_(NULL),
+      rev_(NULL),
+      jit_(NULL),
+      jsz_(0)
   {
     init(NULL, pred);
   }
   /// Copy constructor.
   Pattern(const Pattern& pattern) ///< pattern to copy
+    :
+      opc_(NULL),
+      nop_(0),
+      fsm_(NULL),
+      ext_(false),
+      cache_(NULL),
+      set_(NULL),
+      dns_(NULL),
+      rev_(NULL),
+      jit_(NULL),
+      jsz_(0)
   {
     operator=(pattern);
   }
@@ -166,11 +232,43 @@ class Pattern {
   void clear()
   {
     rex_.clear();
-    if (nop_ > 0 && opc_ != NULL)
+    end_.clear();
+    acc_.clear();
+    dgs_.clear();
+    dgl_.clear();
+    if (set_ != NULL)
+    {
+      delete set_;
+      set_ = NULL;
+    }
+    if (dns_ != NULL)
+    {
+      delete dns_;
+      dns_ = NULL;
+    }
+    if (rev_ != NULL)
+    {
+      delete rev_;
+      rev_ = NULL;
+    }
+    if (cache_ != NULL)
+    {
+      // the opcode table is owned by the lazy DFA cache
+      delete cache_;
+      cache_ = NULL;
+      dfa_.clear();
+      tfa_.clear();
+    }
+    else if (nop_ > 0 && opc_ != NULL && !ext_)
+    {
       delete[] opc_;
+    }
     opc_ = NULL;
     nop_ = 0;
     fsm_ = NULL;
+    ext_ = false;
+    if (jit_ != NULL)
+      jit_free();
   }
   /// Assign a (new) pattern.
   Pattern& assign(
@@ -237,7 +335,42 @@ class Pattern {
     vms_ = pattern.vms_;
     ems_ = pattern.ems_;
     wms_ = pattern.wms_;
-    if (pattern.nop_ > 0 && pattern.opc_ != NULL)
+    len_ = pattern.len_;
+    min_ = pattern.min_;
+    one_ = pattern.one_;
+    std::memcpy(pre_, pattern.pre_, sizeof(pre_));
+    std::memcpy(bit_, pattern.bit_, sizeof(bit_));
+    std::memcpy(pmh_, pattern.pmh_, sizeof(pmh_));
+    std::memcpy(pma_, pattern.pma_, sizeof(pma_));
+    lno_ = pattern.lno_;
+    lfp_ = pattern.lfp_;
+    mln_ = pattern.mln_;
+    mdt_ = pattern.mdt_;
+    std::memcpy(mst_, pattern.mst_, sizeof(mst_));
+    std::memcpy(lln_, pattern.lln_, sizeof(lln_));
+    std::memcpy(lit_, pattern.lit_, sizeof(lit_));
+    std::memcpy(tlo_, pattern.tlo_, sizeof(tlo_));
+    wmn_ = pattern.wmn_;
+    nla_ = pattern.nla_;
+    std::memcpy(wbt_, pattern.wbt_, sizeof(wbt_));
+    std::memcpy(wlo_, pattern.wlo_, sizeof(wlo_));
+    std::memcpy(thi_, pattern.thi_, sizeof(thi_));
+    dgs_ = pattern.dgs_;
+    dgl_ = pattern.dgl_;
+    if (pattern.cache_ != NULL)
+    {
+      // construct a new lazy DFA cache
+      end_.clear();
+      init_cache();
+    }
+    else if (pattern.nop_ > 0 && pattern.opc_ != NULL && pattern.ext_)
+    {
+      // share the external opcode table, e.g. memory-mapped by load()
+      nop_ = pattern.nop_;
+      opc_ = pattern.opc_;
+      ext_ = true;
+    }
+    else if (pattern.nop_ > 0 && pattern.opc_ != NULL)
     {
       nop_ = pattern.nop_;
       Opcode *code = new Opcode[nop_];
@@ -249,6 +382,14 @@ class Pattern {
     {
       fsm_ = pattern.fsm_;
     }
+    if (pattern.jit_ != NULL)
+      jit();
+    if (pattern.set_ != NULL)
+      set_ = new Set(*pattern.set_);
+    if (pattern.dns_ != NULL)
+      dns_ = new Dense(*pattern.dns_);
+    if (pattern.rev_ != NULL)
+      rev_ = new Reverse(*pattern.rev_);
     return *this;
   }
   /// Assign a (new) pattern.
@@ -271,6 +412,38 @@ class Pattern {
   {
     return assign(fsm);
   }
+  /// Append a regex as new subpatterns to this pattern, same as assigning the regex `rex|regex` without changing the options, the lazy DFA of a pattern with option l is extended without parsing rex again, matchers using this pattern should be reassigned this pattern with pattern().
+  Pattern& append(const char *regex)
+    /// @returns this pattern
+    ;
+  /// Append a regex as new subpatterns to this pattern, see append(const char*).
+  Pattern& append(const std::string& regex)
+    /// @returns this pattern
+  {
+    return append(regex.c_str());
+  }
+  /// Save the compiled pattern opcode table and predict match data in binary form to the given file, returns false when this pattern has no opcode table or on write errors.
+  bool save(FILE *file) const
+    /// @returns true if saved
+    ;
+  /// Compile the opcode table of this pattern to native code that reflex::Matcher executes instead of interpreting the opcodes, returns false and leaves the pattern unchanged when the CPU is not x86-64, when the DFA has anchors, word boundaries, lookaheads or indents, or when the DFA is lazy with option l, call jit() again after append() and before matchers use this pattern.
+  bool jit()
+    /// @returns true if compiled to native code
+    ;
+  /// Load a pattern saved with save() from memory, the opcode table is used in place (not copied) when data is aligned, data must remain valid while the pattern is in use.
+  bool load(
+      const void *data, ///< points to the saved pattern, e.g. memory-mapped from a file
+      size_t      size) ///< size of the data in bytes
+    /// @returns true if loaded, false if the data is truncated, corrupt or saved by an incompatible version
+    ;
+  /// Load a pattern saved with save() from memory only if it was compiled from the given regex and options, see load(const void*,size_t).
+  bool load(
+      const void *data,            ///< points to the saved pattern, e.g. memory-mapped from a file
+      size_t      size,            ///< size of the data in bytes
+      const char *regex,           ///< regex of the saved pattern
+      const char *options = NULL)  ///< options of the saved pattern
+    /// @returns true if loaded, false if the data is invalid or was saved for another regex or options
+    ;
   /// Get the number of subpatterns of this pattern object.
   Accept size() const
     /// @returns number of subpatterns
@@ -305,6 +478,12 @@ class Pattern {
   {
     return nop_ > 0 ? eno_ : 0;
   }
+  /// Get the number of lookahead positions used by the opcodes of this pattern.
+  size_t lookaheads() const
+    /// @returns number of lookahead positions, 0 when there are none or when unknown for FSM code, opcode tables and lazy DFA construction
+  {
+    return nla_;
+  }
   /// Get the code size in number of words.
   size_t words() const
     /// @returns number of words or 0 when no code was generated by this pattern
@@ -331,6 +510,28 @@ class Pattern {
   {
     return wms_;
   }
+  /// Pattern::Diagnostics of the DFA construction and of the search predictors, see diagnostics().
+  struct Diagnostics {
+    /// A DFA state with its number of positions.
+    struct State {
+      Index  state;      ///< number of the DFA state in construction order, 0 is the start state
+      size_t positions;  ///< number of NFA positions of the DFA state
+      Accept subpattern; ///< the subpattern with the most positions in the DFA state
+    };
+    std::vector<size_t> states;      ///< states[n-1] is the number of DFA states with positions of subpattern n, requires option y
+    std::vector<State>  largest;     ///< the DFA states with the largest number of positions, largest first, requires option y
+    const char         *strategy;    ///< Matcher::advance() search: "prefix", "required", "literals", "wide", "bitap", "pma", or "none" to match at each position
+    float               prefix_rate; ///< estimated fraction of the input positions at which the pattern prefix is found, 1 if no prefix
+    float               bitap_rate;  ///< estimated fraction of the input positions accepted by the bitap array, 1 if unused
+    float               pmh_rate;    ///< estimated fraction of the input positions accepted by the predict-match hash array, 1 if unused
+    float               pma_rate;    ///< estimated fraction of the input positions accepted by the predict-match array, 1 if unused
+  };
+  /// Get the diagnostics of this pattern, the false positive rates of the predictors are estimated for uniformly distributed bytes or the byte distribution of a sample of the input.
+  void diagnostics(
+      Diagnostics& diag,          ///< the diagnostics to populate
+      const char  *sample = NULL, ///< optional sample of the input with the byte distribution to use
+      size_t       size = 0)      ///< size of the sample in bytes
+    const;
   /// Returns true when match is predicted, based on s[0..3..e-1] (e >= s + 4).
   static inline bool predict_match(const Pred pmh[], const char *s, size_t n)
   {
@@ -409,7 +610,7 @@ class Pattern {
     bool   contains(const Chars& c)   const { return !(c - *this).any(); }
     bool   contains(Char c)           const { return b[c >> 6] & (1ULL << (c & 0x3F)); }
     Chars& insert(Char c)                   { b[c >> 6] |= 1ULL << (c & 0x3F); return *this; }
-    Chars& insert(Char lo, Char hi)         { while (lo <= hi) insert(lo++); return *this; }
+    Chars& insert(Char lo, Char hi)         { for (Char i = lo >> 6, k = hi >> 6; lo <= hi && i <= k; ++i) b[i] |= Bits::mask(i == lo >> 6 ? lo : 0, i == k ? hi : 63); return *this; }
     Chars& flip()                           { b[0] = ~b[0]; b[1] = ~b[1]; b[2] = ~b[2]; b[3] = ~b[3]; b[4] = ~b[4]; return *this; }
     Chars& flip256()                        { b[0] = ~b[0]; b[1] = ~b[1]; b[2] = ~b[2]; b[3] = ~b[3]; return *this; }
     Chars& swap(Chars& c)                   { Chars t = c; c = *this; return *this = t; }
@@ -431,8 +632,9 @@ class Pattern {
     bool   operator>(const Chars& c)  const { return c < *this; }
     bool   operator<=(const Chars& c) const { return !(c < *this); }
     bool   operator>=(const Chars& c) const { return !(*this < c); }
-    Char   lo()                       const { for (Char i = 0; i < 5; ++i) if (b[i]) for (Char j = 0; j < 64; ++j) if (b[i] & (1ULL << j)) return (i << 6) + j; return 0; }
-    Char   hi()                       const { for (Char i = 0; i < 5; ++i) if (b[4-i]) for (Char j = 0; j < 64; ++j) if (b[4-i] & (1ULL << (63-j))) return ((4-i) << 6) + (63-j); return 0; }
+    Char   lo()                       const { for (Char i = 0; i < 5; ++i) if (b[i]) return (i << 6) + Bits::ctz(b[i]); return 0; }
+    Char   hi()                       const { for (Char i = 5; i-- > 0; ) if (b[i]) return (i << 6) + 63 - Bits::clz(b[i]); return 0; }
+    size_t count()                    const { return Bits::popcount(b[0]) + Bits::popcount(b[1]) + Bits::popcount(b[2]) + Bits::popcount(b[3]) + Bits::popcount(b[4]); }
     uint64_t b[5]; ///< 256 bits to store a set of 8-bit chars + extra bits for meta
   };
   /// Finite state machine construction position information.
@@ -474,26 +676,118 @@ class Pattern {
     value_type k;
   };
   typedef std::set<Lazy>               Lazyset;
-  typedef std::set<Position>           Positions;
+  /// Flat ordered set of positions stored in a contiguous sorted vector, replaces std::set<Position> to reduce allocations and improve locality.
+  struct Positions {
+    typedef Position                                     value_type;
+    typedef Position                                     key_type;
+    typedef std::less<Position>                          key_compare;
+    typedef std::vector<Position>::iterator              iterator;
+    typedef std::vector<Position>::const_iterator        const_iterator;
+    typedef std::vector<Position>::reverse_iterator      reverse_iterator;
+    typedef std::vector<Position>::const_reverse_iterator const_reverse_iterator;
+    typedef std::vector<Position>::size_type             size_type;
+    Positions()                                  { }
+    Positions(const Positions& pos) : v(pos.v)   { }
+    Positions& operator=(const Positions& pos)   { v = pos.v; return *this; }
+    iterator               begin()               { return v.begin(); }
+    iterator               end()                 { return v.end(); }
+    const_iterator         begin()         const { return v.begin(); }
+    const_iterator         end()           const { return v.end(); }
+    reverse_iterator       rbegin()              { return v.rbegin(); }
+    reverse_iterator       rend()                { return v.rend(); }
+    const_reverse_iterator rbegin()        const { return v.rbegin(); }
+    const_reverse_iterator rend()          const { return v.rend(); }
+    bool                   empty()         const { return v.empty(); }
+    size_type              size()          const { return v.size(); }
+    key_compare            key_comp()      const { return key_compare(); }
+    void                   clear()               { v.clear(); }
+    void                   swap(Positions& pos)  { v.swap(pos.v); }
+    iterator               erase(iterator i)     { return v.erase(i); }
+    iterator lower_bound(Position p)
+    {
+      return std::lower_bound(v.begin(), v.end(), p);
+    }
+    const_iterator lower_bound(Position p) const
+    {
+      return std::lower_bound(v.begin(), v.end(), p);
+    }
+    iterator find(Position p)
+    {
+      iterator i = lower_bound(p);
+      return i != v.end() && *i == p ? i : v.end();
+    }
+    const_iterator find(Position p) const
+    {
+      const_iterator i = lower_bound(p);
+      return i != v.end() && *i == p ? i : v.end();
+    }
+    size_type count(Position p) const
+    {
+      return find(p) != v.end();
+    }
+    /// insert position, positions are often inserted in increasing order so appending is checked first.
+    std::pair<iterator,bool> insert(Position p)
+    {
+      if (v.empty() || v.back() < p)
+      {
+        v.push_back(p);
+        return std::pair<iterator,bool>(v.end() - 1, true);
+      }
+      iterator i = lower_bound(p);
+      if (*i == p)
+        return std::pair<iterator,bool>(i, false);
+      return std::pair<iterator,bool>(v.insert(i, p), true);
+    }
+    /// insert a range of positions in increasing order, merges in linear time.
+    void insert(const_iterator i, const_iterator j)
+    {
+      if (i == j)
+        return;
+      if (v.empty() || v.back() < *i)
+      {
+        v.insert(v.end(), i, j);
+        return;
+      }
+      std::vector<Position> w;
+      w.reserve(v.size() + (j - i));
+      std::set_union(v.begin(), v.end(), i, j, std::back_inserter(w));
+      v.swap(w);
+    }
+    bool operator==(const Positions& pos) const { return v == pos.v; }
+    bool operator!=(const Positions& pos) const { return v != pos.v; }
+    bool operator<(const Positions& pos)  const { return v < pos.v; }
+    bool operator>(const Positions& pos)  const { return pos.v < v; }
+    std::vector<Position> v; ///< sorted positions without duplicates
+  };
   typedef std::map<Position,Positions> Follow;
   typedef std::pair<Chars,Positions>   Move;
   typedef std::list<Move>              Moves;
-  /// Tree DFA constructed from string patterns.
+  /// Tree DFA constructed from string patterns, stored as a compact trie with sorted sibling lists.
   struct Tree
   {
     struct Node {
       Node()
         :
-          accept(0)
+          child(NULL),
+          sibling(NULL),
+          accept(0),
+          c(0)
+      { }
+      /// return the target node of the edge on char c, or NULL.
+      Node *edge(Char c) const
       {
-        for (int i = 0; i < 256; ++i)
-          edge[i] = NULL;
+        Node *node = child;
+        while (node != NULL && node->c < c)
+          node = node->sibling;
+        return node != NULL && node->c == c ? node : NULL;
       }
-      Node  *edge[256]; ///< 256 edges, one per 8-bit char
-      Accept accept;    ///< nonzero if final state, the index of an accepted/captured subpattern
+      Node   *child;   ///< first target node, ordered by increasing char c
+      Node   *sibling; ///< next target node of the parent, with a larger char c
+      Accept  accept;  ///< nonzero if final state, the index of an accepted/captured subpattern
+      uint8_t c;       ///< the 8-bit char on the edge from the parent to this node
     };
     typedef std::list<Node*> List;
-    static const uint16_t ALLOC = 64; ///< allocate 64 nodes at a time, to improve performance
+    static const uint16_t ALLOC = 256; ///< allocate 256 nodes at a time, to improve performance
     Tree()
       :
         tree(NULL),
@@ -509,6 +803,8 @@ class Pattern {
       for (List::iterator i = list.begin(); i != list.end(); ++i)
         delete[] *i;
       list.clear();
+      tree = NULL;
+      next = ALLOC;
     }
     /// return the root of the tree.
     Node *root()
@@ -518,7 +814,16 @@ class Pattern {
     /// create an edge from a tree node to a target tree node, return the target tree node.
     Node *edge(Node *node, Char c)
     {
-      return node->edge[c] != NULL ? node->edge[c] : (node->edge[c] = leaf());
+      Node **next = &node->child;
+      while (*next != NULL && (*next)->c < c)
+        next = &(*next)->sibling;
+      if (*next != NULL && (*next)->c == c)
+        return *next;
+      Node *target = leaf();
+      target->c = static_cast<uint8_t>(c);
+      target->sibling = *next;
+      *next = target;
+      return target;
     }
     /// create a new leaf node.
     Node *leaf()
@@ -588,6 +893,7 @@ class Pattern {
       for (List::iterator i = list.begin(); i != list.end(); ++i)
         delete[] *i;
       list.clear();
+      next = ALLOC;
     }
     /// new DFA state with optional tree DFA node.
     State *state(Tree::Node *node)
@@ -612,13 +918,75 @@ class Pattern {
     List     list; ///< block allocation list
     uint16_t next; ///< block allocation, next available slot in last block
   };
+  /// Lazy DFA construction cache with option l, DFA states are constructed and encoded when first reached by a match.
+  struct Cache {
+    Cache()
+      :
+        max(0),
+        lazy(0),
+        table(NULL),
+        last(NULL)
+    { }
+    ~Cache()
+    {
+      delete[] table;
+    }
+    size_t                           max;       ///< max number of DFA states cached, the cache is flushed when full before a match
+    Lazy                             lazy;      ///< number of lazy quantifiers parsed, to continue parsing appended subpatterns
+    Positions                        startpos;  ///< start state positions
+    Follow                           followpos; ///< followpos NFA of the regex
+    Map                              modifiers; ///< modifiers of the regex
+    Map                              lookahead; ///< lookaheads of the regex
+    DFA::State                     **table;     ///< hash table with 64K entries of the DFA states cached
+    DFA::State                      *last;      ///< last DFA state added
+    std::vector<DFA::State*>         states;    ///< DFA states cached by state number DFA::State::first
+    std::vector<Index>               stubs;     ///< per DFA state the index of its MAKE opcode stub
+    std::vector<std::vector<Index> > refs;      ///< per DFA state not yet made the GOTO LONG opcode words to patch
+    std::vector<Opcode>              code;      ///< opcode table of the DFA states made so far and the stubs of the others
+  };
+  /// Set-matching DFA to find all subpatterns that match the input in one scan, see Matcher::matching().
+  struct Set {
+    static const size_t MAX = 0x10000; ///< max number of set-matching DFA states
+    std::vector<Index> next; ///< next[256 * s + c] is the state after state s on byte c, state 0 is the start state
+    std::vector<Index> aix;  ///< acc[aix[s]] to acc[aix[s + 1] - 1] are the subpatterns accepted in state s
+    std::vector<Index> acc;  ///< subpatterns accepted
+    std::vector<Index> eix;  ///< eol[eix[s]] to eol[eix[s + 1] - 1] are the subpatterns accepted in state s before a newline
+    std::vector<Index> eol;  ///< subpatterns accepted before a newline, by `$`
+    std::vector<Index> bix;  ///< eob[bix[s]] to eob[bix[s + 1] - 1] are the subpatterns accepted in state s at the end of the input
+    std::vector<Index> eob;  ///< subpatterns accepted at the end of the input, by `$` and `\Z`
+  };
+  /// Dense transition table of the DFA states without metas, lookaheads and redo, see option h.
+  struct Dense {
+    static const size_t MAX = 0x1000000; ///< max number of dense transition table entries
+    uint8_t            cls[256]; ///< byte equivalence classes, bytes in the same class have the same transitions in all dense states
+    Index              ncls;     ///< number of byte equivalence classes
+    Index              nst;      ///< number of dense states
+    Index              start;    ///< dense state of the start state, or Const::IMAX when not dense
+    std::vector<Index> next;     ///< next[ncls * d + cls[c]] is the dense state after d on byte c, or nst + opcode index of a state that is not dense, or Const::IMAX to halt
+    std::vector<Index> take;     ///< take[d] is the subpattern accepted in dense state d, 0 if none
+    std::vector<Index> map;      ///< map[i] is the dense state of the state at opcode index i, or Const::IMAX
+  };
+  /// Reverse DFA of the text before the required literal mst_[], to find the earliest possible match start backward from the literal.
+  struct Reverse {
+    static const size_t MAX = 1024; ///< max number of reverse DFA states
+    std::vector<Index>   next; ///< next[256 * r + c] is the reverse state after r on byte c moving backward, state 0 is dead and state 1 is the start state at the literal
+    std::vector<uint8_t> fin;  ///< fin[r] is nonzero if a match may start in reverse state r
+  };
   /// Global modifier modes, syntax flags, and compiler options.
   struct Option {
-    Option() : b(), e(), f(), i(), m(), n(), o(), p(), q(), r(), s(), w(), x(), z() { }
+    Option() : a(), b(), c(), d(), e(), f(), g(), h(), i(), j(), k(), l(), m(), n(), o(), p(), q(), r(), s(), t(), u(), v(), w(), x(), y(), z() { }
+    bool                     a; ///< also construct the set-matching DFA for Matcher::matching()
     bool                     b; ///< disable escapes in bracket lists
+    size_t                   c; ///< max number of opcode words of the DFA, 0 for no budget
+    bool                     d; ///< minimize the DFA by merging equivalent states
     Char                     e; ///< escape character, or > 255 for none, '\\' default
     std::vector<std::string> f; ///< output to files
+    bool                     g; ///< fall back to lazy DFA construction when a budget of options c, k or t is exceeded
+    bool                     h; ///< also construct the dense transition table of the DFA for fast matching
     bool                     i; ///< case insensitive mode, also `(?i:X)`
+    size_t                   j; ///< number of threads to use for subset construction, 0 or 1 for serial construction
+    size_t                   k; ///< max number of DFA states, 0 for no budget
+    size_t                   l; ///< lazy DFA construction caching at most this many DFA states, 0 to disable
     bool                     m; ///< multi-line mode, also `(?m:X)`
     std::string              n; ///< pattern name (for use in generated code)
     bool                     o; ///< generate optimized FSM code for option f
@@ -626,8 +994,12 @@ class Pattern {
     bool                     q; ///< enable "X" quotation of verbatim content, also `(?q:X)`
     bool                     r; ///< raise syntax errors
     bool                     s; ///< single-line mode (dotall mode), also `(?s:X)`
+    size_t                   t; ///< max ms to construct the DFA, 0 for no budget
+    std::string              u; ///< read a profile from this file to optimize the FSM code for option o
+    std::string              v; ///< instrument the FSM code for option o to append a profile to this file
     bool                     w; ///< write error message to stderr
     bool                     x; ///< free-spacing mode, also `(?x:X)`
+    bool                     y; ///< collect the DFA construction diagnostics reported by diagnostics()
     std::string              z; ///< namespace (NAME1.NAME2.NAME3)
   };
   /// Meta characters.
@@ -652,12 +1024,44 @@ class Pattern {
   void init(
       const char    *options,
       const uint8_t *pred = NULL);
+  void init_pattern(const uint8_t *pred);
+  void compile_budget() const;
   void init_options(const char *options);
+  void init_cache();
+  void init_set();
+  void init_dense();
+  void jit_free();
+  int dense_state(
+      Index               pc,
+      Index&              take,
+      Index              *col,
+      std::vector<Index>& targets) const;
+  void set_closure(
+      Positions&   pos,
+      const Chars& metas,
+      Follow&      followpos,
+      const Map&   modifiers,
+      const Map&   lookahead) const;
+  void set_accepts(
+      const Positions&    pos,
+      std::vector<Index>& acc) const;
+  void set_supported(const Moves& moves) const;
+  void cache_start();
+  Index cache_make(Index id);
+  void cache_flush()
+  {
+    if (cache_->states.size() > cache_->max)
+      cache_start();
+  }
+  std::string key_options() const;
   void parse(
       Positions& startpos,
       Follow&    followpos,
       Map&       modifiers,
-      Map&       lookahead);
+      Map&       lookahead,
+      Location   from = 0,
+      Lazy      *lazy = NULL,
+      bool       tree = true);
   void parse1(
       bool       begin,
       Location&  loc,
@@ -722,13 +1126,35 @@ class Pattern {
       const Positions& pos,
       Positions&       pos1) const;
   void greedy(Positions& pos) const;
-  void trim_lazy(Positions *pos) const;
+  void trim_lazy(
+      Positions *pos,
+      bool       all = false) const;
+  void compile_state(
+      DFA::State   *state,
+      Follow&       followpos,
+      const Map&    modifiers,
+      const Map&    lookahead,
+      DFA::State  **table,
+      DFA::State*&  last_state);
+  void compile_parallel(
+      DFA::State   *start,
+      Follow&       followpos,
+      const Map&    modifiers,
+      const Map&    lookahead,
+      DFA::State  **table,
+      DFA::State*&  last_state);
+  void compile_moves(
+      DFA::State   *state,
+      Moves&        moves,
+      DFA::State  **table,
+      DFA::State*&  last_state);
   void compile_transition(
       DFA::State *state,
       Follow&     followpos,
       const Map&  modifiers,
       const Map&  lookahead,
-      Moves&      moves) const;
+      Moves&      moves,
+      bool        all = false) const;
   void transition(
       Moves&           moves,
       Chars&           chars,
@@ -743,8 +1169,33 @@ class Pattern {
   void flip(Chars& chars) const;
   void assemble(DFA::State *start);
   void compact_dfa(DFA::State *start);
+  void compact_dfa_state(DFA::State *state);
+  void minimize_dfa(DFA::State *start);
   void encode_dfa(DFA::State *start);
+  Opcode loop_opcode(const DFA::State *state) const;
   void gencode_dfa(const DFA::State *start) const;
+  void gencode_dfa_dispatch(
+      FILE        *fd,
+      Index        index,
+      const Index *targets,
+      bool         peek) const;
+  void gencode_dfa_ranges(
+      FILE                     *fd,
+      const Index              *targets,
+      const std::vector<Char>&  runs,
+      size_t                    lo,
+      size_t                    hi,
+      int                       nest,
+      bool                      peek) const;
+  void write_profiler(
+      FILE                                 *fd,
+      const char                           *name,
+      const std::vector<const DFA::State*>& states) const;
+  bool read_profile(
+      const char                             *name,
+      size_t                                  nodes,
+      std::map<Index,size_t>&                 states,
+      std::map<std::pair<Index,Char>,size_t>& edges) const;
   void check_dfa_closure(
       const DFA::State *state,
       int               nest,
@@ -758,9 +1209,25 @@ class Pattern {
   void export_dfa(const DFA::State *start) const;
   void export_code() const;
   void predict_match_dfa(DFA::State *start);
+  void diagnose_dfa(DFA::State *start);
   void gen_predict_match(DFA::State *state);
-  void gen_predict_match_transitions(DFA::State *state, std::map<DFA::State*,ORanges<Hash> >& states);
-  void gen_predict_match_transitions(size_t level, DFA::State *state, ORanges<Hash>& labels, std::map<DFA::State*,ORanges<Hash> >& states);
+  void gen_wide(DFA::State *state);
+  void gen_literals(DFA::State *start);
+  void gen_required(DFA::State *start);
+  bool gen_required(
+      const std::vector<DFA::State*>&    states,
+      const std::map<DFA::State*,Index>& ids,
+      const std::string&                 lit,
+      size_t&                            dist) const;
+  void gen_reverse(
+      const std::vector<DFA::State*>&    states,
+      const std::map<DFA::State*,Index>& ids);
+  bool gen_literals(DFA::State *state, std::string& lit, std::vector<std::string>& lits, size_t& visits) const;
+  void init_literals();
+  void init_wide();
+  void init_lookaheads();
+  void gen_predict_match_transitions(DFA::State *state, std::map<DFA::State*,Bits>& states);
+  void gen_predict_match_transitions(size_t level, DFA::State *state, const Bits& labels, std::map<DFA::State*,Bits>& states);
   void write_predictor(FILE *fd) const;
   void write_namespace_open(FILE* fd) const;
   void write_namespace_close(FILE* fd) const;
@@ -827,6 +1294,14 @@ class Pattern {
       h += static_cast<uint16_t>(*i ^ (*i >> 24)); // (Position(*i).iter() << 4) unique hash for up to 16 chars iterated (abc...p){iter}
     return h;
   }
+  /// true if compile_transition() for this state updates followpos, due to lazy or negative positions
+  static inline bool compile_updates(const DFA::State *state)
+  {
+    for (Positions::const_iterator i = state->begin(); i != state->end(); ++i)
+      if (i->lazy() || i->negate())
+        return true;
+    return false;
+  }
   static inline bool valid_goto_index(Index index)
   {
     return index <= Const::GMAX;
@@ -870,6 +1345,24 @@ class Pattern {
   {
     return is_meta(lo) ? (lo << 24) | index : (lo << 24) | (hi << 16) | index;
   }
+  static inline Opcode opcode_make(Index id)
+  {
+    return 0xFA000000 | (id & 0xFFFFFF); // id < 0xFA0000
+  }
+  static inline Opcode opcode_skip(
+      Char b1,
+      Char b2,
+      Char b3)
+  {
+    return 0xF9000000 | (b1 << 16) | (b2 << 8) | b3; // 0 < b1 <= b2 <= b3 and b1 < 0xF9
+  }
+  static inline Opcode opcode_span(
+      Char b1,
+      Char b2,
+      Char b3)
+  {
+    return 0xF8000000 | (b1 << 16) | (b2 << 8) | b3; // 0 < b1 <= b2 <= b3 and b1 < 0xF8
+  }
   static inline Opcode opcode_halt()
   {
     return 0x00FFFFFF;
@@ -894,6 +1387,18 @@ class Pattern {
   {
     return (opcode & 0xFF000000) == 0xFB000000;
   }
+  static inline bool is_opcode_make(Opcode opcode)
+  {
+    return (opcode & 0xFF000000) == 0xFA000000;
+  }
+  static inline bool is_opcode_skip(Opcode opcode)
+  {
+    return (opcode & 0xFF000000) == 0xF9000000;
+  }
+  static inline bool is_opcode_span(Opcode opcode)
+  {
+    return (opcode & 0xFF000000) == 0xF8000000;
+  }
   static inline bool is_opcode_halt(Opcode opcode)
   {
     return opcode == 0x00FFFFFF;
@@ -964,8 +1469,10 @@ class Pattern {
   std::vector<bool>     acc_; ///< true if subpattern n is accepting (state is reachable)
   size_t                vno_; ///< number of finite state machine vertices |V|
   size_t                eno_; ///< number of finite state machine edges |E|
+  size_t                cno_; ///< number of edge ranges constructed so far, a lower bound of the opcode words checked against the budget of option c
   const Opcode         *opc_; ///< points to the opcode table
   Index                 nop_; ///< number of opcodes generated
+  size_t                nla_; ///< number of lookahead positions used by the opcodes, see Matcher::match()
   FSM                   fsm_; ///< function pointer to FSM code
   size_t                len_; ///< prefix length of pre_[], less or equal to 255
   size_t                min_; ///< patterns after the prefix are at least this long but no more than 8
@@ -973,11 +1480,33 @@ class Pattern {
   Pred                  bit_[256];         ///< bitap array
   Pred                  pmh_[Const::HASH]; ///< predict-match hash array
   Pred                  pma_[Const::HASH]; ///< predict-match array
+  size_t                lno_; ///< number of literal prefixes in lit_[] when the patterns have no common prefix, zero if none
+  size_t                lfp_; ///< fingerprint length of the literal prefixes, the shortest literal length but no more than 3
+  uint8_t               lln_[Const::LITS];             ///< lengths of the literal prefixes
+  char                  lit_[Const::LITS][Const::LLEN]; ///< literal prefixes, one of which starts every match
+  size_t                mln_; ///< length of the required literal mst_[] that every match contains, when the patterns have no prefix and no literal prefixes, zero if none
+  size_t                mdt_; ///< max distance from the start of a match to the required literal, or 0xFFFF when the text before the literal in a match has no newline and rev_ is used to back up
+  char                  mst_[256]; ///< required literal, shorter or equal to 255 bytes
+  size_t                wmn_; ///< number of positions 9 to 64 of the wide bitap prefilter when min_ is 8 and longer matches are required, zero if none
+  uint64_t              wbt_[256]; ///< wide bitap: bit k of wbt_[c] is zero if byte c may occur at position k of a match
+  uint8_t               wlo_[64][16]; ///< wide bitap nibble tables: bit (c >> 4) & 7 of wlo_[k][c & 0xF] is set if byte c may occur at position k of a match
+  uint8_t               tlo_[3][16]; ///< literal prefix bit masks indexed by the low nibble of each fingerprint byte
+  uint8_t               thi_[3][16]; ///< literal prefix bit masks indexed by the high nibble of each fingerprint byte
   float                 pms_; ///< ms elapsed time to parse regex
   float                 vms_; ///< ms elapsed time to compile DFA vertices
   float                 ems_; ///< ms elapsed time to compile DFA edges
   float                 wms_; ///< ms elapsed time to assemble code words
+  float                 tms_; ///< ms elapsed time to parse and construct the DFA so far, checked against the budget of option t
   bool                  one_; ///< true if matching one string in pre_[] without meta/anchors
+  bool                  ext_; ///< true if opc_ points to external memory that is not owned, see load()
+  Cache                *cache_; ///< lazy DFA construction cache with option l, owns opc_ when non-NULL
+  Set                  *set_;   ///< set-matching DFA constructed with option a or when first used by Matcher::matching()
+  Dense                *dns_;   ///< dense transition table constructed with option h
+  Reverse              *rev_;   ///< reverse DFA to back up from the required literal, constructed when the literal may be far from the match start
+  void                 *jit_;   ///< native code compiled from the opcode table by jit(), assigned to fsm_
+  size_t                jsz_;   ///< size of the executable memory allocated for jit_
+  std::vector<size_t>   dgs_; ///< number of DFA states per subpattern, collected with option y
+  std::vector<Diagnostics::State> dgl_; ///< the DFA states with the largest number of positions, collected with option y
 };
 
 } // namespace reflex
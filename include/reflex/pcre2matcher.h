@@ -41,6 +41,12 @@
 #define PCRE2_CODE_UNIT_WIDTH 8
 #include <pcre2.h>
 
+/// Share a JIT stack per thread among PCRE2 matchers; requires C++11 thread_local and atomics.
+#if __cplusplus >= 201103L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201103L)
+# define WITH_PCRE2_THREAD_STACK
+# include <atomic>
+#endif
+
 namespace reflex {
 
 /// PCRE2 JIT-optimized matcher engine class implements reflex::PatternMatcher pattern matching interface with scan, find, split functors and iterators, using the PCRE2 library.
@@ -56,6 +62,7 @@ class PCRE2Matcher : public PatternMatcher<std::string> {
   PCRE2Matcher()
     :
       PatternMatcher<std::string>(),
+      cod_(NULL),
       opc_(NULL),
       dat_(NULL),
       ctx_(NULL),
@@ -68,11 +75,12 @@ class PCRE2Matcher : public PatternMatcher<std::string> {
   PCRE2Matcher(
       const P     *pattern,         ///< points to a string regex for this matcher
       const Input& input = Input(), ///< input character sequence for this matcher
-      const char  *opt = NULL,      ///< option string of the form `(A|N|T(=[[:digit:]])?|;)*`
+      const char  *opt = NULL,      ///< option string of the form `(A|N|R|T(=[[:digit:]])?|;)*`
       uint32_t     options = 0)     ///< pcre2_compile() options
     :
       PatternMatcher<std::string>(pattern, input, opt),
       cop_(options),
+      cod_(NULL),
       opc_(NULL),
       dat_(NULL),
       ctx_(NULL),
@@ -86,11 +94,12 @@ class PCRE2Matcher : public PatternMatcher<std::string> {
   PCRE2Matcher(
       const P&     pattern,         ///< a string regex for this matcher
       const Input& input = Input(), ///< input character sequence for this matcher
-      const char  *opt = NULL,      ///< option string of the form `(A|N|T(=[[:digit:]])?|;)*`
+      const char  *opt = NULL,      ///< option string of the form `(A|N|R|T(=[[:digit:]])?|;)*`
       uint32_t     options = 0)     ///< pcre2_compile() options
     :
       PatternMatcher<std::string>(pattern, input, opt),
       cop_(options),
+      cod_(NULL),
       opc_(NULL),
       dat_(NULL),
       ctx_(NULL),
@@ -105,6 +114,7 @@ class PCRE2Matcher : public PatternMatcher<std::string> {
       PatternMatcher<std::string>(matcher),
       cop_(matcher.cop_),
       flg_(matcher.flg_),
+      cod_(NULL),
       opc_(NULL),
       dat_(NULL),
       ctx_(NULL),
@@ -113,13 +123,7 @@ class PCRE2Matcher : public PatternMatcher<std::string> {
     reset();
     cop_ = matcher.cop_;
     flg_ = matcher.flg_;
-#ifdef pcre2_code_copy_with_tables
-    opc_ = pcre2_code_copy_with_tables(matcher.opc_);
-    dat_ = pcre2_match_data_create_from_pattern(opc_, NULL);
-    jit_ = matcher.jit_ && pcre2_jit_compile(opc_, PCRE2_JIT_PARTIAL_HARD) == 0 && pcre2_pattern_info(opc_, PCRE2_INFO_JITSIZE, NULL) != 0;
-#else
-    compile();
-#endif
+    share(matcher);
   }
   /// Delete matcher.
   virtual ~PCRE2Matcher()
@@ -130,8 +134,7 @@ class PCRE2Matcher : public PatternMatcher<std::string> {
       pcre2_match_context_free(ctx_);
     if (dat_ != NULL)
       pcre2_match_data_free(dat_);
-    if (opc_ != NULL)
-      pcre2_code_free(opc_);
+    unshare();
   }
   /// Assign a matcher.
   PCRE2Matcher& operator=(const PCRE2Matcher& matcher) ///< matcher to copy
@@ -152,6 +155,14 @@ class PCRE2Matcher : public PatternMatcher<std::string> {
     flg_ = 0;
     grp_ = 0;
     PatternMatcher::reset(opt);
+#if defined(WITH_PCRE2_THREAD_STACK)
+    if (ctx_ == NULL)
+    {
+      ctx_ = pcre2_match_context_create(NULL);
+      if (ctx_ != NULL)
+        pcre2_jit_stack_assign(ctx_, thread_stack, NULL);
+    }
+#else
     if (ctx_ == NULL)
       ctx_ = pcre2_match_context_create(NULL);
     if (ctx_ != NULL && stk_ == NULL)
@@ -159,32 +170,18 @@ class PCRE2Matcher : public PatternMatcher<std::string> {
       stk_ = pcre2_jit_stack_create(32*1024, 512*1024, NULL);
       pcre2_jit_stack_assign(ctx_, NULL, stk_);
     }
+#endif
   }
   using PatternMatcher::pattern;
   /// Set the pattern to use with this matcher as a shared pointer to another matcher pattern.
   virtual PatternMatcher& pattern(const PCRE2Matcher& matcher) ///< the other matcher
     /// @returns this matcher.
   {
-    PatternMatcher<std::string>::pattern(matcher);
+    opt_ = matcher.opt_;
+    PatternMatcher<std::string>::pattern(matcher.pattern()); // copy the regex string, the compiled code is shared below
     cop_ = matcher.cop_;
     flg_ = matcher.flg_;
-#ifdef pcre2_code_copy_with_tables
-    if (dat_ != NULL)
-    {
-      pcre2_match_data_free(dat_);
-      dat_ = NULL;
-    }
-    if (opc_ != NULL)
-    {
-      pcre2_code_free(opc_);
-      opc_ = NULL;
-    }
-    opc_ = pcre2_code_copy_with_tables(matcher.opc_);
-    dat_ = pcre2_match_data_create_from_pattern(opc_, NULL);
-    jit_ = matcher.jit_ && pcre2_jit_compile(opc_, PCRE2_JIT_PARTIAL_HARD) == 0 && pcre2_pattern_info(opc_, PCRE2_INFO_JITSIZE, NULL) != 0;
-#else
-    compile();
-#endif
+    share(matcher);
     return *this;
   }
   /// Set the pattern regex string to use with this matcher (the given pattern is shared and must be persistent).
@@ -254,6 +251,79 @@ class PCRE2Matcher : public PatternMatcher<std::string> {
     return id();
   }
  protected:
+  /// Compiled PCRE2 code, shared by copies of a matcher and deleted with the last matcher that uses it.
+  struct Code {
+    Code(pcre2_code *code, bool jitted)
+      :
+        opc(code),
+        jit(jitted),
+        ref(1)
+    { }
+    ~Code()
+    {
+      pcre2_code_free(opc);
+    }
+    pcre2_code         *opc; ///< compiled PCRE2 code, not modified after JIT compilation
+    bool                jit; ///< true if jit-compiled PCRE2 code
+#if defined(WITH_PCRE2_THREAD_STACK)
+    std::atomic<size_t> ref; ///< number of matchers using this code
+#else
+    size_t              ref; ///< number of matchers using this code
+#endif
+   private:
+    Code(const Code&); ///< not copyable
+    Code& operator=(const Code&); ///< not assignable
+  };
+#if defined(WITH_PCRE2_THREAD_STACK)
+  /// JIT stack of a thread, deleted when the thread exits.
+  struct ThreadStack {
+    ThreadStack()
+      :
+        stk(pcre2_jit_stack_create(32*1024, 512*1024, NULL))
+    { }
+    ~ThreadStack()
+    {
+      if (stk != NULL)
+        pcre2_jit_stack_free(stk);
+    }
+    pcre2_jit_stack *stk; ///< PCRE2 jit match stack
+  };
+  /// PCRE2 JIT stack callback returns the JIT stack of the current thread, shared by all matchers used in the thread.
+  static pcre2_jit_stack *thread_stack(void *)
+    /// @returns the JIT stack or NULL to use the machine stack when allocation failed
+  {
+    static thread_local ThreadStack stack;
+    return stack.stk;
+  }
+#endif
+  /// Share the compiled code of another matcher, without copying and JIT compiling it again, and allocate match data.
+  void share(const PCRE2Matcher& matcher) ///< matcher with the compiled code to share
+  {
+    if (dat_ != NULL)
+    {
+      pcre2_match_data_free(dat_);
+      dat_ = NULL;
+    }
+    if (cod_ != matcher.cod_)
+    {
+      unshare();
+      cod_ = matcher.cod_;
+      if (cod_ != NULL)
+        ++cod_->ref;
+    }
+    opc_ = cod_ != NULL ? cod_->opc : NULL;
+    jit_ = cod_ != NULL && cod_->jit;
+    if (opc_ != NULL)
+      dat_ = pcre2_match_data_create_from_pattern(opc_, NULL);
+  }
+  /// Stop using the compiled code, delete it when no other matcher uses it.
+  void unshare()
+  {
+    if (cod_ != NULL && --cod_->ref == 0)
+      delete cod_;
+    cod_ = NULL;
+    opc_ = NULL;
+  }
   /// Translate group capture index to id pair (index,name)
   std::pair<size_t,const char*> id()
   {
@@ -284,11 +354,7 @@ class PCRE2Matcher : public PatternMatcher<std::string> {
       pcre2_match_data_free(dat_);
       dat_ = NULL;
     }
-    if (opc_ != NULL)
-    {
-      pcre2_code_free(opc_);
-      opc_ = NULL;
-    }
+    unshare();
     int err;
     PCRE2_SIZE pos;
     ASSERT(pat_ != NULL);
@@ -300,6 +366,7 @@ class PCRE2Matcher : public PatternMatcher<std::string> {
       throw regex_error(reinterpret_cast<char*>(message), *pat_, pos);
     }
     jit_ = pcre2_jit_compile(opc_, PCRE2_JIT_PARTIAL_HARD) == 0 && pcre2_pattern_info(opc_, PCRE2_INFO_JITSIZE, NULL) != 0;
+    cod_ = new Code(opc_, jit_);
     dat_ = pcre2_match_data_create_from_pattern(opc_, NULL);
     DBGLOGN("jit=%d", jit_);
   }
@@ -452,10 +519,11 @@ class PCRE2Matcher : public PatternMatcher<std::string> {
   }
   uint32_t             cop_; ///< PCRE2 compiled options
   uint32_t             flg_; ///< PCRE2 match flags
-  pcre2_code          *opc_; ///< compiled PCRE2 code
+  Code                *cod_; ///< compiled PCRE2 code shared with copies of this matcher
+  pcre2_code          *opc_; ///< compiled PCRE2 code of cod_
   pcre2_match_data    *dat_; ///< PCRE2 match data
   pcre2_match_context *ctx_; ///< PCRE2 match context;
-  pcre2_jit_stack     *stk_; ///< PCRE2 jit match stack
+  pcre2_jit_stack     *stk_; ///< PCRE2 jit match stack, unless the JIT stack of the thread is used
   PCRE2_SIZE           grp_; ///< last index for group_next_id()
   bool                 jit_; ///< true if jit-compiled PCRE2 code
 };
@@ -477,7 +545,7 @@ class PCRE2UTFMatcher : public PCRE2Matcher {
   PCRE2UTFMatcher(
       const P     *pattern,         ///< points to a string regex for this matcher
       const Input& input = Input(), ///< input character sequence for this matcher
-      const char  *opt = NULL)      ///< option string of the form `(A|N|T(=[[:digit:]])?|;)*`
+      const char  *opt = NULL)      ///< option string of the form `(A|N|R|T(=[[:digit:]])?|;)*`
     :
       PCRE2Matcher(pattern, input, opt, PCRE2_UTF | PCRE2_UCP)
   { }
@@ -486,7 +554,7 @@ class PCRE2UTFMatcher : public PCRE2Matcher {
   PCRE2UTFMatcher(
       const P&     pattern,         ///< a string regex for this matcher
       const Input& input = Input(), ///< input character sequence for this matcher
-      const char  *opt = NULL)      ///< option string of the form `(A|N|T(=[[:digit:]])?|;)*`
+      const char  *opt = NULL)      ///< option string of the form `(A|N|R|T(=[[:digit:]])?|;)*`
     :
       PCRE2Matcher(pattern, input, opt, PCRE2_UTF | PCRE2_UCP)
   { }
@@ -38,22 +38,41 @@
 #define REFLEX_POSIX_H
 
 #include <cstring>
-#include <map>
 
 namespace reflex {
 
 namespace Posix {
 
-class Tables {
- public:
-  struct lt {
-    bool operator()(const char *a, const char *b) const { return std::strcmp(a, b) < 0; }
-  };
-  typedef std::map<const char*,const int*,lt> Range;
-  Tables();
-  Range range;
+/// Character class table entry, a table of entries is sorted by name.
+struct Entry {
+  const char *name;   ///< character class name
+  const int  *ranges; ///< character class ranges, pairs of lo and hi chars terminated by 0, 0
 };
 
+/// Returns the entry with the given name in a table sorted by name, or NULL when not found.
+template<typename T>
+inline const T *lookup(
+    const T    *table, ///< table of entries with a name member, sorted by name
+    size_t      size,  ///< number of entries in the table
+    const char *name)  ///< name to look up
+  /// @returns pointer to the entry or NULL
+{
+  size_t lo = 0;
+  size_t hi = size;
+  while (lo < hi)
+  {
+    size_t mid = (lo + hi) / 2;
+    int cmp = std::strcmp(name, table[mid].name);
+    if (cmp == 0)
+      return &table[mid];
+    if (cmp < 0)
+      hi = mid;
+    else
+      lo = mid + 1;
+  }
+  return NULL;
+}
+
 const int * range(const char *);
 
 }
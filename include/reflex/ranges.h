@@ -42,8 +42,10 @@ This lowers storage overhead and reduces insertion, deletion, and search time.
 #ifndef REFLEX_RANGES_H
 #define REFLEX_RANGES_H
 
+#include <algorithm>  // std::lower_bound
 #include <functional> // std::less
 #include <set>        // base class container
+#include <vector>     // base class container of flat ranges
 
 namespace reflex {
 
@@ -932,6 +934,632 @@ class ORanges : public Ranges<T> {
   }
 };
 
+/// RE/flex FlatRanges template class.
+/**
+The FlatRanges class is a drop-in replacement of the Ranges class that stores
+disjoint ranges [lo,hi] in a sorted `std::vector` instead of a `std::set`.  It
+has the same methods as the Ranges class.
+
+A flat sorted array of ranges is compact and cache friendly, without tree nodes
+to allocate and pointers to chase.  Searching is a binary search.  Inserting
+ranges in ascending order appends ranges, which is the common case when ranges
+are copied from a sorted table of ranges.  Union, intersection and comparison
+of two range sets are performed by linear merging.  However, inserting and
+erasing ranges in the middle of a large range set moves the ranges that follow
+the insertion or deletion point.  Note that iterators are invalidated by
+updates, like `std::vector` iterators.
+
+@warning Using `std::vector::insert()` instead of `FlatRanges::insert()` may
+result in overlapping or unsorted ranges.
+
+Example:
+
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+    reflex::FlatRanges<float> intervals;
+    intervals.insert(1.0, 2.0);  // insert  1.0..2.0
+    intervals.insert(2.0, 3.0);  // insert  2.0..3.0
+    intervals.insert(-1.0, 0.0); // insert -1.0..0.0
+    std::cout << "Set of " << intervals.size() << " intervals:" << std::endl;
+    for (reflex::FlatRanges<float>::const_iterator i = intervals.begin(); i != intervals.end(); ++i)
+      std::cout << "[" << i->first << "," << i->second << "]" << std::endl;
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+Output:
+
+    Set of 2 intervals:
+    [-1,0]
+    [1,3]
+
+*/
+template<typename T>
+class FlatRanges : public std::vector< std::pair<T,T> > {
+ public:
+  /// Type of the bounds.
+  typedef T bound_type;
+  /// Synonym type defining the base class container std::vector.
+  typedef typename std::vector< std::pair<T,T> > container_type;
+  /// Synonym type defining the base class container std::vector::value_type.
+  typedef typename container_type::value_type value_type;
+  /// Synonym type defining the key/value comparison of ranges.
+  typedef range_compare<T> key_compare;
+  typedef range_compare<T> value_compare;
+  /// Synonym type defining the base class container std::vector::iterator.
+  typedef typename container_type::iterator iterator;
+  /// Synonym type defining the base class container std::vector::const_iterator.
+  typedef typename container_type::const_iterator const_iterator;
+  /// Construct an empty range.
+  FlatRanges()
+  { }
+  /// Construct a copy of a range [lo,hi].
+  FlatRanges(const value_type& r)
+  {
+    insert(r);
+  }
+  /// Construct a range [lo,hi].
+  FlatRanges(
+      const bound_type& lo, ///< lower bound
+      const bound_type& hi) ///< upper bound
+  {
+    insert(lo, hi);
+  }
+  /// Construct a singleton range [val,val].
+  FlatRanges(const bound_type& val) ///< value
+  {
+    insert(val, val);
+  }
+  /// Update ranges to include range [lo,hi] by merging overlapping ranges into one range.
+  std::pair<iterator,bool> insert(const value_type& r) ///< range
+    /// @returns a pair of an iterator to the range and a flag indicating whether the range was inserted as new.
+  {
+    return insert(r.first, r.second);
+  }
+  /// Update ranges to include range [lo,hi] by merging overlapping ranges into one range.
+  std::pair<iterator,bool> insert(
+      const bound_type& lo, ///< lower bound
+      const bound_type& hi) ///< upper bound
+    /// @returns a pair of an iterator to the range and a flag indicating whether the range was inserted as new.
+  {
+    // append [lo,hi] when it follows the last range, which is the common case
+    if (this->empty() || std::less<bound_type>()(this->back().second, lo))
+    {
+      container_type::push_back(value_type(lo, hi));
+      return std::pair<iterator,bool>(this->end() - 1, true);
+    }
+    iterator i = lower(lo);
+    // if [lo,hi] does not overlap any range in the set then insert [lo,hi]
+    if (i == this->end() || std::less<bound_type>()(hi, i->first))
+      return std::pair<iterator,bool>(container_type::insert(i, value_type(lo, hi)), true);
+    // if [lo,hi] is subsumed by a range in the set then return without inserting
+    if (!std::less<bound_type>()(lo, i->first) && !std::less<bound_type>()(i->second, hi))
+      return std::pair<iterator,bool>(i, false);
+    // merge [lo,hi] with the ranges [i,j) that overlap with [lo,hi]
+    iterator j = i + 1;
+    while (j != this->end() && !std::less<bound_type>()(hi, j->first))
+      ++j;
+    if (std::less<bound_type>()(lo, i->first)) // lo = min(lo, i.lo)
+      i->first = lo;
+    i->second = std::less<bound_type>()(hi, (j - 1)->second) ? (j - 1)->second : hi; // hi = max(hi, j.hi)
+    container_type::erase(i + 1, j);
+    return std::pair<iterator,bool>(i, true);
+  }
+  /// Update ranges to include the range [val,val].
+  std::pair<iterator,bool> insert(const bound_type& val) ///< value to insert
+    /// @returns a pair of an iterator to the range and a flag indicating whether the range was inserted as new.
+  {
+    return insert(val, val);
+  }
+  /// Find the first range [lo',hi'] that overlaps the given range [lo,hi], i.e. lo <= hi' and lo' <= hi.
+  const_iterator find(
+      const bound_type& lo, ///< lower bound
+      const bound_type& hi) ///< upper bound
+    const
+    /// @returns iterator to the first range that overlaps the given range, or the end iterator.
+  {
+    const_iterator i = lower(lo);
+    if (i != this->end() && std::less<bound_type>()(hi, i->first))
+      return this->end();
+    return i;
+  }
+  /// Find the range [lo',hi'] that includes the given value val, i.e. lo' <= val <= hi'.
+  const_iterator find(const bound_type& val) ///< value to search for
+    const
+    /// @returns iterator to the range that includes the value, or the end iterator.
+  {
+    return find(val, val);
+  }
+  /// Update ranges to insert the given range set by linear merging.
+  FlatRanges& operator|=(const FlatRanges& rs) ///< ranges to insert
+    /// @returns reference to this object.
+  {
+    if (rs.empty())
+      return *this;
+    if (this->empty() || std::less<bound_type>()(this->back().second, rs.front().first))
+    {
+      container_type::insert(this->end(), rs.begin(), rs.end());
+      return *this;
+    }
+    container_type r;
+    r.reserve(this->size() + rs.size());
+    const_iterator i = this->begin();
+    const_iterator j = rs.begin();
+    while (i != this->end() || j != rs.end())
+    {
+      // take the range with the lowest lower bound and merge it with the last range when overlapping
+      const value_type& k = j == rs.end() || (i != this->end() && std::less<bound_type>()(i->first, j->first)) ? *i++ : *j++;
+      if (r.empty() || std::less<bound_type>()(r.back().second, k.first))
+        r.push_back(k);
+      else if (std::less<bound_type>()(r.back().second, k.second))
+        r.back().second = k.second;
+    }
+    this->swap(r);
+    return *this;
+  }
+  /// Update ranges to insert the ranges of the given range set, same as FlatRanges::operator|=(rs).
+  FlatRanges& operator+=(const FlatRanges& rs) ///< ranges to insert
+    /// @returns reference to this object.
+  {
+    return operator|=(rs);
+  }
+  /// Update ranges to intersect the ranges with the given range set.
+  FlatRanges& operator&=(const FlatRanges& rs) ///< ranges to intersect
+    /// @returns reference to this object.
+  {
+    FlatRanges r(*this & rs);
+    this->swap(r);
+    return *this;
+  }
+  /// Returns the union of two range sets.
+  FlatRanges operator|(const FlatRanges& rs) ///< ranges to merge
+    const
+    /// @returns the union of this set and rs.
+  {
+    return FlatRanges(*this) |= rs;
+  }
+  /// Returns the union of two range sets, same as FlatRanges::operator|(rs).
+  FlatRanges operator+(const FlatRanges& rs) ///< ranges to merge
+    const
+    /// @returns the union of this set and rs.
+  {
+    return FlatRanges(*this) |= rs;
+  }
+  /// Returns the intersection of two range sets.
+  FlatRanges operator&(const FlatRanges& rs) ///< range set to intersect
+    const
+    /// @returns the intersection of this range set and rs.
+  {
+    const_iterator i = this->begin();
+    const_iterator j = rs.begin();
+    FlatRanges r;
+    while (i != this->end() && j != rs.end())
+    {
+      if (key_compare()(*i, *j))
+      {
+        ++i;
+      }
+      else if (key_compare()(*j, *i))
+      {
+        ++j;
+      }
+      else
+      {
+        // add the overlap [max(i.lo, j.lo), min(i.hi, j.hi)] and advance the range that ends first
+        const bound_type& lo = std::less<bound_type>()(i->first, j->first) ? j->first : i->first;
+        if (std::less<bound_type>()(i->second, j->second))
+          r.push_back(value_type(lo, i++->second));
+        else if (std::less<bound_type>()(j->second, i->second))
+          r.push_back(value_type(lo, j++->second));
+        else
+        {
+          r.push_back(value_type(lo, i++->second));
+          ++j;
+        }
+      }
+    }
+    return r;
+  }
+  /// True if this range set is lexicographically less than range set rs.
+  bool operator<(const FlatRanges& rs) ///< ranges
+    const
+    /// @returns true if this range set is less than rs.
+  {
+    const_iterator i = this->begin();
+    const_iterator j = rs.begin();
+    while (i != this->end() && j != rs.end())
+    {
+      if (std::less<bound_type>()(i->first, j->first))
+        return true;
+      if (std::less<bound_type>()(j->first, i->first))
+        return false;
+      if (std::less<bound_type>()(i->second, j->second))
+        return true;
+      if (std::less<bound_type>()(j->second, i->second))
+        return false;
+      ++i;
+      ++j;
+    }
+    return false;
+  }
+  /// True if this range set is lexicographically greater than range set rs.
+  bool operator>(const FlatRanges& rs) ///< ranges
+    const
+    /// @returns true if this range set is greater than rs.
+  {
+    return rs.operator<(*this);
+  }
+  /// True if this range set is lexicographically less or equal to range set rs.
+  bool operator<=(const FlatRanges& rs) ///< ranges
+    const
+    /// @returns true if this range set is less or equal to rs.
+  {
+    return !operator>(rs);
+  }
+  /// True if this range set is lexicographically greater or equal to range set rs.
+  bool operator>=(const FlatRanges& rs) ///< ranges
+    const
+    /// @returns true if this is greater or equal to rs.
+  {
+    return !operator<(rs);
+  }
+  /// Return true if this set of ranges contains at least one range, i.e. is not empty.
+  bool any() const
+    /// @returns true if non empty, false if empty.
+  {
+    return !container_type::empty();
+  }
+  /// Return true if this set of ranges intersects with ranges rs, i.e. this set has at least one range [lo',hi'] that overlaps with a range [lo,hi] in rs such that lo <= hi' and lo' <= hi.
+  bool intersects(const FlatRanges& rs) ///< ranges
+    const
+    /// @returns true if this set intersects rs.
+  {
+    const_iterator i = this->begin();
+    const_iterator j = rs.begin();
+    while (i != this->end() && j != rs.end())
+    {
+      if (key_compare()(*i, *j))
+        ++i;
+      else if (key_compare()(*j, *i))
+        ++j;
+      else
+        return true;
+    }
+    return false;
+  }
+  /// Return true if this set of ranges contains all ranges in rs, i.e. rs is a subset of this set which means that for each range [lo,hi] in rs, there is a range [lo',hi'] such that lo' <= lo and hi <= hi'.
+  bool contains(const FlatRanges& rs) ///< ranges
+    const
+    /// @returns true if this set contains rs.
+  {
+    const_iterator i = this->begin();
+    const_iterator j = rs.begin();
+    while (i != this->end() && j != rs.end())
+    {
+      if (key_compare()(*i, *j))
+      {
+        ++i;
+      }
+      else
+      {
+        if (key_compare()(*j, *i) || std::less<bound_type>()(j->first, i->first) || std::less<bound_type>()(i->second, j->second))
+          return false;
+        ++j;
+      }
+    }
+    return j == rs.end();
+  }
+  /// Return the lowest value in the set of ranges (the set cannot be empty)
+  bound_type lo() const
+    /// @returns lowest value
+  {
+    return this->front().first;
+  }
+  /// Return the highest value in the set of ranges (the set cannot be empty)
+  bound_type hi() const
+    /// @returns highest value
+  {
+    return this->back().second;
+  }
+ protected:
+  /// Functor to compare a range upper bound to a value with binary search.
+  struct upper_less {
+    bool operator()(const value_type& r, const bound_type& val) const
+    {
+      return std::less<bound_type>()(r.second, val);
+    }
+  };
+  /// Returns the first range [lo',hi'] with val <= hi'.
+  iterator lower(const bound_type& val) ///< value
+    /// @returns iterator to the range or the end iterator.
+  {
+    return std::lower_bound(this->begin(), this->end(), val, upper_less());
+  }
+  /// Returns the first range [lo',hi'] with val <= hi'.
+  const_iterator lower(const bound_type& val) ///< value
+    const
+    /// @returns iterator to the range or the end iterator.
+  {
+    return std::lower_bound(this->begin(), this->end(), val, upper_less());
+  }
+};
+
+/// RE/flex FlatORanges (open-ended, ordinal value range) template class.
+/**
+The FlatORanges class is a drop-in replacement of the ORanges class that stores
+disjoint open-ended ranges [lo,hi+1) in a sorted `std::vector` instead of a
+`std::set`, see FlatRanges.  It has the same methods as the ORanges class.
+Erasing values, set difference and intersection are performed by linear
+merging.
+
+Example:
+
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+    reflex::FlatORanges<int> ints;
+    ints.insert(100, 200); // insert 100..200
+    ints.insert(300, 400); // insert 300..400
+    ints.insert(200, 300); // insert 200..300
+    ints.erase(250, 350);  // erase 250..350
+    for (reflex::FlatORanges<int>::const_iterator i = ints.begin(); i != ints.end(); ++i)
+      std::cout << "[" << i->first << "," << i->second << ")" << std::endl;
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+Output:
+
+   [100,250)
+   [351,401)
+
+*/
+template<typename T>
+class FlatORanges : public FlatRanges<T> {
+ public:
+  using FlatRanges<T>::insert;
+  using FlatRanges<T>::contains;
+  /// Type of the bounds.
+  typedef T bound_type;
+  /// Synonym type defining the base class container std::vector.
+  typedef typename std::vector< std::pair<T,T> > container_type;
+  /// Synonym type defining the base class container std::vector::value_type.
+  typedef typename container_type::value_type value_type;
+  /// Synonym type defining the key/value comparison of ranges.
+  typedef range_compare<T> key_compare;
+  typedef range_compare<T> value_compare;
+  /// Synonym type defining the base class container std::vector::iterator.
+  typedef typename container_type::iterator iterator;
+  /// Synonym type defining the base class container std::vector::const_iterator.
+  typedef typename container_type::const_iterator const_iterator;
+  /// Construct an empty range.
+  FlatORanges()
+  { }
+  /// Construct a copy of a range [lo,hi].
+  FlatORanges(const value_type& r) ///< range
+  {
+    insert(r.first, r.second);
+  }
+  /// Construct a range [lo,hi].
+  FlatORanges(
+      const bound_type& lo, ///< lower bound
+      const bound_type& hi) ///< upper bound
+  {
+    insert(lo, hi);
+  }
+  /// Construct a singleton range [val,val].
+  FlatORanges(const bound_type& val) ///< value
+  {
+    insert(val, val);
+  }
+  /// Update ranges to include range [lo,hi] by merging overlapping and adjacent ranges into one range.
+  std::pair<iterator,bool> insert(
+      const bound_type& lo, ///< lower bound
+      const bound_type& hi) ///< upper bound
+    /// @returns a pair of an iterator to the range and a flag indicating whether the range was inserted as new.
+  {
+    return FlatRanges<T>::insert(lo, bump(hi));
+  }
+  /// Update ranges to include range [val,val] by merging overlapping and adjacent ranges into one range.
+  std::pair<iterator,bool> insert(const bound_type& val) ///< value to insert
+    /// @returns a pair of an iterator to the range and a flag indicating whether the range was inserted as new.
+  {
+    return insert(val, val);
+  }
+  /// Update ranges by deleting the given range [lo,hi].
+  bool erase(
+      const bound_type& lo, ///< lower bound
+      const bound_type& hi) ///< upper bound
+    /// @returns true if ranges was updated.
+  {
+    iterator i = this->lower(bump(lo));
+    // if [lo,hi] does not overlap any range in the set then return
+    if (i == this->end() || std::less<bound_type>()(hi, i->first))
+      return false;
+    // ranges [i,j) overlap with [lo,hi]
+    iterator j = i + 1;
+    while (j != this->end() && !std::less<bound_type>()(hi, j->first))
+      ++j;
+    bool left = std::less<bound_type>()(i->first, lo);
+    bool right = std::less<bound_type>()(bump(hi), (j - 1)->second);
+    // split range i in two when [lo,hi] is strictly inside range i
+    if (left && right && j == i + 1)
+    {
+      value_type r(bump(hi), i->second);
+      i->second = lo;
+      container_type::insert(i + 1, r);
+      return true;
+    }
+    // put back remaining partial ranges, if any, and erase the rest
+    if (left)
+      i++->second = lo;
+    if (right)
+      (--j)->first = bump(hi);
+    container_type::erase(i, j);
+    return true;
+  }
+  /// Update ranges by deleting the given range [val,val].
+  bool erase(const bound_type& val) ///< value to delete
+    /// @returns true if ranges was updated.
+  {
+    return erase(val, val);
+  }
+  /// Find the first range that overlaps the given range.
+  const_iterator find(
+      const bound_type& lo, ///< lower bound
+      const bound_type& hi) ///< upper bound
+    const
+    /// @returns iterator to the first range that overlaps the given range, or the end iterator.
+  {
+    return FlatRanges<T>::find(bump(lo), hi);
+  }
+  /// Find the range that includes the given value.
+  const_iterator find(const bound_type& val) ///< value to search for
+    const
+    /// @returns iterator to the range that includes the value, or the end iterator.
+  {
+    return find(val, val);
+  }
+  /// Update ranges to remove ranges rs by linear merging.
+  FlatORanges& operator-=(const FlatORanges& rs)
+    /// @returns reference to this object.
+  {
+    if (rs.empty() || this->empty() || !std::less<bound_type>()(rs.front().first, this->back().second) || !std::less<bound_type>()(this->front().first, rs.back().second))
+      return *this;
+    container_type r;
+    r.reserve(this->size() + rs.size());
+    const_iterator j = rs.begin();
+    for (const_iterator i = this->begin(); i != this->end(); ++i)
+    {
+      bound_type lo = i->first;
+      // skip ranges in rs that precede range i
+      while (j != rs.end() && !std::less<bound_type>()(lo, j->second))
+        ++j;
+      // cut ranges in rs out of range [lo,i.hi)
+      const_iterator k = j;
+      while (k != rs.end() && std::less<bound_type>()(k->first, i->second))
+      {
+        if (std::less<bound_type>()(lo, k->first))
+          r.push_back(value_type(lo, k->first));
+        if (!std::less<bound_type>()(k->second, i->second))
+        {
+          lo = i->second;
+          break;
+        }
+        lo = k->second;
+        ++k;
+      }
+      if (std::less<bound_type>()(lo, i->second))
+        r.push_back(value_type(lo, i->second));
+    }
+    this->swap(r);
+    return *this;
+  }
+  /// Update ranges to intersect the ranges of the given range set.
+  FlatORanges& operator&=(const FlatORanges& rs) ///< ranges to intersect
+    /// @returns reference to this object.
+  {
+    FlatORanges r(*this & rs);
+    this->swap(r);
+    return *this;
+  }
+  /// Returns the union of two range sets.
+  FlatORanges operator|(const FlatORanges& rs) ///< ranges to merge
+    const
+    /// @returns the union of this set and rs.
+  {
+    FlatORanges copy(*this);
+    copy.FlatRanges<T>::operator|=(rs);
+    return copy;
+  }
+  /// Returns the union of two range sets.
+  FlatORanges operator+(const FlatORanges& rs) ///< ranges to merge
+    const
+    /// @returns the union of this set and rs.
+  {
+    FlatORanges copy(*this);
+    copy.FlatRanges<T>::operator+=(rs);
+    return copy;
+  }
+  /// Returns the difference of two open-ended range sets.
+  FlatORanges operator-(const FlatORanges& rs) ///< ranges
+    const
+    /// @returns the difference of this set and rs.
+  {
+    return FlatORanges(*this) -= rs;
+  }
+  /// Returns the intersection of two open-ended range sets.
+  FlatORanges operator&(const FlatORanges& rs) ///< ranges to intersect
+    const
+    /// @returns the intersection of this set and rs.
+  {
+    const_iterator i = this->begin();
+    const_iterator j = rs.begin();
+    FlatORanges r;
+    while (i != this->end() && j != rs.end())
+    {
+      if (!std::less<bound_type>()(j->first, i->second))
+      {
+        ++i;
+      }
+      else if (!std::less<bound_type>()(i->first, j->second))
+      {
+        ++j;
+      }
+      else
+      {
+        // add the overlap [max(i.lo, j.lo), min(i.hi, j.hi)) and advance the range that ends first
+        const bound_type& lo = std::less<bound_type>()(i->first, j->first) ? j->first : i->first;
+        if (std::less<bound_type>()(i->second, j->second))
+        {
+          r.push_back(value_type(lo, i++->second));
+        }
+        else if (std::less<bound_type>()(j->second, i->second))
+        {
+          r.push_back(value_type(lo, j++->second));
+        }
+        else
+        {
+          r.push_back(value_type(lo, i++->second));
+          ++j;
+        }
+      }
+    }
+    return r;
+  }
+  /// Return true if this set of ranges intersects with ranges rs, i.e. this set has at least one range [lo',hi'] that overlaps with a range [lo,hi] in rs such that lo <= hi' and lo' <= hi.
+  bool intersects(const FlatORanges& rs) ///< ranges
+    const
+    /// @returns true if this set intersects rs.
+  {
+    const_iterator i = this->begin();
+    const_iterator j = rs.begin();
+    while (i != this->end() && j != rs.end())
+    {
+      if (!std::less<bound_type>()(j->first, i->second))
+        ++i;
+      else if (!std::less<bound_type>()(i->first, j->second))
+        ++j;
+      else
+        return true;
+    }
+    return false;
+  }
+  /// Return the highest value in the set of ranges (the set cannot be empty)
+  bound_type hi() const
+    /// @returns highest value
+  {
+    return this->back().second - static_cast<bound_type>(1);
+  }
+ private:
+  /// Bump value.
+  static inline bound_type bump(bound_type val) ///< the value to bump
+    /// @returns val + 1.
+  {
+#ifdef WITH_ORANGES_CLAMPED
+    bound_type lav = ~val - 1; // trick to get around -Wstrict-overflow warning for signed types
+    if (std::less<bound_type>()(~lav, val)) // check integer overflow, if overflow do not bump
+      return val;
+    return ~lav;
+#else
+    return static_cast<bound_type>(val + static_cast<bound_type>(1));
+#endif
+  }
+};
+
 } // namespace reflex
 
 #endif
@@ -0,0 +1,666 @@
+/******************************************************************************\
+* Copyright (c) 2016, Robert van Engelen, Genivia Inc. All rights reserved.    *
+*                                                                              *
+* Redistribution and use in source and binary forms, with or without           *
+* modification, are permitted provided that the following conditions are met:  *
+*                                                                              *
+*   (1) Redistributions of source code must retain the above copyright notice, *
+*       this list of conditions and the following disclaimer.                  *
+*                                                                              *
+*   (2) Redistributions in binary form must reproduce the above copyright      *
+*       notice, this list of conditions and the following disclaimer in the    *
+*       documentation and/or other materials provided with the distribution.   *
+*                                                                              *
+*   (3) The name of the author may not be used to endorse or promote products  *
+*       derived from this software without specific prior written permission.  *
+*                                                                              *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED *
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF         *
+* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO   *
+* EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       *
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, *
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;  *
+* OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,     *
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR      *
+* OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF       *
+* ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                   *
+\******************************************************************************/
+
+/**
+@file      static_pattern.h
+@brief     RE/flex patterns compiled to opcode tables at compile time (C++20)
+@author    Robert van Engelen - engelen@genivia.com
+@copyright (c) 2016-2020, Robert van Engelen, Genivia Inc. All rights reserved.
+@copyright (c) BSD-3 License - see LICENSE.txt
+
+Usage
+-----
+
+`reflex::static_pattern<"regex">::code` is a `reflex::Pattern::Opcode` table
+constructed by the C++ compiler from a string literal regex, stored in
+read-only data.  No regex is parsed and no DFA is constructed when the program
+runs.  The table is used by a `reflex::Pattern` constructed from opcodes, in
+the same way as the tables generated by the `reflex` tool with option `f`.
+
+`reflex::static_pattern<"regex">::pattern()` returns a `reflex::Pattern`
+constructed from the table when first used.
+
+The regex syntax is a subset of the reflex::Pattern syntax:
+
+- alternations `x|y`, where top-level alternatives are subpatterns 1, 2, ...
+- groups `(x)` and `(?:x)`
+- quantifiers `x*`, `x+`, `x?`, `x{n}`, `x{n,}` and `x{n,m}`
+- any byte except newline `.` and bracket lists `[a-z]` and `[^a-z]`
+- escapes `\d`, `\D`, `\w`, `\W`, `\s`, `\S`, `\h`, `\a`, `\e`, `\f`, `\n`,
+  `\r`, `\t`, `\v`, `\xHH`, `\x{HH}` and escaped punctuation
+
+Anchors, word boundaries, lookaheads, lazy quantifiers, modifiers and Unicode
+classes are rejected with a compile-time error.
+
+Example
+-------
+
+~~~{.cpp}
+    #include <reflex/matcher.h>
+    #include <reflex/static_pattern.h>
+
+    reflex::Matcher matcher(reflex::static_pattern<"[0-9]+\\.[0-9]+|\\w+">::pattern(), "pi 3.14");
+    while (matcher.find())
+      std::cout << matcher.accept() << ": " << matcher.text() << std::endl;
+~~~
+*/
+
+#ifndef REFLEX_STATIC_PATTERN_H
+#define REFLEX_STATIC_PATTERN_H
+
+#if __cplusplus < 202002L && !(defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+# error "reflex/static_pattern.h requires C++20"
+#endif
+
+#include <reflex/pattern.h>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <stdexcept>
+#include <vector>
+
+namespace reflex {
+
+/// A string literal regex passed as a template argument to reflex::static_pattern.
+template<size_t N>
+struct static_regex {
+  constexpr static_regex(const char (&regex)[N])
+  {
+    for (size_t i = 0; i < N; ++i)
+      str[i] = regex[i];
+  }
+  char str[N]; ///< 0-terminated regex string
+};
+
+namespace static_detail {
+
+/// Set of bytes.
+struct Chars {
+  constexpr void add(int lo, int hi)
+  {
+    for (int i = lo >> 6; i <= hi >> 6; ++i)
+    {
+      int a = i == lo >> 6 ? lo & 63 : 0;
+      int b = i == hi >> 6 ? hi & 63 : 63;
+      bits[i] |= (~0ULL >> (63 - b)) & (~0ULL << a);
+    }
+  }
+  constexpr void add(const Chars& chars)
+  {
+    for (int i = 0; i < 4; ++i)
+      bits[i] |= chars.bits[i];
+  }
+  constexpr void flip()
+  {
+    for (int i = 0; i < 4; ++i)
+      bits[i] = ~bits[i];
+  }
+  constexpr bool contains(int c) const
+  {
+    return (bits[c >> 6] >> (c & 63)) & 1;
+  }
+  uint64_t bits[4] = { 0, 0, 0, 0 };
+};
+
+/// Sorted set of positions.
+typedef std::vector<size_t> Positions;
+
+/// Insert the positions of t into s.
+constexpr void insert(Positions& s, const Positions& t)
+{
+  for (size_t p : t)
+  {
+    size_t i = 0;
+    while (i < s.size() && s[i] < p)
+      ++i;
+    if (i == s.size() || s[i] != p)
+      s.insert(s.begin() + i, p);
+  }
+}
+
+/// Subexpression with its nullable, firstpos and lastpos properties.
+struct Node {
+  bool      nullable = true;
+  Positions first;
+  Positions last;
+};
+
+/// Compiles a regex to an opcode table at compile time: a position automaton is parsed from the regex, then the DFA is constructed with subset construction and encoded as opcodes that reflex::Matcher executes.
+class Compiler {
+ public:
+  static const size_t MAX_POSITIONS = 4096; ///< max positions of the regex, including the positions of expanded repeats
+  static const size_t MAX_STATES    = 4096; ///< max DFA states
+  static const size_t MAX_REPEAT    = 255;  ///< max n and m of x{n,m}
+  constexpr Compiler(const char *regex)
+    :
+      rex(regex),
+      loc(0)
+  { }
+  /// Compile the regex.
+  constexpr std::vector<Pattern::Opcode> compile()
+    /// @returns opcode table
+  {
+    // each top-level alternative ends in an accepting position of its subpattern
+    Positions start;
+    Pattern::Accept choice = 0;
+    while (true)
+    {
+      Node node = parse_sequence();
+      Node done = leaf(Chars(), ++choice);
+      node = concat(node, done);
+      insert(start, node.first);
+      if (rex[loc] == '\0')
+        break;
+      if (rex[loc] != '|')
+        throw std::invalid_argument("static_pattern: mismatched )");
+      ++loc;
+    }
+    return encode(start);
+  }
+ private:
+  /// Parse alternatives x|y|... in a group.
+  constexpr Node parse_alternatives()
+  {
+    Node node = parse_sequence();
+    while (rex[loc] == '|')
+    {
+      ++loc;
+      Node next = parse_sequence();
+      insert(node.first, next.first);
+      insert(node.last, next.last);
+      node.nullable = node.nullable || next.nullable;
+    }
+    return node;
+  }
+  /// Parse a sequence xy... up to | or ) or the end.
+  constexpr Node parse_sequence()
+  {
+    Node node;
+    while (rex[loc] != '\0' && rex[loc] != '|' && rex[loc] != ')')
+      node = concat(node, parse_repeat());
+    return node;
+  }
+  /// Parse an atom followed by an optional quantifier.
+  constexpr Node parse_repeat()
+  {
+    size_t from = loc;
+    Node node = parse_atom();
+    char c = rex[loc];
+    if (c == '*' || c == '+' || c == '?')
+    {
+      ++loc;
+      if (c != '?')
+        loop(node);
+      if (c != '+')
+        node.nullable = true;
+    }
+    else if (c == '{')
+    {
+      ++loc;
+      size_t n = parse_number();
+      size_t m = n;
+      if (rex[loc] == ',')
+      {
+        ++loc;
+        m = rex[loc] == '}' ? MAX_REPEAT + 1 : parse_number();
+      }
+      if (rex[loc] != '}' || m < n)
+        throw std::invalid_argument("static_pattern: invalid repeat {n,m}");
+      size_t resume = ++loc;
+      // the atom is parsed again for each copy to give each copy its own positions
+      Node repeat;
+      if (n > 0)
+        repeat = node;
+      for (size_t i = 1; i < n; ++i)
+      {
+        Node copy = parse_atom_at(from);
+        repeat = concat(repeat, copy);
+      }
+      if (m > MAX_REPEAT)
+      {
+        Node copy = parse_atom_at(from);
+        loop(copy);
+        copy.nullable = true;
+        repeat = concat(repeat, copy);
+      }
+      else
+      {
+        for (size_t i = n; i < m; ++i)
+        {
+          Node copy = parse_atom_at(from);
+          copy.nullable = true;
+          repeat = concat(repeat, copy);
+        }
+      }
+      loc = resume;
+      node = repeat;
+    }
+    else
+    {
+      return node;
+    }
+    c = rex[loc];
+    if (c == '?')
+      throw std::invalid_argument("static_pattern: lazy quantifiers are not supported");
+    if (c == '*' || c == '+' || c == '{')
+      throw std::invalid_argument("static_pattern: nested quantifier requires a group");
+    return node;
+  }
+  /// Parse the atom at location from again.
+  constexpr Node parse_atom_at(size_t from)
+  {
+    loc = from;
+    return parse_atom();
+  }
+  /// Parse a decimal number of a repeat.
+  constexpr size_t parse_number()
+  {
+    if (rex[loc] < '0' || rex[loc] > '9')
+      throw std::invalid_argument("static_pattern: invalid repeat {n,m}");
+    size_t n = 0;
+    while (rex[loc] >= '0' && rex[loc] <= '9')
+    {
+      n = 10 * n + (rex[loc++] - '0');
+      if (n > MAX_REPEAT)
+        throw std::invalid_argument("static_pattern: repeat {n,m} exceeds 255");
+    }
+    return n;
+  }
+  /// Parse an atom: a group, a bracket list, a dot, an escape or a byte.
+  constexpr Node parse_atom()
+  {
+    char c = rex[loc++];
+    Chars chars;
+    switch (c)
+    {
+      case '(':
+      {
+        if (rex[loc] == '?')
+        {
+          if (rex[loc + 1] != ':')
+            throw std::invalid_argument("static_pattern: modifiers and lookaheads are not supported");
+          loc += 2;
+        }
+        Node node = parse_alternatives();
+        if (rex[loc] != ')')
+          throw std::invalid_argument("static_pattern: missing )");
+        ++loc;
+        return node;
+      }
+      case '[':
+        parse_list(chars);
+        break;
+      case '.':
+        chars.add(0, '\n' - 1);
+        chars.add('\n' + 1, 255);
+        break;
+      case '\\':
+        parse_escape(chars);
+        break;
+      case '^':
+      case '$':
+        throw std::invalid_argument("static_pattern: anchors are not supported");
+      case '*':
+      case '+':
+      case '?':
+      case '{':
+        throw std::invalid_argument("static_pattern: quantifier without an atom");
+      default:
+        chars.add(static_cast<unsigned char>(c), static_cast<unsigned char>(c));
+    }
+    return leaf(chars, 0);
+  }
+  /// Parse a bracket list after the [.
+  constexpr void parse_list(Chars& chars)
+  {
+    bool negate = rex[loc] == '^';
+    if (negate)
+      ++loc;
+    bool first = true;
+    while (first || rex[loc] != ']')
+    {
+      first = false;
+      if (rex[loc] == '\0')
+        throw std::invalid_argument("static_pattern: missing ]");
+      if (rex[loc] == '[' && rex[loc + 1] == ':')
+        throw std::invalid_argument("static_pattern: POSIX classes are not supported");
+      Chars one;
+      int lo = parse_list_char(one);
+      if (lo >= 0 && rex[loc] == '-' && rex[loc + 1] != ']' && rex[loc + 1] != '\0')
+      {
+        ++loc;
+        int hi = parse_list_char(one);
+        if (hi < lo)
+          throw std::invalid_argument("static_pattern: invalid range in bracket list");
+        one.add(lo, hi);
+      }
+      chars.add(one);
+    }
+    ++loc;
+    if (negate)
+      chars.flip();
+  }
+  /// Parse a byte or an escape of a bracket list, returns the byte or -1 for a class escape.
+  constexpr int parse_list_char(Chars& chars)
+  {
+    char c = rex[loc++];
+    if (c != '\\')
+    {
+      chars.add(static_cast<unsigned char>(c), static_cast<unsigned char>(c));
+      return static_cast<unsigned char>(c);
+    }
+    return parse_escape(chars);
+  }
+  /// Parse an escape after the backslash, returns the byte or -1 for a class escape.
+  constexpr int parse_escape(Chars& chars)
+  {
+    char c = rex[loc++];
+    int b = -1;
+    switch (c)
+    {
+      case 'd':
+      case 'D':
+        chars.add('0', '9');
+        break;
+      case 'w':
+      case 'W':
+        chars.add('0', '9');
+        chars.add('A', 'Z');
+        chars.add('_', '_');
+        chars.add('a', 'z');
+        break;
+      case 's':
+      case 'S':
+        chars.add('\t', '\r');
+        chars.add(' ', ' ');
+        break;
+      case 'h':
+        chars.add('\t', '\t');
+        chars.add(' ', ' ');
+        break;
+      case 'a': b = '\a'; break;
+      case 'e': b = 0x1B; break;
+      case 'f': b = '\f'; break;
+      case 'n': b = '\n'; break;
+      case 'r': b = '\r'; break;
+      case 't': b = '\t'; break;
+      case 'v': b = '\v'; break;
+      case 'x':
+        b = parse_hex();
+        break;
+      case '\0':
+        throw std::invalid_argument("static_pattern: trailing backslash");
+      default:
+        if ((c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z'))
+          throw std::invalid_argument("static_pattern: escape is not supported");
+        b = static_cast<unsigned char>(c);
+    }
+    if (b >= 0)
+    {
+      chars.add(b, b);
+    }
+    else if (c == 'D' || c == 'W' || c == 'S')
+    {
+      // the complement of the class, also when used in a bracket list
+      Chars complement;
+      complement.add(chars);
+      complement.flip();
+      chars = complement;
+    }
+    return b;
+  }
+  /// Parse the hex byte of \xHH or \x{HH}.
+  constexpr int parse_hex()
+  {
+    bool brace = rex[loc] == '{';
+    if (brace)
+      ++loc;
+    int b = 0;
+    int n = 0;
+    while (n < 2)
+    {
+      char c = rex[loc];
+      int d = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 : c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+      if (d < 0)
+        break;
+      b = 16 * b + d;
+      ++loc;
+      ++n;
+    }
+    if (n == 0 || (brace && rex[loc++] != '}'))
+      throw std::invalid_argument("static_pattern: invalid \\x escape");
+    return b;
+  }
+  /// A new position matching the bytes chars, or an accepting position of subpattern choice > 0 matching no bytes.
+  constexpr Node leaf(const Chars& chars, Pattern::Accept choice)
+  {
+    if (pos.size() >= MAX_POSITIONS)
+      throw std::invalid_argument("static_pattern: regex is too large");
+    size_t p = pos.size();
+    pos.push_back(chars);
+    acc.push_back(choice);
+    follow.push_back(Positions());
+    Node node;
+    node.nullable = false;
+    node.first.push_back(p);
+    node.last.push_back(p);
+    return node;
+  }
+  /// Concatenate two subexpressions xy.
+  constexpr Node concat(const Node& x, const Node& y)
+  {
+    for (size_t p : x.last)
+      insert(follow[p], y.first);
+    Node node;
+    node.nullable = x.nullable && y.nullable;
+    node.first = x.first;
+    if (x.nullable)
+      insert(node.first, y.first);
+    node.last = y.last;
+    if (y.nullable)
+      insert(node.last, x.last);
+    return node;
+  }
+  /// Loop a subexpression x back to itself for x* and x+.
+  constexpr void loop(const Node& x)
+  {
+    for (size_t p : x.last)
+      insert(follow[p], x.first);
+  }
+  /// Construct the DFA from the start positions and encode it as opcodes.
+  constexpr std::vector<Pattern::Opcode> encode(const Positions& start)
+  {
+    // position sets of the DFA states are bitsets of w words, followpos is converted to bitsets
+    size_t n = pos.size();
+    size_t w = (n + 63) / 64;
+    std::vector<uint64_t> fol(n * w, 0);
+    std::vector<size_t> accepting;
+    for (size_t p = 0; p < n; ++p)
+    {
+      for (size_t q : follow[p])
+        fol[p * w + q / 64] |= 1ULL << (q % 64);
+      if (acc[p] > 0)
+        accepting.push_back(p);
+    }
+    // subset construction with a hash table of the DFA states
+    std::vector<uint64_t> states(w, 0);
+    for (size_t p : start)
+      states[p / 64] |= 1ULL << (p % 64);
+    std::vector<int> table(64, -1);
+    table[hash(states, 0, w) % table.size()] = 0;
+    std::vector<int> moves; // lo, hi, target state triples of the transitions of each state
+    std::vector<size_t> from(1, 0); // the transitions of state s are moves[from[s]] to moves[from[s + 1] - 1]
+    std::vector<size_t> members; // the positions of the current state
+    std::vector<int> cuts; // the first byte of each byte run of the current state
+    std::vector<uint64_t> next(w, 0); // the position set reached on a byte run from the current state
+    for (size_t s = 0; s < states.size() / w; ++s)
+    {
+      members.clear();
+      for (size_t i = 0; i < w; ++i)
+        for (uint64_t bits = states[s * w + i]; bits != 0; bits &= bits - 1)
+          members.push_back(64 * i + std::countr_zero(bits));
+      // the byte runs lo..hi matched by the same positions of this state, where a byte is a boundary if a position matches it but not the previous byte or vice versa
+      Chars bounds;
+      for (size_t p : members)
+        for (int i = 0; i < 4; ++i)
+          bounds.bits[i] |= pos[p].bits[i] ^ (pos[p].bits[i] << 1 | (i > 0 ? pos[p].bits[i - 1] >> 63 : 0));
+      bounds.bits[0] |= 1;
+      cuts.clear();
+      for (int i = 0; i < 4; ++i)
+        for (uint64_t bits = bounds.bits[i]; bits != 0; bits &= bits - 1)
+          cuts.push_back(64 * i + std::countr_zero(bits));
+      cuts.push_back(256);
+      for (size_t k = 0; k + 1 < cuts.size(); ++k)
+      {
+        int lo = cuts[k];
+        int hi = cuts[k + 1] - 1;
+        for (size_t j = 0; j < w; ++j)
+          next[j] = 0;
+        bool empty = true;
+        for (size_t p : members)
+        {
+          if (pos[p].contains(lo))
+          {
+            for (size_t j = 0; j < w; ++j)
+              next[j] |= fol[p * w + j];
+            empty = false;
+          }
+        }
+        if (!empty)
+        {
+          int target;
+          size_t h = hash(next, 0, w) % table.size();
+          while (table[h] >= 0 && !std::equal(next.begin(), next.end(), states.begin() + table[h] * w))
+            h = (h + 1) % table.size();
+          if (table[h] < 0)
+          {
+            if (states.size() / w >= MAX_STATES)
+              throw std::invalid_argument("static_pattern: DFA is too large");
+            target = static_cast<int>(states.size() / w);
+            table[h] = target;
+            states.insert(states.end(), next.begin(), next.end());
+            if (4 * (states.size() / w) > table.size())
+              rehash(table, states, w);
+          }
+          else
+          {
+            target = table[h];
+          }
+          // merge with the previous adjacent run when it has the same target
+          if (moves.size() > from.back() && moves[moves.size() - 2] == lo - 1 && moves.back() == target)
+          {
+            moves[moves.size() - 2] = hi;
+          }
+          else
+          {
+            moves.push_back(lo);
+            moves.push_back(hi);
+            moves.push_back(target);
+          }
+        }
+      }
+      from.push_back(moves.size());
+    }
+    size_t count = states.size() / w;
+    // a state is a TAKE of the lowest accepted subpattern, if any, followed by GOTO ranges and a HALT
+    std::vector<Pattern::Accept> take(count, 0);
+    std::vector<size_t> index(count + 1, 0);
+    for (size_t s = 0; s < count; ++s)
+    {
+      for (size_t p : accepting)
+        if (((states[s * w + p / 64] >> (p % 64)) & 1) && (take[s] == 0 || acc[p] < take[s]))
+          take[s] = acc[p];
+      index[s + 1] = index[s] + (take[s] > 0) + (from[s + 1] - from[s]) / 3 + 1;
+    }
+    if (index[count] >= Pattern::Const::LONG)
+      throw std::invalid_argument("static_pattern: opcode table is too large");
+    std::vector<Pattern::Opcode> code;
+    for (size_t s = 0; s < count; ++s)
+    {
+      if (take[s] > 0)
+        code.push_back(0xFE000000 | take[s]);
+      for (size_t k = from[s]; k < from[s + 1]; k += 3)
+        code.push_back(static_cast<Pattern::Opcode>(moves[k]) << 24 | static_cast<Pattern::Opcode>(moves[k + 1]) << 16 | static_cast<Pattern::Opcode>(index[moves[k + 2]]));
+      code.push_back(0x00FFFFFF);
+    }
+    return code;
+  }
+  /// Double the size of the hash table of the DFA states.
+  static constexpr void rehash(std::vector<int>& table, const std::vector<uint64_t>& states, size_t w)
+  {
+    table.assign(2 * table.size(), -1);
+    for (size_t t = 0; t < states.size() / w; ++t)
+    {
+      size_t h = hash(states, t * w, w) % table.size();
+      while (table[h] >= 0)
+        h = (h + 1) % table.size();
+      table[h] = static_cast<int>(t);
+    }
+  }
+  /// FNV-1a hash of a position set bitset of w words at k.
+  static constexpr size_t hash(const std::vector<uint64_t>& bits, size_t k, size_t w)
+  {
+    uint64_t h = 0xCBF29CE484222325ULL;
+    for (size_t i = k; i < k + w; ++i)
+      h = (h ^ bits[i]) * 0x100000001B3ULL;
+    return static_cast<size_t>(h ^ (h >> 32));
+  }
+  const char            *rex;    ///< regex string
+  size_t                 loc;    ///< location in the regex string
+  std::vector<Chars>     pos;    ///< bytes matched by each position
+  std::vector<Pattern::Accept> acc; ///< subpattern accepted by each position, 0 if not accepting
+  std::vector<Positions> follow; ///< followpos of each position
+};
+
+} // namespace static_detail
+
+/// Opcode table compiled from a string literal regex at compile time, e.g. reflex::static_pattern<"[0-9]+">::pattern().
+template<static_regex R>
+struct static_pattern {
+  static constexpr size_t size = static_detail::Compiler(R.str).compile().size(); ///< number of opcode words
+  static constexpr std::array<Pattern::Opcode,size> opcodes = []
+  {
+    std::vector<Pattern::Opcode> code = static_detail::Compiler(R.str).compile();
+    std::array<Pattern::Opcode,size> table = { };
+    for (size_t i = 0; i < size; ++i)
+      table[i] = code[i];
+    return table;
+  }(); ///< opcode table in read-only data
+  static constexpr const Pattern::Opcode *code = opcodes.data(); ///< opcode table for the reflex::Pattern(const Opcode*) constructor
+  /// Returns the pattern of this opcode table, constructed when first used.
+  static const Pattern& pattern()
+    /// @returns reflex::Pattern
+  {
+    static const Pattern pattern(code);
+    return pattern;
+  }
+};
+
+} // namespace reflex
+
+#endif
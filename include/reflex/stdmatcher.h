@@ -38,6 +38,7 @@
 #define REFLEX_STDMATCHER_H
 
 #include <reflex/absmatcher.h>
+#include <reflex/matcher.h>
 #include <regex>
 
 namespace reflex {
@@ -52,7 +53,11 @@ class StdMatcher : public PatternMatcher<std::regex> {
     return reflex::convert(regex, "!=:bcdfnrstvwxBDSW?", flags);
   }
   /// Default constructor.
-  StdMatcher() : PatternMatcher<std::regex>()
+  StdMatcher()
+    :
+      PatternMatcher<std::regex>(),
+      prp_(NULL),
+      prm_(NULL)
   {
     reset();
   }
@@ -61,10 +66,12 @@ class StdMatcher : public PatternMatcher<std::regex> {
   StdMatcher(
       const P     *pattern,         ///< points to a std::regex or a string regex for this matcher
       const Input& input = Input(), ///< input character sequence for this matcher
-      const char  *opt = NULL)      ///< option string of the form `(A|N|T(=[[:digit:]])?|;)*`
+      const char  *opt = NULL)      ///< option string of the form `(A|N|R|T(=[[:digit:]])?|;)*`
     :
       PatternMatcher(pattern, input, opt),
-      flg_()
+      flg_(),
+      prp_(NULL),
+      prm_(NULL)
   {
     reset();
   }
@@ -73,10 +80,12 @@ class StdMatcher : public PatternMatcher<std::regex> {
   StdMatcher(
       const P&     pattern,         ///< a std::regex or a string regex for this matcher
       const Input& input = Input(), ///< input character sequence for this matcher
-      const char  *opt = NULL)      ///< option string of the form `(A|N|T(=[[:digit:]])?|;)*`
+      const char  *opt = NULL)      ///< option string of the form `(A|N|R|T(=[[:digit:]])?|;)*`
     :
       PatternMatcher(pattern, input, opt),
-      flg_()
+      flg_(),
+      prp_(NULL),
+      prm_(NULL)
   {
     reset();
   }
@@ -84,13 +93,23 @@ class StdMatcher : public PatternMatcher<std::regex> {
   StdMatcher(const StdMatcher& matcher) ///< matcher to copy
     :
       PatternMatcher<std::regex>(matcher),
-      flg_(matcher.flg_)
-  { }
+      flg_(matcher.flg_),
+      prp_(NULL),
+      prm_(NULL)
+  {
+    copy_prefilter(&matcher);
+  }
+  /// Delete matcher.
+  virtual ~StdMatcher()
+  {
+    copy_prefilter(NULL);
+  }
   /// Assign a matcher.
   StdMatcher& operator=(const StdMatcher& matcher) ///< matcher to copy
   {
     PatternMatcher<std::regex>::operator=(matcher);
     flg_ = matcher.flg_;
+    copy_prefilter(&matcher);
     return *this;
   }
   /// Polymorphic cloning.
@@ -107,6 +126,31 @@ class StdMatcher : public PatternMatcher<std::regex> {
     PatternMatcher::reset(opt);
     buffer(); // no partial matching supported: buffer all input
   }
+  /// Set a RE/flex regex to skip ahead with find() to possible matches predicted by the RE/flex pattern prefilter, the regex should match at least the strings matched by the std::regex, or NULL to remove the prefilter.
+  bool prefilter(const char *regex) ///< RE/flex regex or NULL
+    /// @returns true if the prefilter is used, false when the regex is NULL or not supported by RE/flex
+  {
+    itr_ = fin_;
+    copy_prefilter(NULL);
+    if (regex == NULL)
+      return false;
+    try
+    {
+      prp_ = new reflex::Pattern(reflex::Matcher::convert(regex, convert_flag::none), "r"); // throws on backreferences and other unsupported regex syntax
+    }
+    catch (const regex_error&)
+    {
+      return false;
+    }
+    prm_ = new reflex::Matcher(*prp_, Input(), "R");
+    return true;
+  }
+  /// Set a RE/flex regex to skip ahead with find() to possible matches predicted by the RE/flex pattern prefilter, the regex should match at least the strings matched by the std::regex.
+  bool prefilter(const std::string& regex) ///< RE/flex regex
+    /// @returns true if the prefilter is used, false when the regex is not supported by RE/flex
+  {
+    return prefilter(regex.c_str());
+  }
   using PatternMatcher::pattern;
   /// Set the pattern to use with this matcher as a shared pointer to another matcher pattern.
   virtual PatternMatcher& pattern(const StdMatcher& matcher) ///< the other matcher
@@ -192,7 +236,7 @@ class StdMatcher : public PatternMatcher<std::regex> {
     cur_ = pos_; // reset cur_ when changed in more()
     if (itr_ != fin_) // if regex iterator is still valid then
     {
-      if ((*itr_)[0].second == buf_ + pos_) // if last of regex iterator is still valid in buf_[] then
+      if ((*itr_)[0].second == buf_ + pos_ && !prefiltered(method)) // if last of regex iterator is still valid in buf_[] and not prefiltered then
       {
         DBGLOGN("Continue iterating, pos = %zu", pos_);
         ++itr_;
@@ -223,7 +267,7 @@ class StdMatcher : public PatternMatcher<std::regex> {
     {
       if (pos_ == end_ && !eof_)
       {
-        if (end_ + blk_ + 1 >= max_ && grow()) // make sure we have enough storage to read input
+        if (end_ + tal_ + blk_ + 1 >= max_ && grow()) // make sure we have enough storage to read input
           itr_ = fin_; // buffer shifting/growing invalidates iterator
         (void)peek_more();
         DBGLOGN("Got more input pos = %zu end = %zu max = %zu", pos_, end_, max_);
@@ -358,12 +402,55 @@ class StdMatcher : public PatternMatcher<std::regex> {
     else if (method == Const::MATCH)
       flg |= std::regex_constants::match_continuous;
     ASSERT(pat_ != NULL);
+    if (prefiltered(method))
+    {
+      // match at the positions predicted by the prefilter, until a match is found
+      prm_->buffer(buf_, end_ + 1);
+      size_t loc = txt_ - buf_;
+      while ((loc = prm_->predict(loc)) < end_)
+      {
+        std::regex_constants::match_flag_type f = flg | std::regex_constants::match_continuous;
+        if (buf_ + loc > txt_)
+          f |= std::regex_constants::match_prev_avail; // as if searched from txt_
+        itr_ = std::cregex_iterator(buf_ + loc, buf_ + end_, *pat_, f);
+        if (itr_ != fin_ && (*itr_)[0].matched)
+          return;
+        ++loc;
+      }
+      itr_ = fin_;
+      return;
+    }
     itr_ = std::cregex_iterator(txt_, buf_ + end_, *pat_, flg);
   }
+  /// Returns true if find() uses the prefilter, which requires all input in the buffer and nonempty matches.
+  bool prefiltered(Method method) const
+    /// @returns true if prefiltered
+  {
+    return prm_ != NULL && method == Const::FIND && !opt_.N && in.eof();
+  }
+  /// Copy the prefilter of the given matcher or remove the prefilter when NULL.
+  void copy_prefilter(const StdMatcher *matcher) ///< matcher with prefilter or NULL
+  {
+    if (matcher == this)
+      return;
+    if (prm_ != NULL)
+      delete prm_;
+    if (prp_ != NULL)
+      delete prp_;
+    prp_ = NULL;
+    prm_ = NULL;
+    if (matcher != NULL && matcher->prp_ != NULL)
+    {
+      prp_ = new reflex::Pattern(*matcher->prp_);
+      prm_ = new reflex::Matcher(*prp_, Input(), "R");
+    }
+  }
   std::regex_constants::match_flag_type flg_; ///< std::regex match flags
   std::cregex_iterator                  itr_; ///< const std::regex iterator
   std::cregex_iterator                  fin_; ///< const std::regex iterator final end
   size_t                                grp_; ///< last group index for group_next_id()
+  reflex::Pattern                      *prp_; ///< RE/flex pattern of the prefilter or NULL
+  reflex::Matcher                      *prm_; ///< RE/flex matcher to predict matches with the prefilter or NULL
 };
 
 /// std matcher engine class, extends reflex::StdMatcher for ECMA std::regex::ECMAScript syntax and regex matching.
@@ -379,7 +466,7 @@ class StdEcmaMatcher : public StdMatcher {
   StdEcmaMatcher(
       const char  *pattern,         ///< a string regex for this matcher
       const Input& input = Input(), ///< input character sequence for this matcher
-      const char  *opt = NULL)      ///< option string of the form `(A|N|T(=[[:digit:]])?|;)*`
+      const char  *opt = NULL)      ///< option string of the form `(A|N|R|T(=[[:digit:]])?|;)*`
     :
       StdMatcher(new std::regex(pattern, std::regex::ECMAScript), input, opt)
   {
@@ -389,7 +476,7 @@ class StdEcmaMatcher : public StdMatcher {
   StdEcmaMatcher(
       const std::string& pattern,         ///< a string regex for this matcher
       const Input&       input = Input(), ///< input character sequence for this matcher
-      const char        *opt = NULL)      ///< option string of the form `(A|N|T(=[[:digit:]])?|;)*`
+      const char        *opt = NULL)      ///< option string of the form `(A|N|R|T(=[[:digit:]])?|;)*`
     :
       StdMatcher(new std::regex(pattern, std::regex::ECMAScript), input, opt)
   {
@@ -399,7 +486,7 @@ class StdEcmaMatcher : public StdMatcher {
   StdEcmaMatcher(
       const Pattern& pattern,         ///< a std::regex for this matcher
       const Input&   input = Input(), ///< input character sequence for this matcher
-      const char    *opt = NULL)      ///< option string of the form `(A|N|T(=[[:digit:]])?|;)*`
+      const char    *opt = NULL)      ///< option string of the form `(A|N|R|T(=[[:digit:]])?|;)*`
     :
       StdMatcher(&pattern, input, opt)
   {
@@ -460,7 +547,7 @@ class StdPosixMatcher : public StdMatcher {
   StdPosixMatcher(
       const char  *pattern,         ///< a string regex for this matcher
       const Input& input = Input(), ///< input character sequence for this matcher
-      const char  *opt = NULL)      ///< option string of the form `(A|N|T(=[[:digit:]])?|;)*`
+      const char  *opt = NULL)      ///< option string of the form `(A|N|R|T(=[[:digit:]])?|;)*`
     :
       StdMatcher(new std::regex(pattern, std::regex::awk), input, opt)
   {
@@ -470,7 +557,7 @@ class StdPosixMatcher : public StdMatcher {
   StdPosixMatcher(
       const std::string& pattern,         ///< a string regex for this matcher
       const Input&       input = Input(), ///< input character sequence for this matcher
-      const char        *opt = NULL)      ///< option string of the form `(A|N|T(=[[:digit:]])?|;)*`
+      const char        *opt = NULL)      ///< option string of the form `(A|N|R|T(=[[:digit:]])?|;)*`
     :
       StdMatcher(new std::regex(pattern, std::regex::awk), input, opt)
   {
@@ -480,7 +567,7 @@ class StdPosixMatcher : public StdMatcher {
   StdPosixMatcher(
       const Pattern& pattern,         ///< a std::regex for this matcher
       const Input&   input = Input(), ///< input character sequence for this matcher
-      const char    *opt = NULL)      ///< option string of the form `(A|N|T(=[[:digit:]])?|;)*`
+      const char    *opt = NULL)      ///< option string of the form `(A|N|R|T(=[[:digit:]])?|;)*`
     :
       StdMatcher(&pattern, input, opt)
   {
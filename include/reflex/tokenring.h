@@ -0,0 +1,369 @@
+/******************************************************************************\
+* Copyright (c) 2016, Robert van Engelen, Genivia Inc. All rights reserved.    *
+*                                                                              *
+* Redistribution and use in source and binary forms, with or without           *
+* modification, are permitted provided that the following conditions are met:  *
+*                                                                              *
+*   (1) Redistributions of source code must retain the above copyright notice, *
+*       this list of conditions and the following disclaimer.                  *
+*                                                                              *
+*   (2) Redistributions in binary form must reproduce the above copyright      *
+*       notice, this list of conditions and the following disclaimer in the    *
+*       documentation and/or other materials provided with the distribution.   *
+*                                                                              *
+*   (3) The name of the author may not be used to endorse or promote products  *
+*       derived from this software without specific prior written permission.  *
+*                                                                              *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED *
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF         *
+* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO   *
+* EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       *
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, *
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;  *
+* OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,     *
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR      *
+* OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF       *
+* ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                   *
+\******************************************************************************/
+/**
+@file      tokenring.h
+@brief     RE/flex token ring to pass tokens in batches from a lexer to a parser
+@author    Robert van Engelen - engelen@genivia.com
+@copyright (c) 2016-2020, Robert van Engelen, Genivia Inc. All rights reserved.
+@copyright (c) BSD-3 License - see LICENSE.txt
+
+Usage
+-----
+
+`reflex::TokenRing<Lexer>` is a fixed-size ring of tokens filled by the
+`lex_batch()` method of a lexer generated with option `--lex-batch`.  The ring
+returns the tokens to the parser one at a time with `next()` and refills when
+all tokens were consumed, so the lexer and parser loops take turns in batches
+instead of alternating for every token.
+
+A token in the ring is just a token value, an offset and length of the text in
+the matcher buffer, and a line number.  The text is materialized only when
+requested with `str()`, or later with `reflex::TokenRing<Lexer>::Lexeme::str()`
+from a lexeme stored in a semantic value, typically in a bison parser action.
+The column number is counted on request with `columno()`.
+
+The ring pins the text of the tokens of the current and the previous batch.
+When the matcher shifts its buffer, the pinned bytes that are shifted out are
+kept by the ring, so a lexeme of a token returned at most `N` tokens ago always
+has its text.  The ring uses the matcher's event handler to do so, requiring
+compile-time option `WITH_SPAN` (the default) and replacing a handler set with
+`set_handler()`.
+
+Example
+-------
+
+    // a bison yylex() without semantic value construction, YYSTYPE is reflex::TokenRing<Lexer>::Lexeme
+    static Lexer lexer(stdin);
+    static reflex::TokenRing<Lexer> ring(lexer);
+
+    int yylex(YYSTYPE *lvalp)
+    {
+      int token = ring.next();
+      *lvalp = ring.lexeme();
+      return token;
+    }
+
+    // a grammar action materializes the text of a token: { $$ = lookup($1.str()); }
+
+*/
+
+#ifndef REFLEX_TOKENRING_H
+#define REFLEX_TOKENRING_H
+
+#include <reflex/absmatcher.h>
+#include <string>
+
+namespace reflex {
+
+#if defined(WITH_SPAN)
+
+/// A fixed-size ring of tokens filled in batches by a lexer generated with option --lex-batch.
+template<
+    typename L,       ///< @tparam <L> lexer class with lex_batch(), has_matcher() and matcher()
+    typename T = int, ///< @tparam <T> token type of the lexer
+    size_t   N = 256> ///< @tparam <N> number of tokens in the ring
+class TokenRing {
+ public:
+  /// The lex_batch() method of the lexer, or yylex_batch() with option --flex.
+  typedef size_t (L::*Batch)(T*, size_t*, size_t*, size_t*, size_t);
+  /// The lazily materialized text of a token, to store in a semantic value.
+  class Lexeme {
+   public:
+    /// Construct empty lexeme.
+    Lexeme()
+      :
+        ring_(NULL),
+        off_(0),
+        len_(0)
+    { }
+    /// Construct lexeme of a token.
+    Lexeme(
+        const TokenRing *ring, ///< the token ring
+        size_t           off,  ///< offset of the token text in the input
+        size_t           len)  ///< length of the token text
+      :
+        ring_(ring),
+        off_(off),
+        len_(len)
+    { }
+    /// Returns the text of the token, must be used within N tokens after the token was returned by next().
+    std::string str() const
+      /// @returns string with the text of the token
+    {
+      return ring_ != NULL ? ring_->text(off_, len_) : std::string();
+    }
+    /// Returns the position of the token in the input, like AbstractMatcher::first().
+    size_t first() const
+      /// @returns position in the input character sequence
+    {
+      return off_;
+    }
+    /// Returns the length of the token text in bytes.
+    size_t size() const
+      /// @returns length of the text
+    {
+      return len_;
+    }
+   private:
+    const TokenRing *ring_; ///< the token ring
+    size_t           off_;  ///< offset of the token text in the input
+    size_t           len_;  ///< length of the token text
+  };
+  /// Construct a token ring for a lexer.
+  TokenRing(
+      L&    lexer,                  ///< the lexer to fill the ring
+      T     eof = T(),              ///< the token value returned by next() at the end of the input
+      Batch batch = &L::lex_batch)  ///< the lex_batch() method of the lexer
+    :
+      lexer_(lexer),
+      batch_(batch),
+      eof_(eof),
+      pin_(this)
+  {
+    clear();
+  }
+  /// Forget the tokens, e.g. after switching the input of the lexer.
+  void clear()
+  {
+    len_ = 0;
+    cur_ = 0;
+    end_ = false;
+    pof_ = 0;
+    ach_ = 0;
+    acn_ = 0;
+    cof_ = 0;
+    cno_ = 0;
+    arc_.clear();
+    aof_ = 0;
+  }
+  /// Returns the next token, refills the ring in a batch when all tokens were consumed.
+  T next()
+    /// @returns the next token or the eof token value at the end of the input
+  {
+    if (cur_ >= len_ && !fill())
+      return eof_;
+    return tokens_[cur_++];
+  }
+  /// Returns the lexeme of the token last returned by next(), to store in a semantic value.
+  Lexeme lexeme() const
+    /// @returns lexeme of the token
+  {
+    return cur_ > 0 ? Lexeme(this, offsets_[cur_ - 1], lengths_[cur_ - 1]) : Lexeme();
+  }
+  /// Returns the text of the token last returned by next().
+  std::string str() const
+    /// @returns string with the text of the token
+  {
+    return cur_ > 0 ? text(offsets_[cur_ - 1], lengths_[cur_ - 1]) : std::string();
+  }
+  /// Returns the position of the token last returned by next() in the input.
+  size_t first() const
+    /// @returns position in the input character sequence
+  {
+    return cur_ > 0 ? offsets_[cur_ - 1] : 0;
+  }
+  /// Returns the length of the text of the token last returned by next().
+  size_t size() const
+    /// @returns length of the text
+  {
+    return cur_ > 0 ? lengths_[cur_ - 1] : 0;
+  }
+  /// Returns the line number of the token last returned by next().
+  size_t lineno() const
+    /// @returns line number
+  {
+    return cur_ > 0 ? lines_[cur_ - 1] : 1;
+  }
+  /// Returns the column number of the token last returned by next(), counted on request from the previous token for which the column number was requested or from the start of the batch.
+  size_t columno()
+    /// @returns column number
+  {
+    if (cur_ == 0)
+      return 0;
+    size_t off = offsets_[cur_ - 1];
+    if (cof_ < ach_ || cof_ > off)
+    {
+      cof_ = ach_;
+      cno_ = acn_;
+    }
+    char tabs = lexer_.has_matcher() ? lexer_.matcher().tabs() : 8;
+    while (cof_ < off)
+    {
+      size_t len = off - cof_;
+      const char *s = bytes(cof_, len);
+      if (s == NULL)
+        break;
+      const char *e = s + len;
+      for (; s < e; ++s)
+      {
+        if (*s == '\n')
+          cno_ = 0;
+        else if (*s == '\t')
+          cno_ += 1 + (~cno_ & (tabs - 1));
+        else
+          cno_ += (*s & 0xC0) != 0x80;
+      }
+      cof_ += len;
+    }
+    return cno_;
+  }
+  /// Returns the pinned text at an offset in the input, which is the text of a token returned at most N tokens ago.
+  std::string text(
+      size_t off, ///< offset of the text in the input
+      size_t len) ///< length of the text
+    const
+    /// @returns string with the text
+  {
+    std::string str;
+    while (len > 0)
+    {
+      size_t n = len;
+      const char *s = bytes(off, n);
+      if (s == NULL)
+        break;
+      str.append(s, n);
+      off += n;
+      len -= n;
+    }
+    return str;
+  }
+ protected:
+  /// Matcher event handler to keep the pinned bytes that are shifted out of the matcher buffer.
+  struct Pin : public AbstractMatcher::Handler {
+    Pin(TokenRing *ring)
+      :
+        ring(ring)
+    { }
+    void operator()(AbstractMatcher&, const char *buf, size_t len, size_t num)
+    {
+      ring->keep(buf, len, num);
+    }
+    TokenRing *ring; ///< the token ring
+  };
+  /// Fill the ring with the next batch of tokens, the tokens of the previous batch remain pinned.
+  bool fill()
+    /// @returns true if the ring has tokens
+  {
+    cur_ = 0;
+    if (end_)
+    {
+      len_ = 0;
+      return false;
+    }
+    // pin the text of the tokens of the previous batch and release the bytes kept before them
+    pof_ = len_ > 0 ? offsets_[0] : ach_;
+    if (!arc_.empty() && aof_ < pof_)
+    {
+      size_t n = pof_ - aof_ < arc_.size() ? pof_ - aof_ : arc_.size();
+      arc_.erase(0, n);
+      aof_ += n;
+    }
+    size_t k = 0;
+    if (!lexer_.has_matcher())
+    {
+      // the lexer creates its matcher when scanning the first token
+      ach_ = 0;
+      acn_ = 0;
+      k = (lexer_.*batch_)(tokens_, offsets_, lengths_, lines_, 1);
+    }
+    else
+    {
+      // columns are counted from the last token matched
+      ach_ = lexer_.matcher().first();
+      acn_ = lexer_.matcher().columno();
+    }
+    if (lexer_.has_matcher())
+    {
+      lexer_.matcher().set_handler(&pin_);
+      k += (lexer_.*batch_)(tokens_ + k, offsets_ + k, lengths_ + k, lines_ + k, N - k);
+    }
+    len_ = k;
+    end_ = k < N;
+    return k > 0;
+  }
+  /// Keep the pinned bytes that are shifted out of the matcher buffer.
+  void keep(
+      const char *buf, ///< the bytes shifted out
+      size_t      len, ///< number of bytes
+      size_t      num) ///< offset of the bytes in the input
+  {
+    if (num + len <= pof_)
+      return;
+    size_t skip = num < pof_ ? pof_ - num : 0;
+    if (arc_.empty() || aof_ + arc_.size() != num + skip)
+    {
+      arc_.clear();
+      aof_ = num + skip;
+    }
+    arc_.append(buf + skip, len - skip);
+  }
+  /// Returns the pinned bytes at an offset in the input, kept by the ring or in the matcher buffer.
+  const char *bytes(
+      size_t  off, ///< offset in the input
+      size_t& len) ///< number of bytes requested, set to the number of contiguous bytes available
+    const
+    /// @returns pointer to the bytes or NULL when not pinned
+  {
+    if (off >= aof_ && off < aof_ + arc_.size())
+    {
+      if (len > aof_ + arc_.size() - off)
+        len = aof_ + arc_.size() - off;
+      return arc_.data() + (off - aof_);
+    }
+    if (!lexer_.has_matcher())
+      return NULL;
+    AbstractMatcher::Context context = lexer_.matcher().before();
+    if (off < context.num)
+      return NULL;
+    return context.buf + (off - context.num);
+  }
+  L&          lexer_;       ///< the lexer to fill the ring
+  Batch       batch_;       ///< the lex_batch() method of the lexer
+  T           eof_;         ///< the token value returned by next() at the end of the input
+  Pin         pin_;         ///< matcher event handler to keep pinned bytes shifted out of the matcher buffer
+  T           tokens_[N];   ///< token values
+  size_t      offsets_[N];  ///< token text offsets in the input
+  size_t      lengths_[N];  ///< token text lengths
+  size_t      lines_[N];    ///< token line numbers
+  size_t      len_;         ///< number of tokens in the ring
+  size_t      cur_;         ///< index of the next token returned by next()
+  bool        end_;         ///< true when the last batch reached the end of the input
+  size_t      pof_;         ///< offset in the input of the first pinned byte
+  size_t      ach_;         ///< offset in the input of the last token matched before the current batch
+  size_t      acn_;         ///< column number at TokenRing::ach_
+  size_t      cof_;         ///< offset in the input of the last column counted by columno()
+  size_t      cno_;         ///< column number at TokenRing::cof_
+  std::string arc_;         ///< pinned bytes shifted out of the matcher buffer
+  size_t      aof_;         ///< offset in the input of the first byte in TokenRing::arc_
+};
+
+#endif
+
+} // namespace reflex
+
+#endif
@@ -43,14 +43,18 @@ namespace reflex {
 
 namespace Unicode {
 
-class Tables : public Posix::Tables {
- public:
-  Tables();
- private:
-  void block_scripts(void);
-  void language_scripts(void);
-  void letter_scripts(void);
-};
+/// Unicode block ranges IsBlockName, sorted by name, generated from Blocks.txt.
+extern const Posix::Entry block_scripts[];
+/// Number of entries in block_scripts.
+extern const size_t block_scripts_size;
+/// Unicode language script and category ranges, sorted by name, generated from Scripts.txt.
+extern const Posix::Entry language_scripts[];
+/// Number of entries in language_scripts.
+extern const size_t language_scripts_size;
+/// Unicode letter category ranges Ll, Lt and Lu, sorted by name, generated from UnicodeData.txt.
+extern const Posix::Entry letter_scripts[];
+/// Number of entries in letter_scripts.
+extern const size_t letter_scripts_size;
 
 const int * range(const char *);
 
@@ -264,6 +264,13 @@ inline std::wstring wcs(const std::string& s) ///< string with UTF-8 to convert
   return wcs(s.c_str(), s.size());
 }
 
+/// Check if a string contains a NUL or invalid UTF-8, i.e. binary content, permits an incomplete UTF-8 sequence at the end of the string that may continue in the next block of input.
+bool is_binary(
+    const char *s, ///< points to the string to check
+    size_t      n) ///< length of the string
+  /// @returns true if the string contains a NUL or invalid UTF-8
+  ;
+
 } // namespace reflex
 
 #endif
@@ -0,0 +1,313 @@
+/******************************************************************************\
+* Copyright (c) 2016, Robert van Engelen, Genivia Inc. All rights reserved.    *
+*                                                                              *
+* Redistribution and use in source and binary forms, with or without           *
+* modification, are permitted provided that the following conditions are met:  *
+*                                                                              *
+*   (1) Redistributions of source code must retain the above copyright notice, *
+*       this list of conditions and the following disclaimer.                  *
+*                                                                              *
+*   (2) Redistributions in binary form must reproduce the above copyright      *
+*       notice, this list of conditions and the following disclaimer in the    *
+*       documentation and/or other materials provided with the distribution.   *
+*                                                                              *
+*   (3) The name of the author may not be used to endorse or promote products  *
+*       derived from this software without specific prior written permission.  *
+*                                                                              *
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR IMPLIED *
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF         *
+* MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO   *
+* EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       *
+* SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, *
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;  *
+* OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,     *
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR      *
+* OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF       *
+* ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                                   *
+\******************************************************************************/
+
+/**
+@file      zstream.h
+@brief     RE/flex std::streambuf to read compressed files with zlib
+@author    Robert van Engelen - engelen@genivia.com
+@copyright (c) 2016-2020, Robert van Engelen, Genivia Inc. All rights reserved.
+@copyright (c) BSD-3 License - see LICENSE.txt
+*/
+
+#ifndef REFLEX_ZSTREAM_H
+#define REFLEX_ZSTREAM_H
+
+#include <cstdio>
+#include <cstring>
+#include <streambuf>
+#include <zlib.h>
+
+#if defined(OS_WIN) || defined(_WIN32)
+# include <io.h>
+# define REFLEX_ZSTREAM_DUP _dup
+# define REFLEX_ZSTREAM_CLOSE _close
+#else
+# include <unistd.h>
+# define REFLEX_ZSTREAM_DUP dup
+# define REFLEX_ZSTREAM_CLOSE close
+#endif
+
+#if __cplusplus >= 201103L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201103L)
+# define WITH_ZSTREAM_THREAD
+# include <condition_variable>
+# include <mutex>
+# include <thread>
+#endif
+
+namespace reflex {
+
+/// std::streambuf to read a gzip compressed FILE* decompressed with zlib, or an uncompressed FILE* as is.
+/**
+The gzip magic bytes are detected by zlib, uncompressed input is read as is.
+Decompressed data is stored directly in the buffer of the caller of `sgetn()`
+when the caller reads a block, which is the case for a matcher reading from a
+`std::istream` constructed with this streambuf.
+
+With C++11 or greater, a helper thread decompresses the input ahead of the
+reader when `zstreambuf(file, true)` is used, to decompress the next block
+while the matcher scans the current block.
+
+The FILE* is not closed by the streambuf and should not have been read before,
+because the streambuf reads a duplicate of the file descriptor.  Link with
+`-lz`.
+
+Example:
+
+@code
+    FILE *file = fopen("log.gz", "rb");
+    reflex::zstreambuf streambuf(file);
+    std::istream stream(&streambuf);
+    reflex::Matcher matcher("\\w+", stream);
+    while (matcher.find() != 0)
+      std::cout << matcher.text() << std::endl;
+    fclose(file);
+@endcode
+*/
+class zstreambuf : public std::streambuf {
+ public:
+  static const size_t BLOCK = (256*1024); ///< size of the decompressed blocks, same as AbstractMatcher::Const::BLOCK
+  /// Construct a streambuf to read a compressed or uncompressed FILE*.
+  zstreambuf(
+      FILE *file,             ///< the FILE* to read
+      bool  threaded = false) ///< decompress ahead in a helper thread (requires C++11 or greater)
+    :
+      gzf_(Z_NULL),
+      err_(false)
+#ifdef WITH_ZSTREAM_THREAD
+      ,
+      rah_(NULL)
+#endif
+  {
+    int fd = file != NULL ? REFLEX_ZSTREAM_DUP(fileno(file)) : -1;
+    if (fd >= 0 && (gzf_ = gzdopen(fd, "r")) != Z_NULL)
+      gzbuffer(gzf_, BLOCK);
+    else if (fd >= 0)
+      REFLEX_ZSTREAM_CLOSE(fd);
+    setg(buf_, buf_, buf_);
+#ifdef WITH_ZSTREAM_THREAD
+    if (threaded && gzf_ != Z_NULL)
+    {
+      rah_ = new ReadAhead;
+      rah_->reader = std::thread(&zstreambuf::decompress, this);
+    }
+#else
+    (void)threaded;
+#endif
+  }
+  /// Delete the streambuf, stops the helper thread and closes the duplicate file descriptor.
+  virtual ~zstreambuf()
+  {
+#ifdef WITH_ZSTREAM_THREAD
+    if (rah_ != NULL)
+    {
+      {
+        std::lock_guard<std::mutex> lock(rah_->mutex);
+        rah_->stop = true;
+      }
+      rah_->cond.notify_all();
+      rah_->reader.join();
+      delete rah_;
+    }
+#endif
+    if (gzf_ != Z_NULL)
+      gzclose_r(gzf_);
+  }
+  /// Returns true if a read error or decompression error occurred.
+  bool error() const
+  {
+    return err_;
+  }
+ protected:
+  /// Fill the get area with decompressed data.
+  virtual int_type underflow()
+  {
+    if (gptr() < egptr())
+      return traits_type::to_int_type(*gptr());
+    size_t k = get(buf_, sizeof(buf_));
+    setg(buf_, buf_, buf_ + k);
+    return k > 0 ? traits_type::to_int_type(*gptr()) : traits_type::eof();
+  }
+  /// Returns -1 at the end of the input, or zero when data may be available.
+  virtual std::streamsize showmanyc()
+  {
+    return egptr() > gptr() ? egptr() - gptr() : gzf_ == Z_NULL ? -1 : 0;
+  }
+  /// Read up to n bytes into s, decompressing blocks directly into s.
+  virtual std::streamsize xsgetn(char *s, std::streamsize n)
+  {
+    std::streamsize k = egptr() - gptr();
+    if (k > n)
+      k = n;
+    std::memcpy(s, gptr(), static_cast<size_t>(k));
+    gbump(static_cast<int>(k));
+    while (k < n)
+    {
+      size_t m = static_cast<size_t>(n - k);
+      if (m < sizeof(buf_))
+      {
+        if (underflow() == traits_type::eof())
+          break;
+        std::streamsize l = egptr() - gptr();
+        if (l > n - k)
+          l = n - k;
+        std::memcpy(s + k, gptr(), static_cast<size_t>(l));
+        gbump(static_cast<int>(l));
+        k += l;
+      }
+      else
+      {
+        size_t l = get(s + k, m);
+        if (l == 0)
+          break;
+        k += l;
+      }
+    }
+    return k;
+  }
+  /// Store up to n decompressed bytes in s.
+  size_t get(
+      char  *s, ///< points to the buffer to fill
+      size_t n) ///< size of the buffer
+    /// @returns the number of bytes stored in s, zero at the end of the input
+  {
+    if (gzf_ == Z_NULL)
+      return 0;
+#ifdef WITH_ZSTREAM_THREAD
+    if (rah_ != NULL)
+    {
+      std::unique_lock<std::mutex> lock(rah_->mutex);
+      while (rah_->count == 0 && !rah_->done)
+        rah_->cond.wait(lock);
+      if (rah_->count == 0)
+      {
+        err_ = rah_->error;
+        return 0;
+      }
+      size_t k = rah_->size[rah_->head] - rah_->pos;
+      if (k > n)
+        k = n;
+      std::memcpy(s, rah_->block[rah_->head] + rah_->pos, k);
+      rah_->pos += k;
+      if (rah_->pos >= rah_->size[rah_->head])
+      {
+        // release the block to the helper thread
+        rah_->head ^= 1;
+        rah_->pos = 0;
+        --rah_->count;
+        lock.unlock();
+        rah_->cond.notify_all();
+      }
+      return k;
+    }
+#endif
+    size_t k = read(s, n);
+    if (k == 0)
+      err_ = failed();
+    return k;
+  }
+  /// Decompress up to n bytes into s with gzread.
+  size_t read(char *s, size_t n)
+  {
+    if (n > BLOCK)
+      n = BLOCK;
+    int k = gzread(gzf_, s, static_cast<unsigned>(n));
+    return k > 0 ? static_cast<size_t>(k) : 0;
+  }
+  /// Returns true if gzread failed, including when the compressed input is truncated.
+  bool failed()
+  {
+    int err = Z_OK;
+    gzerror(gzf_, &err);
+    return err != Z_OK;
+  }
+#ifdef WITH_ZSTREAM_THREAD
+  /// Helper thread state to decompress two blocks ahead of the reader.
+  struct ReadAhead {
+    ReadAhead()
+      :
+        head(0),
+        count(0),
+        pos(0),
+        done(false),
+        error(false),
+        stop(false)
+    { }
+    std::mutex              mutex;    ///< protects the members below
+    std::condition_variable cond;     ///< signals a change of count, done or stop
+    std::thread             reader;   ///< the helper thread
+    size_t                  head;     ///< the block to read next
+    size_t                  count;    ///< number of blocks decompressed and not yet read
+    size_t                  pos;      ///< position in the head block
+    bool                    done;     ///< helper thread reached the end of the input
+    bool                    error;    ///< helper thread encountered an error
+    bool                    stop;     ///< helper thread should stop
+    size_t                  size[2];  ///< size of the decompressed blocks
+    char                    block[2][BLOCK]; ///< decompressed blocks
+  };
+  /// Helper thread decompresses the input into the two blocks.
+  void decompress()
+  {
+    std::unique_lock<std::mutex> lock(rah_->mutex);
+    while (true)
+    {
+      while (rah_->count == 2 && !rah_->stop)
+        rah_->cond.wait(lock);
+      if (rah_->stop)
+        break;
+      size_t tail = rah_->head ^ rah_->count;
+      lock.unlock();
+      size_t k = read(rah_->block[tail], BLOCK);
+      bool error = k == 0 && failed();
+      lock.lock();
+      if (k == 0)
+      {
+        rah_->done = true;
+        rah_->error = error;
+        lock.unlock();
+        rah_->cond.notify_all();
+        break;
+      }
+      rah_->size[tail] = k;
+      ++rah_->count;
+      lock.unlock();
+      rah_->cond.notify_all();
+      lock.lock();
+    }
+  }
+#endif
+  gzFile     gzf_;          ///< zlib file handle or Z_NULL
+  bool       err_;          ///< read or decompression error
+  char       buf_[65536];   ///< get area for small reads
+#ifdef WITH_ZSTREAM_THREAD
+  ReadAhead *rah_;          ///< helper thread state or NULL
+#endif
+};
+
+} // namespace reflex
+
+#endif
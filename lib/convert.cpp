@@ -43,6 +43,12 @@
 #include <cstdlib>
 #include <cstring>
 
+/// Process-wide cache of converted Unicode classes; requires C++11 threads.
+#if __cplusplus >= 201103L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201103L)
+# define WITH_CONVERT_CACHE
+# include <mutex>
+#endif
+
 namespace reflex {
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -82,6 +88,69 @@ inline int uppercase(int c)
   return static_cast<unsigned char>(c & ~0x20);
 }
 
+#if defined(WITH_CONVERT_CACHE)
+
+/// Max number of converted Unicode classes in the cache.
+static const size_t CONVERT_CACHE_MAX = 1024;
+
+/// Process-wide cache of converted Unicode classes, maps keys of class names or ranges with conversion parameters to UTF-8 regex.
+struct ConvertCache {
+  std::mutex                        mutex; ///< protects the map
+  std::map<std::string,std::string> map;   ///< converted Unicode classes
+};
+
+/// Returns the process-wide cache of converted Unicode classes, constructed on first use.
+static ConvertCache& convert_cache()
+{
+  static ConvertCache cache;
+  return cache;
+}
+
+#endif
+
+/// Returns a cache key for a Unicode class conversion with the given conversion parameters.
+static std::string cache_key(char kind, int esc, convert_flag_type flags, const char *par)
+{
+  std::string key(1, kind);
+  key.push_back(static_cast<char>(esc));
+  key.push_back((flags & convert_flag::permissive) ? 'p' : 's');
+  key.append(par).push_back('\0');
+  return key;
+}
+
+/// Returns true if the converted Unicode class is cached, assigning it to regex.
+static bool cached_class(const std::string& key, std::string& regex)
+{
+#if defined(WITH_CONVERT_CACHE)
+  ConvertCache& cache = convert_cache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  std::map<std::string,std::string>::const_iterator i = cache.map.find(key);
+  if (i != cache.map.end())
+  {
+    regex = i->second;
+    return true;
+  }
+#else
+  (void)key;
+  (void)regex;
+#endif
+  return false;
+}
+
+/// Cache the converted Unicode class, until the cache is full.
+static void cache_class(const std::string& key, const std::string& regex)
+{
+#if defined(WITH_CONVERT_CACHE)
+  ConvertCache& cache = convert_cache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  if (cache.map.size() < CONVERT_CACHE_MAX)
+    cache.map[key] = regex;
+#else
+  (void)key;
+  (void)regex;
+#endif
+}
+
 static std::string posix_class(const char *s, int esc)
 {
   std::string regex;
@@ -100,7 +169,10 @@ static std::string posix_class(const char *s, int esc)
 
 static std::string unicode_class(const char *s, int esc, convert_flag_type flags, const char *par)
 {
+  std::string key = cache_key('p', esc, flags, par).append(s);
   std::string regex;
+  if (cached_class(key, regex))
+    return regex;
   const int *wc = Unicode::range(s + (s[0] == '^'));
   if (wc != NULL)
   {
@@ -165,6 +237,7 @@ static std::string unicode_class(const char *s, int esc, convert_flag_type flags
   }
   if (regex.find('|') != std::string::npos)
     regex.insert(0, par).push_back(')');
+  cache_class(key, regex);
   return regex;
 }
 
@@ -733,7 +806,7 @@ static void expand_list(const char *pattern, size_t len, size_t& loc, size_t& po
     throw regex_error(regex_error::mismatched_brackets, pattern, loc);
 }
 
-static void insert_escape_class(const char *pattern, size_t& pos, const std::map<size_t,std::string>& mod, ORanges<int>& ranges)
+static void insert_escape_class(const char *pattern, size_t& pos, const std::map<size_t,std::string>& mod, FlatORanges<int>& ranges)
 {
   int c = pattern[pos];
   char name[2] = { static_cast<char>(lowercase(c)), '\0' };
@@ -789,7 +862,7 @@ static void insert_escape_class(const char *pattern, size_t& pos, const std::map
   }
 }
 
-static int insert_escape(const char *pattern, size_t len, size_t& pos, convert_flag_type flags, const std::map<size_t,std::string>& mod, ORanges<int>& ranges)
+static int insert_escape(const char *pattern, size_t len, size_t& pos, convert_flag_type flags, const std::map<size_t,std::string>& mod, FlatORanges<int>& ranges)
 {
   int c = pattern[pos];
   if (c == 'c')
@@ -934,7 +1007,7 @@ static int insert_escape(const char *pattern, size_t len, size_t& pos, convert_f
   return c;
 }
 
-static void insert_posix_class(const char *pattern, size_t len, size_t& pos, ORanges<int>& ranges)
+static void insert_posix_class(const char *pattern, size_t len, size_t& pos, FlatORanges<int>& ranges)
 {
   pos += 2;
   char buf[8] = "";
@@ -974,9 +1047,9 @@ static void insert_posix_class(const char *pattern, size_t len, size_t& pos, ORa
   ++pos;
 }
 
-static void insert_list(const char *pattern, size_t len, size_t& pos, convert_flag_type flags, const std::map<size_t,std::string>& mod, ORanges<int>& ranges, const std::map<std::string,std::string> *macros);
+static void insert_list(const char *pattern, size_t len, size_t& pos, convert_flag_type flags, const std::map<size_t,std::string>& mod, FlatORanges<int>& ranges, const std::map<std::string,std::string> *macros);
 
-static void merge_list(const char *pattern, size_t len, size_t& pos, convert_flag_type flags, const std::map<size_t,std::string>& mod, ORanges<int>& ranges, const std::map<std::string,std::string> *macros)
+static void merge_list(const char *pattern, size_t len, size_t& pos, convert_flag_type flags, const std::map<size_t,std::string>& mod, FlatORanges<int>& ranges, const std::map<std::string,std::string> *macros)
 {
   if (pattern[pos] == '[')
   {
@@ -1000,9 +1073,9 @@ static void merge_list(const char *pattern, size_t len, size_t& pos, convert_fla
   }
 }
 
-static void intersect_list(const char *pattern, size_t len, size_t& pos, convert_flag_type flags, const std::map<size_t,std::string>& mod, ORanges<int>& ranges, const std::map<std::string,std::string> *macros)
+static void intersect_list(const char *pattern, size_t len, size_t& pos, convert_flag_type flags, const std::map<size_t,std::string>& mod, FlatORanges<int>& ranges, const std::map<std::string,std::string> *macros)
 {
-  ORanges<int> intersect;
+  FlatORanges<int> intersect;
   if (pattern[pos] == '[')
   {
     ++pos;
@@ -1027,9 +1100,9 @@ static void intersect_list(const char *pattern, size_t len, size_t& pos, convert
   }
 }
 
-static void subtract_list(const char *pattern, size_t len, size_t& pos, convert_flag_type flags, const std::map<size_t,std::string>& mod, ORanges<int>& ranges, const std::map<std::string,std::string> *macros)
+static void subtract_list(const char *pattern, size_t len, size_t& pos, convert_flag_type flags, const std::map<size_t,std::string>& mod, FlatORanges<int>& ranges, const std::map<std::string,std::string> *macros)
 {
-  ORanges<int> subtract;
+  FlatORanges<int> subtract;
   if (pattern[pos] == '[')
   {
     ++pos;
@@ -1054,7 +1127,7 @@ static void subtract_list(const char *pattern, size_t len, size_t& pos, convert_
   }
 }
 
-static void extend_list(const char *pattern, size_t len, size_t& pos, convert_flag_type flags, const std::map<size_t,std::string>& mod, ORanges<int>& ranges, const std::map<std::string,std::string> *macros)
+static void extend_list(const char *pattern, size_t len, size_t& pos, convert_flag_type flags, const std::map<size_t,std::string>& mod, FlatORanges<int>& ranges, const std::map<std::string,std::string> *macros)
 {
   if ((flags & convert_flag::lex))
   {
@@ -1080,18 +1153,18 @@ static void extend_list(const char *pattern, size_t len, size_t& pos, convert_fl
   }
 }
 
-static void negate_list(convert_flag_type flags, const std::map<size_t,std::string>& mod, ORanges<int>& ranges)
+static void negate_list(convert_flag_type flags, const std::map<size_t,std::string>& mod, FlatORanges<int>& ranges)
 {
   if (is_modified(mod, 'u'))
   {
-    ORanges<int> inverse(0x00, 0x10FFFF);
-    inverse -= ORanges<int>(0xD800, 0xDFFF); // remove surrogates
+    FlatORanges<int> inverse(0x00, 0x10FFFF);
+    inverse -= FlatORanges<int>(0xD800, 0xDFFF); // remove surrogates
     inverse -= ranges;
     ranges.swap(inverse);
   }
   else
   {
-    ORanges<int> inverse(0x00, 0xFF);
+    FlatORanges<int> inverse(0x00, 0xFF);
     inverse -= ranges;
     ranges.swap(inverse);
   }
@@ -1099,7 +1172,7 @@ static void negate_list(convert_flag_type flags, const std::map<size_t,std::stri
     ranges.erase('\n');
 }
 
-static void insert_list(const char *pattern, size_t len, size_t& pos, convert_flag_type flags, const std::map<size_t,std::string>& mod, ORanges<int>& ranges, const std::map<std::string,std::string> *macros)
+static void insert_list(const char *pattern, size_t len, size_t& pos, convert_flag_type flags, const std::map<size_t,std::string>& mod, FlatORanges<int>& ranges, const std::map<std::string,std::string> *macros)
 {
   size_t loc = pos;
   bool negate = false;
@@ -1209,50 +1282,56 @@ static void insert_list(const char *pattern, size_t len, size_t& pos, convert_fl
     throw regex_error(regex_error::empty_class, pattern, loc);
 }
 
-static std::string convert_unicode_ranges(const ORanges<int>& ranges, convert_flag_type flags, const char *signature, const char *par)
+static std::string convert_unicode_ranges(const FlatORanges<int>& ranges, convert_flag_type flags, const char *signature, const char *par)
 {
   std::string regex;
   int esc = hex_or_octal_escape(signature);
-  for (ORanges<int>::const_iterator i = ranges.begin(); i != ranges.end(); ++i)
+  std::string key = cache_key('r', esc, flags, par);
+  for (FlatORanges<int>::const_iterator i = ranges.begin(); i != ranges.end(); ++i)
+    key.append(reinterpret_cast<const char*>(&i->first), sizeof(int)).append(reinterpret_cast<const char*>(&i->second), sizeof(int));
+  if (cached_class(key, regex))
+    return regex;
+  for (FlatORanges<int>::const_iterator i = ranges.begin(); i != ranges.end(); ++i)
     regex.append(utf8(i->first, i->second - 1, esc, par, !(flags & convert_flag::permissive))).push_back('|');
   regex.resize(regex.size() - 1);
   regex.insert(0, par).push_back(')');
+  cache_class(key, regex);
   return regex;
 }
 
-static std::string convert_posix_ranges(const ORanges<int>& ranges, const char *signature)
+static std::string convert_posix_ranges(const FlatORanges<int>& ranges, const char *signature)
 {
   int esc = hex_or_octal_escape(signature);
   std::string regex;
   bool negate = ranges.lo() == 0x00 && ranges.hi() >= 0x7F;
   if (negate && ranges.size() > 1)
   {
-    ORanges<int> inverse(0x00, 0xFF);
+    FlatORanges<int> inverse(0x00, 0xFF);
     inverse -= ranges;
     regex = "[^";
-    for (ORanges<int>::const_iterator i = inverse.begin(); i != inverse.end(); ++i)
+    for (FlatORanges<int>::const_iterator i = inverse.begin(); i != inverse.end(); ++i)
       regex.append(latin1(i->first, i->second - 1, esc, false));
   }
   else
   {
     regex = "[";
-    for (ORanges<int>::const_iterator i = ranges.begin(); i != ranges.end(); ++i)
+    for (FlatORanges<int>::const_iterator i = ranges.begin(); i != ranges.end(); ++i)
       regex.append(latin1(i->first, i->second - 1, esc, false));
   }
   return regex.append("]");
 }
 
-static void convert_anycase_ranges(ORanges<int>& ranges)
+static void convert_anycase_ranges(FlatORanges<int>& ranges)
 {
-  ORanges<int> letters;
+  FlatORanges<int> letters;
   letters.insert('A', 'Z');
   letters.insert('a', 'z');
   letters &= ranges;
-  for (ORanges<int>::const_iterator i = letters.begin(); i != letters.end(); ++i)
+  for (FlatORanges<int>::const_iterator i = letters.begin(); i != letters.end(); ++i)
     ranges.insert(i->first ^ 0x20, (i->second - 1) ^ 0x20);
 }
 
-static std::string convert_ranges(const char *pattern, size_t pos, ORanges<int>& ranges, const std::map<size_t,std::string>& mod, convert_flag_type flags, const char *signature, const char *par)
+static std::string convert_ranges(const char *pattern, size_t pos, FlatORanges<int>& ranges, const std::map<size_t,std::string>& mod, convert_flag_type flags, const char *signature, const char *par)
 {
   if (is_modified(mod, 'i'))
     convert_anycase_ranges(ranges);
@@ -1687,7 +1766,7 @@ std::string convert(const char *pattern, const char *signature, convert_flag_typ
         }
         else
         {
-          ORanges<int> ranges;
+          FlatORanges<int> ranges;
           regex.append(&pattern[loc], pos - loc);
           ++pos;
           insert_list(pattern, len, pos, flags, mod, ranges, macros);
@@ -1782,7 +1861,7 @@ std::string convert(const char *pattern, const char *signature, convert_flag_typ
             if ((flags & convert_flag::lex) && pos + 5 < len && pattern[pos + 1] == '{' && ((c = pattern[pos + 2]) == '+' || c == '|' || c == '&' || c == '-') && pattern[pos + 3] == '}')
             {
               size_t subpos = 0;
-              ORanges<int> ranges;
+              FlatORanges<int> ranges;
               merge_list(subregex.c_str(), subregex.size(), subpos, flags, mod, ranges, macros);
               if (subpos + 1 < subregex.size())
                 throw regex_error(regex_error::invalid_class_range, pattern, loc);
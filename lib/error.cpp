@@ -62,6 +62,7 @@ std::string regex_error::regex_error_message_code(regex_error_type code, const c
     "exceeds length limit",
     "exceeds complexity limits",
     "undefined name",
+    "exceeds construction budget",
   };
   return regex_error_message(messages[code], pattern, pos);
 }
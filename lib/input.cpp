@@ -47,8 +47,51 @@
 # include <unistd.h> // off_t, fstat()
 #endif
 
+// memory-map regular files to read, unless WITH_NO_MMAP is defined
+#if !defined(WITH_NO_MMAP) && !defined(__WIN32__) && !defined(_WIN32) && !defined(WIN32) && !defined(_WIN64) && !defined(__BORLANDC__)
+# define WITH_MMAP
+# include <sys/mman.h>
+#endif
+
+#if defined(WITH_MMAP) && __cplusplus >= 201103L
+# include <atomic>
+#endif
+
+/// Reading FILE* input ahead with read_ahead(); requires C++11 threads.
+#if __cplusplus >= 201103L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201103L)
+# define WITH_READ_AHEAD
+# include <atomic>
+# include <condition_variable>
+# include <mutex>
+# include <thread>
+#endif
+
 namespace reflex {
 
+/// Block size of the reads by the read-ahead thread, the same as reflex::AbstractMatcher::Const::BLOCK.
+static const size_t READ_AHEAD_SIZE = 262144;
+
+/// Number of blocks the read-ahead thread keeps in flight.
+static const size_t READ_AHEAD_BLOCKS = 2;
+
+/// Files smaller than this are read with fread() instead of memory mapped.
+static const size_t MMAP_MIN = 65536;
+
+/// Files of this size or larger are advised to use transparent huge pages, when supported.
+static const size_t MMAP_HUGE = 2097152;
+
+/// A memory-mapped file shared by copies of an Input object.
+struct Input::Mapping {
+  const char           *base; ///< base address of the memory-mapped file
+  size_t                size; ///< size of the memory-mapped file in bytes
+  size_t                len;  ///< length of the memory mapping, len > size when the file content is followed by a zero page
+#if __cplusplus >= 201103L
+  std::atomic<size_t>   refs; ///< number of Input objects sharing this mapping
+#else
+  size_t                refs; ///< number of Input objects sharing this mapping
+#endif
+};
+
 static const unsigned short codepages[38][256] =
 {
   // DOS CP 437 to Unicode
@@ -730,6 +773,491 @@ void Input::file_init()
     if (feof(file_) || handler_ == NULL || (*handler_)() == 0)
       break;
   }
+  if (utfx_ == file_encoding::plain || utfx_ == file_encoding::utf8)
+    file_map();
+}
+
+void Input::file_map()
+{
+#if defined(WITH_MMAP)
+  struct stat st;
+  int fd = ::fileno(file_);
+  if (fd < 0 || ::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size < static_cast<off_t>(MMAP_MIN) || static_cast<uintmax_t>(st.st_size) > static_cast<size_t>(-1))
+    return;
+  // the FILE* position after the UTF BOM check is where the mapped input starts
+  off_t pos = ftello(file_);
+  if (pos < 0 || pos >= st.st_size)
+    return;
+  size_t size = static_cast<size_t>(st.st_size);
+  size_t len = size;
+  void *base = MAP_FAILED;
+#if defined(MAP_ANONYMOUS) && defined(MAP_FIXED)
+  // reserve a zero page after the file content to NUL-terminate the mapped input for scanning in place
+  long page = ::sysconf(_SC_PAGESIZE);
+  if (page > 0)
+  {
+    len = (size / page + 1) * page;
+    base = ::mmap(NULL, len, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base != MAP_FAILED && ::mmap(base, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED)
+    {
+      ::munmap(base, len);
+      base = MAP_FAILED;
+    }
+  }
+#endif
+  if (base == MAP_FAILED)
+  {
+    len = size;
+    base = ::mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (base == MAP_FAILED)
+      return;
+  }
+#if defined(MADV_SEQUENTIAL)
+  ::madvise(base, size, MADV_SEQUENTIAL);
+#endif
+#if defined(MADV_HUGEPAGE)
+  if (size >= MMAP_HUGE)
+    ::madvise(base, size, MADV_HUGEPAGE);
+#endif
+  map_ = new Mapping;
+  map_->base = static_cast<const char*>(base);
+  map_->size = size;
+  map_->len = len;
+  map_->refs = 1;
+  mof_ = static_cast<size_t>(pos);
+  // the size of the remaining input includes the non-BOM bytes buffered in utf8_[] by the UTF BOM check
+  size_ = size - mof_;
+  for (size_t i = uidx_; i < sizeof(utf8_) && utf8_[i] != '\0'; ++i)
+    ++size_;
+#endif
+}
+
+void Input::file_unmap()
+{
+#if defined(WITH_MMAP)
+  // continue reading the FILE* after the consumed part of the memory-mapped file, e.g. when the file grew
+  fseeko(file_, static_cast<off_t>(mof_), SEEK_SET);
+  map_release();
+#endif
+}
+
+void Input::map_acquire() const
+{
+  ++map_->refs;
+}
+
+void Input::map_release()
+{
+#if defined(WITH_MMAP)
+  if (--map_->refs == 0)
+  {
+    ::munmap(const_cast<char*>(map_->base), map_->len);
+    delete map_;
+  }
+#endif
+  map_ = NULL;
+}
+
+#if defined(WITH_READ_AHEAD)
+
+/// The blocks read ahead of a FILE* by a helper thread, shared by copies of an Input object.
+struct Input::ReadAhead {
+  ReadAhead(FILE *file)
+    :
+      file(file),
+      refs(1),
+      head(0),
+      count(0),
+      pos(0),
+      done(false),
+      stop(false)
+  { }
+  FILE                   *file;                     ///< the FILE* to read
+  std::atomic<size_t>     refs;                     ///< number of Input objects sharing the read-ahead state
+  std::mutex              mutex;                    ///< protects the blocks and the state below
+  std::condition_variable cond;                     ///< to wait for a block to be filled or to be consumed
+  size_t                  head;                     ///< index of the block to get input from
+  size_t                  count;                    ///< number of filled blocks, starting at head
+  size_t                  pos;                      ///< position in the head block of the next byte to get
+  bool                    done;                     ///< the reader reached EOF or a read error occurred
+  bool                    stop;                     ///< the reader should stop
+  size_t                  size[READ_AHEAD_BLOCKS];  ///< number of bytes in each block
+  char                    block[READ_AHEAD_BLOCKS][READ_AHEAD_SIZE]; ///< the blocks read ahead
+  std::thread             reader;                   ///< the read-ahead thread
+};
+
+Input& Input::read_ahead()
+{
+  if (file_ == NULL || rah_ != NULL || map_ != NULL || handler_ != NULL || (utfx_ != file_encoding::plain && utfx_ != file_encoding::utf8))
+    return *this;
+  ReadAhead *rah = new ReadAhead(file_);
+  rah->reader = std::thread([rah]() {
+    std::unique_lock<std::mutex> lock(rah->mutex);
+    while (!rah->stop)
+    {
+      if (rah->count == READ_AHEAD_BLOCKS)
+      {
+        rah->cond.wait(lock);
+        continue;
+      }
+      // fill the next free block without holding the lock
+      size_t tail = (rah->head + rah->count) % READ_AHEAD_BLOCKS;
+      lock.unlock();
+      size_t n = ::fread(rah->block[tail], 1, READ_AHEAD_SIZE, rah->file);
+      lock.lock();
+      rah->size[tail] = n;
+      if (n > 0)
+        ++rah->count;
+      if (n < READ_AHEAD_SIZE)
+        rah->done = true;
+      rah->cond.notify_all();
+      if (rah->done)
+        break;
+    }
+  });
+  rah_ = rah;
+  return *this;
+}
+
+size_t Input::read_ahead_get(char *s, size_t n)
+{
+  std::unique_lock<std::mutex> lock(rah_->mutex);
+  size_t k = 0;
+  while (k < n)
+  {
+    if (rah_->count == 0)
+    {
+      // return the input we got so far, or wait for the reader to fill the next block
+      if (k > 0 || rah_->done)
+        break;
+      rah_->cond.wait(lock);
+      continue;
+    }
+    size_t h = rah_->head;
+    size_t m = rah_->size[h] - rah_->pos;
+    if (m > n - k)
+      m = n - k;
+    std::memcpy(s + k, rah_->block[h] + rah_->pos, m);
+    rah_->pos += m;
+    k += m;
+    if (rah_->pos >= rah_->size[h])
+    {
+      // hand the consumed block back to the reader
+      rah_->head = (h + 1) % READ_AHEAD_BLOCKS;
+      rah_->pos = 0;
+      --rah_->count;
+      rah_->cond.notify_all();
+    }
+  }
+  return k;
+}
+
+bool Input::read_ahead_good() const
+{
+  std::lock_guard<std::mutex> lock(rah_->mutex);
+  return rah_->count > 0 || !rah_->done;
+}
+
+void Input::read_ahead_acquire() const
+{
+  ++rah_->refs;
+}
+
+void Input::read_ahead_release()
+{
+  if (--rah_->refs == 0)
+  {
+    {
+      std::lock_guard<std::mutex> lock(rah_->mutex);
+      rah_->stop = true;
+      rah_->cond.notify_all();
+    }
+    // the reader may still be blocked in fread() until input is available or EOF
+    rah_->reader.join();
+    delete rah_;
+  }
+  rah_ = NULL;
+}
+
+#else
+
+Input& Input::read_ahead()
+{
+  return *this;
+}
+
+size_t Input::read_ahead_get(char*, size_t)
+{
+  return 0;
+}
+
+bool Input::read_ahead_good() const
+{
+  return false;
+}
+
+void Input::read_ahead_acquire() const
+{ }
+
+void Input::read_ahead_release()
+{
+  rah_ = NULL;
+}
+
+#endif
+
+const char *Input::mapped(size_t& size) const
+{
+  // scanning in place requires a NUL after the file content
+  if (map_ == NULL || map_->len <= map_->size || file_ == NULL || (utfx_ != file_encoding::plain && utfx_ != file_encoding::utf8))
+    return NULL;
+  // the non-BOM bytes buffered in utf8_[] by the UTF BOM check directly precede the mapped input at mof_
+  size_t k = 0;
+  while (uidx_ + k < sizeof(utf8_) && utf8_[uidx_ + k] != '\0')
+    ++k;
+  if (k > mof_)
+    return NULL;
+  size = map_->size - mof_ + k;
+  return map_->base + mof_ - k;
+}
+
+const char *Input::segment(size_t keep, size_t& size) const
+{
+  if (seg_ == NULL)
+    return NULL;
+  // get() moves on to the next segment when a segment was gotten entirely, skip empty segments
+  const Segment *seg = seg_;
+  while (seg < sge_ && seg->size == 0)
+    ++seg;
+  if (seg >= sge_ || keep > sof_)
+    return NULL;
+  size = seg->size - sof_ + keep;
+  return seg->data + sof_ - keep;
+}
+
+void Input::skip_segment()
+{
+  if (seg_ == NULL)
+    return;
+  while (seg_ < sge_ && seg_->size == 0)
+    ++seg_;
+  if (seg_ >= sge_)
+    return;
+  size_ -= seg_->size - sof_;
+  ++seg_;
+  sof_ = 0;
+}
+
+/// Output buffers smaller than this are filled by reading UTF-16, UTF-32 and code page encoded input one code unit at a time.
+static const size_t FILE_BLOCK_MIN = 64;
+
+/// Read a block of latin-1 or code page encoded input into s and convert it in place to UTF-8.
+static size_t file_get_page(
+    FILE                 *file, ///< the FILE* to read
+    const unsigned short *page, ///< code page to translate the input or NULL for latin-1
+    char                 *s,    ///< points to the string buffer to fill with UTF-8
+    size_t                n)    ///< size of buffer pointed to by s, at least FILE_BLOCK_MIN
+  /// @returns the number of UTF-8 bytes stored in s, or zero when EOF or a read error occurred
+{
+  // ASCII runs are copied as is when the code page maps ASCII to itself
+  bool ascii = true;
+  if (page != NULL)
+    for (int i = 0; i < 0x80 && ascii; ++i)
+      ascii = page[i] == i;
+  char *t = s;
+  // fill the buffer until the room left is too small to read another block or the input is exhausted
+  while (true)
+  {
+    size_t m = s + n - t;
+    if (m < FILE_BLOCK_MIN)
+      break;
+    // read r bytes at the end of the buffer, leaving enough room to convert in place from front to back when each
+    // byte expands to three bytes of UTF-8
+    size_t r = m / 3;
+    unsigned char *b = reinterpret_cast<unsigned char*>(s + n - r);
+    size_t k = ::fread(b, 1, r, file);
+    unsigned char *e = b + k;
+    while (b < e)
+    {
+      if (ascii)
+      {
+#if defined(HAVE_AVX512BW) || defined(HAVE_AVX2) || defined(HAVE_SSE2)
+        if (have_HW_SSE2())
+        {
+          // copy ASCII 16 bytes at a time, the UTF-8 stored at t never overwrites the input at b not yet loaded
+          while (b + 16 <= e)
+          {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+            if (_mm_movemask_epi8(v) != 0)
+              break;
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(t), v);
+            t += 16;
+            b += 16;
+          }
+        }
+#elif defined(HAVE_NEON)
+        // copy ASCII 16 bytes at a time, the UTF-8 stored at t never overwrites the input at b not yet loaded
+        while (b + 16 <= e)
+        {
+          uint8x16_t v = vld1q_u8(b);
+          uint64x2_t vt = vreinterpretq_u64_u8(vandq_u8(v, vdupq_n_u8(0x80)));
+          if ((vgetq_lane_u64(vt, 0) | vgetq_lane_u64(vt, 1)) != 0)
+            break;
+          vst1q_u8(reinterpret_cast<uint8_t*>(t), v);
+          t += 16;
+          b += 16;
+        }
+#endif
+        while (b < e && *b < 0x80)
+          *t++ = static_cast<char>(*b++);
+        if (b >= e)
+          break;
+      }
+      int c = page != NULL ? page[*b++] : *b++;
+      if (c < 0x80)
+        *t++ = static_cast<char>(c);
+      else
+        t += utf8(c, t);
+    }
+    if (k < r)
+      break;
+  }
+  return t - s;
+}
+
+/// Read a block of UTF-16 or UTF-32 input into s and convert it in place to UTF-8.
+static size_t file_get_utf(
+    FILE          *file, ///< the FILE* to read
+    unsigned short enc,  ///< Input::file_encoding::utf16be, utf16le, utf32be, or utf32le
+    char          *s,    ///< points to the string buffer to fill with UTF-8
+    size_t         n)    ///< size of buffer pointed to by s, at least FILE_BLOCK_MIN
+  /// @returns the number of UTF-8 bytes stored in s, or zero when EOF or a read error occurred
+{
+  const bool wide = enc == Input::file_encoding::utf32be || enc == Input::file_encoding::utf32le;
+  const bool big = enc == Input::file_encoding::utf16be || enc == Input::file_encoding::utf32be;
+  const size_t w = wide ? 4 : 2;
+  char *t = s;
+  // fill the buffer until the room left is too small to read another block or the input is exhausted
+  while (true)
+  {
+    size_t m = s + n - t;
+    if (m < FILE_BLOCK_MIN)
+      break;
+    // read r bytes at the end of the buffer, leaving enough room to convert in place from front to back when a
+    // two byte code unit expands to a five byte REFLEX_NONCHAR_UTF8, plus 8 bytes for a pair straddling the block
+    size_t r = (m - 8) / 3 & ~static_cast<size_t>(3);
+    unsigned char *b = reinterpret_cast<unsigned char*>(s + n - r);
+    size_t k = ::fread(b, 1, r, file);
+    if (k % w != 0)
+    {
+      // complete the last code unit, or drop it at EOF
+      k += ::fread(b + k, 1, w - k % w, file);
+      k -= k % w;
+    }
+    unsigned char *e = b + k;
+    while (b < e)
+    {
+#if defined(HAVE_AVX512BW) || defined(HAVE_AVX2) || defined(HAVE_SSE2)
+      if (have_HW_SSE2())
+      {
+        // convert ASCII 16 bytes at a time, the UTF-8 stored at t never overwrites the UTF-16/32 input at b not yet loaded
+        const __m128i vz = _mm_setzero_si128();
+        if (!wide)
+        {
+          const __m128i vm = big ? _mm_set1_epi16(static_cast<short>(0x80FF)) : _mm_set1_epi16(static_cast<short>(0xFF80));
+          while (b + 16 <= e)
+          {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(v, vm), vz)) != 0xFFFF)
+              break;
+            if (big)
+              v = _mm_srli_epi16(v, 8);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(t), _mm_packus_epi16(v, v));
+            t += 8;
+            b += 16;
+          }
+        }
+        else
+        {
+          const __m128i vm = big ? _mm_set1_epi32(static_cast<int>(0x80FFFFFF)) : _mm_set1_epi32(static_cast<int>(0xFFFFFF80));
+          while (b + 16 <= e)
+          {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(v, vm), vz)) != 0xFFFF)
+              break;
+            if (big)
+              v = _mm_srli_epi32(v, 24);
+            v = _mm_packs_epi32(v, v);
+            int c = _mm_cvtsi128_si32(_mm_packus_epi16(v, v));
+            std::memcpy(t, &c, 4);
+            t += 4;
+            b += 16;
+          }
+        }
+        if (b >= e)
+          break;
+      }
+#elif defined(HAVE_NEON)
+      if (!wide)
+      {
+        // convert ASCII 16 bytes at a time, the UTF-8 stored at t never overwrites the UTF-16 input at b not yet loaded
+        const uint16x8_t vm = vdupq_n_u16(big ? 0x80FF : 0xFF80);
+        while (b + 16 <= e)
+        {
+          uint16x8_t v = vreinterpretq_u16_u8(vld1q_u8(b));
+          uint64x2_t vt = vreinterpretq_u64_u16(vandq_u16(v, vm));
+          if ((vgetq_lane_u64(vt, 0) | vgetq_lane_u64(vt, 1)) != 0)
+            break;
+          if (big)
+            v = vshrq_n_u16(v, 8);
+          vst1_u8(reinterpret_cast<uint8_t*>(t), vmovn_u16(v));
+          t += 8;
+          b += 16;
+        }
+        if (b >= e)
+          break;
+      }
+#endif
+      int c;
+      if (!wide)
+      {
+        c = big ? b[0] << 8 | b[1] : b[0] | b[1] << 8;
+        b += 2;
+        if (c >= 0xD800 && c < 0xE000)
+        {
+          // UTF-16 surrogate pair, the second code unit may be located after the block
+          unsigned char buf[2];
+          const unsigned char *d = NULL;
+          if (c < 0xDC00)
+          {
+            if (b < e)
+            {
+              d = b;
+              b += 2;
+            }
+            else if (::fread(buf, 2, 1, file) == 1)
+            {
+              d = buf;
+            }
+          }
+          int c2 = d != NULL ? big ? d[0] << 8 | d[1] : d[0] | d[1] << 8 : 0;
+          if ((c2 & 0xFC00) == 0xDC00)
+            c = 0x010000 - 0xDC00 + ((c - 0xD800) << 10) + c2;
+          else
+            c = REFLEX_NONCHAR;
+        }
+      }
+      else
+      {
+        c = big ? b[0] << 24 | b[1] << 16 | b[2] << 8 | b[3] : b[0] | b[1] << 8 | b[2] << 16 | b[3] << 24;
+        b += 4;
+      }
+      t += utf8(c, t);
+    }
+    if (k < r)
+      break;
+  }
+  return t - s;
 }
 
 size_t Input::file_get(char *s, size_t n)
@@ -751,6 +1279,22 @@ size_t Input::file_get(char *s, size_t n)
     }
     uidx_ = sizeof(utf8_);
   }
+  if (n >= FILE_BLOCK_MIN && utfx_ != file_encoding::plain && utfx_ != file_encoding::utf8)
+  {
+    char *u = t;
+    if (utfx_ == file_encoding::utf16be || utfx_ == file_encoding::utf16le || utfx_ == file_encoding::utf32be || utfx_ == file_encoding::utf32le)
+      t += file_get_utf(file_, utfx_, t, n);
+    else
+      t += file_get_page(file_, utfx_ == file_encoding::latin ? NULL : page_, t, n);
+    n -= t - u;
+    if (n == 0 || ::feof(file_) || ::ferror(file_))
+    {
+      if (size_ + s >= t)
+        size_ -= t - s;
+      return t - s;
+    }
+    // convert the rest one code unit at a time to fill the buffer, since a short read would indicate EOF
+  }
   unsigned char buf[4];
   switch (utfx_)
   {
@@ -986,7 +1530,26 @@ size_t Input::file_get(char *s, size_t n)
         size_ -= t - s;
       return t - s;
     default:
-      t += ::fread(t, 1, n, file_);
+      if (map_ != NULL)
+      {
+        // copy from the memory-mapped file
+        size_t k = map_->size - mof_;
+        if (k > n)
+          k = n;
+        std::memcpy(t, map_->base + mof_, k);
+        mof_ += k;
+        t += k;
+        if (mof_ >= map_->size)
+          file_unmap();
+      }
+      else if (rah_ != NULL)
+      {
+        t += read_ahead_get(t, n);
+      }
+      else
+      {
+        t += ::fread(t, 1, n, file_);
+      }
       if (size_ + s >= t)
         size_ -= t - s;
       return t - s;
@@ -1023,6 +1586,14 @@ void Input::wstring_size()
 
 void Input::file_size()
 {
+  if (map_ != NULL)
+  {
+    size_ = map_->size - mof_;
+    return;
+  }
+  // the FILE* is read by the read-ahead thread, so the size cannot be determined by seeking
+  if (rah_ != NULL)
+    return;
   off_t k = ftello(file_);
   if (k >= 0)
   {
@@ -1149,21 +1720,45 @@ void Input::file_size()
 
 void Input::istream_size()
 {
-  std::streampos k = istream_->tellg();
+  // seek the stream buffer directly, tellg() and seekg() construct a sentry each time
+  std::streambuf *buf = istream_->rdbuf();
+  if (buf == NULL || istream_->fail())
+    return;
+  std::streampos k = buf->pubseekoff(0, std::ios_base::cur, std::ios_base::in);
   if (k >= 0)
   {
-    istream_->seekg(0, istream_->end);
-    std::streampos n = istream_->tellg();
+    std::streampos n = buf->pubseekoff(0, std::ios_base::end, std::ios_base::in);
     if (n >= k)
       size_ = (size_t)(n - k);
-    istream_->seekg(k, istream_->beg);
+    buf->pubseekpos(k, std::ios_base::in);
+  }
+}
+
+size_t Input::istream_get(char *s, size_t n)
+{
+  // bypass the sentry and state checks of std::istream::read() by reading the stream buffer with sgetn()
+  std::streambuf *buf = istream_->rdbuf();
+  if (buf == NULL || !istream_->good())
+  {
+    istream_->setstate(std::ios_base::failbit);
+    return 0;
   }
+  // flush the tied output stream, such as std::cout tied to std::cin, as the sentry of std::istream::read() does
+  if (istream_->tie() != NULL)
+    istream_->tie()->flush();
+  size_t k = static_cast<size_t>(buf->sgetn(s, static_cast<std::streamsize>(n)));
+  if (k < n)
+    istream_->setstate(std::ios_base::eofbit | std::ios_base::failbit);
+  return k;
 }
 
 void Input::file_encoding(unsigned short enc, const unsigned short *page)
 {
   if (file_ && utfx_ != enc)
   {
+    // conversion to UTF-8 reads the FILE* instead of the memory-mapped file
+    if (map_ != NULL && enc != file_encoding::plain && enc != file_encoding::utf8)
+      file_unmap();
     if (utfx_ == file_encoding::plain && uidx_ < sizeof(utf8_))
     {
       // translate (non-BOM) plain bytes (1 to 4 bytes) buffered in utf8_[]
@@ -36,6 +36,34 @@
 
 #include <reflex/matcher.h>
 
+/// Chunk-parallel find_all() with threads > 1; requires C++11 threads.
+#if __cplusplus >= 201103L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201103L)
+# define WITH_FIND_THREADS
+# include <exception>
+# include <thread>
+#endif
+
+/// Per-thread pool of freed buffers reused by AbstractMatcher::DefaultAllocator; requires C++11 thread_local.
+#if __cplusplus >= 201103L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201103L)
+# define WITH_BUFFER_POOL
+#endif
+
+/// Transparent huge pages for large matcher buffers with madvise().
+#if defined(__linux__)
+# include <sys/mman.h>
+# if defined(MADV_HUGEPAGE)
+#  define WITH_HUGE_PAGES
+# endif
+#endif
+
+/// Ring buffers mapped twice in virtual memory for AbstractMatcher::RingAllocator.
+#if !defined(WITH_NO_MMAP) && (defined(__unix__) || defined(__APPLE__))
+# define WITH_RING_BUFFER
+# include <sys/mman.h>
+# include <fcntl.h>
+# include <unistd.h>
+#endif
+
 namespace reflex {
 
 /// Boyer-Moore preprocessing of the given pattern prefix pat of length len (<=255), generates bmd_ > 0 and bms_[] shifts.
@@ -93,15 +121,526 @@ void Matcher::boyer_moore_init(const char *pat, size_t len)
 #endif
 }
 
+// skip input bytes in a SKIP or SPAN loop state up to the first byte that exits the loop, only in the current buffer
+void Matcher::skip_loop(Pattern::Opcode opcode)
+{
+  const char *s = buf_ + pos_;
+  const char *e = buf_ + end_;
+  char b1 = static_cast<char>(opcode >> 16);
+  char b2 = static_cast<char>(opcode >> 8);
+  char b3 = static_cast<char>(opcode);
+  bool span = Pattern::is_opcode_span(opcode);
+#if defined(HAVE_AVX512BW) || defined(HAVE_AVX2)
+  if (have_HW_AVX2())
+  {
+    uint32_t flip = span ? 0xFFFFFFFF : 0;
+    __m256i vb1 = _mm256_set1_epi8(b1);
+    __m256i vb2 = _mm256_set1_epi8(b2);
+    __m256i vb3 = _mm256_set1_epi8(b3);
+    while (s + 32 <= e)
+    {
+      __m256i vstr = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s));
+      __m256i veq = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(vstr, vb1), _mm256_cmpeq_epi8(vstr, vb2)), _mm256_cmpeq_epi8(vstr, vb3));
+      uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(veq)) ^ flip;
+      if (mask != 0)
+      {
+        pos_ = s - buf_ + ctz(mask);
+        return;
+      }
+      s += 32;
+    }
+  }
+#endif
+#if defined(HAVE_AVX512BW) || defined(HAVE_AVX2) || defined(HAVE_SSE2)
+  if (have_HW_SSE2())
+  {
+    uint32_t flip = span ? 0xFFFF : 0;
+    __m128i vb1 = _mm_set1_epi8(b1);
+    __m128i vb2 = _mm_set1_epi8(b2);
+    __m128i vb3 = _mm_set1_epi8(b3);
+    while (s + 16 <= e)
+    {
+      __m128i vstr = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+      __m128i veq = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(vstr, vb1), _mm_cmpeq_epi8(vstr, vb2)), _mm_cmpeq_epi8(vstr, vb3));
+      uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(veq)) ^ flip;
+      if (mask != 0)
+      {
+        pos_ = s - buf_ + ctz(mask);
+        return;
+      }
+      s += 16;
+    }
+  }
+#elif defined(HAVE_NEON)
+  {
+    uint8x16_t vb1 = vdupq_n_u8(static_cast<uint8_t>(b1));
+    uint8x16_t vb2 = vdupq_n_u8(static_cast<uint8_t>(b2));
+    uint8x16_t vb3 = vdupq_n_u8(static_cast<uint8_t>(b3));
+    while (s + 16 <= e)
+    {
+      uint8x16_t vstr = vld1q_u8(reinterpret_cast<const uint8_t*>(s));
+      uint8x16_t veq = vorrq_u8(vorrq_u8(vceqq_u8(vstr, vb1), vceqq_u8(vstr, vb2)), vceqq_u8(vstr, vb3));
+      if (span)
+        veq = vmvnq_u8(veq);
+      uint64x2_t vmask64 = vreinterpretq_u64_u8(veq);
+      if ((vgetq_lane_u64(vmask64, 0) | vgetq_lane_u64(vmask64, 1)) != 0)
+        break;
+      s += 16;
+    }
+  }
+#endif
+  while (s < e && (*s == b1 || *s == b2 || *s == b3) == span)
+    ++s;
+  pos_ = s - buf_;
+}
+
+// match input with the dense transition table, one table lookup per byte
+Pattern::Index Matcher::match_dense(Pattern::Index d, int& c1)
+{
+  const Pattern::Dense *dense = pat_->dns_;
+  const uint8_t *cls = dense->cls;
+  const Pattern::Index *next = &dense->next[0];
+  const Pattern::Index *take = &dense->take[0];
+  Pattern::Index ncls = dense->ncls;
+  Pattern::Index nst = dense->nst;
+  Pattern::Index start = dense->start;
+  while (true)
+  {
+    DBGLOG("Dense: state %u", d);
+    if (take[d] != 0)
+    {
+      cap_ = take[d];
+      cur_ = pos_;
+      DBGLOG("Take: cap = %zu", cap_);
+    }
+    if (c1 == EOF)
+      return Pattern::Const::IMAX;
+    c1 = get();
+    DBGLOG("Get: c1 = %d", c1);
+    if (c1 == EOF)
+      return Pattern::Const::IMAX;
+    Pattern::Index jump = next[static_cast<size_t>(ncls) * d + cls[c1]];
+    if (jump == Pattern::Const::IMAX)
+      return Pattern::Const::IMAX;
+    if (jump >= nst)
+    {
+      jump -= nst;
+      // loop back to start state: failed to match anything so far?
+      if (jump == 0 && cap_ == 0)
+        cur_ = pos_;
+      return jump;
+    }
+    if (jump == start && cap_ == 0)
+      cur_ = pos_;
+    d = jump;
+  }
+}
+
 // advance input cursor position after mismatch to align input for the next match
+Bits Matcher::matching()
+{
+  DBGLOG("BEGIN Matcher::matching()");
+  Bits matches;
+  if (pat_ == NULL)
+    return matches;
+  // without option a, construct the set-matching DFA with a lazy copy of the pattern, the pattern is shared and is not modified here
+  Pattern copy;
+  if (pat_->set_ == NULL)
+    copy.assign(pat_->rex_, pat_->key_options().append("la"));
+  const Pattern::Set& set = *(pat_->set_ != NULL ? pat_->set_ : copy.set_);
+  const Pattern::Index *next = set.next.data();
+  std::vector<uint8_t> seen(set.aix.size() - 1, 0);
+  Pattern::Index state = 0;
+  Pattern::Index prev = 0;
+  int c0 = EOF;
+  size_t loc = pos_;
+  while (true)
+  {
+    while (loc < end_)
+    {
+      int c = static_cast<unsigned char>(buf_[loc++]);
+      seen[state] |= 1;
+      if (c == '\n')
+      {
+        seen[state] |= 2;
+        if (c0 == '\r')
+          seen[prev] |= 2;
+      }
+      prev = state;
+      c0 = c;
+      state = next[(state << 8) + c];
+    }
+    set_current_match(loc);
+    if (peek_more() == EOF)
+      break;
+    loc = cur_;
+  }
+  seen[state] |= 1 | 4;
+  for (size_t s = 0; s < seen.size(); ++s)
+  {
+    if (seen[s] & 1)
+      for (Pattern::Index i = set.aix[s]; i < set.aix[s + 1]; ++i)
+        matches.insert(set.acc[i]);
+    if (seen[s] & 2)
+      for (Pattern::Index i = set.eix[s]; i < set.eix[s + 1]; ++i)
+        matches.insert(set.eol[i]);
+    if (seen[s] & 4)
+      for (Pattern::Index i = set.bix[s]; i < set.bix[s + 1]; ++i)
+        matches.insert(set.eob[i]);
+  }
+  DBGLOG("END Matcher::matching()");
+  return matches;
+}
+
+// find all remaining matches without the per-match overhead of the find() functor and iterator
+size_t Matcher::find_all(std::vector<MatchSpan>& spans)
+{
+  DBGLOG("BEGIN Matcher::find_all()");
+  size_t count = 0;
+  while (Matcher::match(Const::FIND) != 0)
+  {
+    spans.push_back(MatchSpan(first(), size(), accept()));
+    ++count;
+  }
+  DBGLOG("END Matcher::find_all() %zu matches", count);
+  return count;
+}
+
+// returns true if the opcodes never match a newline and have no indent anchors, then the matches found in chunks of lines are the same as the matches found by searching the lines serially
+bool Matcher::is_line_local(const Pattern::Opcode *opc, size_t nop)
+{
+  for (size_t i = 0; i < nop; ++i)
+  {
+    Pattern::Opcode opcode = opc[i];
+    if (!Pattern::is_opcode_goto(opcode))
+      continue;
+    if (Pattern::is_opcode_meta(opcode))
+    {
+      Pattern::Char meta = Pattern::meta_of(opcode);
+      if (meta == Pattern::META_UND || meta == Pattern::META_IND || meta == Pattern::META_DED)
+        return false;
+    }
+    else if (Pattern::is_opcode_goto(opcode, '\n') && Pattern::index_of(opcode) != Pattern::Const::HALT)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// find all remaining matches, searching chunks of lines of the buffered input concurrently when the matches cannot span lines
+size_t Matcher::find_all(std::vector<MatchSpan>& spans, size_t threads, std::vector<size_t> *lines)
+{
+  DBGLOG("BEGIN Matcher::find_all(%zu)", threads);
+  reset_text();
+  size_t count = 0;
+#if defined(WITH_FIND_THREADS)
+  const size_t CHUNK = 65536; // min number of bytes to search per thread
+  if (threads > 1 && lim_ == 0 && !seg_ && pat_ != NULL && pat_->opc_ != NULL && pat_->cache_ == NULL && !opt_.N && is_line_local(pat_->opc_, pat_->nop_))
+  {
+    // read the remaining input into the buffer, including the partial line read ahead with line_buffered()
+    end_ += tal_;
+    tal_ = 0;
+    while (!eof_)
+    {
+      (void)grow();
+      size_t n = get(buf_ + end_, max_ - end_ - 1);
+      if (n > 0)
+        end_ += n;
+      else if (!wrap())
+        eof_ = true;
+    }
+    if (threads > (end_ - cur_) / CHUNK)
+      threads = (end_ - cur_) / CHUNK;
+  }
+  else
+  {
+    threads = 1;
+  }
+  if (threads > 1)
+  {
+    size_t start = cur_;
+    // cut the buffer after a newline at every next chunk
+    std::vector<size_t> cut(threads + 1, end_);
+    cut[0] = start;
+    for (size_t t = 1; t < threads; ++t)
+    {
+      size_t loc = std::max(start + t * ((end_ - start) / threads), cut[t - 1]);
+      const char *s = static_cast<const char*>(std::memchr(buf_ + loc, '\n', end_ - loc));
+      cut[t] = s != NULL ? s - buf_ + 1 : end_;
+    }
+    // the line number at the start, before the buffer is shared by the workers
+    size_t line = 1;
+    if (lines != NULL)
+    {
+      txt_ = buf_ + start;
+      len_ = 0;
+      line = lineno();
+    }
+    std::vector< std::vector<MatchSpan> > found(threads);
+    std::vector< std::vector<size_t> > found_lines(threads);
+    std::vector<size_t> newlines(threads, 0);
+    std::vector<std::exception_ptr> errors(threads);
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t)
+    {
+      workers.push_back(std::thread([&, t]() {
+        try
+        {
+          // a clone of this matcher searches the chunk in place, the chunk ends after a newline where no match can end beyond
+          Matcher worker(*this);
+          worker.buffer(buf_, cut[t + 1] + 1);
+          worker.set_current(cut[t]);
+          if (t == 0)
+            worker.got_ = got_;
+          worker.bol_ = worker.lpb_ = worker.buf_ + cut[t];
+          while (worker.Matcher::match(Const::FIND) != 0)
+          {
+            found[t].push_back(MatchSpan(num_ + worker.first(), worker.size(), worker.accept()));
+            if (lines != NULL)
+              found_lines[t].push_back(worker.lineno());
+          }
+          if (lines != NULL)
+          {
+            worker.txt_ = worker.buf_ + worker.end_;
+            worker.len_ = 0;
+            newlines[t] = worker.lineno() - 1;
+          }
+        }
+        catch (...)
+        {
+          errors[t] = std::current_exception();
+        }
+      }));
+    }
+    for (size_t t = 0; t < threads; ++t)
+      workers[t].join();
+    // merge the matches in order and offset the line numbers of the chunks
+    for (size_t t = 0; t < threads; ++t)
+    {
+      if (errors[t])
+        std::rethrow_exception(errors[t]);
+      spans.insert(spans.end(), found[t].begin(), found[t].end());
+      count += found[t].size();
+      if (lines != NULL)
+      {
+        for (std::vector<size_t>::const_iterator i = found_lines[t].begin(); i != found_lines[t].end(); ++i)
+          lines->push_back(line + *i - 1);
+        line += newlines[t];
+      }
+    }
+    set_current_match(end_);
+    len_ = 0;
+    cap_ = 0;
+    DBGLOG("END Matcher::find_all() %zu matches", count);
+    return count;
+  }
+#else
+  (void)threads;
+#endif
+  while (Matcher::match(Const::FIND) != 0)
+  {
+    spans.push_back(MatchSpan(first(), size(), accept()));
+    if (lines != NULL)
+      lines->push_back(lineno());
+    ++count;
+  }
+  DBGLOG("END Matcher::find_all() %zu matches", count);
+  return count;
+}
+
+// tokenize independent buffers with interleaved dense DFA runs, the transitions of the lanes do not depend on each other
+size_t Matcher::scan_streams(const Pattern& pattern, size_t n, const char *const *data, const size_t *size, std::vector<MatchSpan> *spans)
+{
+  DBGLOG("BEGIN Matcher::scan_streams(%zu)", n);
+  for (size_t i = 0; i < n; ++i)
+    spans[i].clear();
+  // the dense transition table is constructed with option h, the pattern is shared and is not modified here
+  const Pattern::Dense *dense = pattern.dns_;
+  std::vector<size_t> rest; // buffers to tokenize with a matcher
+  size_t count = 0;
+  if (dense != NULL && dense->start != Pattern::Const::IMAX && dense->take[dense->start] == 0)
+  {
+    const size_t LANES = 8;
+    const uint8_t *cls = dense->cls;
+    const Pattern::Index *next = &dense->next[0];
+    const Pattern::Index *take = &dense->take[0];
+    size_t ncls = dense->ncls;
+    Pattern::Index nst = dense->nst;
+    Pattern::Index start = dense->start;
+    size_t str[LANES];         // buffer of each lane
+    const uint8_t *ptr[LANES]; // next byte to read
+    const uint8_t *end[LANES]; // end of the buffer
+    const uint8_t *txt[LANES]; // start of the token
+    const uint8_t *cur[LANES]; // end of the longest match so far
+    Pattern::Index cap[LANES]; // subpattern accepted so far, 0 if none
+    Pattern::Index dst[LANES]; // dense state
+    size_t live = 0;
+    size_t k = 0;
+    while (true)
+    {
+      // assign the next nonempty buffers to the free lanes
+      while (live < LANES && k < n)
+      {
+        if (size[k] > 0)
+        {
+          str[live] = k;
+          txt[live] = ptr[live] = cur[live] = reinterpret_cast<const uint8_t*>(data[k]);
+          end[live] = ptr[live] + size[k];
+          cap[live] = 0;
+          dst[live] = start;
+          ++live;
+        }
+        ++k;
+      }
+      if (live == 0)
+        break;
+      size_t l = 0;
+      while (l < live)
+      {
+        if (ptr[l] < end[l])
+        {
+          Pattern::Index d = next[ncls * dst[l] + cls[*ptr[l]]];
+          if (d < nst)
+          {
+            dst[l] = d;
+            ++ptr[l];
+            if (take[d] != 0)
+            {
+              cap[l] = take[d];
+              cur[l] = ptr[l];
+            }
+            ++l;
+            continue;
+          }
+          if (d != Pattern::Const::IMAX)
+          {
+            // the state is not dense, tokenize this buffer with a matcher instead
+            count -= spans[str[l]].size();
+            rest.push_back(str[l]);
+            cap[l] = 0;
+          }
+        }
+        if (cap[l] != 0)
+        {
+          const uint8_t *base = reinterpret_cast<const uint8_t*>(data[str[l]]);
+          spans[str[l]].push_back(MatchSpan(txt[l] - base, cur[l] - txt[l], cap[l]));
+          ++count;
+          txt[l] = ptr[l] = cur[l];
+          cap[l] = 0;
+          dst[l] = start;
+          if (ptr[l] < end[l])
+          {
+            ++l;
+            continue;
+          }
+        }
+        // the lane is done, move the last lane into this lane
+        --live;
+        str[l] = str[live];
+        ptr[l] = ptr[live];
+        end[l] = end[live];
+        txt[l] = txt[live];
+        cur[l] = cur[live];
+        cap[l] = cap[live];
+        dst[l] = dst[live];
+        if (k < n)
+          break;
+      }
+    }
+  }
+  else
+  {
+    for (size_t i = 0; i < n; ++i)
+      rest.push_back(i);
+  }
+  if (!rest.empty())
+  {
+    Matcher matcher(pattern);
+    for (std::vector<size_t>::const_iterator i = rest.begin(); i != rest.end(); ++i)
+    {
+      spans[*i].clear();
+      matcher.input(Input(data[*i], size[*i]));
+      while (matcher.scan() != 0)
+      {
+        spans[*i].push_back(MatchSpan(matcher.first(), matcher.size(), matcher.accept()));
+        ++count;
+      }
+    }
+  }
+  DBGLOG("END Matcher::scan_streams() %zu tokens", count);
+  return count;
+}
+
+size_t Matcher::predict(size_t loc)
+{
+  if (loc >= end_)
+    return end_;
+  // advance() predicts from cur_ + 1 and never predicts when there is no prefix, no required literal and no minimum length to predict with
+  if (loc == 0 || (pat_->len_ == 0 && pat_->mln_ == 0 && pat_->min_ == 0))
+    return loc;
+  set_current_match(loc - 1);
+  if (advance())
+    return cur_;
+  return end_;
+}
+
+#if defined(WITH_STATS)
+bool Matcher::advance()
+{
+  // absolute positions, since the buffer may shift
+  size_t loc = num_ + cur_ + 1;
+  ++sts_.advances;
+  bool found = advance_search();
+  if (num_ + cur_ > loc)
+    sts_.skipped += num_ + cur_ - loc;
+  if (found)
+    ++sts_.candidates;
+  return found;
+}
+
+bool Matcher::advance_search()
+#else
 bool Matcher::advance()
+#endif
 {
   size_t loc = cur_ + 1;
   size_t min = pat_->min_;
   if (pat_->len_ == 0)
   {
+    if (pat_->mln_ > 0)
+    {
+#if defined(WITH_STATS)
+      ++sts_.paths[Stats::REQUIRED];
+#endif
+      return advance_required(loc);
+    }
     if (min == 0)
       return false;
+#if defined(HAVE_AVX512BW) || defined(HAVE_AVX2) || defined(HAVE_SSE2)
+    if (pat_->lno_ > 0 && have_HW_SSE2())
+#elif defined(HAVE_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+    if (pat_->lno_ > 0)
+#endif
+#if defined(HAVE_AVX512BW) || defined(HAVE_AVX2) || defined(HAVE_SSE2) || (defined(HAVE_NEON) && (defined(__aarch64__) || defined(_M_ARM64)))
+    {
+#if defined(WITH_STATS)
+      ++sts_.paths[Stats::LITERALS];
+#endif
+      return advance_literals(loc);
+    }
+#endif
+    // the wide bitap rescans up to 64 bytes after each refill, which is too slow with small blocks of interactive input
+    if (pat_->wmn_ > 0 && blk_ == 0)
+    {
+#if defined(WITH_STATS)
+      ++sts_.paths[Stats::WIDE];
+#endif
+      return advance_wide(loc);
+    }
+#if defined(WITH_STATS)
+    ++sts_.paths[min >= 4 ? Stats::BITAP : Stats::PMA];
+#endif
     if (loc + min > end_)
     {
       set_current_match(loc - 1);
@@ -130,7 +669,7 @@ bool Matcher::advance()
         {
           s -= min - 1;
           loc = s - buf_;
-          if (Pattern::predict_match(pat_->pmh_, s, min))
+          if (predict_pmh(s, min))
           {
             set_current(loc);
             return true;
@@ -168,7 +707,7 @@ bool Matcher::advance()
         {
           s -= 2;
           loc = s - buf_;
-          if (s + 4 > e || Pattern::predict_match(pma, s) == 0)
+          if (s + 4 > e || predict_pma(s) == 0)
           {
             set_current(loc);
             return true;
@@ -205,7 +744,7 @@ bool Matcher::advance()
         {
           s -= 1;
           loc = s - buf_;
-          if (s + 4 > e || Pattern::predict_match(pma, s) == 0)
+          if (s + 4 > e || predict_pma(s) == 0)
           {
             set_current(loc);
             return true;
@@ -237,7 +776,7 @@ bool Matcher::advance()
           set_current(loc);
           return true;
         }
-        size_t k = Pattern::predict_match(pma, s);
+        size_t k = predict_pma(s);
         if (k == 0)
         {
           set_current(loc);
@@ -256,6 +795,9 @@ bool Matcher::advance()
       }
     }
   }
+#if defined(WITH_STATS)
+  ++sts_.paths[Stats::PREFIX];
+#endif
   const char *pre = pat_->pre_;
   size_t len = pat_->len_; // actually never more than 255
   if (len == 1)
@@ -309,12 +851,12 @@ bool Matcher::advance()
                 return true;
               if (min >= 4)
               {
-                if (loc + len + min > end_ || Pattern::predict_match(pat_->pmh_, &buf_[loc + len], min))
+                if (loc + len + min > end_ || predict_pmh(&buf_[loc + len], min))
                   return true;
               }
               else
               {
-                if (loc + len + 4 > end_ || Pattern::predict_match(pat_->pma_, &buf_[loc + len]) == 0)
+                if (loc + len + 4 > end_ || predict_pma(&buf_[loc + len]) == 0)
                   return true;
               }
             }
@@ -346,12 +888,12 @@ bool Matcher::advance()
                 return true;
               if (min >= 4)
               {
-                if (loc + len + min > end_ || Pattern::predict_match(pat_->pmh_, &buf_[loc + len], min))
+                if (loc + len + min > end_ || predict_pmh(&buf_[loc + len], min))
                   return true;
               }
               else
               {
-                if (loc + len + 4 > end_ || Pattern::predict_match(pat_->pma_, &buf_[loc + len]) == 0)
+                if (loc + len + 4 > end_ || predict_pma(&buf_[loc + len]) == 0)
                   return true;
               }
             }
@@ -383,12 +925,12 @@ bool Matcher::advance()
                 return true;
               if (min >= 4)
               {
-                if (loc + len + min > end_ || Pattern::predict_match(pat_->pmh_, &buf_[loc + len], min))
+                if (loc + len + min > end_ || predict_pmh(&buf_[loc + len], min))
                   return true;
               }
               else
               {
-                if (loc + len + 4 > end_ || Pattern::predict_match(pat_->pma_, &buf_[loc + len]) == 0)
+                if (loc + len + 4 > end_ || predict_pma(&buf_[loc + len]) == 0)
                   return true;
               }
             }
@@ -421,12 +963,12 @@ bool Matcher::advance()
                 return true;
               if (min >= 4)
               {
-                if (loc + len + min > end_ || Pattern::predict_match(pat_->pmh_, &buf_[loc + len], min))
+                if (loc + len + min > end_ || predict_pmh(&buf_[loc + len], min))
                   return true;
               }
               else
               {
-                if (loc + len + 4 > end_ || Pattern::predict_match(pat_->pma_, &buf_[loc + len]) == 0)
+                if (loc + len + 4 > end_ || predict_pma(&buf_[loc + len]) == 0)
                   return true;
               }
             }
@@ -458,12 +1000,12 @@ bool Matcher::advance()
                 return true;
               if (min >= 4)
               {
-                if (loc + len + min > end_ || Pattern::predict_match(pat_->pmh_, &buf_[loc + len], min))
+                if (loc + len + min > end_ || predict_pmh(&buf_[loc + len], min))
                   return true;
               }
               else
               {
-                if (loc + len + 4 > end_ || Pattern::predict_match(pat_->pma_, &buf_[loc + len]) == 0)
+                if (loc + len + 4 > end_ || predict_pma(&buf_[loc + len]) == 0)
                   return true;
               }
             }
@@ -496,12 +1038,12 @@ bool Matcher::advance()
                 return true;
               if (min >= 4)
               {
-                if (loc + len + min > end_ || Pattern::predict_match(pat_->pmh_, &buf_[loc + len], min))
+                if (loc + len + min > end_ || predict_pmh(&buf_[loc + len], min))
                   return true;
               }
               else
               {
-                if (loc + len + 4 > end_ || Pattern::predict_match(pat_->pma_, &buf_[loc + len]) == 0)
+                if (loc + len + 4 > end_ || predict_pma(&buf_[loc + len]) == 0)
                   return true;
               }
             }
@@ -535,12 +1077,12 @@ bool Matcher::advance()
                 return true;
               if (min >= 4)
               {
-                if (loc + len + min > end_ || Pattern::predict_match(pat_->pmh_, &buf_[loc + len], min))
+                if (loc + len + min > end_ || predict_pmh(&buf_[loc + len], min))
                   return true;
               }
               else
               {
-                if (loc + len + 4 > end_ || Pattern::predict_match(pat_->pma_, &buf_[loc + len]) == 0)
+                if (loc + len + 4 > end_ || predict_pma(&buf_[loc + len]) == 0)
                   return true;
               }
             }
@@ -560,12 +1102,12 @@ bool Matcher::advance()
                 return true;
               if (min >= 4)
               {
-                if (loc + len + min > end_ || Pattern::predict_match(pat_->pmh_, &buf_[loc + len], min))
+                if (loc + len + min > end_ || predict_pmh(&buf_[loc + len], min))
                   return true;
               }
               else
               {
-                if (loc + len + 4 > end_ || Pattern::predict_match(pat_->pma_, &buf_[loc + len]) == 0)
+                if (loc + len + 4 > end_ || predict_pma(&buf_[loc + len]) == 0)
                   return true;
               }
             }
@@ -593,12 +1135,12 @@ bool Matcher::advance()
             return true;
           if (min >= 4)
           {
-            if (loc + len + min > end_ || Pattern::predict_match(pat_->pmh_, &buf_[loc + len], min))
+            if (loc + len + min > end_ || predict_pmh(&buf_[loc + len], min))
               return true;
           }
           else
           {
-            if (loc + len + 4 > end_ || Pattern::predict_match(pat_->pma_, &buf_[loc + len]) == 0)
+            if (loc + len + 4 > end_ || predict_pma(&buf_[loc + len]) == 0)
               return true;
           }
         }
@@ -640,12 +1182,12 @@ bool Matcher::advance()
             return true;
           if (min >= 4)
           {
-            if (loc + len + min > end_ || Pattern::predict_match(pat_->pmh_, &buf_[loc + len], min))
+            if (loc + len + min > end_ || predict_pmh(&buf_[loc + len], min))
               return true;
           }
           else
           {
-            if (loc + len + 4 > end_ || Pattern::predict_match(pat_->pma_, &buf_[loc + len]) == 0)
+            if (loc + len + 4 > end_ || predict_pma(&buf_[loc + len]) == 0)
               return true;
           }
         }
@@ -673,4 +1215,828 @@ bool Matcher::advance()
   }
 }
 
+// advance input cursor position to the next possible match predicted by the wide bitap prefilter
+bool Matcher::advance_wide(size_t loc)
+{
+  const size_t wmn = pat_->wmn_;
+  const size_t min = pat_->min_;
+  while (true)
+  {
+    if (loc + wmn <= end_)
+    {
+      // test the bytes at each position of the wide bitap at all possible match starts s < e
+      const char *s = buf_ + loc;
+#if defined(HAVE_AVX512BW) || defined(HAVE_AVX2) || (defined(HAVE_NEON) && (defined(__aarch64__) || defined(_M_ARM64)))
+      const char *e = buf_ + end_ - wmn + 1;
+#endif
+#if defined(HAVE_AVX512BW) && (!defined(_MSC_VER) || defined(_WIN64))
+      if (have_HW_AVX512BW())
+      {
+        // test 64 positions at a time, the nibble tables of a position select the bit of the high nibble of the bytes that may occur
+        __m512i vnib = _mm512_set1_epi8(0x0F);
+        __m512i vhib = _mm512_broadcast_i32x4(_mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128));
+        while (s + 64 <= e)
+        {
+          uint64_t mask = ~0ULL;
+          for (size_t k = 0; k < wmn && mask != 0; ++k)
+          {
+            __m512i vlo = _mm512_broadcast_i32x4(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pat_->wlo_[k])));
+            __m512i vstr = _mm512_loadu_si512(reinterpret_cast<const __m512i*>(s + k));
+            __m512i vstrlo = _mm512_and_si512(vstr, vnib);
+            __m512i vstrhi = _mm512_and_si512(_mm512_srli_epi16(vstr, 4), vnib);
+            __m512i vbit = _mm512_and_si512(_mm512_shuffle_epi8(vlo, vstrlo), _mm512_shuffle_epi8(vhib, vstrhi));
+            mask &= _mm512_test_epi8_mask(vbit, vbit);
+          }
+          while (mask != 0)
+          {
+            const char *q = s + ctzl(mask);
+            if (predict_pmh(q, min))
+            {
+              set_current(q - buf_);
+              return true;
+            }
+            mask &= mask - 1;
+          }
+          s += 64;
+        }
+      }
+      else
+#endif
+#if defined(HAVE_AVX512BW) || defined(HAVE_AVX2)
+      if (have_HW_AVX2())
+      {
+        // test 32 positions at a time, the nibble tables of a position select the bit of the high nibble of the bytes that may occur
+        __m256i vnib = _mm256_set1_epi8(0x0F);
+        __m256i vhib = _mm256_broadcastsi128_si256(_mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128));
+        __m256i vzero = _mm256_setzero_si256();
+        while (s + 32 <= e)
+        {
+          uint32_t mask = ~0U;
+          for (size_t k = 0; k < wmn && mask != 0; ++k)
+          {
+            __m256i vlo = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pat_->wlo_[k])));
+            __m256i vstr = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + k));
+            __m256i vstrlo = _mm256_and_si256(vstr, vnib);
+            __m256i vstrhi = _mm256_and_si256(_mm256_srli_epi16(vstr, 4), vnib);
+            __m256i vbit = _mm256_and_si256(_mm256_shuffle_epi8(vlo, vstrlo), _mm256_shuffle_epi8(vhib, vstrhi));
+            mask &= ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(vbit, vzero)));
+          }
+          while (mask != 0)
+          {
+            const char *q = s + ctz(mask);
+            if (predict_pmh(q, min))
+            {
+              set_current(q - buf_);
+              return true;
+            }
+            mask &= mask - 1;
+          }
+          s += 32;
+        }
+      }
+#elif defined(HAVE_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+      {
+        // test 16 positions at a time, the nibble tables of a position select the bit of the high nibble of the bytes that may occur
+        static const uint8_t hib[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+        uint8x16_t vnib = vdupq_n_u8(0x0F);
+        uint8x16_t vhib = vld1q_u8(hib);
+        while (s + 16 <= e)
+        {
+          // the mask has four bits per position, narrowed from the byte compare results
+          uint64_t mask = ~0ULL;
+          for (size_t k = 0; k < wmn && mask != 0; ++k)
+          {
+            uint8x16_t vlo = vld1q_u8(pat_->wlo_[k]);
+            uint8x16_t vstr = vld1q_u8(reinterpret_cast<const uint8_t*>(s + k));
+            uint8x16_t vbit = vandq_u8(vqtbl1q_u8(vlo, vandq_u8(vstr, vnib)), vqtbl1q_u8(vhib, vshrq_n_u8(vstr, 4)));
+            mask &= vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(vtstq_u8(vbit, vbit)), 4)), 0);
+          }
+          mask &= 0x8888888888888888ULL;
+          while (mask != 0)
+          {
+            const char *q = s + (ctzl(mask) >> 2);
+            if (predict_pmh(q, min))
+            {
+              set_current(q - buf_);
+              return true;
+            }
+            mask &= mask - 1;
+          }
+          s += 16;
+        }
+      }
+#endif
+      // 64 bit shift-or bitap over the remaining positions
+      const uint64_t *wbt = pat_->wbt_;
+      const uint64_t last = 1ULL << (wmn - 1);
+      uint64_t state = ~0ULL;
+      const char *t = s;
+      const char *f = buf_ + end_;
+      while (t < f)
+      {
+        state = (state << 1) | wbt[static_cast<uint8_t>(*t++)];
+        if ((state & last) == 0)
+        {
+          const char *q = t - wmn;
+          if (predict_pmh(q, min))
+          {
+            set_current(q - buf_);
+            return true;
+          }
+        }
+      }
+      loc = end_ - wmn + 1;
+    }
+    set_current_match(loc - 1);
+    (void)peek_more();
+    loc = cur_ + 1;
+    if (loc + wmn > end_)
+      return false;
+  }
+}
+
+// advance input cursor position to the next possible match that contains the required literal
+bool Matcher::advance_required(size_t loc)
+{
+  const char *lit = pat_->mst_;
+  const size_t len = pat_->mln_;
+  const size_t dist = pat_->mdt_;
+  if (bmd_ == 0 || lcp_ >= len || (lcs_ >= len && lcs_ != 0xffff))
+    boyer_moore_init(lit, len);
+  const size_t lcs = lcs_ < len ? lcs_ : lcp_;
+  // keep is the earliest possible match start, no match starts before keep
+  size_t keep = loc;
+  const char *q = NULL;
+  while (true)
+  {
+    if (loc + len <= end_)
+    {
+      // search the required literal by its two rarest chars at positions s < e
+      const char *s = buf_ + loc + lcp_;
+      const char *e = buf_ + end_ + lcp_ - len + 1;
+#if defined(HAVE_AVX512BW) || defined(HAVE_AVX2)
+      if (have_HW_AVX2())
+      {
+        // implements AVX2 string search scheme based on in http://0x80.pl/articles/simd-friendly-karp-rabin.html
+        __m256i vlcp = _mm256_set1_epi8(lit[lcp_]);
+        __m256i vlcs = _mm256_set1_epi8(lit[lcs]);
+        while (s + 32 <= e)
+        {
+          __m256i vlcpm = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s));
+          __m256i vlcsm = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + lcs - lcp_));
+          __m256i vlcpeq = _mm256_cmpeq_epi8(vlcp, vlcpm);
+          __m256i vlcseq = _mm256_cmpeq_epi8(vlcs, vlcsm);
+          uint32_t mask = _mm256_movemask_epi8(_mm256_and_si256(vlcpeq, vlcseq));
+          while (mask != 0)
+          {
+            uint32_t offset = ctz(mask);
+            if (std::memcmp(s - lcp_ + offset, lit, len) == 0)
+            {
+              q = s - lcp_ + offset;
+              goto found;
+            }
+            mask &= mask - 1;
+          }
+          s += 32;
+        }
+      }
+      else
+#endif
+#if defined(HAVE_AVX512BW) || defined(HAVE_AVX2) || defined(HAVE_SSE2)
+      if (have_HW_SSE2())
+      {
+        // implements SSE2 string search scheme based on in http://0x80.pl/articles/simd-friendly-karp-rabin.html
+        __m128i vlcp = _mm_set1_epi8(lit[lcp_]);
+        __m128i vlcs = _mm_set1_epi8(lit[lcs]);
+        while (s + 16 <= e)
+        {
+          __m128i vlcpm = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+          __m128i vlcsm = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + lcs - lcp_));
+          __m128i vlcpeq = _mm_cmpeq_epi8(vlcp, vlcpm);
+          __m128i vlcseq = _mm_cmpeq_epi8(vlcs, vlcsm);
+          uint32_t mask = _mm_movemask_epi8(_mm_and_si128(vlcpeq, vlcseq));
+          while (mask != 0)
+          {
+            uint32_t offset = ctz(mask);
+            if (std::memcmp(s - lcp_ + offset, lit, len) == 0)
+            {
+              q = s - lcp_ + offset;
+              goto found;
+            }
+            mask &= mask - 1;
+          }
+          s += 16;
+        }
+      }
+#elif defined(HAVE_NEON)
+      {
+        // implements NEON/AArch64 string search scheme based on in http://0x80.pl/articles/simd-friendly-karp-rabin.html
+        uint8x16_t vlcp = vdupq_n_u8(lit[lcp_]);
+        uint8x16_t vlcs = vdupq_n_u8(lit[lcs]);
+        while (s + 16 <= e)
+        {
+          uint8x16_t vlcpm = vld1q_u8(reinterpret_cast<const uint8_t*>(s));
+          uint8x16_t vlcsm = vld1q_u8(reinterpret_cast<const uint8_t*>(s) + lcs - lcp_);
+          uint8x16_t vmask8 = vandq_u8(vceqq_u8(vlcp, vlcpm), vceqq_u8(vlcs, vlcsm));
+          uint64x2_t vmask64 = vreinterpretq_u64_u8(vmask8);
+          for (int k = 0; k < 2; ++k)
+          {
+            uint64_t mask = k == 0 ? vgetq_lane_u64(vmask64, 0) : vgetq_lane_u64(vmask64, 1);
+            for (int i = 0; mask != 0; ++i, mask >>= 8)
+            {
+              if ((mask & 0xff) && std::memcmp(s - lcp_ + 8 * k + i, lit, len) == 0)
+              {
+                q = s - lcp_ + 8 * k + i;
+                goto found;
+              }
+            }
+          }
+          s += 16;
+        }
+      }
+#endif
+      while (s < e)
+      {
+        do
+          s = static_cast<const char*>(std::memchr(s, lit[lcp_], e - s));
+        while (s != NULL && s[lcs - lcp_] != lit[lcs] && ++s < e);
+        if (s == NULL || s >= e)
+          break;
+        if (std::memcmp(s - lcp_, lit, len) == 0)
+        {
+          q = s - lcp_;
+          goto found;
+        }
+        ++s;
+      }
+      loc = end_ - len + 1;
+    }
+    // no match starts before the positions that are too far from the literal, or before the last newline
+    if (dist == 0xFFFF)
+    {
+      for (size_t i = loc; i > keep; --i)
+      {
+        if (buf_[i - 1] == '\n')
+        {
+          keep = i;
+          break;
+        }
+      }
+    }
+    else if (loc > keep + dist)
+    {
+      keep = loc - dist;
+    }
+    {
+      // get more input, keeping the text from the earliest possible match start on
+      size_t off = loc - keep;
+      size_t rest = end_ - keep;
+      set_current_match(keep - 1);
+      (void)peek_more();
+      keep = cur_ + 1;
+      loc = keep + off;
+      if (end_ - keep <= rest)
+      {
+        // no more input and no more literals: no match
+        set_current(end_);
+        return false;
+      }
+    }
+    continue;
+found:
+    // back up from the required literal to the earliest possible match start
+    size_t start = q - buf_;
+    const Pattern::Reverse *rev = pat_->rev_;
+    if (rev != NULL)
+    {
+      // run the reverse DFA backward from the literal, the leftmost position reached in a final state is the earliest possible match start
+      const Pattern::Index *next = rev->next.data();
+      Pattern::Index state = 1;
+      size_t first = rev->fin[state] ? start : end_;
+      for (size_t i = start; i > keep && state != 0; )
+      {
+        state = next[(state << 8) + static_cast<uint8_t>(buf_[--i])];
+        if (rev->fin[state])
+          first = i;
+      }
+      if (first == end_)
+      {
+        // no match starts at or before the literal, continue after it
+        loc = keep = start + 1;
+        continue;
+      }
+      start = first;
+    }
+    else if (dist == 0xFFFF)
+    {
+      while (start > keep && buf_[start - 1] != '\n')
+        --start;
+    }
+    else
+    {
+      start = start > keep + dist ? start - dist : keep;
+    }
+    set_current(start);
+    return true;
+  }
+}
+
+// split the input at the next literal delimiter pre_[0..len_-1], the text split off is txt_[0..len_-1]
+size_t Matcher::split_literal()
+{
+  const char *pre = pat_->pre_;
+  const size_t len = pat_->len_;
+  const int got = got_;
+  txt_ = buf_ + cur_;
+  // the delimiter is searched from off bytes after the start of the text on
+  size_t off = 0;
+  while (true)
+  {
+    size_t loc = txt_ - buf_ + off;
+    if (loc + len <= end_)
+    {
+      const char *s = buf_ + loc;
+      const char *e = buf_ + end_ - len + 1;
+      while (s < e)
+      {
+        s = static_cast<const char*>(std::memchr(s, pre[0], e - s));
+        if (s == NULL)
+          break;
+        if (std::memcmp(s + 1, pre + 1, len - 1) == 0)
+        {
+          len_ = s - txt_;
+          set_current(s - buf_ + len);
+          DBGLOG("Split literal: len = %zu", len_);
+          return cap_ = 1;
+        }
+        ++s;
+      }
+      off = end_ - len + 1 - (txt_ - buf_);
+    }
+    // get more input, keeping the text from txt_ on
+    size_t rest = end_ - (txt_ - buf_);
+    pos_ = cur_ = end_;
+    (void)peek_more();
+    if (end_ - (txt_ - buf_) <= rest)
+    {
+      // no more input: the rest is the last text split off, if any
+      len_ = rest;
+      cap_ = rest > 0 || got != Const::EOB ? Const::EMPTY : 0;
+      set_current(end_);
+      got_ = Const::EOB;
+      DBGLOG("Split literal at eof: cap = %zu len = %zu", cap_, len_);
+#if defined(WITH_STATS)
+      if (cap_ == 0)
+        ++sts_.misses;
+#endif
+      return cap_;
+    }
+  }
+}
+
+#if defined(HAVE_AVX512BW) || defined(HAVE_AVX2) || defined(HAVE_SSE2) || (defined(HAVE_NEON) && (defined(__aarch64__) || defined(_M_ARM64)))
+
+// advance input cursor position to the next literal prefix of the multi-literal prefilter
+bool Matcher::advance_literals(size_t loc)
+{
+  const size_t lno = pat_->lno_;
+  const uint8_t *lln = pat_->lln_;
+  size_t lmin = Pattern::Const::LLEN;
+  size_t lmax = 0;
+  for (size_t i = 0; i < lno; ++i)
+  {
+    if (lln[i] < lmin)
+      lmin = lln[i];
+    if (lln[i] > lmax)
+      lmax = lln[i];
+  }
+  while (true)
+  {
+    const char *s = buf_ + loc;
+    if (loc + lmax <= end_)
+    {
+      // all literals can be compared at positions s < e
+      const char *e = buf_ + end_ - lmax + 1;
+#if defined(HAVE_AVX512BW) || defined(HAVE_AVX2)
+      if (have_HW_AVX2())
+      {
+        // implements the Teddy multi-literal scheme: the nibbles of the first lfp_ bytes select literal bit masks
+        const size_t lfp = pat_->lfp_;
+        __m256i vlo[3];
+        __m256i vhi[3];
+        for (size_t k = 0; k < lfp; ++k)
+        {
+          vlo[k] = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pat_->tlo_[k])));
+          vhi[k] = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pat_->thi_[k])));
+        }
+        __m256i vnib = _mm256_set1_epi8(0x0F);
+        __m256i vzero = _mm256_setzero_si256();
+        while (s + 32 <= e)
+        {
+          __m256i vres = _mm256_set1_epi8(-1);
+          for (size_t k = 0; k < lfp; ++k)
+          {
+            __m256i vstr = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + k));
+            __m256i vstrlo = _mm256_and_si256(vstr, vnib);
+            __m256i vstrhi = _mm256_and_si256(_mm256_srli_epi16(vstr, 4), vnib);
+            vres = _mm256_and_si256(vres, _mm256_and_si256(_mm256_shuffle_epi8(vlo[k], vstrlo), _mm256_shuffle_epi8(vhi[k], vstrhi)));
+          }
+          uint32_t mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(vres, vzero)));
+          if (mask != 0)
+          {
+            uint8_t bits[32];
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(bits), vres);
+            while (mask != 0)
+            {
+              uint32_t offset = ctz(mask);
+              for (uint8_t b = bits[offset]; b != 0; b &= b - 1)
+              {
+                size_t i = ctz(b);
+                if (std::memcmp(s + offset, pat_->lit_[i], lln[i]) == 0)
+                {
+                  set_current(s + offset - buf_);
+                  return true;
+                }
+              }
+              mask &= mask - 1;
+            }
+          }
+          s += 32;
+        }
+      }
+      else
+#endif
+#if defined(HAVE_AVX512BW) || defined(HAVE_AVX2) || defined(HAVE_SSE2)
+      {
+        // compare the first two bytes of each literal at 16 positions at a time
+        const size_t lfp = pat_->lfp_ < 2 ? 1 : 2;
+        __m128i vlit[Pattern::Const::LITS][2];
+        for (size_t i = 0; i < lno; ++i)
+          for (size_t k = 0; k < lfp; ++k)
+            vlit[i][k] = _mm_set1_epi8(pat_->lit_[i][k]);
+        while (s + 16 <= e)
+        {
+          __m128i vstr0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+          __m128i vstr1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 1));
+          __m128i vres = _mm_setzero_si128();
+          for (size_t i = 0; i < lno; ++i)
+          {
+            __m128i veq = _mm_cmpeq_epi8(vlit[i][0], vstr0);
+            if (lfp > 1)
+              veq = _mm_and_si128(veq, _mm_cmpeq_epi8(vlit[i][1], vstr1));
+            vres = _mm_or_si128(vres, veq);
+          }
+          uint32_t mask = _mm_movemask_epi8(vres);
+          while (mask != 0)
+          {
+            uint32_t offset = ctz(mask);
+            for (size_t i = 0; i < lno; ++i)
+            {
+              if (std::memcmp(s + offset, pat_->lit_[i], lln[i]) == 0)
+              {
+                set_current(s + offset - buf_);
+                return true;
+              }
+            }
+            mask &= mask - 1;
+          }
+          s += 16;
+        }
+      }
+#else
+      {
+        // implements the Teddy multi-literal scheme: the nibbles of the first lfp_ bytes select literal bit masks
+        const size_t lfp = pat_->lfp_;
+        uint8x16_t vlo[3];
+        uint8x16_t vhi[3];
+        for (size_t k = 0; k < lfp; ++k)
+        {
+          vlo[k] = vld1q_u8(pat_->tlo_[k]);
+          vhi[k] = vld1q_u8(pat_->thi_[k]);
+        }
+        uint8x16_t vnib = vdupq_n_u8(0x0F);
+        while (s + 16 <= e)
+        {
+          uint8x16_t vres = vdupq_n_u8(0xFF);
+          for (size_t k = 0; k < lfp; ++k)
+          {
+            uint8x16_t vstr = vld1q_u8(reinterpret_cast<const uint8_t*>(s + k));
+            vres = vandq_u8(vres, vandq_u8(vqtbl1q_u8(vlo[k], vandq_u8(vstr, vnib)), vqtbl1q_u8(vhi[k], vshrq_n_u8(vstr, 4))));
+          }
+          // the mask has four bits per position, narrowed from the nonzero literal bit masks
+          uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(vtstq_u8(vres, vres)), 4)), 0) & 0x8888888888888888ULL;
+          if (mask != 0)
+          {
+            uint8_t bits[16];
+            vst1q_u8(bits, vres);
+            while (mask != 0)
+            {
+              uint32_t offset = ctzl(mask) >> 2;
+              for (uint8_t b = bits[offset]; b != 0; b &= b - 1)
+              {
+                size_t i = ctz(b);
+                if (std::memcmp(s + offset, pat_->lit_[i], lln[i]) == 0)
+                {
+                  set_current(s + offset - buf_);
+                  return true;
+                }
+              }
+              mask &= mask - 1;
+            }
+          }
+          s += 16;
+        }
+      }
+#endif
+      while (s < e)
+      {
+        for (size_t i = 0; i < lno; ++i)
+        {
+          if (*s == pat_->lit_[i][0] && std::memcmp(s, pat_->lit_[i], lln[i]) == 0)
+          {
+            set_current(s - buf_);
+            return true;
+          }
+        }
+        ++s;
+      }
+    }
+    // get more input, keeping the positions not yet searched
+    loc = s - buf_;
+    size_t rest = end_ - loc;
+    set_current_match(loc - 1);
+    (void)peek_more();
+    loc = cur_ + 1;
+    if (end_ - loc <= rest)
+    {
+      // no more input: search the remaining positions for the shorter literals
+      for (; loc + lmin <= end_; ++loc)
+      {
+        for (size_t i = 0; i < lno; ++i)
+        {
+          if (loc + lln[i] <= end_ && std::memcmp(buf_ + loc, pat_->lit_[i], lln[i]) == 0)
+          {
+            set_current(loc);
+            return true;
+          }
+        }
+      }
+      return false;
+    }
+  }
+}
+
+#endif
+
+
+/// Buffers of at least this size are aligned to and advised to use 2MB transparent huge pages.
+static const size_t BUFFER_HUGE = 2097152;
+
+/// Buffers larger than this are not kept in the per-thread pool.
+static const size_t BUFFER_POOL_MAX = 4194304;
+
+#if defined(WITH_BUFFER_POOL)
+
+/// Per-thread pool of freed buffers, trivially destructible to remain usable by matchers destroyed after the thread's BufferPoolGuard.
+struct BufferPool {
+  static const size_t SIZE = 8; ///< max number of buffers kept
+  char  *buf[SIZE];             ///< freed buffers, the most recently freed last
+  size_t size[SIZE];            ///< size of the freed buffers
+  size_t num;                   ///< number of buffers in the pool
+  bool   live;                  ///< true when the pool accepts buffers, false after the thread's BufferPoolGuard is destroyed
+};
+
+static thread_local BufferPool buffer_pool = { { NULL }, { 0 }, 0, false };
+
+static void buffer_free(char *buf, size_t size);
+
+/// Frees the buffers in the pool when the thread exits.
+struct BufferPoolGuard {
+  BufferPoolGuard()
+  {
+    buffer_pool.live = true;
+  }
+  ~BufferPoolGuard()
+  {
+    buffer_pool.live = false;
+    while (buffer_pool.num > 0)
+    {
+      --buffer_pool.num;
+      buffer_free(buffer_pool.buf[buffer_pool.num], buffer_pool.size[buffer_pool.num]);
+    }
+  }
+};
+
+#endif
+
+/// Allocate a page-aligned buffer, aligned to 2MB and advised to use transparent huge pages when at least BUFFER_HUGE.
+static char *buffer_alloc(size_t size)
+{
+#if defined(WITH_REALLOC)
+#if (defined(__WIN32__) || defined(_WIN32) || defined(WIN32) || defined(_WIN64) || defined(__BORLANDC__)) && !defined(__CYGWIN__) && !defined(__MINGW32__) && !defined(__MINGW64__)
+  char *buf = static_cast<char*>(_aligned_malloc(size, 4096));
+  if (buf == NULL)
+    throw std::bad_alloc();
+#else
+  char *buf = NULL;
+#if defined(WITH_HUGE_PAGES)
+  if (size >= BUFFER_HUGE)
+  {
+    if (::posix_memalign(reinterpret_cast<void**>(&buf), BUFFER_HUGE, size) != 0)
+      throw std::bad_alloc();
+    (void)::madvise(buf, size & ~(BUFFER_HUGE - 1), MADV_HUGEPAGE);
+    return buf;
+  }
+#endif
+  if (::posix_memalign(reinterpret_cast<void**>(&buf), 4096, size) != 0)
+    throw std::bad_alloc();
+#endif
+  return buf;
+#else
+  return new char[size];
+#endif
+}
+
+/// Free a buffer allocated with buffer_alloc().
+static void buffer_free(char *buf, size_t)
+{
+#if defined(WITH_REALLOC)
+#if (defined(__WIN32__) || defined(_WIN32) || defined(WIN32) || defined(_WIN64) || defined(__BORLANDC__)) && !defined(__CYGWIN__) && !defined(__MINGW32__) && !defined(__MINGW64__)
+  _aligned_free(static_cast<void*>(buf));
+#else
+  std::free(static_cast<void*>(buf));
+#endif
+#else
+  delete[] buf;
+#endif
+}
+
+AbstractMatcher::DefaultAllocator& AbstractMatcher::DefaultAllocator::instance()
+{
+  static DefaultAllocator allocator;
+  return allocator;
+}
+
+char *AbstractMatcher::DefaultAllocator::allocate(size_t size)
+{
+#if defined(WITH_BUFFER_POOL)
+  // reuse the most recently freed buffer of the same size, which is likely cached and local to this thread's NUMA node
+  for (size_t i = buffer_pool.num; i > 0; --i)
+  {
+    if (buffer_pool.size[i - 1] == size)
+    {
+      char *buf = buffer_pool.buf[i - 1];
+      --buffer_pool.num;
+      for (; i <= buffer_pool.num; ++i)
+      {
+        buffer_pool.buf[i - 1] = buffer_pool.buf[i];
+        buffer_pool.size[i - 1] = buffer_pool.size[i];
+      }
+      return buf;
+    }
+  }
+#endif
+  return buffer_alloc(size);
+}
+
+char *AbstractMatcher::DefaultAllocator::reallocate(char *buf, size_t size, size_t new_size, size_t keep)
+{
+#if defined(WITH_REALLOC)
+#if defined(WITH_HUGE_PAGES)
+  // realloc() does not align to huge pages
+  if (new_size < BUFFER_HUGE)
+#endif
+  {
+#if (defined(__WIN32__) || defined(_WIN32) || defined(WIN32) || defined(_WIN64) || defined(__BORLANDC__)) && !defined(__CYGWIN__) && !defined(__MINGW32__) && !defined(__MINGW64__)
+    char *newbuf = static_cast<char*>(_aligned_realloc(static_cast<void*>(buf), new_size, 4096));
+#else
+    char *newbuf = static_cast<char*>(std::realloc(static_cast<void*>(buf), new_size));
+#endif
+    if (newbuf == NULL)
+      throw std::bad_alloc();
+    return newbuf;
+  }
+#endif
+  char *newbuf = allocate(new_size);
+  std::memcpy(newbuf, buf, keep);
+  deallocate(buf, size);
+  return newbuf;
+}
+
+void AbstractMatcher::DefaultAllocator::deallocate(char *buf, size_t size)
+{
+#if defined(WITH_BUFFER_POOL)
+  if (size <= BUFFER_POOL_MAX)
+  {
+    static thread_local BufferPoolGuard guard;
+    if (buffer_pool.live)
+    {
+      if (buffer_pool.num == BufferPool::SIZE)
+      {
+        // the pool is full, free the least recently freed buffer
+        buffer_free(buffer_pool.buf[0], buffer_pool.size[0]);
+        --buffer_pool.num;
+        for (size_t i = 0; i < buffer_pool.num; ++i)
+        {
+          buffer_pool.buf[i] = buffer_pool.buf[i + 1];
+          buffer_pool.size[i] = buffer_pool.size[i + 1];
+        }
+      }
+      buffer_pool.buf[buffer_pool.num] = buf;
+      buffer_pool.size[buffer_pool.num] = size;
+      ++buffer_pool.num;
+      return;
+    }
+  }
+#endif
+  buffer_free(buf, size);
+}
+
+AbstractMatcher::RingAllocator::~RingAllocator()
+{
+#if defined(WITH_RING_BUFFER)
+  for (std::map<char*,size_t>::iterator i = rings_.begin(); i != rings_.end(); ++i)
+    ::munmap(i->first, 2 * i->second + static_cast<size_t>(::sysconf(_SC_PAGESIZE)));
+#endif
+}
+
+char *AbstractMatcher::RingAllocator::allocate(size_t size)
+{
+#if defined(WITH_RING_BUFFER)
+  // map the pages of a shared memory object twice in a reserved region of twice the size plus a readable guard page
+  size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+  size_t len = (size + page - 1) / page * page;
+#if defined(MFD_CLOEXEC)
+  int fd = ::memfd_create("reflex", MFD_CLOEXEC);
+#else
+  char name[] = "/tmp/reflex.XXXXXX";
+  int fd = ::mkstemp(name);
+  if (fd >= 0)
+    ::unlink(name);
+#endif
+  if (fd >= 0)
+  {
+    char *base = NULL;
+    if (::ftruncate(fd, static_cast<off_t>(len)) == 0)
+    {
+      void *addr = ::mmap(NULL, 2 * len + page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (addr != MAP_FAILED)
+      {
+        base = static_cast<char*>(addr);
+        if (::mmap(base, len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED ||
+            ::mmap(base + len, len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED)
+        {
+          ::munmap(addr, 2 * len + page);
+          base = NULL;
+        }
+      }
+    }
+    ::close(fd);
+    if (base != NULL)
+    {
+      rings_[base] = len;
+      return base;
+    }
+  }
+#endif
+  return DefaultAllocator::instance().allocate(size);
+}
+
+void AbstractMatcher::RingAllocator::deallocate(char *buf, size_t size)
+{
+#if defined(WITH_RING_BUFFER)
+  std::map<char*,size_t>::iterator i = ring(buf);
+  if (i != rings_.end())
+  {
+    ::munmap(i->first, 2 * i->second + static_cast<size_t>(::sysconf(_SC_PAGESIZE)));
+    rings_.erase(i);
+    return;
+  }
+#endif
+  DefaultAllocator::instance().deallocate(buf, size);
+}
+
+char *AbstractMatcher::RingAllocator::rotate(char *buf, size_t size, size_t gap)
+{
+  std::map<char*,size_t>::iterator i = ring(buf);
+  if (i == rings_.end() || size > i->second)
+    return NULL;
+  // the data at buf[gap] is also located len bytes before it, keep the buffer in the first mapping
+  buf += gap;
+  if (buf >= i->first + i->second)
+    buf -= i->second;
+  return buf;
+}
+
+std::map<char*,size_t>::iterator AbstractMatcher::RingAllocator::ring(char *buf)
+{
+  std::map<char*,size_t>::iterator i = rings_.upper_bound(buf);
+  if (i == rings_.begin())
+    return rings_.end();
+  --i;
+  if (buf >= i->first + i->second)
+    return rings_.end();
+  return i;
+}
+
 } // namespace reflex
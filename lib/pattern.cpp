@@ -40,6 +40,21 @@
 #include <cerrno>
 #include <cmath>
 
+/// Parallel subset construction with option j=n; requires C++11 threads.
+#if __cplusplus >= 201103L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201103L)
+# define WITH_COMPILE_THREADS
+# include <atomic>
+# include <exception>
+# include <thread>
+#endif
+
+/// Native code compilation of the opcode table with Pattern::jit() on x86-64, disabled with WITH_NO_JIT.
+#if !defined(WITH_NO_JIT) && (defined(__x86_64__) || defined(__amd64__)) && (defined(__unix__) || defined(__APPLE__))
+# define WITH_JIT
+# include <reflex/matcher.h>
+# include <sys/mman.h>
+#endif
+
 /// DFA compaction: -1 == reverse order edge compression (best); 1 == edge compression; 0 == no edge compression.
 /** Edge compression reorders edges to produce fewer tests when executed in the compacted order.
     For example ([a-cg-ik]|d|[e-g]|j|y|[x-z]) after reverse edge compression has only 2 edges:
@@ -103,6 +118,13 @@ static void print_char(FILE *file, int c, bool h = false)
     ::fprintf(file, "%u", c);
 }
 
+template<typename K>
+static size_t profile_count(const std::map<K,size_t>& counts, const K& key)
+{
+  typename std::map<K,size_t>::const_iterator i = counts.find(key);
+  return i != counts.end() ? i->second : 0;
+}
+
 static const char *posix_class[] = {
   "ASCII",
   "Space",
@@ -164,10 +186,21 @@ void Pattern::error(regex_error_type code, size_t pos) const
 void Pattern::init(const char *options, const uint8_t *pred)
 {
   init_options(options);
+  init_pattern(pred);
+}
+
+void Pattern::init_pattern(const uint8_t *pred)
+{
   nop_ = 0;
+  nla_ = 0;
   len_ = 0;
   min_ = 0;
   one_ = false;
+  lno_ = 0;
+  lfp_ = 0;
+  mln_ = 0;
+  mdt_ = 0;
+  wmn_ = 0;
   if (opc_ || fsm_)
   {
     if (pred != NULL)
@@ -175,10 +208,11 @@ void Pattern::init(const char *options, const uint8_t *pred)
       len_ = pred[0];
       min_ = pred[1] & 0x0f;
       one_ = pred[1] & 0x10;
+      opt_.h = pred[1] & 0x40;
       memcpy(pre_, pred + 2, len_);
+      size_t n = len_ + 2;
       if (min_ > 0)
       {
-        size_t n = len_ + 2;
         if (min_ > 1 && len_ == 0)
         {
           for (size_t i = 0; i < 256; ++i)
@@ -195,40 +229,736 @@ void Pattern::init(const char *options, const uint8_t *pred)
           for (size_t i = 0; i < Const::HASH; ++i)
             pma_[i] = ~pred[i + n];
         }
+        n += Const::HASH;
+        if ((pred[1] & 0x20) && len_ == 0 && pred[n] <= Const::LITS)
+        {
+          // literal prefixes of the multi-literal prefilter
+          lno_ = pred[n++];
+          for (size_t i = 0; i < lno_; ++i)
+            lln_[i] = pred[n++];
+          for (size_t i = 0; i < lno_; ++i)
+          {
+            if (lln_[i] == 0 || lln_[i] > Const::LLEN)
+            {
+              lno_ = 0;
+              break;
+            }
+            memcpy(lit_[i], pred + n, lln_[i]);
+            n += lln_[i];
+          }
+          init_literals();
+        }
+      }
+      if ((pred[1] & 0x80) && len_ == 0 && lno_ == 0)
+      {
+        // required literal of the required literal prefilter
+        mln_ = pred[n++];
+        memcpy(mst_, pred + n, mln_);
+        n += mln_;
+        mdt_ = pred[n] | (pred[n + 1] << 8);
       }
     }
   }
+  else if (opt_.l > 0 && opt_.f.empty())
+  {
+    // lazy DFA construction, but not when exporting the DFA with option f
+    init_cache();
+  }
+  else
+  {
+    try
+    {
+      Positions startpos;
+      Follow    followpos;
+      Map       modifiers;
+      Map       lookahead;
+      // parse the regex pattern to construct the followpos NFA without epsilon transitions
+      parse(startpos, followpos, modifiers, lookahead);
+      // start state = startpos = firstpost of the followpos NFA, also merge the tree DFA root when non-NULL
+      DFA::State *start = dfa_.state(tfa_.tree, startpos);
+      // compile the NFA into a DFA
+      compile(start, followpos, modifiers, lookahead);
+      // assemble DFA opcode tables or direct code
+      assemble(start);
+      // delete the DFA
+      dfa_.clear();
+    }
+    catch (const regex_error& err)
+    {
+      dfa_.clear();
+      tfa_.clear();
+      if (err.code() != regex_error::exceeds_budget || !opt_.g || !opt_.f.empty())
+        throw;
+      // fall back to lazy DFA construction with the default cache size of option l
+      DBGLOG("Budget exceeded, falling back to lazy DFA construction");
+      end_.clear();
+      acc_.clear();
+      nop_ = 0;
+      len_ = 0;
+      min_ = 0;
+      one_ = false;
+      lno_ = 0;
+      lfp_ = 0;
+      mln_ = 0;
+      mdt_ = 0;
+      wmn_ = 0;
+      opt_.l = 4096;
+      init_cache();
+    }
+  }
+  if (opt_.a)
+    init_set();
+  if (opt_.h && opt_.f.empty())
+    init_dense();
+  if (cache_ == NULL)
+    init_lookaheads();
+}
+
+void Pattern::init_lookaheads()
+{
+  // count the lookahead positions of the opcodes, so the matcher reserves them in advance
+  nla_ = 0;
+  if (opc_ != NULL)
+  {
+    for (Index i = 0; i < nop_; ++i)
+      if (is_opcode_head(opc_[i]) || is_opcode_tail(opc_[i]))
+        nla_ = std::max(nla_, static_cast<size_t>(lookahead_of(opc_[i])) + 1);
+  }
+}
+
+Pattern& Pattern::append(const char *regex)
+{
+  DBGLOG("BEGIN append(%s)", regex);
+  if (rex_.empty() && end_.empty())
+    return assign(regex);
+  if (set_ != NULL)
+  {
+    delete set_;
+    set_ = NULL;
+  }
+  if (dns_ != NULL)
+  {
+    delete dns_;
+    dns_ = NULL;
+  }
+  if (rev_ != NULL)
+  {
+    delete rev_;
+    rev_ = NULL;
+  }
+  size_t size = rex_.size();
+  rex_.append("|").append(regex);
+  if (cache_ != NULL)
+  {
+    // extend the NFA of the lazy DFA with the appended subpatterns only, then flush the DFA states cached
+    size_t num = end_.size();
+    Positions startpos(cache_->startpos);
+    Lazy lazy = cache_->lazy;
+    try
+    {
+      parse(cache_->startpos, cache_->followpos, cache_->modifiers, cache_->lookahead, static_cast<Location>(size + 1), &cache_->lazy);
+    }
+    catch (...)
+    {
+      rex_.resize(size);
+      end_.resize(num);
+      // the strings of the appended subpatterns merged into the tree DFA so far no longer accept
+      for (Tree::List::iterator i = tfa_.list.begin(); i != tfa_.list.end(); ++i)
+        for (uint16_t j = 0; j < Tree::ALLOC; ++j)
+          if ((*i)[j].accept > num)
+            (*i)[j].accept = 0;
+      cache_->startpos.swap(startpos);
+      cache_->lazy = lazy;
+      cache_start();
+      throw;
+    }
+    acc_.assign(end_.size(), true);
+    cache_start();
+  }
   else
+  {
+    // recompile the combined regex with the same options
+    Option opt(opt_);
+    std::string rex;
+    rex.swap(rex_);
+    clear();
+    rex_.swap(rex);
+    opt_ = opt;
+    init_pattern(NULL);
+  }
+  if (opt_.a)
+    init_set();
+  DBGLOG("END append()");
+  return *this;
+}
+
+void Pattern::init_cache()
+{
+  DBGLOG("BEGIN init_cache()");
+  cache_ = new Cache;
+  cache_->max = opt_.l;
+  cache_->table = new DFA::State*[65536];
+  // parse the regex pattern to construct the followpos NFA, the DFA states are constructed when reached by a match
+  parse(cache_->startpos, cache_->followpos, cache_->modifiers, cache_->lookahead, 0, &cache_->lazy);
+  // subpatterns are not known to be unreachable until all DFA states are constructed
+  acc_.assign(end_.size(), true);
+  vms_ = 0.0;
+  ems_ = 0.0;
+  wms_ = 0.0;
+  cache_start();
+  DBGLOG("END init_cache()");
+}
+
+void Pattern::init_set()
+{
+  DBGLOG("BEGIN init_set()");
+  if (set_ != NULL)
+    return;
+  Set *set = new Set;
+  try
   {
     Positions startpos;
     Follow    followpos;
     Map       modifiers;
     Map       lookahead;
-    // parse the regex pattern to construct the followpos NFA without epsilon transitions
-    parse(startpos, followpos, modifiers, lookahead);
-    // start state = startpos = firstpost of the followpos NFA, also merge the tree DFA root when non-NULL
-    DFA::State *start = dfa_.state(tfa_.tree, startpos);
-    // compile the NFA into a DFA
-    compile(start, followpos, modifiers, lookahead);
-    // assemble DFA opcode tables or direct code
-    assemble(start);
-    // delete the DFA
-    dfa_.clear();
+    if (!end_.empty())
+    {
+      // parse the regex pattern without a tree DFA, such that all subpatterns are NFA positions
+      std::vector<Location> end;
+      end.swap(end_);
+      float pms = pms_;
+      try
+      {
+        parse(startpos, followpos, modifiers, lookahead, 0, NULL, false);
+      }
+      catch (...)
+      {
+        end_.swap(end);
+        throw;
+      }
+      end_.swap(end);
+      pms_ = pms;
+    }
+    // lookaheads are not supported by set matching
+    for (Map::const_iterator i = lookahead.begin(); i != lookahead.end(); ++i)
+      if (!i->second.empty())
+        throw regex_error(regex_error::invalid_anchor, rex_, rex_.size());
+    // the start positions are added to every state to find matches anywhere in the input, begin anchors
+    // are checked by the DFA after the first char of a match, so a state also records if a match started
+    // at the next char is at the begin of a line (1) or at the begin of the input and a line (2)
+    typedef std::pair<Positions,int> Key;
+    typedef std::map<Key,Index> States;
+    States states;
+    std::vector<Key> todo;
+    todo.push_back(Key(startpos, 2));
+    states[todo.back()] = 0;
+    Chars bol;
+    bol.insert(META_BOL);
+    Chars bob(bol);
+    bob.insert(META_BOB);
+    Chars eol;
+    eol.insert(META_EOL);
+    Chars eob(eol);
+    eob.insert(META_EOB);
+    Moves start;
+    {
+      DFA::State state;
+      Positions(startpos).swap(state);
+      compile_transition(&state, followpos, modifiers, lookahead, start, true);
+      set_supported(start);
+    }
+    for (Index s = 0; s < todo.size(); ++s)
+    {
+      Positions pos(todo[s].first);
+      int anchor = todo[s].second;
+      const Chars& begin = anchor > 1 ? bob : bol;
+      Positions eolpos(pos);
+      set_closure(eolpos, eol, followpos, modifiers, lookahead);
+      Positions eobpos(pos);
+      set_closure(eobpos, eob, followpos, modifiers, lookahead);
+      if (anchor > 0)
+      {
+        // empty matches started here satisfy the begin anchors
+        Positions from(startpos);
+        set_closure(from, begin, followpos, modifiers, lookahead);
+        pos.insert(from.begin(), from.end());
+        from = startpos;
+        set_closure(from, begin | eol, followpos, modifiers, lookahead);
+        eolpos.insert(from.begin(), from.end());
+        from = startpos;
+        set_closure(from, begin | eob, followpos, modifiers, lookahead);
+        eobpos.insert(from.begin(), from.end());
+      }
+      set->aix.push_back(static_cast<Index>(set->acc.size()));
+      set_accepts(pos, set->acc);
+      set->eix.push_back(static_cast<Index>(set->eol.size()));
+      set_accepts(eolpos, set->eol);
+      set->bix.push_back(static_cast<Index>(set->eob.size()));
+      set_accepts(eobpos, set->eob);
+      DFA::State state;
+      Positions(todo[s].first).swap(state);
+      Moves moves;
+      compile_transition(&state, followpos, modifiers, lookahead, moves, true);
+      set_supported(moves);
+      std::vector<Positions> targets(256);
+      for (Moves::const_iterator i = moves.begin(); i != moves.end(); ++i)
+        for (Char c = 0; c < 256; ++c)
+          if (i->first.contains(c))
+            targets[c].insert(i->second.begin(), i->second.end());
+      if (anchor > 0)
+      {
+        // matches started at the next char satisfy the begin anchors
+        for (Moves::const_iterator i = start.begin(); i != start.end(); ++i)
+        {
+          for (Char c = 0; c < 256; ++c)
+          {
+            if (i->first.contains(c))
+            {
+              Positions from(i->second);
+              set_closure(from, begin, followpos, modifiers, lookahead);
+              targets[c].insert(from.begin(), from.end());
+            }
+          }
+        }
+      }
+      for (Char c = 0; c < 256; ++c)
+      {
+        Key target(Positions(), c == '\n');
+        target.first.swap(targets[c]);
+        target.first.insert(startpos.begin(), startpos.end());
+        std::pair<States::iterator,bool> next = states.insert(States::value_type(target, static_cast<Index>(todo.size())));
+        if (next.second)
+        {
+          if (todo.size() >= Set::MAX)
+            error(regex_error::exceeds_limits, rex_.size());
+          todo.push_back(target);
+        }
+        set->next.push_back(next.first->second);
+      }
+    }
+    set->aix.push_back(static_cast<Index>(set->acc.size()));
+    set->eix.push_back(static_cast<Index>(set->eol.size()));
+    set->bix.push_back(static_cast<Index>(set->eob.size()));
+  }
+  catch (...)
+  {
+    delete set;
+    throw;
+  }
+  set_ = set;
+  DBGLOG("END init_set()");
+}
+
+void Pattern::init_dense()
+{
+  DBGLOG("BEGIN init_dense()");
+  if (dns_ != NULL || cache_ != NULL || opc_ == NULL)
+    return;
+  Dense *dense = new Dense;
+  std::vector<Index> pcs;     // per dense state its opcode index
+  std::vector<bool>  visited; // states visited by opcode index
+  std::vector<Index> todo(1, 0);
+  std::vector<Index> targets;
+  Index col[256];
+  uint64_t hash[256];
+  for (int c = 0; c < 256; ++c)
+    hash[c] = 0;
+  // visit the states reachable from the start state, hash the columns of the dense states to group bytes into classes
+  while (!todo.empty())
+  {
+    Index pc = todo.back();
+    todo.pop_back();
+    if (pc < visited.size() && visited[pc])
+      continue;
+    if (pc >= visited.size())
+      visited.resize(pc + 1, false);
+    visited[pc] = true;
+    Index take;
+    targets.clear();
+    int kind = dense_state(pc, take, col, targets);
+    if (kind < 0)
+    {
+      delete dense;
+      return;
+    }
+    todo.insert(todo.end(), targets.begin(), targets.end());
+    if (kind > 0)
+    {
+      if (pc >= dense->map.size())
+        dense->map.resize(pc + 1, static_cast<Index>(Const::IMAX));
+      dense->map[pc] = static_cast<Index>(pcs.size());
+      pcs.push_back(pc);
+      dense->take.push_back(take);
+      for (int c = 0; c < 256; ++c)
+        hash[c] = (hash[c] ^ col[c]) * 0x100000001B3ULL;
+    }
+  }
+  dense->map.resize(visited.size(), static_cast<Index>(Const::IMAX));
+  dense->nst = static_cast<Index>(pcs.size());
+  std::vector<uint64_t> hashes(hash, hash + 256);
+  std::sort(hashes.begin(), hashes.end());
+  hashes.erase(std::unique(hashes.begin(), hashes.end()), hashes.end());
+  dense->ncls = static_cast<Index>(hashes.size());
+  if (dense->nst == 0 || static_cast<size_t>(dense->nst) * dense->ncls > Dense::MAX)
+  {
+    DBGLOG("No dense table for %u states and %u classes", dense->nst, dense->ncls);
+    delete dense;
+    return;
+  }
+  int rep[256]; // a representative byte of each class
+  for (int c = 255; c >= 0; --c)
+  {
+    dense->cls[c] = static_cast<uint8_t>(std::lower_bound(hashes.begin(), hashes.end(), hash[c]) - hashes.begin());
+    rep[dense->cls[c]] = c;
+  }
+  dense->start = dense->map[0];
+  dense->next.resize(static_cast<size_t>(dense->nst) * dense->ncls);
+  for (Index d = 0; d < dense->nst; ++d)
+  {
+    Index take;
+    targets.clear();
+    dense_state(pcs[d], take, col, targets);
+    for (int c = 0; c < 256; ++c)
+    {
+      if (col[c] != col[rep[dense->cls[c]]])
+      {
+        // hash collision, give up
+        delete dense;
+        return;
+      }
+    }
+    Index *next = &dense->next[static_cast<size_t>(d) * dense->ncls];
+    for (Index k = 0; k < dense->ncls; ++k)
+    {
+      Index target = col[rep[k]];
+      if (target == Const::IMAX)
+        next[k] = Const::IMAX;
+      else if (dense->map[target] != Const::IMAX)
+        next[k] = dense->map[target];
+      else
+        next[k] = dense->nst + target;
+    }
+  }
+  dns_ = dense;
+  DBGLOG("END init_dense() %u states %u classes", dense->nst, dense->ncls);
+}
+
+int Pattern::dense_state(
+    Index               pc,
+    Index&              take,
+    Index              *col,
+    std::vector<Index>& targets) const
+{
+  // decode the opcodes of the state at pc like Matcher::match() does, returns 1 if the state is dense, 0 if not, -1 if invalid
+  bool covered[256];
+  size_t count = 0;
+  for (int c = 0; c < 256; ++c)
+    covered[c] = false;
+  take = 0;
+  int kind = 1;
+  if (is_opcode_skip(opc_[pc]) || is_opcode_span(opc_[pc]))
+    ++pc;
+  if (is_opcode_take(opc_[pc]))
+    take = long_index_of(opc_[pc++]);
+  if (is_opcode_halt(opc_[pc]))
+    kind = 0; // Matcher::match() halts without reading input
+  while (count < 256)
+  {
+    if (nop_ > 0 && pc >= nop_)
+      return -1;
+    Opcode opcode = opc_[pc++];
+    if (is_opcode_goto(opcode))
+    {
+      Index index = index_of(opcode);
+      if (index == Const::LONG)
+        index = long_index_of(opc_[pc++]);
+      else if (index == Const::HALT)
+        index = Const::IMAX;
+      if (index != Const::IMAX)
+        targets.push_back(index);
+      for (Char c = lo_of(opcode); c <= hi_of(opcode); ++c)
+      {
+        if (!covered[c])
+        {
+          covered[c] = true;
+          col[c] = index;
+          ++count;
+        }
+      }
+    }
+    else if (is_opcode_make(opcode))
+    {
+      return -1;
+    }
+    else if (is_opcode_take(opcode) || is_opcode_redo(opcode) || is_opcode_tail(opcode) || is_opcode_head(opcode))
+    {
+      kind = 0;
+    }
+    else
+    {
+      // meta transition
+      kind = 0;
+      Index index = index_of(opcode);
+      if (index == Const::LONG)
+        index = long_index_of(opc_[pc++]);
+      if (index != Const::HALT)
+        targets.push_back(index);
+    }
+  }
+  return kind;
+}
+
+void Pattern::set_closure(
+    Positions&   pos,
+    const Chars& metas,
+    Follow&      followpos,
+    const Map&   modifiers,
+    const Map&   lookahead) const
+{
+  // add the positions reached by transitions on the meta chars, until no new positions are reached
+  while (true)
+  {
+    DFA::State state;
+    Positions(pos).swap(state);
+    Moves moves;
+    compile_transition(&state, followpos, modifiers, lookahead, moves, true);
+    set_supported(moves);
+    size_t size = pos.size();
+    for (Moves::const_iterator i = moves.begin(); i != moves.end(); ++i)
+      if (i->first.intersects(metas))
+        pos.insert(i->second.begin(), i->second.end());
+    if (pos.size() == size)
+      break;
+  }
+}
+
+void Pattern::set_supported(const Moves& moves) const
+{
+  // word boundaries and indent anchors are not supported by set matching
+  Chars unsupported;
+  unsupported.insert(META_NWB, META_EWE);
+  unsupported.insert(META_UND, META_DED);
+  for (Moves::const_iterator i = moves.begin(); i != moves.end(); ++i)
+    if (i->first.intersects(unsupported))
+      throw regex_error(regex_error::invalid_anchor, rex_, rex_.size());
+}
+
+void Pattern::set_accepts(
+    const Positions&    pos,
+    std::vector<Index>& acc) const
+{
+  // add the subpatterns accepted by the positions in increasing order without duplicates
+  size_t size = acc.size();
+  for (Positions::const_iterator p = pos.begin(); p != pos.end(); ++p)
+  {
+    if (p->accept() && !p->negate())
+    {
+      Index accept = p->accepts();
+      if (std::find(acc.begin() + size, acc.end(), accept) == acc.end())
+        acc.push_back(accept);
+    }
+  }
+  std::sort(acc.begin() + size, acc.end());
+}
+
+void Pattern::cache_start()
+{
+  DBGLOG("BEGIN cache_start()");
+  // flush the cache and make the start state
+  dfa_.clear();
+  for (int i = 0; i < 65536; ++i)
+    cache_->table[i] = NULL;
+  cache_->states.clear();
+  cache_->stubs.clear();
+  cache_->refs.clear();
+  cache_->code.clear();
+  vno_ = 0;
+  eno_ = 0;
+  cno_ = 0;
+  Positions startpos(cache_->startpos);
+  DFA::State *start = dfa_.state(tfa_.tree, startpos);
+  trim_lazy(start);
+  // start state should only be discoverable (to possibly cycle back to) if no tree DFA was constructed
+  if (start->tnode == NULL)
+    cache_->table[hash_pos(start)] = start;
+  start->first = 0;
+  start->index = Const::IMAX;
+  cache_->last = start;
+  cache_->states.push_back(start);
+  cache_->stubs.push_back(static_cast<Index>(Const::IMAX));
+  cache_->refs.push_back(std::vector<Index>());
+  // the start state is made first at opcode index 0
+  cache_make(0);
+  DBGLOG("END cache_start()");
+}
+
+Pattern::Index Pattern::cache_make(Index id)
+{
+  DBGLOG("BEGIN cache_make(%u)", id);
+  DFA::State *state = cache_->states[id];
+  if (state->index != Const::IMAX)
+    return state->index;
+  timer_type t;
+  timer_start(t);
+  DFA::State *last_state = cache_->last;
+  float ems = ems_;
+  compile_state(state, cache_->followpos, cache_->modifiers, cache_->lookahead, cache_->table, cache_->last);
+  vms_ += timer_elapsed(t) - (ems_ - ems);
+  timer_start(t);
+  std::vector<Opcode>& code = cache_->code;
+  // number the new DFA states, their stubs are added after this state's opcodes
+  Index first_num = static_cast<Index>(cache_->states.size());
+  if (cache_->last != last_state)
+  {
+    for (DFA::State *next = last_state->next; next != NULL; next = next->next)
+    {
+      Index num = static_cast<Index>(cache_->states.size());
+      if (num >= 0xFA0000) // MAKE opcodes must not be mistaken for GOTO opcodes
+        throw regex_error(regex_error::exceeds_limits, rex_, rex_.size());
+      next->first = num;
+      next->index = Const::IMAX;
+      cache_->states.push_back(next);
+      cache_->stubs.push_back(static_cast<Index>(Const::IMAX));
+      cache_->refs.push_back(std::vector<Index>());
+    }
+  }
+  compact_dfa_state(state);
+  if (state->accept > Const::AMAX)
+    state->accept = Const::AMAX;
+  // add final dead state (HALT opcode) only when needed, i.e. skip dead state if all chars 0-255 are already covered
+#if WITH_COMPACT_DFA == -1
+  Char hi = 0x00;
+  for (DFA::State::Edges::const_iterator i = state->edges.begin(); i != state->edges.end(); ++i)
+    if (i->first == hi)
+      hi = i->second.first + 1;
+  if (hi <= 0xFF)
+    state->edges[hi] = std::pair<Char,DFA::State*>(0xFF, static_cast<DFA::State*>(NULL));
+#else
+  Char lo = 0xFF;
+  bool covered = false;
+  for (DFA::State::Edges::const_reverse_iterator i = state->edges.rbegin(); i != state->edges.rend(); ++i)
+  {
+    if (i->first == lo)
+    {
+      if (i->second.first == 0x00)
+        covered = true;
+      else
+        lo = i->second.first - 1;
+    }
+  }
+  if (!covered)
+    state->edges[lo] = std::pair<Char,DFA::State*>(0x00, static_cast<DFA::State*>(NULL));
+#endif
+  state->index = static_cast<Index>(code.size());
+  if (id > 0)
+  {
+    Opcode loop = loop_opcode(state);
+    if (loop != 0)
+      code.push_back(loop);
+  }
+  if (state->redo)
+    code.push_back(opcode_redo());
+  else if (state->accept > 0)
+    code.push_back(opcode_take(state->accept));
+  for (Lookaheads::const_iterator i = state->tails.begin(); i != state->tails.end(); ++i)
+  {
+    if (!valid_lookahead_index(static_cast<Index>(*i)))
+      throw regex_error(regex_error::exceeds_limits, rex_, rex_.size());
+    code.push_back(opcode_tail(static_cast<Index>(*i)));
+  }
+  for (Lookaheads::const_iterator i = state->heads.begin(); i != state->heads.end(); ++i)
+  {
+    if (!valid_lookahead_index(static_cast<Index>(*i)))
+      throw regex_error(regex_error::exceeds_limits, rex_, rex_.size());
+    code.push_back(opcode_head(static_cast<Index>(*i)));
+  }
+  // meta edges first, then the edges in reverse order with the dead state last, like encode_dfa()
+  for (DFA::State::Edges::const_reverse_iterator i = state->edges.rbegin(); i != state->edges.rend(); ++i)
+  {
+#if WITH_COMPACT_DFA == -1
+    Char lo = i->first;
+    Char hi = i->second.first;
+#else
+    Char lo = i->second.first;
+    Char hi = i->first;
+#endif
+    const DFA::State *target = i->second.second;
+    Char max = hi;
+    if (is_meta(lo))
+      hi = lo;
+    while (true)
+    {
+      if (target == NULL)
+      {
+        code.push_back(opcode_goto(lo, hi, Const::HALT));
+      }
+      else if (target->index < Const::LONG)
+      {
+        code.push_back(opcode_goto(lo, hi, target->index));
+      }
+      else if (target->index != Const::IMAX)
+      {
+        code.push_back(opcode_goto(lo, hi, Const::LONG));
+        code.push_back(opcode_long(target->index));
+      }
+      else
+      {
+        // jump to the stub to make the target state, the jump is patched when the target state is made
+        code.push_back(opcode_goto(lo, hi, Const::LONG));
+        cache_->refs[target->first].push_back(static_cast<Index>(code.size()));
+        code.push_back(opcode_long(cache_->stubs[target->first]));
+      }
+      if (hi >= max)
+        break;
+      lo = hi = lo + 1;
+    }
+  }
+  // add the MAKE opcode stubs of the new DFA states and patch the jumps to them
+  for (Index num = first_num; num < cache_->states.size(); ++num)
+  {
+    Index stub = static_cast<Index>(code.size());
+    cache_->stubs[num] = stub;
+    const std::vector<Index>& refs = cache_->refs[num];
+    for (std::vector<Index>::const_iterator i = refs.begin(); i != refs.end(); ++i)
+      code[*i] = opcode_long(stub);
+    code.push_back(opcode_make(num));
   }
+  if (!valid_goto_index(static_cast<Index>(code.size())))
+    throw regex_error(regex_error::exceeds_limits, rex_, rex_.size());
+  // patch the jumps to the stub of this state
+  std::vector<Index>& refs = cache_->refs[id];
+  for (std::vector<Index>::const_iterator i = refs.begin(); i != refs.end(); ++i)
+    code[*i] = opcode_long(state->index);
+  std::vector<Index>().swap(refs);
+  opc_ = &code[0];
+  nop_ = static_cast<Index>(code.size());
+  wms_ += timer_elapsed(t);
+  DBGLOG("END cache_make(%u) = %u", id, state->index);
+  return state->index;
 }
 
 void Pattern::init_options(const char *options)
 {
+  opt_.a = false;
   opt_.b = false;
+  opt_.c = 0;
+  opt_.d = false;
+  opt_.g = false;
+  opt_.h = false;
   opt_.i = false;
+  opt_.j = 0;
+  opt_.k = 0;
+  opt_.l = 0;
   opt_.m = false;
   opt_.o = false;
   opt_.p = false;
   opt_.q = false;
   opt_.r = false;
   opt_.s = false;
+  opt_.t = 0;
   opt_.w = false;
   opt_.x = false;
+  opt_.y = false;
   opt_.e = '\\';
   if (options != NULL)
   {
@@ -236,19 +966,77 @@ void Pattern::init_options(const char *options)
     {
       switch (*s)
       {
+        case 'a':
+          opt_.a = true;
+          break;
         case 'b':
           opt_.b = true;
           break;
+        case 'c':
+          opt_.c = 0;
+          if (s[1] == '=')
+          {
+            char *r = NULL;
+            opt_.c = static_cast<size_t>(std::strtoul(s + 2, &r, 10));
+            s = r;
+            if (*s != ';')
+              --s;
+          }
+          break;
+        case 'd':
+          opt_.d = true;
+          break;
         case 'e':
           opt_.e = (*(s += (s[1] == '=') + 1) == ';' || *s == '\0' ? 256 : *s++);
           --s;
           break;
+        case 'g':
+          opt_.g = true;
+          break;
+        case 'h':
+          opt_.h = true;
+          break;
         case 'p':
           opt_.p = true;
           break;
         case 'i':
           opt_.i = true;
           break;
+        case 'j':
+          opt_.j = 0;
+          if (s[1] == '=')
+          {
+            char *r = NULL;
+            opt_.j = static_cast<size_t>(std::strtoul(s + 2, &r, 10));
+            s = r;
+            if (*s != ';')
+              --s;
+          }
+          break;
+        case 'k':
+          opt_.k = 0;
+          if (s[1] == '=')
+          {
+            char *r = NULL;
+            opt_.k = static_cast<size_t>(std::strtoul(s + 2, &r, 10));
+            s = r;
+            if (*s != ';')
+              --s;
+          }
+          break;
+        case 'l':
+          opt_.l = 4096;
+          if (s[1] == '=')
+          {
+            char *r = NULL;
+            size_t max = static_cast<size_t>(std::strtoul(s + 2, &r, 10));
+            if (r > s + 2 && max > 0)
+              opt_.l = max;
+            s = r;
+            if (*s != ';')
+              --s;
+          }
+          break;
         case 'm':
           opt_.m = true;
           break;
@@ -264,12 +1052,42 @@ void Pattern::init_options(const char *options)
         case 's':
           opt_.s = true;
           break;
+        case 't':
+          opt_.t = 0;
+          if (s[1] == '=')
+          {
+            char *r = NULL;
+            opt_.t = static_cast<size_t>(std::strtoul(s + 2, &r, 10));
+            s = r;
+            if (*s != ';')
+              --s;
+          }
+          break;
+        case 'u':
+        case 'v':
+          {
+            std::string& file = *s == 'u' ? opt_.u : opt_.v;
+            for (const char *t = s += (s[1] == '='); *s != ';' && *s != '\0'; ++t)
+            {
+              if (*t == ';' || *t == '\0')
+              {
+                if (t > s + 1)
+                  file = std::string(s + 1, t - s - 1);
+                s = t;
+              }
+            }
+            --s;
+          }
+          break;
         case 'w':
           opt_.w = true;
           break;
         case 'x':
           opt_.x = true;
           break;
+        case 'y':
+          opt_.y = true;
+          break;
         case 'z':
             for (const char *t = s += (s[1] == '='); *s != ';' && *s != '\0'; ++t)
             {
@@ -310,22 +1128,25 @@ void Pattern::parse(
     Positions& startpos,
     Follow&    followpos,
     Map&       modifiers,
-    Map&       lookahead)
+    Map&       lookahead,
+    Location   from,
+    Lazy      *lazy,
+    bool       tree)
 {
   DBGLOG("BEGIN parse()");
   if (rex_.size() > Position::MAXLOC)
     throw regex_error(regex_error::exceeds_length, rex_, Position::MAXLOC);
   Location   len = static_cast<Location>(rex_.size());
-  Location   loc = 0;
-  Accept     choice = 1;
-  Lazy       lazyidx = 0;
+  Location   loc = from;
+  Accept     choice = static_cast<Accept>(end_.size() + 1);
+  Lazy       lazyidx = lazy != NULL ? *lazy : 0;
   Positions  firstpos;
   Positions  lastpos;
   bool       nullable;
   Iter       iter;
   timer_type t;
   timer_start(t);
-  if (at(0) == '(' && at(1) == '?')
+  if (from == 0 && at(0) == '(' && at(1) == '?')
   {
     loc = 2;
     while (at(loc) == '-' || std::isalnum(at(loc)))
@@ -364,7 +1185,7 @@ void Pattern::parse(
   do
   {
     Location end = loc;
-    if (!opt_.q && !opt_.x)
+    if (!opt_.q && !opt_.x && tree)
     {
       // TODO: perhaps allow \< \> and ^ $ anchors with string patterns?
       while (true)
@@ -434,6 +1255,7 @@ void Pattern::parse(
       }
       if (t->accept == 0)
         t->accept = choice;
+      end_.push_back(loc);
     }
     else
     {
@@ -480,6 +1302,8 @@ void Pattern::parse(
     if (++choice == 0)
       error(regex_error::exceeds_limits, loc); // overflow: too many top-level alternations (should never happen)
   } while (at(loc++) == '|');
+  if (lazy != NULL)
+    *lazy = lazyidx;
   if (opt_.i)
     update_modified('i', modifiers, 0, len - 1);
   if (opt_.m)
@@ -1285,8 +2109,9 @@ void Pattern::compile(
   // init stats and timers
   vno_ = 0;
   eno_ = 0;
+  cno_ = 0;
   ems_ = 0.0;
-  timer_type vt, et;
+  timer_type vt;
   timer_start(vt);
   // construct the DFA
   acc_.resize(end_.size(), false);
@@ -1300,195 +2125,463 @@ void Pattern::compile(
     table[hash_pos(start)] = start;
   // last added state
   DFA::State *last_state = start;
-  for (DFA::State *state = start; state; state = state->next)
+  // the time budget of option t includes parsing
+  tms_ = pms_;
+  try
   {
-    Moves moves;
-    timer_start(et);
-    // use the tree DFA accept state, if present
-    if (state->tnode != NULL && state->tnode->accept > 0)
-      state->accept = state->tnode->accept;
-    compile_transition(
-        state,
-        followpos,
-        modifiers,
-        lookahead,
-        moves);
-    if (state->tnode != NULL)
+#ifdef WITH_COMPILE_THREADS
+    if (opt_.j > 1 && !opt_.w)
     {
-      // merge tree DFA transitions into the final DFA transitions to target states
-      if (moves.empty())
-      {
-        // no DFA transitions: the final DFA transitions are the tree DFA transitions to target states
-        for (Char c = 0; c < 256; ++c)
-        {
-          if (state->tnode->edge[c] != NULL)
-          {
-            DFA::State *target_state = last_state = last_state->next = dfa_.state(state->tnode->edge[c]);
-            if (opt_.i && std::isalpha(c))
-            {
-              state->edges[lowercase(c)] = std::pair<Char,DFA::State*>(lowercase(c), target_state);
-              state->edges[uppercase(c)] = std::pair<Char,DFA::State*>(uppercase(c), target_state);
-              eno_ += 2;
-            }
-            else
-            {
-              state->edges[c] = std::pair<Char,DFA::State*>(c, target_state);
-              ++eno_;
-            }
-          }
-        }
+      compile_parallel(start, followpos, modifiers, lookahead, table, last_state);
+    }
+    else
+#endif
+    {
+      timer_type bt;
+      timer_start(bt);
+      for (DFA::State *state = start; state; state = state->next)
+      {
+        compile_state(state, followpos, modifiers, lookahead, table, last_state);
+        if (opt_.t > 0)
+          tms_ += timer_elapsed(bt);
+        compile_budget();
       }
-      else
+    }
+  }
+  catch (...)
+  {
+    delete[] table;
+    throw;
+  }
+  delete[] table;
+  tfa_.clear();
+  vms_ = timer_elapsed(vt) - ems_;
+  dgs_.clear();
+  dgl_.clear();
+  if (opt_.y)
+    diagnose_dfa(start);
+  DBGLOG("END compile()");
+}
+
+void Pattern::diagnose_dfa(DFA::State *start)
+{
+  // count the DFA states with positions of each subpattern and keep the states with the most positions
+  static const size_t LARGEST = 10;
+  dgs_.assign(end_.size(), 0);
+  std::vector<size_t> count(end_.size(), 0);
+  std::vector<size_t> seen;
+  Index number = 0;
+  for (DFA::State *state = start; state != NULL; state = state->next, ++number)
+  {
+    seen.clear();
+    for (Positions::const_iterator p = state->begin(); p != state->end(); ++p)
+    {
+      // accept positions hold the subpattern, other positions point into the subpattern's regex
+      size_t n = p->accept() ? p->accepts() - 1 : std::lower_bound(end_.begin(), end_.end(), p->loc()) - end_.begin();
+      if (n < count.size() && count[n]++ == 0)
+        seen.push_back(n);
+    }
+    Diagnostics::State diag;
+    diag.state = number;
+    diag.positions = state->size();
+    diag.subpattern = 0;
+    size_t most = 0;
+    for (std::vector<size_t>::const_iterator n = seen.begin(); n != seen.end(); ++n)
+    {
+      ++dgs_[*n];
+      if (count[*n] > most)
       {
-        // combine the tree DFA transitions with the regex DFA transition moves
-        Chars chars;
-        for (Char c = 0; c < 256; ++c)
-          if (state->tnode->edge[c] != NULL)
-            chars.insert(c);
-        if (opt_.i)
-          for (Char c = 'a'; c <= 'z'; ++c)
-            if (state->tnode->edge[c] != NULL)
-              chars.insert(uppercase(c));
-        Moves::iterator i = moves.begin();
-        Moves::iterator end = moves.end();
-        while (i != end)
+        most = count[*n];
+        diag.subpattern = static_cast<Accept>(*n + 1);
+      }
+      count[*n] = 0;
+    }
+    if (diag.positions > 0 && (dgl_.size() < LARGEST || diag.positions > dgl_.back().positions))
+    {
+      std::vector<Diagnostics::State>::iterator i = dgl_.begin();
+      while (i != dgl_.end() && i->positions >= diag.positions)
+        ++i;
+      dgl_.insert(i, diag);
+      if (dgl_.size() > LARGEST)
+        dgl_.pop_back();
+    }
+  }
+}
+
+void Pattern::diagnostics(Diagnostics& diag, const char *sample, size_t size) const
+{
+  diag.states = dgs_;
+  diag.largest = dgl_;
+  // the search of Matcher::advance(), the literals and wide bitap searches are used when supported at run time
+  if (opc_ == NULL && fsm_ == NULL)
+    diag.strategy = "none";
+  else if (len_ > 0)
+    diag.strategy = "prefix";
+  else if (mln_ > 0)
+    diag.strategy = "required";
+  else if (min_ == 0)
+    diag.strategy = "none";
+  else if (lno_ > 0)
+    diag.strategy = "literals";
+  else if (wmn_ > 0)
+    diag.strategy = "wide";
+  else if (min_ >= 4)
+    diag.strategy = "bitap";
+  else
+    diag.strategy = "pma";
+  // the cumulative byte distribution of the sample, or uniform
+  size_t cdf[256];
+  size_t total = 0;
+  for (int c = 0; c < 256; ++c)
+    cdf[c] = 1;
+  if (sample != NULL && size > 0)
+  {
+    for (int c = 0; c < 256; ++c)
+      cdf[c] = 0;
+    for (size_t i = 0; i < size; ++i)
+      ++cdf[static_cast<uint8_t>(sample[i])];
+  }
+  for (int c = 0; c < 256; ++c)
+    cdf[c] = total += cdf[c];
+  // the prefix and bitap rates are products of the probabilities of the bytes at each position
+  diag.prefix_rate = 1.0;
+  for (size_t i = 0; i < len_; ++i)
+  {
+    uint8_t c = static_cast<uint8_t>(pre_[i]);
+    diag.prefix_rate *= static_cast<float>(cdf[c] - (c > 0 ? cdf[c - 1] : 0)) / total;
+  }
+  diag.bitap_rate = 1.0;
+  if (len_ == 0 && min_ > 1 && (opc_ != NULL || fsm_ != NULL))
+  {
+    for (size_t k = 0; k < min_; ++k)
+    {
+      size_t n = 0;
+      for (int c = 0; c < 256; ++c)
+        if ((bit_[c] & (1 << k)) == 0)
+          n += cdf[c] - (c > 0 ? cdf[c - 1] : 0);
+      diag.bitap_rate *= static_cast<float>(n) / total;
+    }
+  }
+  // the hashed predictors are sampled with random strings drawn from the byte distribution
+  static const size_t SAMPLES = 65536;
+  diag.pmh_rate = 1.0;
+  diag.pma_rate = 1.0;
+  if (min_ > 0 && (opc_ != NULL || fsm_ != NULL))
+  {
+    size_t accepted = 0;
+    uint32_t seed = 1;
+    char s[8];
+    for (size_t i = 0; i < SAMPLES; ++i)
+    {
+      for (size_t k = 0; k < 8; ++k)
+      {
+        seed = seed * 1103515245 + 12345;
+        size_t r = (seed >> 8) % total;
+        s[k] = static_cast<char>(std::upper_bound(cdf, cdf + 256, r) - cdf);
+      }
+      if (min_ >= 4 ? predict_match(pmh_, s, min_) : predict_match(pma_, s) == 0)
+        ++accepted;
+    }
+    if (min_ >= 4)
+      diag.pmh_rate = static_cast<float>(accepted) / SAMPLES;
+    else
+      diag.pma_rate = static_cast<float>(accepted) / SAMPLES;
+  }
+}
+
+void Pattern::compile_budget() const
+{
+  // check the DFA construction budgets of options c, k and t
+  if ((opt_.c > 0 && cno_ > opt_.c) || (opt_.k > 0 && vno_ > opt_.k) || (opt_.t > 0 && tms_ > opt_.t))
+    throw regex_error(regex_error::exceeds_budget, rex_, rex_.size());
+}
+
+void Pattern::compile_state(
+    DFA::State   *state,
+    Follow&       followpos,
+    const Map&    modifiers,
+    const Map&    lookahead,
+    DFA::State  **table,
+    DFA::State*&  last_state)
+{
+  timer_type et;
+  Moves moves;
+  timer_start(et);
+  // use the tree DFA accept state, if present
+  if (state->tnode != NULL && state->tnode->accept > 0)
+    state->accept = state->tnode->accept;
+  compile_transition(
+      state,
+      followpos,
+      modifiers,
+      lookahead,
+      moves);
+  ems_ += timer_elapsed(et);
+  compile_moves(state, moves, table, last_state);
+}
+
+#ifdef WITH_COMPILE_THREADS
+
+void Pattern::compile_parallel(
+    DFA::State   *start,
+    Follow&       followpos,
+    const Map&    modifiers,
+    const Map&    lookahead,
+    DFA::State  **table,
+    DFA::State*&  last_state)
+{
+  DBGLOG("BEGIN compile_parallel(%zu)", opt_.j);
+  std::vector<DFA::State*> batch;
+  std::vector<Moves> moves;
+  std::vector<std::exception_ptr> errors;
+  timer_type bt;
+  timer_start(bt);
+  DFA::State *state = start;
+  while (state != NULL)
+  {
+    // collect the next batch of states that do not update followpos with lazy and negative positions
+    batch.clear();
+    for (DFA::State *next = state; next != NULL && !compile_updates(next); next = next->next)
+      batch.push_back(next);
+    if (batch.size() < 2 * opt_.j)
+    {
+      // too few states to benefit from threads, compile the batch or the next updating state serially
+      if (batch.empty())
+        batch.push_back(state);
+      for (size_t k = 0; k < batch.size(); ++k)
+      {
+        compile_state(batch[k], followpos, modifiers, lookahead, table, last_state);
+        if (opt_.t > 0)
+          tms_ += timer_elapsed(bt);
+        compile_budget();
+      }
+      state = batch.back()->next;
+      continue;
+    }
+    // compute the transition moves of the batch states concurrently, followpos is only read
+    timer_type et;
+    timer_start(et);
+    moves.clear();
+    moves.resize(batch.size());
+    errors.clear();
+    errors.resize(batch.size());
+    std::atomic<size_t> work(0);
+    std::vector<std::thread> workers;
+    size_t threads = std::min(opt_.j, batch.size());
+    for (size_t t = 0; t < threads; ++t)
+    {
+      workers.push_back(std::thread([&]() {
+        size_t k;
+        while ((k = work++) < batch.size())
         {
-          if (chars.intersects(i->first))
+          try
           {
-            // tree DFA transitions intersect with this DFA transition move
-            Chars common = chars & i->first;
-            chars -= common;
-            Char lo = common.lo();
-            Char hi = common.hi();
-            for (Char c = lo; c <= hi; ++c)
-            {
-              if (common.contains(c))
-              {
-                Positions pos(i->second);
-                if (opt_.i && std::isalpha(c))
-                {
-                  if (c >= 'a' && c <= 'z')
-                  {
-                    DFA::State *target_state = last_state = last_state->next = dfa_.state(state->tnode->edge[c], pos);
-                    state->edges[c] = std::pair<Char,DFA::State*>(c, target_state);
-                    state->edges[uppercase(c)] = std::pair<Char,DFA::State*>(uppercase(c), target_state);
-                    eno_ += 2;
-                  }
-                }
-                else
-                {
-                  DFA::State *target_state = last_state = last_state->next = dfa_.state(state->tnode->edge[c], pos);
-                  state->edges[c] = std::pair<Char,DFA::State*>(c, target_state);
-                  ++eno_;
-                }
-              }
-            }
-            i->first -= common;
-            if (i->first.any())
-              ++i;
-            else
-              moves.erase(i++);
+            DFA::State *s = batch[k];
+            if (s->tnode != NULL && s->tnode->accept > 0)
+              s->accept = s->tnode->accept;
+            compile_transition(s, followpos, modifiers, lookahead, moves[k]);
           }
-          else
+          catch (...)
           {
-            ++i;
+            errors[k] = std::current_exception();
           }
         }
-        if (opt_.i)
+      }));
+    }
+    for (size_t t = 0; t < threads; ++t)
+      workers[t].join();
+    ems_ += timer_elapsed(et);
+    // add the new states in batch order, which produces the same DFA as serial construction
+    for (size_t k = 0; k < batch.size(); ++k)
+    {
+      if (errors[k])
+        std::rethrow_exception(errors[k]);
+      compile_moves(batch[k], moves[k], table, last_state);
+      if (opt_.t > 0)
+        tms_ += timer_elapsed(bt);
+      compile_budget();
+    }
+    state = batch.back()->next;
+  }
+  DBGLOG("END compile_parallel()");
+}
+
+#endif
+
+void Pattern::compile_moves(
+    DFA::State   *state,
+    Moves&        moves,
+    DFA::State  **table,
+    DFA::State*&  last_state)
+{
+  if (state->tnode != NULL)
+  {
+    // merge tree DFA transitions into the final DFA transitions to target states
+    if (moves.empty())
+    {
+      // no DFA transitions: the final DFA transitions are the tree DFA transitions to target states
+      for (Tree::Node *node = state->tnode->child; node != NULL; node = node->sibling)
+      {
+        Char c = node->c;
+        DFA::State *target_state = last_state = last_state->next = dfa_.state(node);
+        if (opt_.i && std::isalpha(c))
+        {
+          state->edges[lowercase(c)] = std::pair<Char,DFA::State*>(lowercase(c), target_state);
+          state->edges[uppercase(c)] = std::pair<Char,DFA::State*>(uppercase(c), target_state);
+          eno_ += 2;
+        }
+        else
         {
-          // normalize by removing upper case if option i (case insensitivem matching) is enabled
-          static const uint64_t upper[5] = { 0x0000000000000000, 0x0000000007FFFFFE, 0, 0, 0 };
-          chars -= Chars(upper);
+          state->edges[c] = std::pair<Char,DFA::State*>(c, target_state);
+          ++eno_;
         }
-        if (chars.any())
+      }
+    }
+    else
+    {
+      // combine the tree DFA transitions with the regex DFA transition moves
+      Chars chars;
+      for (Tree::Node *node = state->tnode->child; node != NULL; node = node->sibling)
+      {
+        chars.insert(node->c);
+        if (opt_.i && node->c >= 'a' && node->c <= 'z')
+          chars.insert(uppercase(node->c));
+      }
+      Moves::iterator i = moves.begin();
+      Moves::iterator end = moves.end();
+      while (i != end)
+      {
+        if (chars.intersects(i->first))
         {
-          Char lo = chars.lo();
-          Char hi = chars.hi();
+          // tree DFA transitions intersect with this DFA transition move
+          Chars common = chars & i->first;
+          chars -= common;
+          Char lo = common.lo();
+          Char hi = common.hi();
           for (Char c = lo; c <= hi; ++c)
           {
-            if (chars.contains(c))
+            if (common.contains(c))
             {
-              DFA::State *target_state = last_state = last_state->next = dfa_.state(state->tnode->edge[c]);
+              Positions pos(i->second);
               if (opt_.i && std::isalpha(c))
               {
-                state->edges[lowercase(c)] = std::pair<Char,DFA::State*>(lowercase(c), target_state);
-                state->edges[uppercase(c)] = std::pair<Char,DFA::State*>(uppercase(c), target_state);
-                eno_ += 2;
+                if (c >= 'a' && c <= 'z')
+                {
+                  DFA::State *target_state = last_state = last_state->next = dfa_.state(state->tnode->edge(c), pos);
+                  state->edges[c] = std::pair<Char,DFA::State*>(c, target_state);
+                  state->edges[uppercase(c)] = std::pair<Char,DFA::State*>(uppercase(c), target_state);
+                  eno_ += 2;
+                }
               }
               else
               {
+                DFA::State *target_state = last_state = last_state->next = dfa_.state(state->tnode->edge(c), pos);
                 state->edges[c] = std::pair<Char,DFA::State*>(c, target_state);
                 ++eno_;
               }
             }
           }
-        }
-      }
-    }
-    ems_ += timer_elapsed(et);
-    Moves::iterator end = moves.end();
-    for (Moves::iterator i = moves.begin(); i != end; ++i)
-    {
-      Positions& pos = i->second;
-      if (!pos.empty())
-      {
-        uint16_t h = hash_pos(&pos);
-        DFA::State **branch_ptr = &table[h];
-        DFA::State *target_state = *branch_ptr;
-        // binary search the target state for a possible matching state in the hash table overflow tree
-        while (target_state != NULL)
-        {
-          if (pos < *target_state)
-            target_state = *(branch_ptr = &target_state->left);
-          else if (pos > *target_state)
-            target_state = *(branch_ptr = &target_state->right);
+          i->first -= common;
+          if (i->first.any())
+            ++i;
           else
-            break;
+            moves.erase(i++);
         }
-        if (target_state == NULL)
+        else
         {
-          target_state = last_state = last_state->next = dfa_.state(NULL, pos);
-          if (branch_ptr != NULL)
-            *branch_ptr = target_state;
-          else
-            table[h] = target_state;
+          ++i;
+        }
+      }
+      if (opt_.i)
+      {
+        // normalize by removing upper case if option i (case insensitivem matching) is enabled
+        static const uint64_t upper[5] = { 0x0000000000000000, 0x0000000007FFFFFE, 0, 0, 0 };
+        chars -= Chars(upper);
+      }
+      if (chars.any())
+      {
+        Char lo = chars.lo();
+        Char hi = chars.hi();
+        for (Char c = lo; c <= hi; ++c)
+        {
+          if (chars.contains(c))
+          {
+            DFA::State *target_state = last_state = last_state->next = dfa_.state(state->tnode->edge(c));
+            if (opt_.i && std::isalpha(c))
+            {
+              state->edges[lowercase(c)] = std::pair<Char,DFA::State*>(lowercase(c), target_state);
+              state->edges[uppercase(c)] = std::pair<Char,DFA::State*>(uppercase(c), target_state);
+              eno_ += 2;
+            }
+            else
+            {
+              state->edges[c] = std::pair<Char,DFA::State*>(c, target_state);
+              ++eno_;
+            }
+          }
         }
-        Char lo = i->first.lo();
-        Char max = i->first.hi();
+      }
+    }
+  }
+  Moves::iterator end = moves.end();
+  for (Moves::iterator i = moves.begin(); i != end; ++i)
+  {
+    Positions& pos = i->second;
+    if (!pos.empty())
+    {
+      uint16_t h = hash_pos(&pos);
+      DFA::State **branch_ptr = &table[h];
+      DFA::State *target_state = *branch_ptr;
+      // binary search the target state for a possible matching state in the hash table overflow tree
+      while (target_state != NULL)
+      {
+        if (pos < *target_state)
+          target_state = *(branch_ptr = &target_state->left);
+        else if (pos > *target_state)
+          target_state = *(branch_ptr = &target_state->right);
+        else
+          break;
+      }
+      if (target_state == NULL)
+      {
+        target_state = last_state = last_state->next = dfa_.state(NULL, pos);
+        if (branch_ptr != NULL)
+          *branch_ptr = target_state;
+        else
+          table[h] = target_state;
+      }
+      Char lo = i->first.lo();
+      Char max = i->first.hi();
 #ifdef DEBUG
-        DBGLOGN("from state %p on %02x-%02x move to {", state, lo, max);
-        for (Positions::const_iterator p = pos.begin(); p != pos.end(); ++p)
-          DBGLOGPOS(*p);
-        DBGLOGN(" } = state %p", target_state);
+      DBGLOGN("from state %p on %02x-%02x move to {", state, lo, max);
+      for (Positions::const_iterator p = pos.begin(); p != pos.end(); ++p)
+        DBGLOGPOS(*p);
+      DBGLOGN(" } = state %p", target_state);
 #endif
-        while (lo <= max)
+      while (lo <= max)
+      {
+        if (i->first.contains(lo))
         {
-          if (i->first.contains(lo))
-          {
-            Char hi = lo + 1;
-            while (hi <= max && i->first.contains(hi))
-              ++hi;
-            --hi;
+          Char hi = lo + 1;
+          while (hi <= max && i->first.contains(hi))
+            ++hi;
+          --hi;
 #if WITH_COMPACT_DFA == -1
-            state->edges[lo] = std::pair<Char,DFA::State*>(hi, target_state);
+          state->edges[lo] = std::pair<Char,DFA::State*>(hi, target_state);
 #else
-            state->edges[hi] = std::pair<Char,DFA::State*>(lo, target_state);
+          state->edges[hi] = std::pair<Char,DFA::State*>(lo, target_state);
 #endif
-            eno_ += hi - lo + 1;
-            lo = hi + 1;
-          }
-          ++lo;
+          eno_ += hi - lo + 1;
+          lo = hi + 1;
         }
+        ++lo;
       }
     }
-    if (state->accept > 0 && state->accept <= end_.size())
-      acc_[state->accept - 1] = true;
-    ++vno_;
   }
-  delete[] table;
-  tfa_.clear();
-  vms_ = timer_elapsed(vt) - ems_;
-  DBGLOG("END compile()");
+  if (state->accept > 0 && state->accept <= end_.size())
+    acc_[state->accept - 1] = true;
+  cno_ += state->edges.size();
+  ++vno_;
 }
 
 void Pattern::lazy(
@@ -1523,7 +2616,9 @@ void Pattern::greedy(Positions& pos) const
   pos.swap(pos1);
 }
 
-void Pattern::trim_lazy(Positions *pos) const
+void Pattern::trim_lazy(
+    Positions *pos,
+    bool       all) const
 {
 #ifdef DEBUG
   DBGLOG("BEGIN trim_lazy({");
@@ -1537,14 +2632,15 @@ void Pattern::trim_lazy(Positions *pos) const
     Location l = p->lazy();
     if (p->accept() || p->anchor()) // CHECKED algorithmic options: 7/28 added p->anchor()
     {
-      pos->insert(p->lazy(0)); // make lazy accept/anchor a non-lazy accept/anchor
-      pos->erase(--p.base());
+      Position lazy_pos = *p;
+      pos->insert(lazy_pos.lazy(0)); // make lazy accept/anchor a non-lazy accept/anchor
+      p = Positions::reverse_iterator(pos->erase(pos->find(lazy_pos)));
       while (p != pos->rend() && !p->accept() && p->lazy() == l)
       {
 #if 0 // CHECKED algorithmic options: set to 1 to turn lazy trimming off
         ++p;
 #else
-        pos->erase(--p.base());
+        p = Positions::reverse_iterator(pos->erase(--p.base()));
 #endif
       }
     }
@@ -1563,8 +2659,9 @@ void Pattern::trim_lazy(Positions *pos) const
 #else
       if (!p->greedy()) // stop here, greedy bit is 0 from here on
         break;
-      pos->insert(p->lazy(0));
-      pos->erase(--p.base()); // CHECKED 10/21 ++p;
+      Position lazy_pos = *p;
+      pos->insert(lazy_pos.lazy(0));
+      p = Positions::reverse_iterator(pos->erase(pos->find(lazy_pos))); // CHECKED 10/21 ++p;
 #endif
     }
   }
@@ -1575,16 +2672,16 @@ void Pattern::trim_lazy(Positions *pos) const
     pos->erase(--p.base());
   }
 #endif
-  // trims accept positions keeping the first only
+  // trims accept positions keeping the first only, unless all accept positions are kept for the set-matching DFA
   Positions::iterator q = pos->begin(), a = pos->end();
-  while (q != pos->end())
+  while (!all && q != pos->end())
   {
     if (q->accept() && !q->negate())
     {
       if (a == pos->end())
         a = q++;
       else
-        pos->erase(q++);
+        q = pos->erase(q);
     }
     else
     {
@@ -1604,7 +2701,8 @@ void Pattern::compile_transition(
     Follow&     followpos,
     const Map&  modifiers,
     const Map&  lookahead,
-    Moves&      moves) const
+    Moves&      moves,
+    bool        all) const
 {
   DBGLOG("BEGIN compile_transition()");
   Positions::const_iterator end = state->end();
@@ -1817,7 +2915,7 @@ void Pattern::compile_transition(
   Moves::iterator e = moves.end();
   while (i != e)
   {
-    trim_lazy(&i->second);
+    trim_lazy(&i->second, all);
     if (i->second.empty())
       moves.erase(i++);
     else
@@ -1994,9 +3092,18 @@ void Pattern::assemble(DFA::State *start)
   DBGLOG("BEGIN assemble()");
   timer_type t;
   timer_start(t);
+  timer_type bt = t;
   predict_match_dfa(start);
   export_dfa(start);
+  // minimize the DFA before compaction, which makes edge ranges overlap
+  if (opt_.d)
+    minimize_dfa(start);
   compact_dfa(start);
+  if (opt_.t > 0)
+  {
+    tms_ += timer_elapsed(bt);
+    compile_budget();
+  }
   encode_dfa(start);
   wms_ = timer_elapsed(t);
   gencode_dfa(start);
@@ -2005,62 +3112,168 @@ void Pattern::assemble(DFA::State *start)
 }
 
 void Pattern::compact_dfa(DFA::State *start)
+{
+  for (DFA::State *state = start; state; state = state->next)
+    compact_dfa_state(state);
+}
+
+void Pattern::compact_dfa_state(DFA::State *state)
 {
 #if WITH_COMPACT_DFA == -1
   // edge compaction in reverse order
-  for (DFA::State *state = start; state; state = state->next)
+  for (DFA::State::Edges::iterator i = state->edges.begin(); i != state->edges.end(); ++i)
   {
-    for (DFA::State::Edges::iterator i = state->edges.begin(); i != state->edges.end(); ++i)
+    Char hi = i->second.first;
+    if (hi >= 0xFF)
+      break;
+    DFA::State::Edges::iterator j = i;
+    ++j;
+    while (j != state->edges.end() && j->first <= hi + 1)
     {
-      Char hi = i->second.first;
-      if (hi >= 0xFF)
-        break;
-      DFA::State::Edges::iterator j = i;
-      ++j;
-      while (j != state->edges.end() && j->first <= hi + 1)
+      hi = j->second.first;
+      if (j->second.second == i->second.second)
       {
-        hi = j->second.first;
-        if (j->second.second == i->second.second)
-        {
-          i->second.first = hi;
-          state->edges.erase(j++);
-        }
-        else
-        {
-          ++j;
-        }
+        i->second.first = hi;
+        state->edges.erase(j++);
+      }
+      else
+      {
+        ++j;
       }
     }
   }
 #elif WITH_COMPACT_DFA == 1
   // edge compaction
+  for (DFA::State::Edges::reverse_iterator i = state->edges.rbegin(); i != state->edges.rend(); ++i)
+  {
+    Char lo = i->second.first;
+    if (lo <= 0x00)
+      break;
+    DFA::State::Edges::reverse_iterator j = i;
+    ++j;
+    while (j != state->edges.rend() && j->first >= lo - 1)
+    {
+      lo = j->second.first;
+      if (j->second.second == i->second.second)
+      {
+        i->second.first = lo;
+        state->edges.erase(--j.base());
+      }
+      else
+      {
+        ++j;
+      }
+    }
+  }
+#else
+  (void)state;
+#endif
+}
+
+void Pattern::minimize_dfa(DFA::State *start)
+{
+  DBGLOG("BEGIN minimize_dfa()");
+  typedef std::vector<Index> Signature;
+  typedef std::map<Signature,Index> Blocks;
+  // number the states in list order, the start state is state 0
+  std::vector<DFA::State*> states;
   for (DFA::State *state = start; state; state = state->next)
   {
-    for (DFA::State::Edges::reverse_iterator i = state->edges.rbegin(); i != state->edges.rend(); ++i)
+    state->index = static_cast<Index>(states.size());
+    states.push_back(state);
+  }
+  size_t n = states.size();
+  std::vector<Index> block(n);
+  Blocks blocks;
+  // initial partition of the states by accept, redo, lookahead heads and tails
+  for (size_t k = 0; k < n; ++k)
+  {
+    const DFA::State *state = states[k];
+    Signature sig;
+    // the start state is in a block of its own, because find() restarts matching at the start state
+    sig.push_back(k == 0);
+    sig.push_back(state->accept);
+    sig.push_back(state->redo);
+    sig.push_back(static_cast<Index>(state->heads.size()));
+    sig.insert(sig.end(), state->heads.begin(), state->heads.end());
+    sig.insert(sig.end(), state->tails.begin(), state->tails.end());
+    block[k] = blocks.insert(Blocks::value_type(sig, static_cast<Index>(blocks.size()))).first->second;
+  }
+  // refine the partition by the blocks of the target states of the disjoint edge ranges, before compact_dfa() makes them overlap, until stable
+  size_t count = 0;
+  while (count < blocks.size())
+  {
+    count = blocks.size();
+    blocks.clear();
+    std::vector<Index> refined(n);
+    for (size_t k = 0; k < n; ++k)
     {
-      Char lo = i->second.first;
-      if (lo <= 0x00)
-        break;
-      DFA::State::Edges::reverse_iterator j = i;
-      ++j;
-      while (j != state->edges.rend() && j->first >= lo - 1)
+      const DFA::State *state = states[k];
+      Signature sig;
+      sig.push_back(block[k]);
+      Char last_hi = 0;
+      Index last_block = Const::IMAX;
+      for (DFA::State::Edges::const_iterator i = state->edges.begin(); i != state->edges.end(); ++i)
       {
-        lo = j->second.first;
-        if (j->second.second == i->second.second)
+#if WITH_COMPACT_DFA == -1
+        Char lo = i->first;
+        Char hi = i->second.first;
+#else
+        Char lo = i->second.first;
+        Char hi = i->first;
+#endif
+        Index target_block = i->second.second != NULL ? block[i->second.second->index] : Const::IMAX;
+        if (sig.size() > 1 && lo == last_hi + 1 && target_block == last_block)
         {
-          i->second.first = lo;
-          state->edges.erase(--j.base());
+          // adjacent ranges to the same block are equivalent to one range
+          sig.back() = last_hi = hi;
         }
         else
         {
-          ++j;
+          sig.push_back(target_block);
+          sig.push_back(lo);
+          sig.push_back(hi);
+          last_hi = hi;
+          last_block = target_block;
         }
       }
+      refined[k] = blocks.insert(Blocks::value_type(sig, static_cast<Index>(blocks.size()))).first->second;
     }
+    block.swap(refined);
   }
+  DBGLOG("minimize_dfa() %zu states to %zu states", n, blocks.size());
+  if (blocks.size() < n)
+  {
+    // the first state in list order of each block represents the block, the start state remains first
+    std::vector<DFA::State*> repr(blocks.size(), static_cast<DFA::State*>(NULL));
+    for (size_t k = 0; k < n; ++k)
+      if (repr[block[k]] == NULL)
+        repr[block[k]] = states[k];
+    DFA::State *last_state = NULL;
+    eno_ = 0;
+    for (size_t k = 0; k < n; ++k)
+    {
+      DFA::State *state = states[k];
+      if (repr[block[k]] != state)
+        continue;
+      for (DFA::State::Edges::iterator i = state->edges.begin(); i != state->edges.end(); ++i)
+      {
+        if (i->second.second != NULL)
+          i->second.second = repr[block[i->second.second->index]];
+#if WITH_COMPACT_DFA == -1
+        eno_ += i->second.first - i->first + 1;
 #else
-  (void)start;
+        eno_ += i->first - i->second.first + 1;
 #endif
+      }
+      if (last_state != NULL)
+        last_state->next = state;
+      last_state = state;
+    }
+    last_state->next = NULL;
+    vno_ = blocks.size();
+  }
+  DBGLOG("END minimize_dfa()");
 }
 
 void Pattern::encode_dfa(DFA::State *start)
@@ -2112,7 +3325,7 @@ void Pattern::encode_dfa(DFA::State *start)
       ++nop_;
     }
 #endif
-    nop_ += static_cast<Index>(state->heads.size() + state->tails.size() + (state->accept > 0 || state->redo));
+    nop_ += static_cast<Index>(state->heads.size() + state->tails.size() + (state->accept > 0 || state->redo) + (state != start && loop_opcode(state) != 0));
     if (!valid_goto_index(nop_))
       throw regex_error(regex_error::exceeds_limits, rex_, rex_.size());
   }
@@ -2174,16 +3387,24 @@ void Pattern::encode_dfa(DFA::State *start)
         }
       }
 #endif
-      nop_ += static_cast<Index>(state->heads.size() + state->tails.size() + (state->accept > 0 || state->redo));
+      nop_ += static_cast<Index>(state->heads.size() + state->tails.size() + (state->accept > 0 || state->redo) + (state != start && loop_opcode(state) != 0));
       if (!valid_goto_index(nop_))
         throw regex_error(regex_error::exceeds_limits, rex_, rex_.size());
     }
   }
+  if (opt_.c > 0 && nop_ > opt_.c)
+    throw regex_error(regex_error::exceeds_budget, rex_, rex_.size());
   Opcode *opcode = new Opcode[nop_];
   opc_ = opcode;
   Index pc = 0;
   for (const DFA::State *state = start; state; state = state->next)
   {
+    if (state != start)
+    {
+      Opcode loop = loop_opcode(state);
+      if (loop != 0)
+        opcode[pc++] = loop;
+    }
     if (state->redo)
     {
       opcode[pc++] = opcode_redo();
@@ -2304,11 +3525,87 @@ void Pattern::encode_dfa(DFA::State *start)
   }
 }
 
+Pattern::Opcode Pattern::loop_opcode(const DFA::State *state) const
+{
+  // a SKIP opcode to skip bytes until one to three exit bytes or a SPAN opcode to skip one to three bytes looping back to the state
+  // the first edge that covers a byte in the order of the GOTO opcodes emitted by encode_dfa() takes the byte
+  // a state with HEAD or TAIL lookahead opcodes cannot loop without executing them again for each byte
+  if (!state->heads.empty() || !state->tails.empty())
+    return 0;
+  bool loop[256];
+  bool covered[256];
+  int count = 0;
+  for (int c = 0; c < 256; ++c)
+    loop[c] = covered[c] = false;
+#if WITH_COMPACT_DFA == -1
+  for (DFA::State::Edges::const_reverse_iterator i = state->edges.rbegin(); i != state->edges.rend(); ++i)
+  {
+    Char lo = i->first;
+    Char hi = i->second.first;
+#else
+  for (DFA::State::Edges::const_iterator i = state->edges.begin(); i != state->edges.end(); ++i)
+  {
+    Char lo = i->second.first;
+    Char hi = i->first;
+#endif
+    if (is_meta(lo))
+      return 0;
+    for (Char c = lo; c <= hi; ++c)
+    {
+      if (!covered[c])
+      {
+        covered[c] = true;
+        if (i->second.second == state)
+        {
+          loop[c] = true;
+          ++count;
+        }
+      }
+    }
+  }
+  bool skip = count >= 253 && count < 256;
+  if (!skip && (count == 0 || count > 3))
+    return 0;
+  Char bytes[3];
+  int n = 0;
+  for (int c = 0; c < 256 && n < 3; ++c)
+    if (loop[c] != skip)
+      bytes[n++] = c;
+  while (n < 3)
+  {
+    bytes[n] = bytes[n - 1];
+    ++n;
+  }
+  if (bytes[0] == 0 || bytes[0] >= 0xF8)
+    return 0;
+  return skip ? opcode_skip(bytes[0], bytes[1], bytes[2]) : opcode_span(bytes[0], bytes[1], bytes[2]);
+}
+
 void Pattern::gencode_dfa(const DFA::State *start) const
 {
   if (!opt_.o)
     return;
-  for (std::vector<std::string>::const_iterator i = opt_.f.begin(); i != opt_.f.end(); ++i)
+  const char *name = opt_.n.empty() ? "FSM" : opt_.n.c_str();
+  // the states in the order of the generated code, the start state is first
+  std::vector<const DFA::State*> states;
+  for (const DFA::State *state = start; state; state = state->next)
+    states.push_back(state);
+  std::map<Index,size_t> state_counts;
+  std::map<std::pair<Index,Char>,size_t> edge_counts;
+  bool profile = !opt_.u.empty() && read_profile(name, states.size(), state_counts, edge_counts);
+  if (profile)
+  {
+    // lay out the hot states first, sorted by decreasing visit count, followed by the cold states never visited
+    std::vector<std::pair<size_t,size_t> > order;
+    for (size_t k = 1; k < states.size(); ++k)
+      order.push_back(std::pair<size_t,size_t>(~profile_count(state_counts, states[k]->index), k));
+    std::sort(order.begin(), order.end());
+    std::vector<const DFA::State*> hot(1, start);
+    for (size_t k = 0; k < order.size(); ++k)
+      hot.push_back(states[order[k].second]);
+    states.swap(hot);
+  }
+  for (std::vector<std::string>::const_iterator i = opt_.f.begin(); i != opt_.f.end(); ++i)
   {
     const std::string& filename = *i;
     size_t len = filename.length();
@@ -2339,16 +3636,25 @@ void Pattern::gencode_dfa(const DFA::State *start) const
             "#pragma clang diagnostic ignored \"-Wunused-label\"\n"
             "#endif\n\n");
         write_namespace_open(file);
+        if (!opt_.v.empty())
+          ::fprintf(file,
+              "static unsigned long reflex_prof_%s_state[%zu];\n"
+              "static unsigned long reflex_prof_%s_edge[%zu][256];\n\n", name, states.size(), name, states.size());
         ::fprintf(file,
             "void reflex_code_%s(reflex::Matcher& m)\n"
             "{\n"
             "  int c0 = 0, c1 = 0;\n"
-            "  m.FSM_INIT(c1);\n", opt_.n.empty() ? "FSM" : opt_.n.c_str());
-        for (const DFA::State *state = start; state; state = state->next)
+            "  m.FSM_INIT(c1);\n", name);
+        for (size_t k = 0; k < states.size(); ++k)
         {
+          const DFA::State *state = states[k];
           ::fprintf(file, "\nS%u:\n", state->index);
+          if (!opt_.v.empty())
+            ::fprintf(file, "  ++reflex_prof_%s_state[%zu];\n", name, k);
           if (state == start)
             ::fprintf(file, "  m.FSM_FIND();\n");
+          else if (loop_opcode(state) != 0)
+            ::fprintf(file, "  m.FSM_SKIP(0x%08X);\n", loop_opcode(state));
           if (state->redo)
             ::fprintf(file, "  m.FSM_REDO();\n");
           else if (state->accept > 0)
@@ -2395,8 +3701,59 @@ void Pattern::gencode_dfa(const DFA::State *start) const
           bool read = peek;
           bool elif = false;
 #if WITH_COMPACT_DFA == -1
+          std::vector<DFA::State::Edges::const_reverse_iterator> edges;
           for (DFA::State::Edges::const_reverse_iterator i = state->edges.rbegin(); i != state->edges.rend(); ++i)
+            edges.push_back(i);
+          if (profile)
+          {
+            // test hot edges first, but edges are tested in order and may overlap, so an edge cannot move before an overlapping edge to another state
+            for (size_t e = 1; e < edges.size(); ++e)
+            {
+              for (size_t f = e; f > 0; --f)
+              {
+                DFA::State::Edges::const_reverse_iterator a = edges[f - 1];
+                DFA::State::Edges::const_reverse_iterator b = edges[f];
+                if (is_meta(a->first) || is_meta(b->first))
+                  break;
+                if (profile_count(edge_counts, std::pair<Index,Char>(state->index, b->first)) <= profile_count(edge_counts, std::pair<Index,Char>(state->index, a->first)))
+                  break;
+                if (a->second.second != b->second.second && a->first <= b->second.first && b->first <= a->second.first)
+                  break;
+                std::swap(edges[f - 1], edges[f]);
+              }
+            }
+          }
+          // dispatch on the target states of the 256 byte values when there are too many edges to test in order, unless instrumented with option v
+          Index targets[256];
+          size_t tests = 0;
+          if (opt_.v.empty())
+          {
+            bool hit[256];
+            std::fill(targets, targets + 256, static_cast<Index>(Const::IMAX));
+            std::fill(hit, hit + 256, false);
+            for (size_t e = 0; e < edges.size(); ++e)
+            {
+              Char lo = edges[e]->first;
+              Char hi = edges[e]->second.first;
+              if (!is_meta(lo))
+              {
+                if (edges[e]->second.second != NULL)
+                  ++tests;
+                for (Char c = lo; c <= hi; ++c)
+                {
+                  if (!hit[c])
+                  {
+                    hit[c] = true;
+                    if (edges[e]->second.second != NULL)
+                      targets[c] = edges[e]->second.second->index;
+                  }
+                }
+              }
+            }
+          }
+          for (size_t e = 0; e < edges.size(); ++e)
           {
+            DFA::State::Edges::const_reverse_iterator i = edges[e];
             Char lo = i->first;
             Char hi = i->second.first;
             Index target_index = Const::IMAX;
@@ -2410,10 +3767,14 @@ void Pattern::gencode_dfa(const DFA::State *start) const
                 ::fprintf(file, "  c1 = m.FSM_CHAR();\n");
               read = false;
             }
+            if (!is_meta(lo) && tests >= Const::TESTS)
+            {
+              gencode_dfa_dispatch(file, state->index, targets, peek);
+              break;
+            }
             if (!is_meta(lo))
             {
-              DFA::State::Edges::const_reverse_iterator j = i;
-              if (target_index == Const::IMAX && (++j == state->edges.rend() || is_meta(j->second.first)))
+              if (target_index == Const::IMAX && (e + 1 == edges.size() || is_meta(edges[e + 1]->second.first)))
                 break;
               if (lo == hi)
               {
@@ -2442,6 +3803,10 @@ void Pattern::gencode_dfa(const DFA::State *start) const
                 else
                   ::fprintf(file, " return m.FSM_HALT();\n");
               }
+              else if (!opt_.v.empty())
+              {
+                ::fprintf(file, " { ++reflex_prof_%s_edge[%zu][%u]; goto S%u; }\n", name, k, lo, target_index);
+              }
               else
               {
                 ::fprintf(file, " goto S%u;\n", target_index);
@@ -2585,6 +3950,10 @@ void Pattern::gencode_dfa(const DFA::State *start) const
                 else
                   ::fprintf(file, " return m.FSM_HALT();\n");
               }
+              else if (!opt_.v.empty())
+              {
+                ::fprintf(file, " { ++reflex_prof_%s_edge[%zu][%u]; goto S%u; }\n", name, k, lo, target_index);
+              }
               else
               {
                 ::fprintf(file, " goto S%u;\n", target_index);
@@ -2598,6 +3967,8 @@ void Pattern::gencode_dfa(const DFA::State *start) const
             ::fprintf(file, "  return m.FSM_HALT();\n");
         }
         ::fprintf(file, "}\n\n");
+        if (!opt_.v.empty())
+          write_profiler(file, name, states);
         if (opt_.p)
           write_predictor(file);
         write_namespace_close(file);
@@ -2608,6 +3979,164 @@ void Pattern::gencode_dfa(const DFA::State *start) const
   }
 }
 
+void Pattern::gencode_dfa_dispatch(FILE *file, Index index, const Index *targets, bool peek) const
+{
+  // the byte values that start a run of byte values with the same target state
+  std::vector<Char> runs;
+  for (Char c = 0; c <= 0xFF; ++c)
+    if (c == 0 || targets[c] != targets[c - 1])
+      runs.push_back(c);
+  if (runs.size() < Const::RUNS)
+  {
+    // binary search the runs
+    gencode_dfa_ranges(file, targets, runs, 0, runs.size(), 1, peek);
+    return;
+  }
+  // jump to the target state with a computed goto when supported, or with a switch on the target state number
+  ::fprintf(file,
+      "  if (c1 < 0)\n"
+      "    return m.FSM_HALT(%s);\n"
+      "#if defined(__GNUC__)\n"
+      "  {\n"
+      "    static const void *const jump[256] = {", peek ? "c1" : "");
+  for (Char c = 0; c <= 0xFF; ++c)
+  {
+    ::fprintf(file, "%s", c == 0 ? "\n      " : c % 8 == 0 ? ",\n      " : ", ");
+    if (targets[c] == Const::IMAX)
+      ::fprintf(file, "&&H%u", index);
+    else
+      ::fprintf(file, "&&S%u", targets[c]);
+  }
+  ::fprintf(file,
+      "\n    };\n"
+      "    goto *jump[c1];\n"
+      "  }\n"
+      "H%u:\n"
+      "#else\n"
+      "  {\n"
+      "    static const unsigned char jump[256] = {", index);
+  std::vector<Index> cases;
+  for (Char c = 0; c <= 0xFF; ++c)
+  {
+    size_t k = 0;
+    if (targets[c] != Const::IMAX)
+    {
+      k = std::find(cases.begin(), cases.end(), targets[c]) - cases.begin();
+      if (k == cases.size())
+        cases.push_back(targets[c]);
+      ++k;
+    }
+    ::fprintf(file, "%s%zu", c == 0 ? "\n      " : c % 16 == 0 ? ",\n      " : ", ", k);
+  }
+  ::fprintf(file,
+      "\n    };\n"
+      "    switch (jump[c1])\n"
+      "    {\n");
+  for (size_t k = 0; k < cases.size(); ++k)
+    ::fprintf(file, "      case %zu: goto S%u;\n", k + 1, cases[k]);
+  ::fprintf(file,
+      "    }\n"
+      "  }\n"
+      "#endif\n");
+}
+
+void Pattern::gencode_dfa_ranges(FILE *file, const Index *targets, const std::vector<Char>& runs, size_t lo, size_t hi, int nest, bool peek) const
+{
+  if (hi - lo == 1)
+  {
+    Index target_index = targets[runs[lo]];
+    if (target_index == Const::IMAX)
+      ::fprintf(file, "%*sreturn m.FSM_HALT(%s);\n", 2*nest, "", peek ? "c1" : "");
+    else if (runs[lo] == 0)
+      ::fprintf(file, "%*sif (0 <= c1) goto S%u;\n%*sreturn m.FSM_HALT(%s);\n", 2*nest, "", target_index, 2*nest, "", peek ? "c1" : "");
+    else
+      ::fprintf(file, "%*sgoto S%u;\n", 2*nest, "", target_index);
+    return;
+  }
+  size_t mid = (lo + hi) / 2;
+  ::fprintf(file, "%*sif (c1 < ", 2*nest, "");
+  print_char(file, runs[mid]);
+  ::fprintf(file, ")\n%*s{\n", 2*nest, "");
+  gencode_dfa_ranges(file, targets, runs, lo, mid, nest + 1, peek);
+  ::fprintf(file, "%*s}\n", 2*nest, "");
+  gencode_dfa_ranges(file, targets, runs, mid, hi, nest, peek);
+}
+
+void Pattern::write_profiler(FILE *file, const char *name, const std::vector<const DFA::State*>& states) const
+{
+  ::fprintf(file, "static const unsigned reflex_prof_%s_index[%zu] = {", name, states.size());
+  for (size_t k = 0; k < states.size(); ++k)
+    ::fprintf(file, "%s%u", k == 0 ? "\n  " : k % 16 == 0 ? ",\n  " : ", ", states[k]->index);
+  ::fprintf(file,
+      "\n};\n\n"
+      "static struct reflex_prof_%s_type {\n"
+      "  ~reflex_prof_%s_type()\n"
+      "  {\n"
+      "    FILE *file = fopen(\"", name, name);
+  for (const char *s = opt_.v.c_str(); *s != '\0'; ++s)
+  {
+    if (*s == '\\' || *s == '"')
+      ::fputc('\\', file);
+    ::fputc(*s, file);
+  }
+  ::fprintf(file,
+      "\", \"a\");\n"
+      "    if (file == NULL)\n"
+      "      return;\n"
+      "    fprintf(file, \"FSM %s %zu\\n\");\n"
+      "    for (unsigned k = 0; k < %zu; ++k)\n"
+      "    {\n"
+      "      if (reflex_prof_%s_state[k] > 0)\n"
+      "        fprintf(file, \"S %%u %%lu\\n\", reflex_prof_%s_index[k], reflex_prof_%s_state[k]);\n"
+      "      for (int c = 0; c < 256; ++c)\n"
+      "        if (reflex_prof_%s_edge[k][c] > 0)\n"
+      "          fprintf(file, \"E %%u %%d %%lu\\n\", reflex_prof_%s_index[k], c, reflex_prof_%s_edge[k][c]);\n"
+      "    }\n"
+      "    fclose(file);\n"
+      "  }\n"
+      "} reflex_prof_%s;\n\n", name, states.size(), states.size(), name, name, name, name, name, name, name);
+}
+
+bool Pattern::read_profile(
+    const char                             *name,
+    size_t                                  nodes,
+    std::map<Index,size_t>&                 states,
+    std::map<std::pair<Index,Char>,size_t>& edges) const
+{
+  FILE *file = NULL;
+  if (reflex::fopen_s(&file, opt_.u.c_str(), "r") != 0 || file == NULL)
+    return false;
+  // sum the counts of the FSM name with the given number of states, skipping profiles of other FSMs and stale profiles
+  bool found = false;
+  bool match = false;
+  char line[256];
+  while (::fgets(line, sizeof(line), file) != NULL)
+  {
+    char fsm[256];
+    unsigned long size, index, count;
+    int c;
+    if (std::sscanf(line, "FSM %255s %lu", fsm, &size) == 2)
+    {
+      match = std::strcmp(fsm, name) == 0 && size == nodes;
+      found = found || match;
+    }
+    else if (!match)
+    {
+      continue;
+    }
+    else if (std::sscanf(line, "S %lu %lu", &index, &count) == 2)
+    {
+      states[static_cast<Index>(index)] += count;
+    }
+    else if (std::sscanf(line, "E %lu %d %lu", &index, &c, &count) == 3 && c >= 0 && c <= 0xFF)
+    {
+      edges[std::pair<Index,Char>(static_cast<Index>(index), static_cast<Char>(c))] += count;
+    }
+  }
+  ::fclose(file);
+  return found;
+}
+
 void Pattern::check_dfa_closure(const DFA::State *state, int nest, bool& peek, bool& prev) const
 {
   if (nest > 5)
@@ -2888,6 +4417,22 @@ void Pattern::export_code() const
           {
             ::fprintf(file, "REDO\n");
           }
+          else if (is_opcode_skip(opcode) || is_opcode_span(opcode))
+          {
+            ::fprintf(file, is_opcode_skip(opcode) ? "SKIP TO " : "SKIP OVER ");
+            print_char(file, (opcode >> 16) & 0xFF, true);
+            if (((opcode >> 8) & 0xFF) != ((opcode >> 16) & 0xFF))
+            {
+              ::fprintf(file, " ");
+              print_char(file, (opcode >> 8) & 0xFF, true);
+            }
+            if ((opcode & 0xFF) != ((opcode >> 8) & 0xFF))
+            {
+              ::fprintf(file, " ");
+              print_char(file, opcode & 0xFF, true);
+            }
+            ::fprintf(file, "\n");
+          }
           else if (is_opcode_take(opcode))
           {
             ::fprintf(file, "TAKE %u\n", long_index_of(opcode));
@@ -2941,7 +4486,7 @@ void Pattern::export_code() const
           }
         }
         ::fprintf(file, "};\n\n");
-        if (opt_.p)
+        if (opt_.p || opt_.h)
           write_predictor(file);
         write_namespace_close(file);
         if (file != stdout)
@@ -2958,7 +4503,7 @@ void Pattern::predict_match_dfa(DFA::State *start)
   one_ = true;
   while (state->accept == 0)
   {
-    if (state->edges.size() != 1)
+    if (state->edges.size() != 1 || !state->heads.empty() || !state->tails.empty())
     {
       one_ = false;
       break;
@@ -2988,15 +4533,27 @@ void Pattern::predict_match_dfa(DFA::State *start)
     }
     state = next;
   }
-  if (state != NULL && state->accept > 0 && !state->edges.empty())
+  // a lookahead head or tail makes the match shorter than the string in pre_[]
+  if (state != NULL && (!state->edges.empty() || !state->heads.empty() || !state->tails.empty()))
     one_ = false;
   min_ = 0;
+  lno_ = 0;
+  lfp_ = 0;
+  mln_ = 0;
+  mdt_ = 0;
+  wmn_ = 0;
   std::memset(bit_, 0xFF, sizeof(bit_));
   std::memset(pmh_, 0xFF, sizeof(pmh_));
   std::memset(pma_, 0xFF, sizeof(pma_));
   if (state != NULL && state->accept == 0)
   {
     gen_predict_match(state);
+    if (len_ == 0 && min_ > 0)
+      gen_literals(start);
+    if (len_ == 0 && lno_ == 0)
+      gen_required(start);
+    if (len_ == 0 && lno_ == 0 && mln_ == 0 && min_ >= 8)
+      gen_wide(state);
 #ifdef DEBUG
     for (Char i = 0; i < 256; ++i)
     {
@@ -3037,16 +4594,622 @@ void Pattern::predict_match_dfa(DFA::State *start)
 void Pattern::gen_predict_match(DFA::State *state)
 {
   min_ = 8;
-  std::map<DFA::State*,ORanges<Hash> > states[8];
+  std::map<DFA::State*,Bits> states[8];
   gen_predict_match_transitions(state, states[0]);
   for (int level = 1; level < 8; ++level)
-    for (std::map<DFA::State*,ORanges<Hash> >::iterator from = states[level - 1].begin(); from != states[level - 1].end(); ++from)
+    for (std::map<DFA::State*,Bits>::iterator from = states[level - 1].begin(); from != states[level - 1].end(); ++from)
       gen_predict_match_transitions(level, from->first, from->second, states[level]);
   for (Char i = 0; i < 256; ++i)
     bit_[i] &= (1 << min_) - 1;
 }
 
-void Pattern::gen_predict_match_transitions(DFA::State *state, std::map<DFA::State*,ORanges<Hash> >& states)
+void Pattern::gen_wide(DFA::State *state)
+{
+  // bitap over the sets of states at each position, up to the shortest match or 64 positions
+  std::memset(wbt_, 0xFF, sizeof(wbt_));
+  std::set<DFA::State*> states;
+  std::set<DFA::State*> next;
+  states.insert(state);
+  size_t level = 0;
+  while (level < 64 && !states.empty() && states.size() <= 256)
+  {
+    next.clear();
+    bool meta = false;
+    bool accept = false;
+    for (std::set<DFA::State*>::const_iterator from = states.begin(); from != states.end() && !meta; ++from)
+    {
+      for (DFA::State::Edges::const_iterator edge = (*from)->edges.begin(); edge != (*from)->edges.end(); ++edge)
+      {
+        if (is_meta(edge->first))
+        {
+          meta = true;
+          break;
+        }
+        DFA::State *to = edge->second.second;
+        if (to == NULL || to->accept > 0 || (!to->edges.empty() && is_meta(to->edges.rbegin()->first)))
+          accept = true;
+        else
+          next.insert(to);
+        for (Char c = edge->first; c <= edge->second.first; ++c)
+          wbt_[c] &= ~(1ULL << level);
+      }
+    }
+    // an anchor at this position ends the prefilter before this position, a match ends the prefilter at this position
+    if (meta)
+      break;
+    ++level;
+    if (accept)
+      break;
+    states = next;
+  }
+  wmn_ = level;
+  if (wmn_ <= 8)
+    wmn_ = 0;
+  init_wide();
+  DBGLOGN("wide min = %zu", wmn_);
+}
+
+void Pattern::gen_literals(DFA::State *start)
+{
+  std::string lit;
+  std::vector<std::string> lits;
+  size_t visits = 0;
+  if (!gen_literals(start, lit, lits, visits) || lits.empty())
+    return;
+  // remove literals that have another literal as a prefix, since the shorter literal is found first
+  std::sort(lits.begin(), lits.end());
+  lits.erase(std::unique(lits.begin(), lits.end()), lits.end());
+  for (size_t i = 0; i < lits.size(); ++i)
+  {
+    if (lno_ > 0 && lits[i].compare(0, lln_[lno_ - 1], lit_[lno_ - 1], lln_[lno_ - 1]) == 0)
+      continue;
+    lln_[lno_] = static_cast<uint8_t>(lits[i].size());
+    std::memcpy(lit_[lno_], lits[i].data(), lits[i].size());
+    ++lno_;
+  }
+  init_literals();
+#ifdef DEBUG
+  for (size_t i = 0; i < lno_; ++i)
+    DBGLOGN("lit[%zu] = '%.*s'", i, static_cast<int>(lln_[i]), lit_[i]);
+#endif
+}
+
+/// order strings by length, longest first
+static bool longer(const std::string& a, const std::string& b)
+{
+  return a.size() > b.size();
+}
+
+void Pattern::gen_required(DFA::State *start)
+{
+  // number the DFA states, the start state is state 0
+  std::vector<DFA::State*> states;
+  std::map<DFA::State*,Index> ids;
+  for (DFA::State *state = start; state != NULL; state = state->next)
+  {
+    // limit the search, lookaheads and negative patterns are not supported
+    if (states.size() >= 4096 || state->redo || !state->heads.empty() || !state->tails.empty())
+      return;
+    ids[state] = static_cast<Index>(states.size());
+    states.push_back(state);
+  }
+  // the single byte on all transitions to a state, or -1 if none, or -2 if not unique
+  std::vector<int> pred(states.size(), -1);
+  pred[0] = -2;
+  for (size_t i = 0; i < states.size(); ++i)
+  {
+    for (DFA::State::Edges::const_iterator edge = states[i]->edges.begin(); edge != states[i]->edges.end(); ++edge)
+    {
+      if (edge->second.second == NULL)
+        continue;
+      std::map<DFA::State*,Index>::const_iterator id = ids.find(edge->second.second);
+      if (id == ids.end())
+        return;
+      int& c = pred[id->second];
+      if (is_meta(edge->first) || edge->first != edge->second.first || (c != -1 && c != static_cast<int>(edge->first)))
+        c = -2;
+      else
+        c = edge->first;
+    }
+  }
+  // the BFS depth of the states, to find the transitions forward to deeper states
+  std::vector<size_t> depth(states.size(), states.size());
+  std::vector<Index> queue(1, 0);
+  depth[0] = 0;
+  for (size_t q = 0; q < queue.size(); ++q)
+  {
+    const DFA::State *state = states[queue[q]];
+    for (DFA::State::Edges::const_iterator edge = state->edges.begin(); edge != state->edges.end(); ++edge)
+    {
+      if (edge->second.second == NULL)
+        continue;
+      Index t = ids[edge->second.second];
+      if (depth[t] == states.size())
+      {
+        depth[t] = depth[queue[q]] + 1;
+        queue.push_back(t);
+      }
+    }
+  }
+  // candidate literals are the byte to a state followed by the bytes on the single transitions forward, the other transitions loop back
+  std::set<std::string> candidates;
+  for (size_t i = 0; i < states.size(); ++i)
+  {
+    std::string lit;
+    if (pred[i] >= 0)
+      lit.push_back(static_cast<char>(pred[i]));
+    Index id = static_cast<Index>(i);
+    while (lit.size() < 255 && states[id]->accept == 0)
+    {
+      const DFA::State *state = states[id];
+      DFA::State::Edges::const_iterator next = state->edges.end();
+      size_t forward = 0;
+      for (DFA::State::Edges::const_iterator edge = state->edges.begin(); edge != state->edges.end(); ++edge)
+      {
+        if (edge->second.second != NULL && (state->edges.size() == 1 || depth[ids[edge->second.second]] > depth[id]))
+        {
+          next = edge;
+          ++forward;
+        }
+      }
+      if (forward != 1 || is_meta(next->first) || next->first != next->second.first)
+        break;
+      lit.push_back(static_cast<char>(next->first));
+      id = ids[next->second.second];
+    }
+    if (lit.size() >= 3)
+      candidates.insert(lit);
+  }
+  // verify the longest candidates, the first literal that is required by all matches is used
+  std::vector<std::string> lits(candidates.begin(), candidates.end());
+  std::stable_sort(lits.begin(), lits.end(), longer);
+  for (size_t i = 0; i < lits.size() && i < 8; ++i)
+  {
+    size_t dist;
+    if (gen_required(states, ids, lits[i], dist))
+    {
+      mln_ = lits[i].size();
+      mdt_ = dist;
+      std::memcpy(mst_, lits[i].data(), mln_);
+      DBGLOGN("required = '%.*s' dist = %zu", static_cast<int>(mln_), mst_, mdt_);
+      // backing up over more than a few bytes to the match start is faster with a reverse DFA
+      if (mdt_ > 16)
+        gen_reverse(states, ids);
+      // without a reverse DFA, backing up to the line start restarts matching at too many positions in long lines
+      if (rev_ == NULL && mdt_ == 0xFFFF)
+        mln_ = 0;
+      break;
+    }
+  }
+}
+
+bool Pattern::gen_required(
+    const std::vector<DFA::State*>&    states,
+    const std::map<DFA::State*,Index>& ids,
+    const std::string&                 lit,
+    size_t&                            dist) const
+{
+  // the product of the DFA with the KMP automaton of the literal has nodes s * m + j for DFA state s and literal position j
+  size_t m = lit.size();
+  size_t n = states.size() * m;
+  if (n > 0x40000)
+    return false;
+  std::string chars(lit);
+  std::sort(chars.begin(), chars.end());
+  chars.erase(std::unique(chars.begin(), chars.end()), chars.end());
+  size_t k = chars.size();
+  // KMP transitions delta[j * k + c] on the chars of the literal, all other chars go back to position 0
+  std::vector<uint8_t> delta(m * k);
+  std::vector<size_t> fail(m + 1, 0);
+  for (size_t j = 0; j < m; ++j)
+  {
+    size_t lj = 0;
+    for (size_t c = 0; c < k; ++c)
+    {
+      if (chars[c] == lit[j])
+      {
+        delta[j * k + c] = static_cast<uint8_t>(j + 1);
+        lj = c;
+      }
+      else
+      {
+        delta[j * k + c] = j == 0 ? 0 : delta[fail[j] * k + c];
+      }
+    }
+    fail[j + 1] = j == 0 ? 0 : delta[fail[j] * k + lj];
+  }
+  // explore the product from the start node to the nodes that complete the literal, fail when accepting before the literal
+  std::vector<bool> seen(n, false);
+  std::vector<uint32_t> queue;
+  std::vector<uint32_t> from;
+  std::vector<uint32_t> to;
+  std::vector<uint8_t> arcs; // bit 0 if the arc consumes a byte, bit 1 if the arc may consume a newline
+  std::vector<uint32_t> hits;
+  seen[0] = true;
+  queue.push_back(0);
+  for (size_t q = 0; q < queue.size(); ++q)
+  {
+    uint32_t u = queue[q];
+    const DFA::State *state = states[u / m];
+    size_t j = u % m;
+    if (state->accept > 0)
+      return false;
+    for (DFA::State::Edges::const_iterator edge = state->edges.begin(); edge != state->edges.end(); ++edge)
+    {
+      if (edge->second.second == NULL)
+        continue;
+      size_t t = ids.find(edge->second.second)->second * m;
+      Char lo = edge->first;
+      Char hi = edge->second.first;
+      size_t w = from.size();
+      if (is_meta(lo))
+      {
+        from.push_back(u);
+        to.push_back(static_cast<uint32_t>(t + j));
+        arcs.push_back(0);
+      }
+      else
+      {
+        size_t in = 0;
+        for (size_t c = 0; c < k; ++c)
+        {
+          Char b = static_cast<uint8_t>(chars[c]);
+          if (b < lo || b > hi)
+            continue;
+          ++in;
+          size_t nj = delta[j * k + c];
+          if (nj == m)
+          {
+            hits.push_back(u);
+          }
+          else
+          {
+            from.push_back(u);
+            to.push_back(static_cast<uint32_t>(t + nj));
+            arcs.push_back(1 | ((b == '\n') << 1));
+          }
+        }
+        if (in < hi - lo + 1U)
+        {
+          from.push_back(u);
+          to.push_back(static_cast<uint32_t>(t));
+          arcs.push_back(1 | ((lo <= '\n' && '\n' <= hi && chars.find('\n') == std::string::npos) << 1));
+        }
+      }
+      for (; w < to.size(); ++w)
+      {
+        if (!seen[to[w]])
+        {
+          seen[to[w]] = true;
+          queue.push_back(to[w]);
+        }
+      }
+      if (from.size() > 0x400000)
+        return false;
+    }
+  }
+  if (hits.empty())
+    return false;
+  // the live nodes reach a node that completes the literal
+  std::vector<uint32_t> rix(n + 1, 0);
+  for (size_t a = 0; a < to.size(); ++a)
+    ++rix[to[a] + 1];
+  for (size_t v = 0; v < n; ++v)
+    rix[v + 1] += rix[v];
+  std::vector<uint32_t> rev(to.size());
+  std::vector<uint32_t> fill(rix.begin(), rix.end() - 1);
+  for (size_t a = 0; a < to.size(); ++a)
+    rev[fill[to[a]]++] = static_cast<uint32_t>(a);
+  std::vector<bool> live(n, false);
+  queue.clear();
+  for (size_t h = 0; h < hits.size(); ++h)
+  {
+    if (!live[hits[h]])
+    {
+      live[hits[h]] = true;
+      queue.push_back(hits[h]);
+    }
+  }
+  for (size_t q = 0; q < queue.size(); ++q)
+  {
+    uint32_t v = queue[q];
+    for (uint32_t r = rix[v]; r < rix[v + 1]; ++r)
+    {
+      uint32_t u = from[rev[r]];
+      if (!live[u])
+      {
+        live[u] = true;
+        queue.push_back(u);
+      }
+    }
+  }
+  // the longest path over the live nodes bounds the distance from the match start to the literal, unless the live nodes loop
+  std::vector<uint32_t> deg(n, 0);
+  std::vector<uint32_t> fix(n + 1, 0);
+  bool newline = chars.find('\n') != std::string::npos;
+  for (size_t a = 0; a < to.size(); ++a)
+  {
+    if (live[from[a]] && live[to[a]])
+    {
+      ++deg[to[a]];
+      ++fix[from[a] + 1];
+      if (arcs[a] & 2)
+        newline = true;
+    }
+  }
+  for (size_t u = 0; u < n; ++u)
+    fix[u + 1] += fix[u];
+  std::vector<uint32_t> fwd(fix[n]);
+  fill.assign(fix.begin(), fix.end() - 1);
+  for (size_t a = 0; a < to.size(); ++a)
+    if (live[from[a]] && live[to[a]])
+      fwd[fill[from[a]]++] = static_cast<uint32_t>(a);
+  std::vector<size_t> depth(n, 0);
+  size_t done = 0;
+  size_t lives = 0;
+  queue.clear();
+  for (size_t u = 0; u < n; ++u)
+  {
+    if (live[u])
+    {
+      ++lives;
+      if (deg[u] == 0)
+        queue.push_back(static_cast<uint32_t>(u));
+    }
+  }
+  for (size_t q = 0; q < queue.size(); ++q, ++done)
+  {
+    uint32_t u = queue[q];
+    for (uint32_t f = fix[u]; f < fix[u + 1]; ++f)
+    {
+      size_t a = fwd[f];
+      uint32_t v = to[a];
+      if (depth[v] < depth[u] + (arcs[a] & 1))
+        depth[v] = depth[u] + (arcs[a] & 1);
+      if (--deg[v] == 0)
+        queue.push_back(v);
+    }
+  }
+  dist = 0;
+  if (done == lives)
+  {
+    for (size_t h = 0; h < hits.size(); ++h)
+      if (dist < depth[hits[h]] + 1 - m)
+        dist = depth[hits[h]] + 1 - m;
+    if (dist < 0xFFFF)
+      return true;
+  }
+  // matches are unbounded before the literal, which is fine as long as the text before the literal has no newline
+  if (newline)
+    return false;
+  dist = 0xFFFF;
+  return true;
+}
+
+void Pattern::gen_reverse(
+    const std::vector<DFA::State*>&    states,
+    const std::map<DFA::State*,Index>& ids)
+{
+  // the forward transitions on metas and the reversed transitions on bytes of the DFA
+  size_t n = states.size();
+  std::vector<std::vector<Index> > metas(n);
+  std::vector<std::vector<Index> > backs(n);
+  std::vector<std::vector<std::pair<Char,Char> > > ranges(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    for (DFA::State::Edges::const_iterator edge = states[i]->edges.begin(); edge != states[i]->edges.end(); ++edge)
+    {
+      if (edge->second.second == NULL)
+        continue;
+      Index t = ids.find(edge->second.second)->second;
+      if (is_meta(edge->first))
+      {
+        metas[i].push_back(t);
+      }
+      else
+      {
+        backs[t].push_back(static_cast<Index>(i));
+        ranges[t].push_back(std::pair<Char,Char>(edge->first, edge->second.first));
+      }
+    }
+  }
+  // the start state at the literal has the states that match the literal, anchors are assumed to hold in both directions
+  std::vector<Index> start;
+  for (size_t i = 0; i < n; ++i)
+  {
+    std::vector<bool> cur(n, false);
+    std::vector<Index> work(1, static_cast<Index>(i));
+    cur[i] = true;
+    for (size_t k = 0; k <= mln_ && !work.empty(); ++k)
+    {
+      for (size_t w = 0; w < work.size(); ++w)
+      {
+        for (size_t m = 0; m < metas[work[w]].size(); ++m)
+        {
+          if (!cur[metas[work[w]][m]])
+          {
+            cur[metas[work[w]][m]] = true;
+            work.push_back(metas[work[w]][m]);
+          }
+        }
+      }
+      if (k == mln_)
+        break;
+      Char c = static_cast<uint8_t>(mst_[k]);
+      std::vector<Index> next;
+      std::vector<bool> nxt(n, false);
+      for (size_t w = 0; w < work.size(); ++w)
+      {
+        for (DFA::State::Edges::const_iterator edge = states[work[w]]->edges.begin(); edge != states[work[w]]->edges.end(); ++edge)
+        {
+          if (!is_meta(edge->first) && edge->first <= c && c <= edge->second.first && edge->second.second != NULL)
+          {
+            Index t = ids.find(edge->second.second)->second;
+            if (!nxt[t])
+            {
+              nxt[t] = true;
+              next.push_back(t);
+            }
+          }
+        }
+      }
+      work.swap(next);
+      cur.swap(nxt);
+    }
+    if (!work.empty())
+      start.push_back(static_cast<Index>(i));
+  }
+  // subset construction of the reverse DFA, reverse states are closed under the reversed meta transitions
+  std::vector<std::vector<Index> > rmetas(n);
+  for (size_t i = 0; i < n; ++i)
+    for (size_t m = 0; m < metas[i].size(); ++m)
+      rmetas[metas[i][m]].push_back(static_cast<Index>(i));
+  std::vector<std::vector<Index> > sets(2);
+  std::map<std::vector<Index>,Index> table;
+  sets[1].swap(start);
+  Reverse *reverse = new Reverse;
+  for (size_t r = 1; r < sets.size(); ++r)
+  {
+    std::vector<Index>& set = sets[r];
+    std::vector<bool> in(n, false);
+    for (size_t k = 0; k < set.size(); ++k)
+      in[set[k]] = true;
+    for (size_t k = 0; k < set.size(); ++k)
+    {
+      for (size_t m = 0; m < rmetas[set[k]].size(); ++m)
+      {
+        if (!in[rmetas[set[k]][m]])
+        {
+          in[rmetas[set[k]][m]] = true;
+          set.push_back(rmetas[set[k]][m]);
+        }
+      }
+    }
+    std::sort(set.begin(), set.end());
+    if (r == 1)
+      table[set] = 1;
+    // a match may start in the reverse states with the DFA start state
+    std::vector<std::vector<Index> > prev(256);
+    for (size_t k = 0; k < set.size(); ++k)
+      for (size_t b = 0; b < backs[set[k]].size(); ++b)
+        for (Char c = ranges[set[k]][b].first; c <= ranges[set[k]][b].second; ++c)
+          prev[c].push_back(backs[set[k]][b]);
+    reverse->next.resize(256 * (r + 1), 0);
+    reverse->fin.resize(r + 1, 0);
+    reverse->fin[r] = !set.empty() && set[0] == 0;
+    for (Char c = 0; c < 256; ++c)
+    {
+      std::vector<Index>& from = prev[c];
+      if (from.empty())
+        continue;
+      std::sort(from.begin(), from.end());
+      from.erase(std::unique(from.begin(), from.end()), from.end());
+      // close under the reversed meta transitions before the lookup, to find equal reverse states
+      std::vector<bool> got(n, false);
+      for (size_t k = 0; k < from.size(); ++k)
+        got[from[k]] = true;
+      for (size_t k = 0; k < from.size(); ++k)
+      {
+        for (size_t m = 0; m < rmetas[from[k]].size(); ++m)
+        {
+          if (!got[rmetas[from[k]][m]])
+          {
+            got[rmetas[from[k]][m]] = true;
+            from.push_back(rmetas[from[k]][m]);
+          }
+        }
+      }
+      std::sort(from.begin(), from.end());
+      std::map<std::vector<Index>,Index>::iterator i = table.find(from);
+      if (i == table.end())
+      {
+        if (sets.size() >= Reverse::MAX)
+        {
+          delete reverse;
+          return;
+        }
+        i = table.insert(std::pair<std::vector<Index>,Index>(from, static_cast<Index>(sets.size()))).first;
+        sets.push_back(from);
+      }
+      reverse->next[256 * r + c] = i->second;
+    }
+  }
+  rev_ = reverse;
+  DBGLOGN("reverse DFA states = %zu", sets.size());
+}
+
+bool Pattern::gen_literals(DFA::State *state, std::string& lit, std::vector<std::string>& lits, size_t& visits) const
+{
+  // limit the search, a literal prefix set is only useful when it is small
+  if (++visits > 256)
+    return false;
+  if (state == NULL || state->accept > 0 || lit.size() >= Const::LLEN)
+  {
+    if (lit.empty())
+      return false;
+    lits.push_back(lit);
+    return lits.size() <= Const::LITS;
+  }
+  size_t chars = 0;
+  for (DFA::State::Edges::const_iterator edge = state->edges.begin(); edge != state->edges.end(); ++edge)
+  {
+    if (is_meta(edge->first))
+      chars = Const::LITS;
+    else
+      chars += edge->second.first - edge->first + 1;
+  }
+  if (chars >= Const::LITS)
+  {
+    // too many chars or anchors: truncate the literal, if possible
+    if (lit.empty())
+      return false;
+    lits.push_back(lit);
+    return lits.size() <= Const::LITS;
+  }
+  for (DFA::State::Edges::const_iterator edge = state->edges.begin(); edge != state->edges.end(); ++edge)
+  {
+    Char lo = edge->first;
+    Char hi = edge->second.first;
+    for (Char c = lo; c <= hi; ++c)
+    {
+      lit.push_back(static_cast<char>(c));
+      if (!gen_literals(edge->second.second, lit, lits, visits))
+        return false;
+      lit.erase(lit.size() - 1);
+    }
+  }
+  return true;
+}
+
+void Pattern::init_wide()
+{
+  std::memset(wlo_, 0, sizeof(wlo_));
+  for (Char c = 0; c < 256; ++c)
+    for (size_t k = 0; k < wmn_; ++k)
+      if (((wbt_[c] >> k) & 1) == 0)
+        wlo_[k][c & 0x0F] |= static_cast<uint8_t>(1 << ((c >> 4) & 7));
+}
+
+void Pattern::init_literals()
+{
+  lfp_ = 3;
+  for (size_t i = 0; i < lno_; ++i)
+    if (lln_[i] < lfp_)
+      lfp_ = lln_[i];
+  std::memset(tlo_, 0, sizeof(tlo_));
+  std::memset(thi_, 0, sizeof(thi_));
+  for (size_t i = 0; i < lno_; ++i)
+  {
+    for (size_t k = 0; k < lfp_; ++k)
+    {
+      uint8_t c = static_cast<uint8_t>(lit_[i][k]);
+      tlo_[k][c & 0x0F] |= static_cast<uint8_t>(1 << i);
+      thi_[k][c >> 4] |= static_cast<uint8_t>(1 << i);
+    }
+  }
+}
+
+void Pattern::gen_predict_match_transitions(DFA::State *state, std::map<DFA::State*,Bits>& states)
 {
   for (DFA::State::Edges::const_iterator edge = state->edges.begin(); edge != state->edges.end(); ++edge)
   {
@@ -3077,6 +5240,7 @@ void Pattern::gen_predict_match_transitions(DFA::State *state, std::map<DFA::Sta
     }
     if (accept)
       min_ = 1;
+    Bits *follow = next != NULL ? &states[next] : NULL;
     Char hi = edge->second.first;
     while (lo <= hi)
     {
@@ -3085,14 +5249,14 @@ void Pattern::gen_predict_match_transitions(DFA::State *state, std::map<DFA::Sta
       if (accept)
         pma_[lo] &= ~(1 << 7);
       pma_[lo] &= ~(1 << 6);
-      if (next != NULL)
-        states[next].insert(hash(lo));
+      if (follow != NULL)
+        follow->insert(hash(lo));
       ++lo;
     }
   }
 }
 
-void Pattern::gen_predict_match_transitions(size_t level, DFA::State *state, ORanges<Hash>& labels, std::map<DFA::State*,ORanges<Hash> >& states)
+void Pattern::gen_predict_match_transitions(size_t level, DFA::State *state, const Bits& labels, std::map<DFA::State*,Bits>& states)
 {
   for (DFA::State::Edges::const_iterator edge = state->edges.begin(); edge != state->edges.end(); ++edge)
   {
@@ -3126,24 +5290,21 @@ void Pattern::gen_predict_match_transitions(size_t level, DFA::State *state, ORa
       if (level <= min_)
         while (lo <= hi)
           bit_[lo++] &= ~(1 << level);
-      for (ORanges<Hash>::const_iterator label = labels.begin(); label != labels.end(); ++label)
+      Bits *follow = next != NULL ? &states[next] : NULL;
+      for (size_t label = labels.find_first(); label != Bits::npos; label = labels.find_next(label))
       {
-        Hash label_hi = label->second - 1;
-        for (Hash label_lo = label->first; label_lo <= label_hi; ++label_lo)
+        for (lo = edge->first; lo <= hi; ++lo)
         {
-          for (lo = edge->first; lo <= hi; ++lo)
+          Hash h = hash(static_cast<Hash>(label), static_cast<uint8_t>(lo));
+          pmh_[h] &= ~(1 << level);
+          if (level < 4)
           {
-            Hash h = hash(label_lo, static_cast<uint8_t>(lo));
-            pmh_[h] &= ~(1 << level);
-            if (level < 4)
-            {
-              if (level == 3 || accept)
-                pma_[h] &= ~(1 << (7 - 2 * level));
-              pma_[h] &= ~(1 << (6 - 2 * level));
-            }
-            if (next != NULL)
-              states[next].insert(hash(h));
+            if (level == 3 || accept)
+              pma_[h] &= ~(1 << (7 - 2 * level));
+            pma_[h] &= ~(1 << (6 - 2 * level));
           }
+          if (follow != NULL)
+            follow->insert(hash(h));
         }
       }
     }
@@ -3152,8 +5313,17 @@ void Pattern::gen_predict_match_transitions(size_t level, DFA::State *state, ORa
 
 void Pattern::write_predictor(FILE *file) const
 {
-  ::fprintf(file, "extern const reflex::Pattern::Pred reflex_pred_%s[%zu] = {", opt_.n.empty() ? "FSM" : opt_.n.c_str(), 2 + len_ + (min_ > 1 && len_ == 0) * 256 + (min_ > 0) * Const::HASH);
-  ::fprintf(file, "\n  %3hhu,%3hhu,", static_cast<uint8_t>(len_), (static_cast<uint8_t>(min_ | (one_ << 4))));
+  size_t lits = 0;
+  if (min_ > 0 && lno_ > 0)
+  {
+    lits = 1 + lno_;
+    for (size_t i = 0; i < lno_; ++i)
+      lits += lln_[i];
+  }
+  // the reverse DFA is not exported, a required literal that is unbounded from the match start needs it
+  size_t reqs = mln_ > 0 && mdt_ < 0xFFFF ? 3 + mln_ : 0;
+  ::fprintf(file, "extern const reflex::Pattern::Pred reflex_pred_%s[%zu] = {", opt_.n.empty() ? "FSM" : opt_.n.c_str(), 2 + len_ + (min_ > 1 && len_ == 0) * 256 + (min_ > 0) * Const::HASH + lits + reqs);
+  ::fprintf(file, "\n  %3hhu,%3hhu,", static_cast<uint8_t>(len_), (static_cast<uint8_t>(min_ | (one_ << 4) | ((lits > 0) << 5) | (opt_.h << 6) | ((reqs > 0) << 7))));
   for (size_t i = 0; i < len_; ++i)
     ::fprintf(file, "%s%3hhu,", ((i + 2) & 0xF) ? "" : "\n  ", static_cast<uint8_t>(pre_[i]));
   if (min_ > 0)
@@ -3173,10 +5343,593 @@ void Pattern::write_predictor(FILE *file) const
       for (Hash i = 0; i < Const::HASH; ++i)
         ::fprintf(file, "%s%3hhu,", (i & 0xF) ? "" : "\n  ", static_cast<uint8_t>(~pma_[i]));
     }
+    if (lits > 0)
+    {
+      ::fprintf(file, "\n  %3hhu,", static_cast<uint8_t>(lno_));
+      for (size_t i = 0; i < lno_; ++i)
+        ::fprintf(file, "%3hhu,", lln_[i]);
+      for (size_t i = 0; i < lno_; ++i)
+      {
+        ::fprintf(file, "\n ");
+        for (size_t k = 0; k < lln_[i]; ++k)
+          ::fprintf(file, "%3hhu,", static_cast<uint8_t>(lit_[i][k]));
+      }
+    }
+  }
+  if (reqs > 0)
+  {
+    ::fprintf(file, "\n  %3hhu,", static_cast<uint8_t>(mln_));
+    for (size_t i = 0; i < mln_; ++i)
+      ::fprintf(file, "%s%3hhu,", ((i + 1) & 0xF) ? "" : "\n  ", static_cast<uint8_t>(mst_[i]));
+    ::fprintf(file, "\n  %3hhu,%3hhu,", static_cast<uint8_t>(mdt_ & 0xFF), static_cast<uint8_t>(mdt_ >> 8));
   }
   ::fprintf(file, "\n};\n\n");
 }
 
+/// magic number "RExF" of a saved pattern, also detects a byte order mismatch
+static const uint32_t save_magic = 0x52457846;
+
+/// version of the saved pattern format
+static const uint32_t save_version = 3;
+
+/// number of 32 bit header words of a saved pattern
+static const size_t save_header = 13;
+
+/// FNV-1a hash to checksum and key saved patterns
+static uint32_t save_hash(uint32_t h, const void *data, size_t size)
+{
+  const unsigned char *s = static_cast<const unsigned char*>(data);
+  while (size-- > 0)
+    h = (h ^ *s++) * 0x01000193;
+  return h;
+}
+
+std::string Pattern::key_options() const
+{
+  // the options that affect the compiled pattern
+  std::string opt;
+  if (opt_.b)
+    opt.push_back('b');
+  if (opt_.d)
+    opt.push_back('d');
+  if (opt_.i)
+    opt.push_back('i');
+  if (opt_.m)
+    opt.push_back('m');
+  if (opt_.q)
+    opt.push_back('q');
+  if (opt_.s)
+    opt.push_back('s');
+  if (opt_.x)
+    opt.push_back('x');
+  if (opt_.e != '\\')
+  {
+    opt.append("e=");
+    if (opt_.e < 256)
+      opt.push_back(static_cast<char>(opt_.e));
+    opt.push_back(';');
+  }
+  return opt;
+}
+
+bool Pattern::save(FILE *file) const
+{
+  if (file == NULL || opc_ == NULL || nop_ == 0 || cache_ != NULL)
+    return false;
+  std::string opt = key_options();
+  std::string key(rex_);
+  key.push_back('\0');
+  key.append(opt);
+  // the opcode table and subpattern ends are stored first to keep them 32 bit aligned
+  std::string data(reinterpret_cast<const char*>(opc_), nop_ * sizeof(Opcode));
+  for (size_t i = 0; i < end_.size(); ++i)
+  {
+    uint32_t loc = end_[i];
+    data.append(reinterpret_cast<const char*>(&loc), sizeof(loc));
+  }
+  for (size_t i = 0; i < end_.size(); ++i)
+    data.push_back(i < acc_.size() && acc_[i]);
+  data.append(rex_);
+  data.append(opt);
+  data.append(pre_, len_);
+  data.append(reinterpret_cast<const char*>(bit_), sizeof(bit_));
+  data.append(reinterpret_cast<const char*>(pmh_), sizeof(pmh_));
+  data.append(reinterpret_cast<const char*>(pma_), sizeof(pma_));
+  data.push_back(static_cast<char>(lno_));
+  data.append(reinterpret_cast<const char*>(lln_), sizeof(lln_));
+  data.append(&lit_[0][0], sizeof(lit_));
+  size_t mlen = mdt_ < 0xFFFF ? mln_ : 0;
+  data.append(mst_, mlen);
+  if (wmn_ > 0)
+    data.append(reinterpret_cast<const char*>(wbt_), sizeof(wbt_));
+  uint32_t header[save_header] = {
+    save_magic,
+    save_version,
+    static_cast<uint32_t>(save_header * sizeof(uint32_t) + data.size()),
+    save_hash(0x811C9DC5, data.data(), data.size()),
+    save_hash(0x811C9DC5, key.data(), key.size()),
+    static_cast<uint32_t>(nop_),
+    static_cast<uint32_t>(vno_),
+    static_cast<uint32_t>(eno_),
+    static_cast<uint32_t>(len_ | (wmn_ << 8)),
+    static_cast<uint32_t>(min_ | (one_ << 4) | (mlen << 8) | (mdt_ << 16)),
+    static_cast<uint32_t>(end_.size()),
+    static_cast<uint32_t>(rex_.size()),
+    static_cast<uint32_t>(opt.size()),
+  };
+  return ::fwrite(header, sizeof(header), 1, file) == 1 && ::fwrite(data.data(), data.size(), 1, file) == 1;
+}
+
+bool Pattern::load(const void *data, size_t size)
+{
+  uint32_t header[save_header];
+  if (data == NULL || size < sizeof(header))
+    return false;
+  std::memcpy(header, data, sizeof(header));
+  if (header[0] != save_magic || header[1] != save_version || header[2] > size)
+    return false;
+  size_t nop = header[5];
+  size_t len = header[8] & 0xff;
+  size_t wmn = header[8] >> 8;
+  size_t num = header[10];
+  size_t rlen = header[11];
+  size_t olen = header[12];
+  size_t mlen = (header[9] >> 8) & 0xff;
+  if (nop == 0 || (header[9] & 0x0f) > 8 || (wmn > 0 && (wmn <= 8 || wmn > 64)))
+    return false;
+  size_t need = sizeof(header) + nop * sizeof(Opcode) + num * (sizeof(uint32_t) + 1) + rlen + olen + len + sizeof(bit_) + sizeof(pmh_) + sizeof(pma_) + 1 + sizeof(lln_) + sizeof(lit_) + mlen + (wmn > 0 ? sizeof(wbt_) : 0);
+  if (need != header[2])
+    return false;
+  const char *ptr = static_cast<const char*>(data) + sizeof(header);
+  if (save_hash(0x811C9DC5, ptr, need - sizeof(header)) != header[3])
+    return false;
+  const char *code = ptr;
+  ptr += nop * sizeof(Opcode);
+  const char *ends = ptr;
+  ptr += num * sizeof(uint32_t);
+  const char *accs = ptr;
+  ptr += num;
+  std::string rex(ptr, rlen);
+  ptr += rlen;
+  std::string opt(ptr, olen);
+  ptr += olen;
+  clear();
+  rex_.swap(rex);
+  init_options(opt.c_str());
+  end_.resize(num);
+  acc_.resize(num);
+  for (size_t i = 0; i < num; ++i)
+  {
+    uint32_t loc;
+    std::memcpy(&loc, ends + i * sizeof(loc), sizeof(loc));
+    end_[i] = loc;
+    acc_[i] = accs[i] != 0;
+  }
+  vno_ = header[6];
+  eno_ = header[7];
+  len_ = len;
+  min_ = header[9] & 0x0f;
+  one_ = (header[9] & 0x10) != 0;
+  std::memcpy(pre_, ptr, len_);
+  ptr += len_;
+  std::memcpy(bit_, ptr, sizeof(bit_));
+  ptr += sizeof(bit_);
+  std::memcpy(pmh_, ptr, sizeof(pmh_));
+  ptr += sizeof(pmh_);
+  std::memcpy(pma_, ptr, sizeof(pma_));
+  ptr += sizeof(pma_);
+  lno_ = static_cast<uint8_t>(*ptr++);
+  std::memcpy(lln_, ptr, sizeof(lln_));
+  ptr += sizeof(lln_);
+  std::memcpy(lit_, ptr, sizeof(lit_));
+  ptr += sizeof(lit_);
+  if (lno_ > Const::LITS || len_ > 0)
+    lno_ = 0;
+  for (size_t i = 0; i < lno_; ++i)
+    if (lln_[i] == 0 || lln_[i] > Const::LLEN)
+      lno_ = 0;
+  init_literals();
+  mln_ = len_ == 0 && lno_ == 0 ? mlen : 0;
+  mdt_ = header[9] >> 16;
+  std::memcpy(mst_, ptr, mln_);
+  ptr += mlen;
+  // the wide bitap prefilter, reset when not saved
+  wmn_ = wmn;
+  if (wmn_ > 0)
+    std::memcpy(wbt_, ptr, sizeof(wbt_));
+  init_wide();
+  pms_ = 0.0;
+  vms_ = 0.0;
+  ems_ = 0.0;
+  wms_ = 0.0;
+  if (reinterpret_cast<uintptr_t>(code) % sizeof(Opcode) == 0)
+  {
+    // use the opcode table in place
+    opc_ = reinterpret_cast<const Opcode*>(code);
+    ext_ = true;
+  }
+  else
+  {
+    Opcode *copy = new Opcode[nop];
+    std::memcpy(copy, code, nop * sizeof(Opcode));
+    opc_ = copy;
+  }
+  nop_ = static_cast<Index>(nop);
+  init_lookaheads();
+  return true;
+}
+
+bool Pattern::load(
+    const void *data,
+    size_t      size,
+    const char *regex,
+    const char *options)
+{
+  if (data == NULL || size < save_header * sizeof(uint32_t))
+    return false;
+  // check the key of the saved pattern before loading
+  Option opt(opt_);
+  init_options(options);
+  std::string key(regex != NULL ? regex : "");
+  key.push_back('\0');
+  key.append(key_options());
+  opt_ = opt;
+  uint32_t header[save_header];
+  std::memcpy(header, data, sizeof(header));
+  if (header[4] != save_hash(0x811C9DC5, key.data(), key.size()))
+    return false;
+  if (!load(data, size))
+    return false;
+  std::string loaded(rex_);
+  loaded.push_back('\0');
+  loaded.append(key_options());
+  if (loaded != key)
+  {
+    clear();
+    return false;
+  }
+  return true;
+}
+
+#if defined(WITH_JIT)
+
+/// Returns the next character read by the native code of Pattern::jit() when the matcher buffer is exhausted.
+static int jit_more(Matcher *matcher)
+{
+  return matcher->FSM_CHAR();
+}
+
+/// x86-64 machine code emitted by Pattern::jit() with rel32 jumps and calls to labels patched when the code is complete.
+struct JIT {
+  JIT(size_t labels) : label(labels, static_cast<size_t>(-1)) { }
+  /// emit a byte
+  void op(uint8_t b)
+  {
+    code.push_back(b);
+  }
+  /// emit two or three bytes
+  void op(uint8_t b1, uint8_t b2, int b3 = -1)
+  {
+    code.push_back(b1);
+    code.push_back(b2);
+    if (b3 >= 0)
+      code.push_back(static_cast<uint8_t>(b3));
+  }
+  /// emit a 32 bit little-endian value
+  void u32(uint32_t v)
+  {
+    for (int i = 0; i < 32; i += 8)
+      code.push_back(static_cast<uint8_t>(v >> i));
+  }
+  /// emit a 64 bit little-endian value
+  void u64(uint64_t v)
+  {
+    for (int i = 0; i < 64; i += 8)
+      code.push_back(static_cast<uint8_t>(v >> i));
+  }
+  /// emit instruction REX opcode ModRM with operand [rbx + disp32]
+  void mem(uint8_t rex, uint8_t opcode, uint8_t modrm, size_t disp)
+  {
+    op(rex, opcode, modrm);
+    u32(static_cast<uint32_t>(disp));
+  }
+  /// emit jmp (cc = 0), jcc (cc = 0x80 | cond) or call (cc = 0xE8) to label
+  void jump(uint8_t cc, size_t to)
+  {
+    if (cc == 0)
+      op(0xE9);
+    else if (cc == 0xE8)
+      op(0xE8);
+    else
+      op(0x0F, cc);
+    fix.push_back(std::pair<size_t,size_t>(code.size(), to));
+    u32(0);
+  }
+  /// create a new label
+  size_t make()
+  {
+    label.push_back(static_cast<size_t>(-1));
+    return label.size() - 1;
+  }
+  /// bind label to the current code position
+  void bind(size_t at)
+  {
+    label[at] = code.size();
+  }
+  /// patch the rel32 displacements
+  void patch()
+  {
+    for (std::vector< std::pair<size_t,size_t> >::const_iterator i = fix.begin(); i != fix.end(); ++i)
+    {
+      uint32_t rel = static_cast<uint32_t>(label[i->second] - (i->first + 4));
+      for (int k = 0; k < 4; ++k)
+        code[i->first + k] = static_cast<uint8_t>(rel >> (8 * k));
+    }
+  }
+  static const uint8_t JB  = 0x82;
+  static const uint8_t JE  = 0x84;
+  static const uint8_t JNE = 0x85;
+  static const uint8_t JBE = 0x86;
+  static const uint8_t CALL = 0xE8;
+  std::vector<uint8_t>                       code;  ///< machine code
+  std::vector<size_t>                        label; ///< code position of each label
+  std::vector< std::pair<size_t,size_t> >    fix;   ///< rel32 positions and their labels
+};
+
+/// A run of bytes lo..hi dispatched to the same label by the native code of Pattern::jit().
+struct JITRun {
+  JITRun(uint32_t lo, uint32_t hi, size_t to) : lo(lo), hi(hi), to(to) { }
+  uint32_t lo;
+  uint32_t hi;
+  size_t   to;
+};
+
+/// Emit the dispatch on c1 in r12d over runs[a..b), each run jumps to its label and bytes outside the runs jump to halt.
+static void jit_dispatch(JIT& jit, const std::vector<JITRun>& runs, size_t a, size_t b, size_t halt)
+{
+  if (b - a > 4)
+  {
+    // binary search on the first byte of the middle run
+    size_t m = (a + b) / 2;
+    size_t left = jit.make();
+    jit.op(0x41, 0x81, 0xFC); // cmp r12d, imm32
+    jit.u32(runs[m].lo);
+    jit.jump(JIT::JB, left);
+    jit_dispatch(jit, runs, m, b, halt);
+    jit.bind(left);
+    jit_dispatch(jit, runs, a, m, halt);
+    return;
+  }
+  for (size_t i = a; i < b; ++i)
+  {
+    if (runs[i].to == halt)
+      continue;
+    if (runs[i].lo == runs[i].hi)
+    {
+      jit.op(0x41, 0x81, 0xFC); // cmp r12d, imm32
+      jit.u32(runs[i].lo);
+      jit.jump(JIT::JE, runs[i].to);
+    }
+    else
+    {
+      jit.op(0x44, 0x89, 0xE0); // mov eax, r12d
+      jit.op(0x2D); // sub eax, imm32
+      jit.u32(runs[i].lo);
+      jit.op(0x3D); // cmp eax, imm32
+      jit.u32(runs[i].hi - runs[i].lo);
+      jit.jump(JIT::JBE, runs[i].to);
+    }
+  }
+  jit.jump(0, halt);
+}
+
+#endif
+
+bool Pattern::jit()
+{
+#if defined(WITH_JIT)
+  if (opc_ == NULL || nop_ == 0 || cache_ != NULL)
+    return false;
+  // the matcher state accessed by the native code, the layout is the same for all matchers
+  Matcher matcher;
+  const char *base = reinterpret_cast<const char*>(&matcher);
+  size_t BUF = reinterpret_cast<const char*>(&matcher.buf_) - base;
+  size_t CAP = reinterpret_cast<const char*>(&matcher.cap_) - base;
+  size_t CUR = reinterpret_cast<const char*>(&matcher.cur_) - base;
+  size_t POS = reinterpret_cast<const char*>(&matcher.pos_) - base;
+  size_t END = reinterpret_cast<const char*>(&matcher.end_) - base;
+  size_t C1 = reinterpret_cast<const char*>(&matcher.fsm_.c1) - base;
+#if defined(WITH_STATS)
+  size_t GETS = reinterpret_cast<const char*>(&matcher.sts_.gets) - base;
+  size_t TRANS = reinterpret_cast<const char*>(&matcher.sts_.transitions) - base;
+#endif
+  // labels 0 to nop_ - 1 are the states at these opcode indexes, followed by labels halt, find, more and start
+  JIT jit(nop_);
+  size_t halt = jit.make();
+  size_t find = jit.make();
+  size_t more = jit.make();
+  size_t start = jit.make();
+  // prologue: rbx = &matcher, r12d = c1, the stack is 16 byte aligned for calls
+  jit.op(0x53); // push rbx
+  jit.op(0x41, 0x54); // push r12
+  jit.op(0x48, 0x83, 0xEC); // sub rsp, 8
+  jit.op(0x08);
+  jit.op(0x48, 0x89, 0xFB); // mov rbx, rdi
+  jit.mem(0x44, 0x8B, 0xA3, C1); // mov r12d, [rbx + C1]
+  jit.jump(0, start);
+  // halt: store c1 and return
+  jit.bind(halt);
+  jit.mem(0x44, 0x89, 0xA3, C1); // mov [rbx + C1], r12d
+  jit.op(0x48, 0x83, 0xC4); // add rsp, 8
+  jit.op(0x08);
+  jit.op(0x41, 0x5C); // pop r12
+  jit.op(0x5B); // pop rbx
+  jit.op(0xC3); // ret
+  // find: back at the start state without a match so far, move cur_ forward like FSM_FIND()
+  jit.bind(find);
+  jit.mem(0x48, 0x83, 0xBB, CAP); // cmp qword [rbx + CAP], 0
+  jit.op(0x00);
+  jit.jump(JIT::JNE, 0);
+  jit.mem(0x48, 0x8B, 0x83, POS); // mov rax, [rbx + POS]
+  jit.mem(0x48, 0x89, 0x83, CUR); // mov [rbx + CUR], rax
+  jit.jump(0, 0);
+  // more: r12d = FSM_CHAR() when the buffer is exhausted
+  jit.bind(more);
+  jit.op(0x48, 0x83, 0xEC); // sub rsp, 8
+  jit.op(0x08);
+  jit.op(0x48, 0x89, 0xDF); // mov rdi, rbx
+  jit.op(0x48, 0xB8); // movabs rax, imm64
+  jit.u64(reinterpret_cast<uint64_t>(&jit_more));
+  jit.op(0xFF, 0xD0); // call rax
+  jit.op(0x48, 0x83, 0xC4); // add rsp, 8
+  jit.op(0x08);
+  jit.op(0x41, 0x89, 0xC4); // mov r12d, eax
+  jit.op(0xC3); // ret
+  // compile the states reachable from the start state, in the same way as the opcode interpreter of Matcher::match()
+  std::vector<bool> seen(nop_, false);
+  std::vector<Index> work(1, 0);
+  seen[0] = true;
+  while (!work.empty())
+  {
+    Index pc = work.back();
+    work.pop_back();
+    jit.bind(pc);
+#if defined(WITH_STATS)
+    jit.mem(0x48, 0x83, 0x83, TRANS); // add qword [rbx + TRANS], 1
+    jit.op(0x01);
+#endif
+    if (pc == 0)
+      jit.bind(start);
+    while (!is_opcode_goto(opc_[pc]))
+    {
+      Opcode opcode = opc_[pc];
+      if (is_opcode_take(opcode) || is_opcode_redo(opcode))
+      {
+        // cap_ = accept index or Const::REDO, cur_ = pos_
+        jit.mem(0x48, 0xC7, 0x83, CAP); // mov qword [rbx + CAP], imm32
+        jit.u32(is_opcode_redo(opcode) ? static_cast<uint32_t>(AbstractMatcher::Const::REDO) : long_index_of(opcode));
+        jit.mem(0x48, 0x8B, 0x83, POS); // mov rax, [rbx + POS]
+        jit.mem(0x48, 0x89, 0x83, CUR); // mov [rbx + CUR], rax
+      }
+      else if (!is_opcode_skip(opcode) && !is_opcode_span(opcode))
+      {
+        // lookaheads, anchors, word boundaries and indents are left to the opcode interpreter
+        return false;
+      }
+      if (++pc >= nop_)
+        return false;
+    }
+    if (is_opcode_halt(opc_[pc]))
+    {
+      jit.jump(0, halt);
+      continue;
+    }
+    // the target of each byte is the first GOTO opcode that covers it, like the unrolled loop of Matcher::match()
+    size_t targets[256];
+    for (Char c = 0; c < 256; ++c)
+    {
+      Opcode lo = c << 24;
+      Opcode hi = lo | 0x00FFFFFF;
+      Index i = pc;
+      while (hi < opc_[i] || lo > (opc_[i] << 8))
+        if (++i >= nop_)
+          return false;
+      Index jump = index_of(opc_[i]);
+      if (jump == Const::HALT)
+      {
+        targets[c] = halt;
+        continue;
+      }
+      if (jump == Const::LONG)
+      {
+        if (i + 1 >= nop_)
+          return false;
+        jump = long_index_of(opc_[i + 1]);
+      }
+      else if (jump == 0)
+      {
+        targets[c] = find;
+        continue;
+      }
+      if (jump >= nop_)
+        return false;
+      if (!seen[jump])
+      {
+        seen[jump] = true;
+        work.push_back(jump);
+      }
+      targets[c] = jump;
+    }
+    std::vector<JITRun> runs;
+    for (Char c = 0; c < 256; ++c)
+    {
+      if (runs.empty() || runs.back().to != targets[c])
+        runs.push_back(JITRun(c, c, targets[c]));
+      else
+        runs.back().hi = c;
+    }
+    // if (c1 == EOF) halt
+    jit.op(0x41, 0x83, 0xFC); // cmp r12d, -1
+    jit.op(0xFF);
+    jit.jump(JIT::JE, halt);
+    // c1 = get() with the buffered input in place or by calling more
+    size_t fast = jit.make();
+    size_t next = jit.make();
+    jit.mem(0x48, 0x8B, 0x83, POS); // mov rax, [rbx + POS]
+    jit.mem(0x48, 0x3B, 0x83, END); // cmp rax, [rbx + END]
+    jit.jump(JIT::JB, fast);
+    jit.jump(JIT::CALL, more);
+    jit.op(0x41, 0x83, 0xFC); // cmp r12d, -1
+    jit.op(0xFF);
+    jit.jump(JIT::JE, halt);
+    jit.jump(0, next);
+    jit.bind(fast);
+    jit.mem(0x48, 0x8B, 0x8B, BUF); // mov rcx, [rbx + BUF]
+    jit.op(0x44, 0x0F, 0xB6); // movzx r12d, byte [rcx + rax]
+    jit.op(0x24, 0x01);
+    jit.op(0x48, 0xFF, 0xC0); // inc rax
+    jit.mem(0x48, 0x89, 0x83, POS); // mov [rbx + POS], rax
+#if defined(WITH_STATS)
+    jit.mem(0x48, 0x83, 0x83, GETS); // add qword [rbx + GETS], 1
+    jit.op(0x01);
+#endif
+    jit.bind(next);
+    jit_dispatch(jit, runs, 0, runs.size(), halt);
+  }
+  jit.patch();
+  // copy the code to executable memory, never writable and executable at the same time
+  size_t size = jit.code.size();
+  void *code = ::mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (code == MAP_FAILED)
+    return false;
+  std::memcpy(code, &jit.code[0], size);
+  if (::mprotect(code, size, PROT_READ | PROT_EXEC) != 0)
+  {
+    ::munmap(code, size);
+    return false;
+  }
+  if (jit_ != NULL)
+    jit_free();
+  jit_ = code;
+  jsz_ = size;
+  fsm_ = reinterpret_cast<FSM>(reinterpret_cast<uintptr_t>(code));
+  return true;
+#else
+  return false;
+#endif
+}
+
+void Pattern::jit_free()
+{
+#if defined(WITH_JIT)
+  if (fsm_ == reinterpret_cast<FSM>(reinterpret_cast<uintptr_t>(jit_)))
+    fsm_ = NULL;
+  ::munmap(jit_, jsz_);
+#endif
+  jit_ = NULL;
+  jsz_ = 0;
+}
+
 void Pattern::write_namespace_open(FILE *file) const
 {
   if (opt_.z.empty())
@@ -41,61 +41,68 @@ namespace reflex {
 
 namespace Unicode {
 
-Tables::Tables()
-{
-  block_scripts();
-  language_scripts();
-  letter_scripts();
-
-  range["Other"]                  = range["C"];
-  range["Letter"]                 = range["L"];
-  range["Mark"]                   = range["M"];
-  range["Number"]                 = range["N"];
-  range["Punctuation"]            = range["P"];
-  range["Symbol"]                 = range["S"];
-  range["Separator"]              = range["Z"];
-  range["Lowercase_Letter"]       = range["Ll"];
-  range["Uppercase_Letter"]       = range["Lu"];
-  range["Titlecase_Letter"]       = range["Lt"];
-  range["Modifier_Letter"]        = range["Lm"];
-  range["Other_Letter"]           = range["Lo"];
-  range["Non_Spacing_Mark"]       = range["Mn"];
-  range["Spacing_Combining_Mark"] = range["Mc"];
-  range["Enclosing_Mark"]         = range["Me"];
-  range["Space_Separator"]        = range["Zs"];
-  range["Line_Separator"]         = range["Zl"];
-  range["Paragraph_Separator"]    = range["Zp"];
-  range["Math_Symbol"]            = range["Sm"];
-  range["Currency_Symbol"]        = range["Sc"];
-  range["Modifier_Symbol"]        = range["Sk"];
-  range["Other_Symbol"]           = range["So"];
-  range["Decimal_Digit_Number"]   = range["Nd"];
-  range["Letter_Number"]          = range["Nl"];
-  range["Other_Number"]           = range["No"];
-  range["Dash_Punctuation"]       = range["Pd"];
-  range["Open_Punctuation"]       = range["Ps"];
-  range["Close_Punctuation"]      = range["Pe"];
-  range["Initial_Punctuation"]    = range["Pi"];
-  range["Final_Punctuation"]      = range["Pf"];
-  range["Connector_Punctuation"]  = range["Pc"];
-  range["Other_Punctuation"]      = range["Po"];
-  range["Control"]                = range["Cc"];
-  range["Format"]                 = range["Cf"];
-
-  range["l"] = range["Lowercase_Letter"];
-  range["u"] = range["Uppercase_Letter"];
-  range["s"] = range["Space"];
-  range["w"] = range["Word"];
-}
+/// Alias of a Unicode character class name.
+struct Alias {
+  const char *name;  ///< alias name
+  const char *alias; ///< name of the character class in the generated tables
+};
 
-static const Tables tables;
+// sorted by name
+static const Alias aliases[] = {
+  { "Close_Punctuation",      "Pe" },
+  { "Connector_Punctuation",  "Pc" },
+  { "Control",                "Cc" },
+  { "Currency_Symbol",        "Sc" },
+  { "Dash_Punctuation",       "Pd" },
+  { "Decimal_Digit_Number",   "Nd" },
+  { "Enclosing_Mark",         "Me" },
+  { "Final_Punctuation",      "Pf" },
+  { "Format",                 "Cf" },
+  { "Initial_Punctuation",    "Pi" },
+  { "Letter",                 "L" },
+  { "Letter_Number",          "Nl" },
+  { "Line_Separator",         "Zl" },
+  { "Lowercase_Letter",       "Ll" },
+  { "Mark",                   "M" },
+  { "Math_Symbol",            "Sm" },
+  { "Modifier_Letter",        "Lm" },
+  { "Modifier_Symbol",        "Sk" },
+  { "Non_Spacing_Mark",       "Mn" },
+  { "Number",                 "N" },
+  { "Open_Punctuation",       "Ps" },
+  { "Other",                  "C" },
+  { "Other_Letter",           "Lo" },
+  { "Other_Number",           "No" },
+  { "Other_Punctuation",      "Po" },
+  { "Other_Symbol",           "So" },
+  { "Paragraph_Separator",    "Zp" },
+  { "Punctuation",            "P" },
+  { "Separator",              "Z" },
+  { "Space_Separator",        "Zs" },
+  { "Spacing_Combining_Mark", "Mc" },
+  { "Symbol",                 "S" },
+  { "Titlecase_Letter",       "Lt" },
+  { "Uppercase_Letter",       "Lu" },
+  { "l",                      "Ll" },
+  { "s",                      "Space" },
+  { "u",                      "Lu" },
+  { "w",                      "Word" },
+};
 
 const int * range(const char *s)
 {
-  Tables::Range::const_iterator i = tables.range.find(s);
-  if (i != tables.range.end())
-    return i->second;
-  return NULL;
+  const Alias *alias = Posix::lookup(aliases, sizeof(aliases) / sizeof(aliases[0]), s);
+  if (alias != NULL)
+    s = alias->alias;
+  // the generated tables have no names in common, Unicode classes take precedence over POSIX classes
+  const Posix::Entry *entry = Posix::lookup(language_scripts, language_scripts_size, s);
+  if (entry == NULL)
+    entry = Posix::lookup(letter_scripts, letter_scripts_size, s);
+  if (entry == NULL)
+    entry = Posix::lookup(block_scripts, block_scripts_size, s);
+  if (entry != NULL)
+    return entry->ranges;
+  return Posix::range(s);
 }
 
 }
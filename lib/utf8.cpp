@@ -35,6 +35,7 @@
 */
 
 #include <reflex/utf8.h>
+#include <reflex/input.h>
 
 namespace reflex {
 
@@ -278,4 +279,65 @@ std::string utf8(int a, int b, int esc, const char *par, bool strict)
   return regex;
 }
 
+bool is_binary(const char *s, size_t n)
+{
+  const unsigned char *b = reinterpret_cast<const unsigned char*>(s);
+  const unsigned char *e = b + n;
+  while (b < e)
+  {
+#if defined(HAVE_AVX512BW) || defined(HAVE_AVX2) || defined(HAVE_SSE2)
+    if (have_HW_SSE2())
+    {
+      // skip ASCII 16 bytes at a time, stop at a NUL or at a byte with the high bit set
+      const __m128i vz = _mm_setzero_si128();
+      while (b + 16 <= e)
+      {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+        if (_mm_movemask_epi8(_mm_or_si128(v, _mm_cmpeq_epi8(v, vz))) != 0)
+          break;
+        b += 16;
+      }
+    }
+#elif defined(HAVE_NEON)
+    // skip ASCII 16 bytes at a time, stop at a NUL or at a byte with the high bit set
+    while (b + 16 <= e)
+    {
+      uint8x16_t v = vld1q_u8(b);
+      uint64x2_t vt = vreinterpretq_u64_u8(vorrq_u8(vandq_u8(v, vdupq_n_u8(0x80)), vceqq_u8(v, vdupq_n_u8(0))));
+      if ((vgetq_lane_u64(vt, 0) | vgetq_lane_u64(vt, 1)) != 0)
+        break;
+      b += 16;
+    }
+#endif
+    while (b < e && *b != '\0' && *b < 0x80)
+      ++b;
+    if (b >= e)
+      break;
+    int c = *b;
+    size_t k;
+    // a NUL, a stray continuation byte, an overlong C0 or C1, or F5 to FF are binary
+    if (c < 0xC2)
+      return true;
+    if (c < 0xE0)
+      k = 1;
+    else if (c < 0xF0)
+      k = 2;
+    else if (c < 0xF5)
+      k = 3;
+    else
+      return true;
+    size_t m = e - b - 1;
+    for (size_t i = 1; i <= k && i <= m; ++i)
+      if ((b[i] & 0xC0) != 0x80)
+        return true;
+    // reject overlong three and four byte sequences, surrogate halves, and code points beyond U+10FFFF
+    if (m >= 1 && ((c == 0xE0 && b[1] < 0xA0) || (c == 0xED && b[1] >= 0xA0) || (c == 0xF0 && b[1] < 0x90) || (c == 0xF4 && b[1] >= 0x90)))
+      return true;
+    if (k > m)
+      break;
+    b += k + 1;
+  }
+  return false;
+}
+
 } // namespace reflex
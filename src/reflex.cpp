@@ -69,6 +69,7 @@ static const char *options_table[] = {
   "ctorarg",
   "debug",
   "default",
+  "dense",
   "dotall",
   "exception",
   "extra_type",
@@ -83,10 +84,13 @@ static const char *options_table[] = {
   "indent",
   "input",
   "interactive",
+  "jobs",
   "lex",
+  "lex_batch",
   "lex_compat",
   "lexer",
   "main",
+  "main_jobs",
   "matcher",
   "namespace",
   "never_interactive",
@@ -118,9 +122,12 @@ static const char *options_table[] = {
   "perf_report",
   "posix_compat",
   "prefix",
+  "profile_gen",
+  "profile_use",
   "reentrant",
   "regexp_file",
   "stack",
+  "stats",
   "stdinit",
   "stdout",
   "tables_file",
@@ -547,8 +554,12 @@ void Reflex::help(const char *message, const char *arg)
                 generate scanner for batch input by buffering the entire input\n\
         -f, --full\n\
                 generate full scanner with FSM opcode tables\n\
+        --dense\n\
+                match with dense transition tables of the FSM opcode tables\n\
         -F, --fast\n\
                 generate fast scanner with FSM code\n\
+        --profile-use=FILE\n\
+                optimize the FSM code of option --fast with the profile FILE\n\
         -i, --case-insensitive\n\
                 ignore case in patterns\n\
         -I, --interactive, --always-interactive\n\
@@ -593,12 +604,18 @@ void Reflex::help(const char *message, const char *arg)
                 use lexer class NAME instead of Lexer or yyFlexLexer\n\
         --lex=NAME\n\
                 use lex function NAME instead of lex or yylex\n\
+        --lex-batch\n\
+                generate lex_batch() to tokenize input into arrays of tokens\n\
         --class=NAME\n\
                 declare a user-defined scanner class NAME\n\
         --yyclass=NAME\n\
                 generate Flex-compatible scanner with user-defined class NAME\n\
         --main\n\
                 generate main() to invoke lex() or yylex() once\n\
+        --main-jobs[=N]\n\
+                generate main() to scan the files given as arguments with N\n\
+                threads, one lexer per file, N is the number of cores if\n\
+                not specified\n\
         -L, --noline\n\
                 suppress #line directives in scanner\n\
         -P NAME, --prefix=NAME\n\
@@ -636,8 +653,12 @@ void Reflex::help(const char *message, const char *arg)
                 enable debug mode in scanner\n\
         -p, --perf-report\n\
                 scanner reports detailed performance statistics to stderr\n\
+        --profile-gen=FILE\n\
+                scanner with option --fast appends its FSM profile to FILE\n\
         -s, --nodefault\n\
                 disable the default rule in scanner that echoes unmatched text\n\
+        --stats\n\
+                report DFA diagnostics and search predictor estimates to stdout\n\
         -v, --verbose\n\
                 report summary of scanner statistics to stdout\n\
         -w, --nowarn\n\
@@ -648,6 +669,8 @@ void Reflex::help(const char *message, const char *arg)
                 do-nothing POSIX options\n\
         -?, -h, --help\n\
                 produce this help message and exit\n\
+        --jobs=N\n\
+                use N threads to construct the scanner's DFA\n\
         -V, --version\n\
                 report reflex version and exit\n\
 \n\
@@ -1295,6 +1318,53 @@ std::string Reflex::param_args(const std::string& params)
   return args;
 }
 
+/// Extract TOKEN from an action of the form `return TOKEN;` or `{ return TOKEN; }` where TOKEN is a name, number or character, TOKEN is empty for an empty action
+bool Reflex::token_code(const std::string& code, std::string& token)
+  /// @returns true if the action only returns a TOKEN or is empty
+{
+  size_t i = 0;
+  size_t j = code.size();
+  token.clear();
+  while (i < j && std::isspace(static_cast<unsigned char>(code.at(i))))
+    ++i;
+  while (j > i && std::isspace(static_cast<unsigned char>(code.at(j - 1))))
+    --j;
+  if (j > i + 1 && code.at(i) == '{' && code.at(j - 1) == '}')
+  {
+    ++i;
+    --j;
+    while (i < j && std::isspace(static_cast<unsigned char>(code.at(i))))
+      ++i;
+    while (j > i && std::isspace(static_cast<unsigned char>(code.at(j - 1))))
+      --j;
+  }
+  if (i == j || (j == i + 1 && code.at(i) == ';'))
+    return true;
+  if (j < i + 9 || code.compare(i, 6, "return") != 0 || !std::isspace(static_cast<unsigned char>(code.at(i + 6))) || code.at(j - 1) != ';')
+    return false;
+  i += 7;
+  --j;
+  while (i < j && std::isspace(static_cast<unsigned char>(code.at(i))))
+    ++i;
+  while (j > i && std::isspace(static_cast<unsigned char>(code.at(j - 1))))
+    --j;
+  if (i == j)
+    return false;
+  if (code.at(i) == '\'')
+  {
+    if (j - i < 3 || j - i > 4 || code.at(j - 1) != '\'' || (j - i == 4 && code.at(i + 1) != '\\'))
+      return false;
+  }
+  else
+  {
+    for (size_t k = i; k < j; ++k)
+      if (!std::isalnum(static_cast<unsigned char>(code.at(k))) && code.at(k) != '_' && code.at(k) != ':')
+        return false;
+  }
+  token = code.substr(i, j - i);
+  return true;
+}
+
 /// Add start conditions <start1,start2,...> or subtract them with <-start1,-start2,...>
 bool Reflex::get_starts(size_t& pos, Starts& starts)
 {
@@ -1745,6 +1815,23 @@ void Reflex::write()
     options["token_type"] = options["bison_cc_namespace"] + "::" + options["bison_cc_parser"] + "::symbol_type";
   if (!options["bison_complete"].empty() && options["token_eof"].empty())
     options["token_eof"] = options["token_type"] + (options["bison_locations"].empty() ? "(0)" : "(0, location())");
+  if (!options["main_jobs"].empty())
+  {
+    if (!options["bison"].empty() || !options["bison_cc"].empty() || !options["bison_bridge"].empty() || !options["bison_locations"].empty())
+    {
+      warning("%option main-jobs is ignored with bison options that scan with a global lexer");
+      options["main_jobs"].clear();
+    }
+    else
+    {
+      options["main"] = "true";
+    }
+  }
+  if (!options["lex_batch"].empty() && (!options["bison_cc"].empty() || !options["bison_bridge"].empty() || !options["bison_locations"].empty() || !options["yyclass"].empty() || !options["class"].empty()))
+  {
+    warning("%option lex-batch is ignored with bison-cc, bison-bridge, bison-locations, yyclass and class");
+    options["lex_batch"].clear();
+  }
   std::ofstream ofs;
   if (options["stdout"].empty())
   {
@@ -1775,6 +1862,7 @@ void Reflex::write()
   write_class();
   write_section_1();
   write_lexer();
+  write_lex_batch();
   write_main();
   write_section_3();
   if (!out->good())
@@ -2023,8 +2111,8 @@ void Reflex::write_prelude()
       *out << "#define REFLEX_OPTION_";
       out->width(20);
       *out << std::left << option->first;
-      // if option name ends in 'file' then #define the option's value as a string file name
-      if (option->first.size() > 4 && option->first.compare(option->first.size() - 4, 4, "file") == 0)
+      // if option name ends in 'file' or is a profile option then #define the option's value as a string file name
+      if ((option->first.size() > 4 && option->first.compare(option->first.size() - 4, 4, "file") == 0) || option->first == "profile_gen" || option->first == "profile_use")
         *out << "\"" << escape_bs(option->second) << "\"\n";
       else
         *out << option->second << '\n';
@@ -2348,6 +2436,9 @@ void Reflex::write_class()
         "    return " << lex << "(" << args << ");\n"
         "  }\n";
   }
+  if (!options["lex_batch"].empty())
+    *out <<
+      "  size_t " << lex << "_batch(" << token_type << " *tokens, size_t *offsets, size_t *lengths, size_t *lines, size_t max" << comma_params << ");\n";
   write_perf_report();
   *out <<
     "};\n";
@@ -2423,6 +2514,32 @@ void Reflex::write_perf_report()
       "    std::cerr << \"  WARNING: execution time measurements are relative:\\n  - includes caller's execution time between matches when " << options["lex"] << "() returns\\n  - perf-report instrumentation adds overhead that increases execution times\\n\" << std::endl;\n"
       "    set_perf_report();\n"
       "  }\n";
+    if (!options["main_jobs"].empty())
+    {
+      *out <<
+        "  void perf_report_merge(const " << options["lexer"] << "& lexer)\n"
+        "  {\n";
+      for (Start start = 0; start < conditions.size(); ++start)
+      {
+        size_t report = 0;
+        for (Rules::const_iterator rule = rules[start].begin(); rule != rules[start].end(); ++rule)
+        {
+          if (rule->regex != "<<EOF>>" && rule->code.line != "|")
+          {
+            *out <<
+              "    perf_report_" << conditions[start] << "_rule[" << report << "] += lexer.perf_report_" << conditions[start] << "_rule[" << report << "];\n"
+              "    perf_report_" << conditions[start] << "_size[" << report << "] += lexer.perf_report_" << conditions[start] << "_size[" << report << "];\n"
+              "    perf_report_" << conditions[start] << "_time[" << report << "] += lexer.perf_report_" << conditions[start] << "_time[" << report << "];\n";
+            ++report;
+          }
+        }
+        if (options["nodefault"].empty())
+          *out <<
+            "    perf_report_" << conditions[start] << "_default += lexer.perf_report_" << conditions[start] << "_default;\n";
+      }
+      *out <<
+        "  }\n";
+    }
     *out <<
       "  void set_perf_report()\n"
       "  {\n";
@@ -2812,7 +2929,7 @@ void Reflex::write_lexer()
       if (!options["namespace"].empty())
         write_namespace_open();
       *out << "extern const reflex::Pattern::Opcode reflex_code_" << conditions[start] << "[];\n";
-      if (!options["find"].empty())
+      if (!options["find"].empty() || !options["dense"].empty())
         *out << "extern const reflex::Pattern::Pred reflex_pred_" << conditions[start] << "[];\n";
       if (!options["namespace"].empty())
         write_namespace_close();
@@ -2836,29 +2953,7 @@ void Reflex::write_lexer()
     *out << "::" << lex << "(" << yystype << "& yylval" << comma_params << ")\n{\n";
   else
     *out << "::" << lex << "(" << params << ")\n{\n";
-  for (Start start = 0; start < conditions.size(); ++start)
-  {
-    if (options["matcher"].empty())
-    {
-      if (!options["full"].empty() || !options["fast"].empty())
-      {
-        *out << "  static const reflex::Pattern PATTERN_" << conditions[start] << "(reflex_code_" << conditions[start];
-        if (!options["find"].empty())
-          *out << ", reflex_pred_" << conditions[start];
-        *out << ");\n";
-      }
-      else
-      {
-        write_regex(&conditions[start], patterns[start]);
-        *out << "  static const reflex::Pattern PATTERN_" << conditions[start] << "(REGEX_" << conditions[start] << ");\n";
-      }
-    }
-    else
-    {
-      write_regex(&conditions[start], patterns[start]);
-      *out << "  static const " << library->pattern << " PATTERN_" << conditions[start] << "(REGEX_" << conditions[start] << ");\n";
-    }
-  }
+  write_patterns();
   *out <<
     "  if (!has_matcher())\n"
     "  {\n";
@@ -2915,9 +3010,23 @@ void Reflex::write_lexer()
   for (Start start = 0; start < conditions.size(); ++start)
   {
     if (conditions.size() > 1)
+    {
       *out <<
-        "      case " << conditions[start] << ":\n"
-        "        matcher().pattern(PATTERN_" << conditions[start] << ");\n";
+        "      case " << conditions[start] << ":\n";
+      if (start > 0)
+      {
+        *out << "        {\n          ";
+        write_pattern(start);
+        *out <<
+          "          matcher().pattern(PATTERN_" << conditions[start] << ");\n"
+          "        }\n";
+      }
+      else
+      {
+        *out <<
+          "        matcher().pattern(PATTERN_" << conditions[start] << ");\n";
+      }
+    }
     if (!options["find"].empty())
     {
       if (!options["bison_locations"].empty() && options["bison_complete"].empty())
@@ -2968,7 +3077,7 @@ void Reflex::write_lexer()
           "              if (debug()) std::cerr << \"--" <<
           SGR("\\033[1;35m") << "EOF" << SGR("\\033[0m") <<
           " (start condition \" << start() << \")\\n\";\n";
-      if (!options["perf_report"].empty())
+      if (!options["perf_report"].empty() && options["main_jobs"].empty())
         *out << "              perf_report();\n";
       if (!has_eof)
       {
@@ -3094,6 +3203,163 @@ void Reflex::write_lexer()
     "}" << std::endl;
 }
 
+/// Write the regex strings of the start conditions and the static pattern object of the INITIAL start condition, local to lex() and lex_batch()
+void Reflex::write_patterns()
+{
+  if (!options["matcher"].empty() || (options["full"].empty() && options["fast"].empty()))
+    for (Start start = 0; start < conditions.size(); ++start)
+      write_regex(&conditions[start], patterns[start]);
+  *out << "  ";
+  write_pattern(0);
+}
+
+/// Write the static pattern object of a start condition, constructed when the start condition is first used
+void Reflex::write_pattern(Start start)
+{
+  if (options["matcher"].empty())
+  {
+    if (!options["full"].empty() || !options["fast"].empty())
+    {
+      *out << "static const reflex::Pattern PATTERN_" << conditions[start] << "(reflex_code_" << conditions[start];
+      if (!options["find"].empty() || (!options["dense"].empty() && options["fast"].empty()))
+        *out << ", reflex_pred_" << conditions[start];
+    }
+    else
+    {
+      *out << "static const reflex::Pattern PATTERN_" << conditions[start] << "(REGEX_" << conditions[start];
+      if (!options["dense"].empty())
+        *out << ", \"h\"";
+    }
+  }
+  else
+  {
+    *out << "static const " << library->pattern << " PATTERN_" << conditions[start] << "(REGEX_" << conditions[start];
+  }
+  *out << ");\n";
+}
+
+/// Write lex_batch() method code to lex.yy.cpp, which scans token-only rules in a tight loop and invokes lex() for all other rules
+void Reflex::write_lex_batch()
+{
+  if (!out->good() || options["lex_batch"].empty())
+    return;
+  std::string lex = options["lex"];
+  std::string token_type = options["token_type"].empty() ? "int" : options["token_type"];
+  std::string token_eof = options["token_eof"].empty() ? token_type + "()" : options["token_eof"];
+  std::string comma_params = options["params"].empty() ? "" : ", " + options["params"];
+  std::string args = options["params"].empty() ? "" : param_args(options["params"]);
+  // the fast path skips the code at the start of section 2, debugging and performance reporting done by lex()
+  bool fast = section_2.empty() && options["debug"].empty() && options["perf_report"].empty();
+  *out << "\nsize_t ";
+  if (!options["namespace"].empty())
+    write_namespace_scope();
+  *out << options["lexer"] << "::" << lex << "_batch(" << token_type << " *tokens, size_t *offsets, size_t *lengths, size_t *lines, size_t max" << comma_params << ")\n{\n";
+  if (fast && conditions.size() > 1)
+    write_patterns();
+  *out <<
+    "  size_t k = 0;\n"
+    "  while (k < max)\n"
+    "  {\n"
+    "    bool hit = false;\n";
+  if (fast)
+  {
+    *out <<
+      "    if (has_matcher())\n"
+      "    {\n";
+    if (conditions.size() > 1)
+      *out <<
+        "      switch (start())\n"
+        "      {\n";
+    for (Start start = 0; start < conditions.size(); ++start)
+    {
+      if (conditions.size() > 1)
+      {
+        *out <<
+          "        case " << conditions[start] << ":\n";
+        if (start > 0)
+        {
+          *out << "          {\n            ";
+          write_pattern(start);
+          *out <<
+            "            matcher().pattern(PATTERN_" << conditions[start] << ");\n"
+            "          }\n";
+        }
+        else
+        {
+          *out <<
+            "          matcher().pattern(PATTERN_" << conditions[start] << ");\n";
+        }
+      }
+      *out <<
+        "          switch (matcher()." << (options["find"].empty() ? "scan" : "find") << "())\n"
+        "          {\n";
+      std::vector<std::pair<size_t,Rules::const_iterator> > labels;
+      size_t accept = 1;
+      bool has_code = true;
+      for (Rules::const_iterator rule = rules[start].begin(); rule != rules[start].end(); ++rule)
+      {
+        bool eof_rule = rule->regex == "<<EOF>>";
+        if (!eof_rule || !has_code)
+        {
+          if (!eof_rule)
+            labels.push_back(std::pair<size_t,Rules::const_iterator>(accept, rule));
+          has_code = rule->code.line != "|";
+          if (has_code)
+          {
+            std::string token;
+            if (!labels.empty() && token_code(rule->code.line, token))
+            {
+              for (std::vector<std::pair<size_t,Rules::const_iterator> >::const_iterator i = labels.begin(); i != labels.end(); ++i)
+                *out <<
+                  "            case " << i->first << ": // rule " << i->second->code.file << ":" << i->second->code.lineno << ": " << i->second->pattern << " :\n";
+              if (!options["flex"].empty())
+                *out <<
+                  "              YY_USER_ACTION\n";
+              if (token.empty())
+                *out <<
+                  "              continue;\n";
+              else
+                *out <<
+                  "              tokens[k] = " << token << ";\n"
+                  "              hit = true;\n"
+                  "              break;\n";
+            }
+            labels.clear();
+          }
+          ++accept;
+        }
+      }
+      *out <<
+        "            default:\n"
+        "              matcher().less(0);\n"
+        "          }\n";
+      if (conditions.size() > 1)
+        *out <<
+          "          break;\n";
+    }
+    if (conditions.size() > 1)
+      *out <<
+        "      }\n";
+    *out <<
+      "    }\n";
+  }
+  *out <<
+    "    if (!hit)\n"
+    "    {\n"
+    "      tokens[k] = " << lex << "(" << args << ");\n"
+    "      if (tokens[k] == " << token_eof << ")\n"
+    "        return k;\n"
+    "    }\n"
+    "    offsets[k] = matcher().first();\n"
+    "    lengths[k] = matcher().size();\n"
+    "    if (lines != NULL)\n"
+    "      lines[k] = matcher().lineno();\n"
+    "    ++k;\n"
+    "  }\n"
+    "  return k;\n"
+    "}" << std::endl;
+}
+
 /// Write main() to lex.yy.cpp
 void Reflex::write_main()
 {
@@ -3102,6 +3368,11 @@ void Reflex::write_main()
   if (!options["main"].empty())
   {
     write_banner("SECTION 3: main");
+    if (!options["main_jobs"].empty())
+    {
+      write_main_jobs();
+      return;
+    }
     *out << "int main()\n{\n  return ";
     if (options["bison"].empty())
     {
@@ -3123,6 +3394,146 @@ void Reflex::write_main()
   }
 }
 
+/// Write main() to lex.yy.cpp that scans the files given as arguments with multiple threads
+void Reflex::write_main_jobs()
+{
+  std::string lexer;
+  if (!options["namespace"].empty())
+    lexer.append(options["namespace"]).append("::");
+  if (!options["yyclass"].empty())
+    lexer.append(options["yyclass"]);
+  else if (!options["class"].empty())
+    lexer.append(options["class"]);
+  else
+    lexer.append(options["lexer"]);
+  std::string lex = options["lex"];
+  std::string token_type = options["token_type"].empty() ? "int" : options["token_type"];
+  std::string token_eof = options["token_eof"].empty() ? token_type + "()" : options["token_eof"];
+  bool perf_report = !options["perf_report"].empty();
+  // actions that write to stdout directly bypass the per-file output of the lexer, which is buffered by threads
+  static const char *stdout_writes[] = { "printf", "puts", "putchar", "cout", NULL };
+  for (Start start = 0; start < conditions.size(); ++start)
+  {
+    for (Rules::const_iterator rule = rules[start].begin(); rule != rules[start].end(); ++rule)
+    {
+      for (const char **name = stdout_writes; *name != NULL; ++name)
+      {
+        size_t pos = rule->code.line.find(*name);
+        if (pos != std::string::npos && (pos == 0 || (!std::isalnum(static_cast<unsigned char>(rule->code.line[pos - 1])) && rule->code.line[pos - 1] != '_')))
+        {
+          warning("%option main-jobs buffers the output of out(), yyout and ECHO per file, but this action writes to stdout with ", *name, rule->code.lineno);
+          break;
+        }
+      }
+    }
+  }
+  *out <<
+    "#include <atomic>\n"
+    "#include <mutex>\n"
+    "#include <thread>\n"
+    "#include <vector>\n"
+    "\n"
+    "int main(int argc, char **argv)\n"
+    "{\n"
+    "  if (argc < 2)\n"
+    "    return " << lexer << "()." << lex << "();\n";
+  if (options["main_jobs"] == "true")
+    *out <<
+      "  int jobs = static_cast<int>(std::thread::hardware_concurrency());\n";
+  else
+    *out <<
+      "  int jobs = " << options["main_jobs"] << ";\n";
+  *out <<
+    "  if (jobs < 1)\n"
+    "    jobs = 1;\n"
+    "  if (jobs > argc - 1)\n"
+    "    jobs = argc - 1;\n"
+    "  int status = EXIT_SUCCESS;\n";
+  if (perf_report)
+    *out <<
+      "  " << lexer << " report;\n";
+  *out <<
+    "  if (jobs == 1)\n"
+    "  {\n"
+    "    // scan the files one after another without buffering the output\n"
+    "    for (int arg = 1; arg < argc; ++arg)\n"
+    "    {\n"
+    "      FILE *file = fopen(argv[arg], \"r\");\n"
+    "      if (file == NULL)\n"
+    "      {\n"
+    "        std::cerr << argv[arg] << \": cannot open file\" << std::endl;\n"
+    "        status = EXIT_FAILURE;\n"
+    "        continue;\n"
+    "      }\n"
+    "      " << lexer << " lexer;\n"
+    "      lexer.in(file);\n"
+    "      while (lexer." << lex << "() != " << token_eof << ")\n"
+    "        continue;\n"
+    "      fclose(file);\n";
+  if (perf_report)
+    *out <<
+      "      report.perf_report_merge(lexer);\n";
+  *out <<
+    "    }\n"
+    "  }\n"
+    "  else\n"
+    "  {\n"
+    "    // scan each file with a new lexer, the output of a file is written when it and the files before it are scanned\n"
+    "    std::vector<std::string> texts(argc);\n"
+    "    std::vector<int> scanned(argc, 0);\n"
+    "    std::atomic<int> next(1);\n"
+    "    int written = 1;\n"
+    "    std::mutex output;\n"
+    "    std::vector<std::thread> workers;\n"
+    "    for (int i = 0; i < jobs; ++i)\n"
+    "    {\n"
+    "      workers.push_back(std::thread([&]() {\n"
+    "        int arg;\n"
+    "        while ((arg = next++) < argc)\n"
+    "        {\n"
+    "          " << lexer << " lexer;\n"
+    "          std::stringstream text;\n"
+    "          FILE *file = fopen(argv[arg], \"r\");\n"
+    "          if (file != NULL)\n"
+    "          {\n"
+    "            lexer.in(file);\n"
+    "            lexer.out(text);\n"
+    "            while (lexer." << lex << "() != " << token_eof << ")\n"
+    "              continue;\n"
+    "            fclose(file);\n"
+    "          }\n"
+    "          std::lock_guard<std::mutex> lock(output);\n";
+  if (perf_report)
+    *out <<
+      "          report.perf_report_merge(lexer);\n";
+  *out <<
+    "          texts[arg] = text.str();\n"
+    "          scanned[arg] = file != NULL ? 1 : -1;\n"
+    "          for (; written < argc && scanned[written] != 0; ++written)\n"
+    "          {\n"
+    "            if (scanned[written] < 0)\n"
+    "            {\n"
+    "              std::cout.flush();\n"
+    "              std::cerr << argv[written] << \": cannot open file\" << std::endl;\n"
+    "              status = EXIT_FAILURE;\n"
+    "            }\n"
+    "            std::cout << texts[written];\n"
+    "            std::string().swap(texts[written]);\n"
+    "          }\n"
+    "        }\n"
+    "      }));\n"
+    "    }\n"
+    "    for (int i = 0; i < jobs; ++i)\n"
+    "      workers[i].join();\n"
+    "  }\n";
+  if (perf_report)
+    *out <<
+      "  report.perf_report();\n";
+  *out <<
+    "  return status;\n"
+    "}\n";
+}
+
 /// Write regex string to lex.yy.cpp by escaping \ and ", prevent trigraphs, very long strings are represented by character arrays
 void Reflex::write_regex(const std::string *condition, const std::string& regex)
 {
@@ -3254,9 +3665,21 @@ void Reflex::stats()
       else if (!options["graphs_file"].empty())
         option.append(";f=").append(start > 0 ? "+" : "").append(file_ext(options["graphs_file"], "gv"));
       if (!options["fast"].empty())
+      {
         option.append(";o");
+        if (!options["profile_gen"].empty())
+          option.append(";v=").append(options["profile_gen"]);
+        if (!options["profile_use"].empty())
+          option.append(";u=").append(options["profile_use"]);
+      }
       if (!options["find"].empty())
         option.append(";p");
+      if (!options["dense"].empty())
+        option.append(";h");
+      if (!options["jobs"].empty())
+        option.append(";j=").append(options["jobs"]);
+      if (!options["stats"].empty())
+        option.append(";y");
       if (options["tables_file"] == "true")
         option.append(";f=reflex.").append(conditions[start]).append(".cpp");
       else if (!options["tables_file"].empty())
@@ -3267,10 +3690,16 @@ void Reflex::stats()
       {
         reflex::Pattern pattern(patterns[start], option);
         reflex::Pattern::Index accept = 1;
+        std::vector<size_t> linenos;
         for (size_t rule = 0; rule < rules[start].size(); ++rule)
+        {
           if (rules[start][rule].regex != "<<EOF>>")
+          {
             if (!pattern.reachable(accept++))
               warning("rule cannot be matched because a previous rule subsumes it, perhaps try to move this rule up?", "", rules[start][rule].code.lineno);
+            linenos.push_back(rules[start][rule].code.lineno);
+          }
+        }
         reflex::Pattern::Index n = 0;
         if (!patterns[start].empty())
           n = pattern.size();
@@ -3291,6 +3720,30 @@ void Reflex::stats()
             << std::setw(10) << pattern.edges() << " edges (" << pattern.edges_time() << " ms)\n"
             << std::setw(10) << pattern.words() << " words (" << pattern.words_time() << " ms)\n";
         }
+        if (!options["stats"].empty())
+        {
+          reflex::Pattern::Diagnostics diag;
+          pattern.diagnostics(diag);
+          std::cout << "reflex " << infile << " start condition " << conditions[start] << " diagnostics:\n"
+            << "  search: " << diag.strategy << '\n'
+            << "  estimated fraction of input positions accepted by the predictors:\n"
+            << std::setw(14) << diag.prefix_rate << " prefix\n"
+            << std::setw(14) << diag.bitap_rate << " bitap\n"
+            << std::setw(14) << diag.pmh_rate << " predict-match hash\n"
+            << std::setw(14) << diag.pma_rate << " predict-match\n"
+            << "  DFA states with positions of each rule:\n";
+          for (size_t i = 0; i < diag.states.size() && i < linenos.size(); ++i)
+            std::cout << std::setw(14) << diag.states[i] << " rule at line " << linenos[i] << '\n';
+          std::cout << "  largest DFA states:\n";
+          for (std::vector<reflex::Pattern::Diagnostics::State>::const_iterator i = diag.largest.begin(); i != diag.largest.end(); ++i)
+          {
+            std::cout << std::setw(14) << i->positions << " positions in state " << i->state;
+            if (i->subpattern > 0 && i->subpattern <= linenos.size())
+              std::cout << " mostly of rule at line " << linenos[i->subpattern - 1];
+            std::cout << '\n';
+          }
+          std::cout << std::endl;
+        }
       }
       catch (reflex::regex_error& e)
       {
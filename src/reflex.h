@@ -157,7 +157,11 @@ class Reflex
   void        write_code(const Codes& codes);
   void        write_code(const Code& code);
   void        write_lexer();
+  void        write_patterns();
+  void        write_pattern(Start start);
+  void        write_lex_batch();
   void        write_main();
+  void        write_main_jobs();
   void        write_regex(const std::string *condition, const std::string& regex);    
   void        write_namespace_open();
   void        write_namespace_close();
@@ -186,6 +190,7 @@ class Reflex
   std::string escape_bs(const std::string& s);
   std::string upper_name(const std::string& s);
   std::string param_args(const std::string& s);
+  bool        token_code(const std::string& code, std::string& token);
   bool        get_starts(size_t& pos, Starts& starts);
   void        abort(const char *message, const char *arg = NULL);
   void        error(const char *message, const char *arg = NULL, size_t at_lineno = 0);
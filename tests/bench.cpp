@@ -0,0 +1,623 @@
+// benchmark RE/flex and the regex engines supported by RE/flex
+//
+// Reproducible corpora are generated in memory with a fixed seed: logs, source
+// code, UTF-16 text and binary data.  Each engine is timed on find(), scan(),
+// split() and matches() (per line), reporting the best of the runs.
+//
+// usage: bench [-n RUNS] [-s KB] [-e ENGINE,ENGINE,...] [-o FILE.json]
+//
+//   -n RUNS   number of runs per benchmark, the best time is reported (default 3)
+//   -s KB     size of each corpus in KB (default 1024)
+//   -e LIST   comma-separated engines to run: reflex,fsm,boost,pcre2,std,fuzzy
+//   -o FILE   write results in JSON to FILE, - is stdout
+//
+// the fsm engine requires FSM code generated by bench compiled with -DBENCH_GEN:
+//
+//   c++ -DBENCH_GEN -o bench_gen bench.cpp -lreflex && ./bench_gen bench_fsm.h
+//   c++ -DWITH_BENCH_FSM -o bench bench.cpp -lreflex && ./bench
+//
+// define WITH_BOOST and WITH_PCRE2 to enable the Boost.Regex and PCRE2 engines,
+// std::regex is enabled with C++11 except for the UTF-16 corpus
+
+#include <reflex/matcher.h>
+#include <reflex/timer.h>
+#include <reflex/utf8.h>
+#ifndef BENCH_GEN
+# include "fuzzymatcher.h"
+# ifdef WITH_BOOST
+#  include <reflex/boostmatcher.h>
+# endif
+# ifdef WITH_PCRE2
+#  include <reflex/pcre2matcher.h>
+# endif
+# if __cplusplus >= 201103L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201103L)
+#  define WITH_STD
+#  include <reflex/stdmatcher.h>
+# endif
+#endif
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if !defined(OS_WIN) && !defined(_WIN32)
+# include <sys/resource.h>
+#endif
+
+#ifdef WITH_BENCH_FSM
+# include "bench_fsm.h" // bench_code[] and bench_pred[] generated by bench_gen
+#endif
+
+enum Corpus { LOG, CODE, UTF16, BINARY, CORPORA };
+
+static const char *corpus_name[CORPORA] = { "log", "code", "utf16", "binary" };
+
+enum Method { FIND, SCAN, SPLIT, MATCHES, METHODS };
+
+static const char *method_name[METHODS] = { "find", "scan", "split", "matches" };
+
+// the benchmark regex patterns, with a search, token, delimiter and line pattern per corpus
+struct Regex {
+  Corpus      corpus;
+  Method      method;
+  const char *regex;
+};
+
+static const Regex regexes[] = {
+  { LOG,    FIND,    "\\d+\\.\\d+\\.\\d+\\.\\d+" },
+  { LOG,    SCAN,    "(\\w+)|(\\s+)|(.)" },
+  { LOG,    SPLIT,   "\\s+" },
+  { LOG,    MATCHES, "\\d{4}-\\d\\d-\\d\\d \\d\\d:\\d\\d:\\d\\d \\w+ [\\w.-]+\\[\\d+\\]: ERROR .*" },
+  { CODE,   FIND,    "\\w+\\s*\\(" },
+  { CODE,   SCAN,    "(\\w+)|(\\s+)|(.)" },
+  { CODE,   SPLIT,   "[;{}]" },
+  { CODE,   MATCHES, "[ \\t]*(if|for|while|return)[ (][^\\n]*" },
+  { UTF16,  FIND,    "\\p{Greek}+" },
+  { UTF16,  SCAN,    "(\\p{L}+)|(\\s+)|(.)" },
+  { UTF16,  SPLIT,   "[\\s\\p{P}]+" },
+  { UTF16,  MATCHES, "\\p{Lu}\\p{L}*( \\p{L}+)*\\." },
+  { BINARY, FIND,    "[[:print:]]{8,}" },
+  { BINARY, SCAN,    "([[:alnum:]]+)|(\\s+)|(.)" },
+  { BINARY, SPLIT,   "\\x00+" },
+  { BINARY, MATCHES, "[[:print:]]*" },
+};
+
+static const size_t REGEXES = sizeof(regexes) / sizeof(regexes[0]);
+
+// regex conversion flags of the corpus
+static reflex::convert_flag_type corpus_flags(Corpus corpus)
+{
+  return corpus == UTF16 ? reflex::convert_flag::unicode : reflex::convert_flag::none;
+}
+
+#ifdef BENCH_GEN
+
+// generate the FSM code of the benchmark regex patterns
+int main(int argc, char **argv)
+{
+  const char *filename = argc > 1 ? argv[1] : "bench_fsm.h";
+  FILE *file = fopen(filename, "w");
+  if (file == NULL)
+  {
+    perror(filename);
+    exit(EXIT_FAILURE);
+  }
+  fprintf(file, "// generated by bench_gen\n\n");
+  fclose(file);
+  for (size_t i = 0; i < REGEXES; ++i)
+  {
+    char name[32];
+    snprintf(name, sizeof(name), "o;p;n=bench_%zu;f=+", i);
+    std::string options(name);
+    options.append(filename);
+    reflex::Pattern pattern(reflex::Matcher::convert(regexes[i].regex, corpus_flags(regexes[i].corpus)), options);
+  }
+  file = fopen(filename, "a");
+  if (file == NULL)
+  {
+    perror(filename);
+    exit(EXIT_FAILURE);
+  }
+  fprintf(file, "static const reflex::Pattern::FSM bench_code[] = {\n");
+  for (size_t i = 0; i < REGEXES; ++i)
+    fprintf(file, "  reflex_code_bench_%zu,\n", i);
+  fprintf(file, "};\n\nstatic const reflex::Pattern::Pred *bench_pred[] = {\n");
+  for (size_t i = 0; i < REGEXES; ++i)
+    fprintf(file, "  reflex_pred_bench_%zu,\n", i);
+  fprintf(file, "};\n");
+  fclose(file);
+  return EXIT_SUCCESS;
+}
+
+#else
+
+// a corpus of text or data, UTF-16 is read from a temporary file to include decoding
+struct Text {
+  Text() : file(NULL), bytes(0) { }
+  std::string                           data;  // the corpus, decoded to UTF-8 for UTF-16
+  std::vector< std::pair<size_t,size_t> > lines; // lines in data
+  FILE                                 *file;  // UTF-16 file or NULL
+  size_t                                bytes; // size of the corpus in bytes
+};
+
+// benchmark result
+struct Result {
+  const char *engine;
+  Corpus      corpus;
+  Method      method;
+  size_t      bytes;
+  float       ms;
+  size_t      count;
+  long        rss;
+};
+
+// benchmark pattern compilation result
+struct Compiled {
+  size_t regex;
+  float  parse_ms;
+  float  nodes_ms;
+  float  edges_ms;
+  float  words_ms;
+  size_t nodes;
+  size_t edges;
+  size_t bytes;
+};
+
+static int                   runs = 3;
+static std::vector<Result>   results;
+static std::vector<Compiled> compiled;
+
+// reproducible pseudo-random numbers
+static unsigned long seed = 1;
+
+static size_t rnd(size_t n)
+{
+  seed = seed * 1103515245UL + 12345UL;
+  return static_cast<size_t>((seed >> 16) & 0x7FFF) % n;
+}
+
+static const char *pick(const char *const *words, size_t n)
+{
+  return words[rnd(n)];
+}
+
+#define PICK(words) pick(words, sizeof(words) / sizeof(words[0]))
+
+static void gen_log(std::string& data, size_t size)
+{
+  static const char *const levels[] = { "INFO", "INFO", "INFO", "DEBUG", "WARN", "ERROR" };
+  static const char *const services[] = { "sshd", "kernel", "nginx", "cron", "systemd-logind", "postfix.smtpd" };
+  static const char *const messages[] = { "Accepted password for", "connection closed by", "session opened for user", "GET /index.html 200 from", "timeout while waiting for", "failed login attempt from" };
+  char line[256];
+  while (data.size() < size)
+  {
+    snprintf(line, sizeof(line), "2024-%02u-%02u %02u:%02u:%02u %s %s[%u]: %s %s user%u from %u.%u.%u.%u port %u\n",
+        static_cast<unsigned>(1 + rnd(12)), static_cast<unsigned>(1 + rnd(28)), static_cast<unsigned>(rnd(24)), static_cast<unsigned>(rnd(60)), static_cast<unsigned>(rnd(60)),
+        PICK(levels), PICK(services), static_cast<unsigned>(rnd(32768)), PICK(levels), PICK(messages), static_cast<unsigned>(rnd(100)),
+        static_cast<unsigned>(rnd(256)), static_cast<unsigned>(rnd(256)), static_cast<unsigned>(rnd(256)), static_cast<unsigned>(rnd(256)), static_cast<unsigned>(1024 + rnd(60000)));
+    data.append(line);
+  }
+}
+
+static void gen_code(std::string& data, size_t size)
+{
+  static const char *const types[] = { "int", "size_t", "char*", "double", "std::string", "const Node&" };
+  static const char *const names[] = { "count", "buffer", "node", "len", "result", "index", "value", "next" };
+  static const char *const calls[] = { "strlen", "compute", "insert", "find_first", "malloc", "printf" };
+  char line[256];
+  while (data.size() < size)
+  {
+    switch (rnd(8))
+    {
+      case 0:
+        snprintf(line, sizeof(line), "\n// %s the %s of %s\n%s %s_%u(%s %s)\n{\n", PICK(calls), PICK(names), PICK(names), PICK(types), PICK(calls), static_cast<unsigned>(rnd(1000)), PICK(types), PICK(names));
+        break;
+      case 1:
+        snprintf(line, sizeof(line), "  if (%s > %u && %s(%s) != 0)\n", PICK(names), static_cast<unsigned>(rnd(1000)), PICK(calls), PICK(names));
+        break;
+      case 2:
+        snprintf(line, sizeof(line), "  for (%s %s = 0; %s < %s; ++%s)\n    %s += %s[%s];\n", PICK(types), PICK(names), PICK(names), PICK(names), PICK(names), PICK(names), PICK(names), PICK(names));
+        break;
+      case 3:
+        snprintf(line, sizeof(line), "  return %s(%s, \"%s %u\\n\");\n}\n", PICK(calls), PICK(names), PICK(names), static_cast<unsigned>(rnd(100)));
+        break;
+      default:
+        snprintf(line, sizeof(line), "  %s %s = %s(%s) * %u.%u;\n", PICK(types), PICK(names), PICK(calls), PICK(names), static_cast<unsigned>(rnd(100)), static_cast<unsigned>(rnd(100)));
+        break;
+    }
+    data.append(line);
+  }
+}
+
+// UTF-8 text in English, German, Greek, Russian and Chinese, UTF-16 encoded in a temporary file
+static void gen_utf16(Text& text, size_t size)
+{
+  static const char *const words[] = {
+    "the", "quick", "brown", "fox", "über", "Straße", "größer", "naïve", "café",
+    "αλφα", "βήτα", "γάμμα", "Δέλτα", "λόγος",
+    "Привет", "мир", "быстрая", "лиса",
+    "中文", "文字", "測試",
+  };
+  std::string& data = text.data;
+  size_t bytes = 2; // BOM
+  while (bytes < size)
+  {
+    std::string word(PICK(words));
+    if (rnd(6) == 0 && data.size() > 0 && data[data.size() - 1] != '\n')
+      data.append(rnd(3) == 0 ? ".\n" : ", ");
+    else if (data.size() > 0 && data[data.size() - 1] != '\n')
+      data.push_back(' ');
+    data.append(word);
+    bytes = 2 * data.size(); // approximate, UTF-16 is generated below
+  }
+  data.append(".\n");
+  text.file = tmpfile();
+  if (text.file == NULL)
+  {
+    perror("tmpfile");
+    exit(EXIT_FAILURE);
+  }
+  fputc(0xFF, text.file);
+  fputc(0xFE, text.file);
+  for (const char *s = data.c_str(), *e = s + data.size(); s < e; )
+  {
+    int c = reflex::utf8(s, &s);
+    if (c > 0xFFFF)
+    {
+      c -= 0x10000;
+      int hi = 0xD800 + (c >> 10);
+      int lo = 0xDC00 + (c & 0x3FF);
+      fputc(hi & 0xFF, text.file);
+      fputc(hi >> 8, text.file);
+      c = lo;
+    }
+    fputc(c & 0xFF, text.file);
+    fputc(c >> 8, text.file);
+  }
+  fflush(text.file);
+  text.bytes = static_cast<size_t>(ftell(text.file));
+}
+
+// random bytes with embedded strings
+static void gen_binary(std::string& data, size_t size)
+{
+  static const char *const strings[] = { "libc.so.6", "GLIBC_2.17", "__cxa_finalize", "/usr/lib/locale", "Copyright (c) 2016", "error: out of memory" };
+  while (data.size() < size)
+  {
+    if (rnd(16) == 0)
+    {
+      data.append(PICK(strings));
+    }
+    else
+    {
+      size_t n = rnd(64);
+      for (size_t i = 0; i < n; ++i)
+        data.push_back(static_cast<char>(rnd(4) == 0 ? 0 : rnd(256)));
+    }
+  }
+}
+
+static void gen(Corpus corpus, Text& text, size_t size)
+{
+  seed = 1 + corpus;
+  switch (corpus)
+  {
+    case LOG:
+      gen_log(text.data, size);
+      break;
+    case CODE:
+      gen_code(text.data, size);
+      break;
+    case UTF16:
+      gen_utf16(text, size);
+      break;
+    case BINARY:
+      gen_binary(text.data, size);
+      break;
+    default:
+      break;
+  }
+  if (text.file == NULL)
+    text.bytes = text.data.size();
+  for (size_t i = 0, j = 0; i < text.data.size(); i = j + 1)
+  {
+    j = text.data.find('\n', i);
+    if (j == std::string::npos)
+      j = text.data.size();
+    text.lines.push_back(std::pair<size_t,size_t>(i, j - i));
+  }
+}
+
+// peak resident set size in KB, or 0 when unknown
+static long peak_rss()
+{
+#if !defined(OS_WIN) && !defined(_WIN32)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0)
+# ifdef __APPLE__
+    return usage.ru_maxrss / 1024;
+# else
+    return usage.ru_maxrss;
+# endif
+#endif
+  return 0;
+}
+
+// reset the matcher to read the corpus
+template<typename M>
+static void reset(M& matcher, const Text& text)
+{
+  if (text.file != NULL)
+  {
+    rewind(text.file);
+    matcher.input(reflex::Input(text.file));
+  }
+  else
+  {
+    matcher.input(reflex::Input(text.data.c_str(), text.data.size()));
+  }
+}
+
+// run the method over the corpus, returns the number of matches
+template<typename M>
+static size_t run(M& matcher, Method method, const Text& text)
+{
+  size_t count = 0;
+  switch (method)
+  {
+    case FIND:
+      reset(matcher, text);
+      while (matcher.find())
+        ++count;
+      break;
+    case SCAN:
+      reset(matcher, text);
+      while (matcher.scan())
+        ++count;
+      break;
+    case SPLIT:
+      reset(matcher, text);
+      while (matcher.split())
+        ++count;
+      break;
+    case MATCHES:
+      for (std::vector< std::pair<size_t,size_t> >::const_iterator i = text.lines.begin(); i != text.lines.end(); ++i)
+      {
+        matcher.input(reflex::Input(text.data.c_str() + i->first, i->second));
+        if (matcher.matches())
+          ++count;
+      }
+      break;
+    default:
+      break;
+  }
+  return count;
+}
+
+// time the method over the corpus, best of runs
+template<typename M>
+static void bench(const char *engine, M& matcher, const Regex& regex, const Text& text)
+{
+  Result result;
+  result.engine = engine;
+  result.corpus = regex.corpus;
+  result.method = regex.method;
+  result.bytes = regex.method == MATCHES ? text.data.size() : text.bytes;
+  result.ms = 0;
+  result.count = 0;
+  for (int i = 0; i < runs; ++i)
+  {
+    reflex::timer_type t;
+    reflex::timer_start(t);
+    result.count = run(matcher, regex.method, text);
+    float ms = reflex::timer_elapsed(t);
+    if (i == 0 || ms < result.ms)
+      result.ms = ms;
+  }
+  result.rss = peak_rss();
+  results.push_back(result);
+  fprintf(stderr, "%-6s %-6s %-7s %9zu matches %10.3f ms %8.3f GB/s\n", engine, corpus_name[regex.corpus], method_name[regex.method], result.count, result.ms, result.ms > 0 ? result.bytes / (result.ms * 1e6) : 0.0);
+}
+
+static void bench_reflex(size_t i, const Text& text)
+{
+  const Regex& regex = regexes[i];
+  reflex::Pattern pattern(reflex::Matcher::convert(regex.regex, corpus_flags(regex.corpus)));
+  Compiled c;
+  c.regex = i;
+  c.parse_ms = pattern.parse_time();
+  c.nodes_ms = pattern.nodes_time();
+  c.edges_ms = pattern.edges_time();
+  c.words_ms = pattern.words_time();
+  c.nodes = pattern.nodes();
+  c.edges = pattern.edges();
+  c.bytes = pattern.words() * sizeof(reflex::Pattern::Opcode);
+  compiled.push_back(c);
+  reflex::Matcher matcher(pattern);
+  bench("reflex", matcher, regex, text);
+}
+
+static void bench_fsm(size_t i, const Text& text)
+{
+#ifdef WITH_BENCH_FSM
+  reflex::Pattern pattern(bench_code[i], bench_pred[i]);
+  reflex::Matcher matcher(pattern);
+  bench("fsm", matcher, regexes[i], text);
+#else
+  (void)i;
+  (void)text;
+#endif
+}
+
+static void bench_fuzzy(size_t i, const Text& text)
+{
+  const Regex& regex = regexes[i];
+  reflex::Pattern pattern(reflex::FuzzyMatcher::convert(regex.regex, corpus_flags(regex.corpus)));
+  reflex::FuzzyMatcher matcher(pattern, 1);
+  bench("fuzzy", matcher, regex, text);
+}
+
+static void bench_boost(size_t i, const Text& text)
+{
+#ifdef WITH_BOOST
+  const Regex& regex = regexes[i];
+  reflex::BoostPerlMatcher matcher(reflex::BoostPerlMatcher::convert(regex.regex, corpus_flags(regex.corpus)));
+  bench("boost", matcher, regex, text);
+#else
+  (void)i;
+  (void)text;
+#endif
+}
+
+static void bench_pcre2(size_t i, const Text& text)
+{
+#ifdef WITH_PCRE2
+  const Regex& regex = regexes[i];
+  reflex::PCRE2Matcher matcher(reflex::PCRE2Matcher::convert(regex.regex, corpus_flags(regex.corpus)));
+  bench("pcre2", matcher, regex, text);
+#else
+  (void)i;
+  (void)text;
+#endif
+}
+
+static void bench_std(size_t i, const Text& text)
+{
+#ifdef WITH_STD
+  const Regex& regex = regexes[i];
+  // std::regex recursion overflows the stack on the large UTF-8 alternations of converted Unicode classes
+  if (corpus_flags(regex.corpus) == reflex::convert_flag::unicode)
+    return;
+  reflex::StdEcmaMatcher matcher(reflex::StdEcmaMatcher::convert(regex.regex, corpus_flags(regex.corpus)));
+  bench("std", matcher, regex, text);
+#else
+  (void)i;
+  (void)text;
+#endif
+}
+
+// write a JSON string
+static void json_string(FILE *file, const char *s)
+{
+  fputc('"', file);
+  for (; *s != '\0'; ++s)
+  {
+    if (*s == '"' || *s == '\\')
+      fprintf(file, "\\%c", *s);
+    else if (static_cast<unsigned char>(*s) < 0x20)
+      fprintf(file, "\\u%04x", *s);
+    else
+      fputc(*s, file);
+  }
+  fputc('"', file);
+}
+
+static void json(FILE *file, size_t kb)
+{
+  fprintf(file, "{\n  \"corpus_kb\": %zu,\n  \"runs\": %d,\n  \"patterns\": [", kb, runs);
+  for (size_t i = 0; i < compiled.size(); ++i)
+  {
+    const Compiled& c = compiled[i];
+    fprintf(file, "%s\n    { \"corpus\": \"%s\", \"method\": \"%s\", \"regex\": ", i ? "," : "", corpus_name[regexes[c.regex].corpus], method_name[regexes[c.regex].method]);
+    json_string(file, regexes[c.regex].regex);
+    fprintf(file, ", \"parse_ms\": %.3f, \"nodes_ms\": %.3f, \"edges_ms\": %.3f, \"words_ms\": %.3f, \"nodes\": %zu, \"edges\": %zu, \"opcode_bytes\": %zu }",
+        c.parse_ms, c.nodes_ms, c.edges_ms, c.words_ms, c.nodes, c.edges, c.bytes);
+  }
+  fprintf(file, "\n  ],\n  \"results\": [");
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    const Result& r = results[i];
+    fprintf(file, "%s\n    { \"engine\": \"%s\", \"corpus\": \"%s\", \"method\": \"%s\", \"bytes\": %zu, \"ms\": %.3f, \"gbps\": %.4f, \"matches\": %zu, \"peak_rss_kb\": %ld }",
+        i ? "," : "", r.engine, corpus_name[r.corpus], method_name[r.method], r.bytes, r.ms, r.ms > 0 ? r.bytes / (r.ms * 1e6) : 0.0, r.count, r.rss);
+  }
+  fprintf(file, "\n  ],\n  \"peak_rss_kb\": %ld\n}\n", peak_rss());
+}
+
+static bool enabled(const char *engines, const char *engine)
+{
+  if (engines == NULL)
+    return true;
+  size_t len = strlen(engine);
+  for (const char *s = engines; (s = strstr(s, engine)) != NULL; s += len)
+    if ((s == engines || s[-1] == ',') && (s[len] == '\0' || s[len] == ','))
+      return true;
+  return false;
+}
+
+int main(int argc, char **argv)
+{
+  size_t kb = 1024;
+  const char *engines = NULL;
+  const char *output = NULL;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (argv[i][0] == '-' && argv[i][1] != '\0' && argv[i][2] == '\0' && i + 1 < argc)
+    {
+      switch (argv[i][1])
+      {
+        case 'n':
+          runs = atoi(argv[++i]);
+          continue;
+        case 's':
+          kb = static_cast<size_t>(atol(argv[++i]));
+          continue;
+        case 'e':
+          engines = argv[++i];
+          continue;
+        case 'o':
+          output = argv[++i];
+          continue;
+      }
+    }
+    fprintf(stderr, "usage: bench [-n RUNS] [-s KB] [-e reflex,fsm,boost,pcre2,std,fuzzy] [-o FILE.json]\n");
+    exit(EXIT_FAILURE);
+  }
+  if (runs < 1)
+    runs = 1;
+  Text texts[CORPORA];
+  for (int corpus = 0; corpus < CORPORA; ++corpus)
+    gen(static_cast<Corpus>(corpus), texts[corpus], kb * 1024);
+  try
+  {
+    for (size_t i = 0; i < REGEXES; ++i)
+    {
+      const Text& text = texts[regexes[i].corpus];
+      if (enabled(engines, "reflex"))
+        bench_reflex(i, text);
+      if (enabled(engines, "fsm"))
+        bench_fsm(i, text);
+      if (enabled(engines, "boost"))
+        bench_boost(i, text);
+      if (enabled(engines, "pcre2"))
+        bench_pcre2(i, text);
+      if (enabled(engines, "std"))
+        bench_std(i, text);
+      if (enabled(engines, "fuzzy"))
+        bench_fuzzy(i, text);
+    }
+  }
+  catch (const reflex::regex_error& e)
+  {
+    fprintf(stderr, "%s\n", e.what());
+    exit(EXIT_FAILURE);
+  }
+  if (output != NULL)
+  {
+    FILE *file = strcmp(output, "-") == 0 ? stdout : fopen(output, "w");
+    if (file == NULL)
+    {
+      perror(output);
+      exit(EXIT_FAILURE);
+    }
+    json(file, kb);
+    if (file != stdout)
+      fclose(file);
+  }
+  for (int corpus = 0; corpus < CORPORA; ++corpus)
+    if (texts[corpus].file != NULL)
+      fclose(texts[corpus].file);
+  return EXIT_SUCCESS;
+}
+
+#endif
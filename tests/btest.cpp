@@ -743,6 +743,33 @@ int main()
     error("match results");
   std::cout << std::endl;
   //
+  banner("TEST PREFILTER");
+  //
+  {
+    const char *regexs[] = { "abc", "a\\w+c", "\\bfoo\\b", "^ab", "(x)(yz)|w", "[0-9]+\\.[0-9]+", "hello|world", "q+u", "a|bc|def" };
+    const char *text = "abc foo foobar xfoo foo. ab\nab abc aXXc 12.5 3.14x xyz w hello world qqqu quux aa def bc";
+    for (size_t i = 0; i < sizeof(regexs)/sizeof(regexs[0]); ++i)
+    {
+      BoostMatcher matcher1(regexs[i], text);
+      BoostMatcher matcher2(regexs[i], text);
+      if (!matcher2.prefilter(regexs[i]))
+        error("prefilter");
+      size_t count = 0;
+      while (matcher1.find())
+      {
+        if (!matcher2.find() || matcher1.first() != matcher2.first() || matcher1.size() != matcher2.size() || matcher1.accept() != matcher2.accept())
+          error("prefilter find");
+        ++count;
+      }
+      if (matcher2.find())
+        error("prefilter find");
+      std::cout << regexs[i] << ": " << count << " matches" << std::endl;
+    }
+    BoostMatcher matcher3("(a)\\1", "aa");
+    if (matcher3.prefilter("(a)\\1") || !matcher3.find())
+      error("prefilter backreference");
+  }
+  //
   banner("DONE");
   //
   return 0;
@@ -5,6 +5,15 @@
 // c++ -std=gnu++11 -Wall test.cpp pattern.cpp matcher.cpp
 
 #include <reflex/matcher.h>
+#include <reflex/abslexer.h>
+#include <reflex/tokenring.h>
+#include <sstream>
+#if __cplusplus >= 202002L
+# include <reflex/static_pattern.h>
+#endif
+#if defined(WITH_MATCHER_POOL)
+# include <thread>
+#endif
 
 // #define INTERACTIVE // for interactive mode testing
 
@@ -49,6 +58,168 @@ class WrappedMatcher : public Matcher {
   int source;
 };
 
+// a matcher with a buffer of limited size, to check its capacity
+class LimitedMatcher : public Matcher {
+ public:
+  LimitedMatcher(const char *pattern, const Input& input) : Matcher(pattern, input)
+  { }
+  size_t capacity() const
+  {
+    return max_;
+  }
+  // true if the buffered input ends at a newline or at the end of the input of the given size
+  bool whole_lines(size_t size) const
+  {
+    return end_ == 0 || buf_[end_ - 1] == '\n' || num_ + end_ == size;
+  }
+};
+
+// read a file into a string
+static std::string read_file(const char *filename)
+{
+  std::string data;
+  FILE *file = fopen(filename, "r");
+  if (file == NULL)
+    error("cannot read file");
+  char buf[256];
+  size_t len;
+  while ((len = fread(buf, 1, sizeof(buf), file)) > 0)
+    data.append(buf, len);
+  fclose(file);
+  return data;
+}
+
+// a lexer with a lex_batch() method like the lexers generated with option --lex-batch, skips white space
+class BatchLexer {
+ public:
+  BatchLexer(const Input& input) : matcher_("(\\w+)|(\\s+)|(.)", input)
+  { }
+  bool has_matcher() const
+  {
+    return true;
+  }
+  Matcher& matcher()
+  {
+    return matcher_;
+  }
+  size_t lex_batch(int *tokens, size_t *offsets, size_t *lengths, size_t *lines, size_t max)
+  {
+    size_t k = 0;
+    while (k < max && (tokens[k] = static_cast<int>(matcher_.scan())) != 0)
+    {
+      if (tokens[k] == 2)
+        continue;
+      offsets[k] = matcher_.first();
+      lengths[k] = matcher_.size();
+      lines[k] = matcher_.lineno();
+      ++k;
+    }
+    return k;
+  }
+ private:
+  Matcher matcher_;
+};
+
+// scan a token with a lexer that pushes a start condition state at ( and pops it at ), returns a token description or an empty string at the end
+static std::string lex_token(reflex::AbstractLexer<reflex::Matcher>& lexer)
+{
+  size_t accept = lexer.matcher().scan();
+  if (accept == 0)
+    return "";
+  if (accept == 3)
+    lexer.push_state(lexer.start() + 1);
+  else if (accept == 4)
+    lexer.pop_state();
+  std::stringstream token;
+  token << accept << "@" << lexer.matcher().first() << ":" << lexer.lineno() << "," << lexer.columno() << "<" << lexer.start() << ">" << lexer.str();
+  return token.str();
+}
+
+// count the truncated matches signalled when the buffer limit is reached
+struct LimitHandler : public AbstractMatcher::Handler {
+  LimitHandler() : events(0)
+  { }
+  virtual void operator()(AbstractMatcher& matcher, const char*, size_t, size_t)
+  {
+    if (matcher.overflow())
+      ++events;
+  }
+  size_t events;
+};
+
+// count the buffer allocations of matchers
+struct CountingAllocator : public AbstractMatcher::Allocator {
+  CountingAllocator() : allocated(0), deallocated(0), bytes(0)
+  { }
+  virtual char *allocate(size_t size)
+  {
+    ++allocated;
+    bytes += size;
+    return static_cast<char*>(malloc(size));
+  }
+  virtual void deallocate(char *buf, size_t size)
+  {
+    ++deallocated;
+    bytes -= size;
+    free(buf);
+  }
+  size_t allocated;
+  size_t deallocated;
+  size_t bytes;
+};
+
+// a matcher that reports the capacity of its lookahead positions, to test that matching does not allocate
+class LookaheadMatcher : public Matcher {
+ public:
+  LookaheadMatcher(const Pattern& pattern, const std::string& input) : Matcher(pattern, input)
+  { }
+  size_t capacity() const
+  {
+    return lap_.capacity();
+  }
+};
+
+// pseudo-random number less than n
+static int random_number(unsigned& seed, int n)
+{
+  seed = seed * 1103515245 + 12345;
+  return static_cast<int>((seed >> 16) % n);
+}
+
+// pseudo-random regex up to the given depth, without lookaheads and without quantified word boundaries that may match empty forever
+static std::string random_regex(unsigned& seed, int depth, bool anchors = true)
+{
+  static const char *atoms[] = { "a", "b", "c", ".", "\\d", "1", "x", "\\w", "[^a]", "[a-c]", "[0-2]", "\\s", "\\b" };
+  static const char *quantifiers[] = { "*", "+", "?", "?\?", "*?", "+?", "{1,3}" };
+  if (depth <= 0 || random_number(seed, 3) == 0)
+    return atoms[random_number(seed, anchors ? 13 : 12)];
+  switch (random_number(seed, 3))
+  {
+    case 0:
+      return "(" + random_regex(seed, depth - 1, anchors) + "|" + random_regex(seed, depth - 1, anchors) + ")";
+    case 1:
+      return "(" + random_regex(seed, depth - 1, false) + ")" + quantifiers[random_number(seed, 7)];
+  }
+  return random_regex(seed, depth - 1, anchors) + random_regex(seed, depth - 1, anchors);
+}
+
+// the matches of a pattern in the input with find(), scan(), split() and matches() as a string
+static std::string match_results(const Pattern& pattern, const char *input, int method)
+{
+  std::ostringstream results;
+  Matcher m(pattern, input);
+  if (method == 3)
+    results << m.matches();
+  else
+    while (size_t accept = method == 0 ? m.find() : method == 1 ? m.scan() : m.split())
+    {
+      results << accept << "@" << m.first() << ":" << m.size() << "/";
+      if (accept == Matcher::Const::EMPTY)
+        break;
+    }
+  return results.str();
+}
+
 struct Test {
   const char *pattern;
   const char *popts;
@@ -249,6 +420,23 @@ Test tests[] = {
   // { "(?m)[ \\t]*\\i|^[ \\t]+|[ \\t]*\\j|a|[ \\n]|(?^\\\\\n[ \\t]*)", "m", "", "a\n  a\n  a\\\na\n    a\n  a\na\n", { 4, 5, 1, 4, 5, 2, 4, 4, 5, 1, 4, 5, 2, 3, 4, 5, 3, 4, 5 } }, // TODO line continuation stopping at left margin triggers dedent
   // Unicode or UTF-8 (TODO: requires a flag and changes to the parser so that UTF-8 multibyte chars are parsed as ONE char)
   { "(©)+", "", "", "©", { 1 } },
+  // Tree DFA of string patterns merged with regex patterns
+  { "zebra|abc|zeta|ab|\\x7f\\x01|a[a-z]+|Zoo| ", "", "", "abc ab zeta zebra Zoo \x7f\x01 axe", { 2, 8, 4, 8, 3, 8, 1, 8, 7, 8, 5, 8, 6 } },
+  { "zebra|abc|zeta|ab|a[a-z]+|Zoo| ", "i", "", "ABC aB ZetA zebra zOO axe", { 2, 7, 4, 7, 3, 7, 1, 7, 6, 7, 5 } },
+  // Lazy DFA construction with option l
+  { "ab|xy", "l", "", "abxy", { 1, 2 } },
+  { "(a|b)+?a|c?", "l=2;", "", "bbaaa", { 1, 1 } },
+  { "a(?=bc)|ab(?=d)|bc|d", "l=2;", "", "abcdabd", { 1, 3, 4, 2, 4 } },
+  { "\\<a\\>|\\<a|a\\>|a|-", "l=3;", "", "a-aaa", { 1, 5, 2, 4, 3 } },
+  { "(?m)^[ \\t]+|[ \\t]+\\i|[ \\t]*\\j|a|[ \\n]", "ml=4;", "", "a\n  a\n  a\n    a\n", { 4, 5, 2, 4, 5, 1, 4, 5, 2, 4, 5, 3, 3 } },
+  // DFA minimization with option d
+  { "ab|cb|xy*|zy*", "d", "", "abcbxyyzyy", { 1, 2, 3, 4 } },
+  { "(ab|cb)(x|y)*|z", "d", "", "abxycbyxz", { 1, 1, 2 } },
+  { "(a|b)*abb|c", "d", "", "ababbcabb", { 1, 2, 1 } },
+  { "(ab|cd)+?ab|d?", "d", "", "cdcdababab", { 1, 1 } },
+  { "a(?=bc)|ab(?=d)|bc|d", "d", "", "abcdabd", { 1, 3, 4, 2, 4 } },
+  { "(?^ab)|\\w+| ", "d", "A", "aa ab abab ababba", { 2, 3, reflex::Matcher::Const::REDO, 3, 2, 3, 2 } },
+  { "(?m)^[ \\t]+|[ \\t]+\\i|[ \\t]*\\j|a|[ \\n]", "md", "", "a\n  a\n  a\n    a\n", { 4, 5, 2, 4, 5, 1, 4, 5, 2, 4, 5, 3, 3 } },
   { NULL, NULL, NULL, NULL, { } }
 };
 
@@ -712,6 +900,21 @@ int main()
   std::cout << std::endl;
   if (test != "a/b/c/")
     error("less");
+  // less() restores the char before the next match for anchors
+  Pattern pattern_less("(ab\\n)|(^b)|(b)", "m");
+  matcher.pattern(pattern_less);
+  matcher.input("ab\n");
+  test = "";
+  while (size_t accept = matcher.scan())
+  {
+    if (accept == 1)
+      matcher.less(1);
+    std::cout << accept << matcher.text() << "/";
+    test.append(1, '0' + accept).append(matcher.text()).append("/");
+  }
+  std::cout << std::endl;
+  if (test != "1a/3b/")
+    error("less anchor");
   //
   banner("TEST MATCHES");
   //
@@ -757,6 +960,1450 @@ int main()
   else
     error("match results");
   std::cout << std::endl;
+  //
+  banner("TEST MINIMIZE");
+  //
+  Pattern pattern10("(ab|cb|eb)(x|y)*");
+  Pattern pattern11("(ab|cb|eb)(x|y)*", "d");
+  std::cout << pattern10.nodes() << " states " << pattern10.edges() << " edges " << pattern10.words() << " words" << std::endl;
+  std::cout << pattern11.nodes() << " states " << pattern11.edges() << " edges " << pattern11.words() << " words" << std::endl;
+  if (pattern11.nodes() != 3 || pattern11.nodes() >= pattern10.nodes() || pattern11.edges() >= pattern10.edges() || pattern11.words() >= pattern10.words())
+    error("minimize");
+  matcher.pattern(pattern11);
+  matcher.input("abxycbyeb");
+  test = "";
+  while (matcher.find())
+  {
+    std::cout << matcher.text() << "/";
+    test.append(matcher.text()).append("/");
+  }
+  std::cout << std::endl;
+  if (test != "abxy/cby/eb/")
+    error("minimize find");
+  // minimized DFAs match like the plain DFAs, the start state is never merged with other states because it restarts find() and split()
+  {
+    const char *patterns[] = { "((a)?\?)*1", "a*?b\\b|\\ba", "(ab?\?)+?c|\\bb+", "x(a|b)?\?\\b.", "\\b(a|aa)*?2", "\\d|1|[a-c]", "[^a]|1", "\\w|1|(xyz)*", ".*?\\d*|1" };
+    const char *inputs[] = { "aa2cxa11", "ab a aab bab", "abbc bb abc b", "xa xb. xab x.", "aa2 a2 aaa2 2", "2", "2", "2 xyz", "2" };
+    for (size_t i = 0; i < sizeof(patterns) / sizeof(patterns[0]); ++i)
+    {
+      Pattern plain(patterns[i]);
+      Pattern minimal(patterns[i], "d");
+      for (int method = 0; method < 4; ++method)
+        if (match_results(plain, inputs[i], method) != match_results(minimal, inputs[i], method))
+          error("minimize lazy and word boundary");
+    }
+    // random patterns with overlapping character classes, lazy quantifiers and word boundaries
+    unsigned seed = 1;
+    for (int i = 0; i < 1000; ++i)
+    {
+      std::string regex = random_regex(seed, 4);
+      std::string input;
+      for (int k = random_number(seed, 12); k >= 0; --k)
+        input.push_back("abc12x a9z_"[random_number(seed, 11)]);
+      Pattern plain(regex);
+      Pattern minimal(regex, "d");
+      for (int method = 0; method < 4; ++method)
+        if (match_results(plain, input.c_str(), method) != match_results(minimal, input.c_str(), method))
+          error("minimize random");
+    }
+    Pattern start("((a)?\?)*1", "d");
+    Matcher m(start, "aa2cxa11");
+    if (!m.split() || m.first() != 0 || m.size() != 5)
+      error("minimize start state");
+  }
+  //
+  banner("TEST LAZY DFA");
+  //
+  {
+    std::string input;
+    unsigned int seed = 1;
+    for (int k = 0; k < 4096; ++k)
+    {
+      seed = seed * 1103515245 + 12345;
+      input.push_back((seed >> 16) & 1 ? 'a' : 'b');
+      if (k % 64 == 63)
+        input.push_back('\n');
+    }
+    Pattern pattern16("(a|b)*a(a|b){8}");
+    Pattern pattern17("(a|b)*a(a|b){8}", "l=32;");
+    Pattern pattern18(pattern17);
+    std::string test1, test2;
+    matcher.pattern(pattern16);
+    matcher.input(input);
+    while (matcher.find())
+      test1.append(matcher.text()).append("/");
+    matcher.pattern(pattern18);
+    matcher.input(input);
+    while (matcher.find())
+      test2.append(matcher.text()).append("/");
+    std::cout << pattern16.nodes() << " states " << pattern18.nodes() << " lazy states" << std::endl;
+    if (test1.empty() || test1 != test2 || pattern18.nodes() == 0 || pattern18.nodes() >= pattern16.nodes())
+      error("lazy DFA");
+    // adversarial pattern with a big DFA is constructed only as far as needed
+    Pattern pattern19("(a|b)*a(a|b){20}", "l");
+    matcher.pattern(pattern19);
+    matcher.input(input);
+    test2.clear();
+    while (matcher.find())
+      test2.append(matcher.text()).append("/");
+    std::cout << pattern19.nodes() << " lazy states" << std::endl;
+    if (test2.empty() || pattern19.nodes() > 4096 + 4096)
+      error("lazy DFA");
+  }
+  //
+  banner("TEST SAVE AND LOAD");
+  //
+  {
+    Pattern pattern12("\\w+|\\s+|[0-9]+\\.[0-9]+", "d");
+    FILE *file = tmpfile();
+    if (file == NULL || !pattern12.save(file))
+      error("save");
+    std::vector<char> data(static_cast<size_t>(ftell(file)) + 1);
+    rewind(file);
+    if (fread(&data[1], data.size() - 1, 1, file) != 1)
+      error("save");
+    fclose(file);
+    // unaligned data is copied, aligned data is used in place
+    Pattern pattern13;
+    if (!pattern13.load(&data[1], data.size() - 1, "\\w+|\\s+|[0-9]+\\.[0-9]+", "d"))
+      error("load");
+    std::vector<Pattern::Opcode> code((data.size() + sizeof(Pattern::Opcode) - 2) / sizeof(Pattern::Opcode));
+    memcpy(&code[0], &data[1], data.size() - 1);
+    Pattern pattern14;
+    if (!pattern14.load(&code[0], data.size() - 1))
+      error("load");
+    if (pattern13.words() != pattern12.words() || pattern14.nodes() != pattern12.nodes() || pattern14.size() != 3 || pattern14[3] != "[0-9]+\\.[0-9]+")
+      error("load");
+    Pattern pattern15(pattern14);
+    matcher.pattern(pattern15);
+    matcher.input("abc 3.14");
+    test = "";
+    while (matcher.scan())
+    {
+      std::cout << matcher.text() << "/" << matcher.accept() << "/";
+      test.append(matcher.text()).append("/");
+    }
+    std::cout << std::endl;
+    if (test != "abc/ /3.14/")
+      error("load scan");
+    // mismatching key, truncated and corrupted data fail to load
+    if (pattern14.load(&code[0], data.size() - 1, "\\w+|\\s+|[0-9]+\\.[0-9]+", "i"))
+      error("load key");
+    if (pattern14.load(&code[0], data.size() - 2))
+      error("load truncated");
+    reinterpret_cast<char*>(&code[0])[data.size() / 2] ^= 1;
+    if (pattern14.load(&code[0], data.size() - 1))
+      error("load corrupted");
+    // the wide bitap prefilter of a pattern is saved, and reset by loading a pattern without it
+    std::string saved[3];
+    Pattern pattern14a("[a-z]{12}[0-9]");
+    Pattern pattern14b;
+    for (int k = 0; k < 3; ++k)
+    {
+      file = tmpfile();
+      if (file == NULL || !(k == 0 ? pattern14a : pattern14b).save(file))
+        error("save");
+      saved[k].resize(static_cast<size_t>(ftell(file)));
+      rewind(file);
+      if (fread(&saved[k][0], saved[k].size(), 1, file) != 1)
+        error("save");
+      fclose(file);
+      if (k == 0 && !pattern14b.load(saved[0].data(), saved[0].size()))
+        error("load wide");
+      if (k == 1 && !pattern14b.load(&data[1], data.size() - 1))
+        error("load");
+    }
+    if (saved[1] != saved[0] || saved[2] != std::string(&data[1], data.size() - 1))
+      error("load wide");
+    Pattern pattern14c;
+    if (!pattern14c.load(saved[0].data(), saved[0].size()))
+      error("load wide");
+    matcher.pattern(pattern14c);
+    matcher.input("abc abcdefghijkl abcdefghijklm3");
+    if (!matcher.find() || matcher.first() != 18)
+      error("load wide find");
+    // the number of lookahead positions is counted when loading
+    Pattern pattern14d("a(?=b)|b(?=c)|\\w+(?=;)");
+    file = tmpfile();
+    if (file == NULL || !pattern14d.save(file))
+      error("save");
+    size_t lookahead_size = static_cast<size_t>(ftell(file));
+    std::vector<Pattern::Opcode> lookahead_code((lookahead_size + sizeof(Pattern::Opcode) - 1) / sizeof(Pattern::Opcode));
+    rewind(file);
+    if (fread(&lookahead_code[0], lookahead_size, 1, file) != 1)
+      error("save");
+    fclose(file);
+    if (!pattern14c.load(&lookahead_code[0], lookahead_size) || pattern14c.lookaheads() != pattern14d.lookaheads() || pattern14c.lookaheads() != 3)
+      error("load lookaheads");
+  }
+  //
+  banner("TEST PARALLEL DFA CONSTRUCTION");
+  //
+  {
+    static const char *regex[] = {
+      "(a|b)*a(a|b){7}",
+      "\\w+@\\w+\\.(com|org|net)|[0-9]+(\\.[0-9]+)?",
+      "(a|b)*?c|(?^ab)|[a-z]+",
+      "abc|abd|xyz|\\d+",
+      NULL
+    };
+    for (const char **r = regex; *r != NULL; ++r)
+    {
+      std::string code[2];
+      for (int k = 0; k < 2; ++k)
+      {
+        Pattern pattern16(*r, k == 0 ? "" : "j=4;");
+        std::cout << *r << " " << pattern16.nodes() << " states" << std::endl;
+        FILE *file = tmpfile();
+        if (file == NULL || !pattern16.save(file))
+          error("save");
+        code[k].resize(static_cast<size_t>(ftell(file)));
+        rewind(file);
+        if (fread(&code[k][0], code[k].size(), 1, file) != 1)
+          error("save");
+        fclose(file);
+      }
+      if (code[0] != code[1])
+        error("parallel DFA construction differs from serial construction");
+    }
+  }
+  //
+  banner("TEST MULTI-LITERAL PREFILTER");
+  //
+  {
+    std::string input;
+    for (int k = 0; k < 256; ++k)
+      input.append(k % 37 == 0 ? "ERROR " : k % 53 == 0 ? "panic: " : k % 61 == 0 ? "Traceback " : "ERR FAT pan Trace ");
+    input.append("FATAL");
+    static const char *regex[] = {
+      "ERROR|FATAL|panic:|Traceback",
+      "ERR[O]R|FA(TAL|X)|p[a]nic:|Trace\\w+",
+      "\\bERROR\\b|FATAL|pa(?=nic)|Tr",
+      NULL
+    };
+    for (const char **r = regex; *r != NULL; ++r)
+    {
+      Pattern pattern20(*r);
+      Pattern pattern21(*r, "l");
+      std::string test1, test2;
+      matcher.pattern(pattern20);
+      matcher.input(input);
+      while (matcher.find())
+        test1.append(matcher.text()).append("/");
+      matcher.pattern(pattern21);
+      matcher.input(input);
+      while (matcher.find())
+        test2.append(matcher.text()).append("/");
+      std::cout << *r << ": " << test1.size() << " bytes matched" << std::endl;
+      if (test1.empty() || test1 != test2)
+        error("multi-literal prefilter");
+    }
+  }
+  //
+  banner("TEST SET MATCHING");
+  //
+  {
+    static const struct { const char *regex; const char *options; const char *input; const char *expect; } sets[] = {
+      { "abc|x+|de|zz", "", "zzdezz", "3 4" },
+      { "[0-9]+|[a-z]+|foo|bar|(?i:BAZ)", "a", "foo 12 bAz", "1 2 3 5" },
+      { "^a|b$|c\\z|\\Ad", "", "dab\nc", "3 4" },
+      { "^a|b$|c\\z|\\Ad", "m", "xa\nab\nc\n", "1 2" },
+      { "a.*?b|x\\d|q", "", "a   b q", "1 3" },
+      { "baz|x", "i", "BAZ", "1" },
+      { "", "", "", "1" },
+      { NULL, NULL, NULL, NULL }
+    };
+    for (int i = 0; sets[i].regex != NULL; ++i)
+    {
+      Pattern pattern22(sets[i].regex, sets[i].options);
+      matcher.pattern(pattern22);
+      matcher.input(sets[i].input);
+      Bits matches = matcher.matching();
+      std::string test;
+      for (size_t j = matches.find_first(); j != Bits::npos; j = matches.find_next(j))
+        test.append(test.empty() ? "" : " ").append(1, static_cast<char>('0' + j));
+      std::cout << sets[i].regex << ": " << test << std::endl;
+      if (test != sets[i].expect || !matcher.at_end())
+        error("set matching");
+    }
+    // word boundaries, indent anchors and lookaheads are not supported by set matching
+    static const char *unsupported[] = { "\\bfoo\\b|x", "a\\Bb|x", "\\ia|x", "foo(?=a)|x", NULL };
+    for (int i = 0; unsupported[i] != NULL; ++i)
+    {
+      Pattern pattern22(unsupported[i]);
+      matcher.pattern(pattern22);
+      matcher.input("a foo x");
+      try
+      {
+        matcher.matching();
+        error("set matching unsupported");
+      }
+      catch (const regex_error& e)
+      {
+        if (e.code() != regex_error::invalid_anchor)
+          error("set matching unsupported");
+      }
+    }
+  }
+  //
+  banner("TEST PATTERN APPEND");
+  //
+  {
+    static const char *regex[] = { "foo", "fo+bar", "(?i:baz)", "b[a-z]*?z", "qux|quux", "\\d+", "ba(?=r)", "abc", NULL };
+    static const char *options[] = { "", "l", NULL };
+    std::string input = "foo foobar BAZ bazzz quux 123 bar abc";
+    for (const char **o = options; *o != NULL; ++o)
+    {
+      Pattern pattern23(regex[0], *o);
+      std::string all = regex[0];
+      for (const char **r = regex + 1; *r != NULL; ++r)
+      {
+        pattern23.append(*r);
+        all.append("|").append(*r);
+      }
+      Pattern pattern24(all, *o);
+      std::string test1, test2;
+      matcher.pattern(pattern23);
+      matcher.input(input);
+      while (matcher.find())
+        test1.append(1, static_cast<char>('0' + matcher.accept())).append(matcher.text()).append("/");
+      matcher.pattern(pattern24);
+      matcher.input(input);
+      while (matcher.find())
+        test2.append(1, static_cast<char>('0' + matcher.accept())).append(matcher.text()).append("/");
+      std::cout << all << " with options \"" << *o << "\": " << test1 << std::endl;
+      if (test1 != test2 || pattern23.size() != 9 || pattern23[9] != "abc")
+        error("pattern append");
+    }
+  }
+  //
+  banner("TEST CONSTRUCTION BUDGETS");
+  //
+  {
+    static const char *options[] = { "k=100;", "c=100;", "k=100;j=2;", NULL };
+    for (const char **o = options; *o != NULL; ++o)
+    {
+      try
+      {
+        Pattern pattern25("(a|b)*a(a|b){12}", *o);
+        error("construction budget");
+      }
+      catch (const regex_error& err)
+      {
+        std::cout << "Option " << *o << ": " << err.what();
+        if (err.code() != regex_error::exceeds_budget)
+          error("construction budget error code");
+      }
+    }
+    Pattern pattern26("(a|b)*a(a|b){12}", "k=100;g");
+    Pattern pattern27("(a|b)*a(a|b){12}", "l");
+    std::string input = "bbbababbabababbbbabbaaaababbbbbabababaabbbabbbbbbbbbbbbb";
+    std::string test1, test2;
+    matcher.pattern(pattern26);
+    matcher.input(input);
+    while (matcher.find())
+      test1.append(matcher.text()).append("/");
+    matcher.pattern(pattern27);
+    matcher.input(input);
+    while (matcher.find())
+      test2.append(matcher.text()).append("/");
+    std::cout << "Fallback: " << test1 << std::endl;
+    if (test1.empty() || test1 != test2)
+      error("construction budget fallback");
+  }
+  //
+  banner("TEST DENSE TABLE");
+  //
+  {
+    static const char *regexes[] = {
+      "if|else|while|[A-Za-z_][A-Za-z0-9_]*|[0-9]+|\\s+|.",
+      "^\\w+|\\w+$|\\<a\\w*\\>|\\s|.",
+      "ab(?=cd)|abc|a+b*|\\n|.",
+      "(a|b)*a(a|b){3}|b+",
+      NULL };
+    std::string input = "while x1 < 100 else abac abcd abb\nif aabab baa\nabba 42 _foo_\n";
+    for (const char **r = regexes; *r != NULL; ++r)
+    {
+      Pattern pattern28(*r);
+      Pattern pattern29(*r, "h");
+      Pattern pattern30(pattern29);
+      std::string test1, test2, test3;
+      matcher.pattern(pattern28);
+      matcher.input(input);
+      while (matcher.scan())
+        test1.append(matcher.text()).push_back(static_cast<char>('0' + matcher.accept()));
+      matcher.input(input);
+      while (matcher.find())
+        test1.append(matcher.text()).append("/");
+      matcher.pattern(pattern29);
+      matcher.input(input);
+      while (matcher.scan())
+        test2.append(matcher.text()).push_back(static_cast<char>('0' + matcher.accept()));
+      matcher.input(input);
+      while (matcher.find())
+        test2.append(matcher.text()).append("/");
+      matcher.pattern(pattern30);
+      matcher.input(input);
+      while (matcher.scan())
+        test3.append(matcher.text()).push_back(static_cast<char>('0' + matcher.accept()));
+      matcher.input(input);
+      while (matcher.find())
+        test3.append(matcher.text()).append("/");
+      std::cout << *r << ": " << test2.size() << " bytes matched" << std::endl;
+      if (test1 != test2 || test1 != test3)
+        error("dense table");
+    }
+  }
+  //
+  banner("TEST LOOP SKIPPING");
+  //
+  {
+    Pattern pattern31("\"[^\"\\\\\\n]*\"|[ \t]+|//.*|\\w+|\\n");
+    std::string input;
+    std::string expect;
+    for (size_t n = 1; n < 200; n += 13)
+    {
+      input.append("\"").append(n, 'x').append("\"").append(n % 37, ' ').append("\t//").append(n, 'c').append("\n");
+      expect.append(std::string(n + 2, '1')).append("/").append(n % 37 + 1, '2').append("/").append(n + 2, '3').append("/5/");
+    }
+    std::string test1, test2;
+    matcher.pattern(pattern31);
+    matcher.input(input);
+    while (matcher.scan())
+      test1.append(matcher.size(), static_cast<char>('0' + matcher.accept())).append("/");
+    matcher.input(input);
+    matcher.buffer(7); // read the input in blocks of 7 bytes to skip loops up to the end of the buffered input
+    while (matcher.scan())
+      test2.append(matcher.size(), static_cast<char>('0' + matcher.accept())).append("/");
+    std::cout << "Skipped: " << test1.size() << " bytes" << std::endl;
+    if (test1 != expect || test2 != expect)
+      error("loop skipping");
+    // states with lookahead heads or tails are not looped, the lookahead positions are updated for each byte
+    Pattern pattern31a("a+(?=(c.)?)");
+    Matcher matcher31a(pattern31a, "aaaa");
+    if (!matcher31a.scan() || matcher31a.first() != 0 || matcher31a.size() != 3)
+      error("loop skipping lookahead");
+    Pattern pattern31b("((a){1,3}|((.)+|([0-9])?\?)((c)?\?)+?)(?=(((c.)+)+?)?\?)|x");
+    Matcher matcher31b(pattern31b, "aaaa");
+    if (!matcher31b.scan() || matcher31b.first() != 0)
+      error("loop skipping lookahead");
+  }
+  //
+  banner("TEST REQUIRED LITERAL");
+  //
+  {
+    Pattern pattern32("\\w+@example\\.com");
+    Pattern pattern33("[0-9]{4}-ERROR-.*");
+    std::string input("mail joe@example.com or x@example.org, ann@example.com\n2024-ERROR-disk full\n24-ERROR-no\n1234567-ERROR-\n");
+    for (size_t n = 0; n < 500; ++n)
+      input.append("aaaa bbbb 9999 ");
+    input.append("zoe@example.com 0000-ERROR-end");
+    const char *expect1 = "joe@example.com/ann@example.com/zoe@example.com/";
+    const char *expect2 = "2024-ERROR-disk full/4567-ERROR-/0000-ERROR-end/";
+    for (int i = 0; i < 2; ++i)
+    {
+      std::string test1, test2;
+      matcher.pattern(pattern32);
+      matcher.input(input);
+      if (i > 0)
+        matcher.buffer(7); // read the input in blocks of 7 bytes to back up from the literal over buffer shifts
+      while (matcher.find())
+        test1.append(matcher.text()).append("/");
+      matcher.pattern(pattern33);
+      matcher.input(input);
+      if (i > 0)
+        matcher.buffer(7);
+      while (matcher.find())
+        test2.append(matcher.text()).append("/");
+      std::cout << "Found: " << test1 << test2 << std::endl;
+      if (test1 != expect1 || test2 != expect2)
+        error("required literal");
+    }
+  }
+  //
+  banner("TEST REVERSE DFA");
+  //
+  {
+    Pattern pattern34("\\w+ERROR|[0-9]+[-:]ERROR");
+    Pattern pattern35("(?m)^[^\\n]*need\\w*");
+    std::string input;
+    std::string expect1;
+    std::string expect2;
+    for (size_t n = 1; n < 300; n += 7)
+    {
+      std::string word(n % 50 + 1, static_cast<char>('a' + n % 26));
+      input.append(word).append(" ").append(n, 'x').append("ERROR ").append(word).append("1:ERROR ERROR");
+      expect1.append(std::string(n, 'x')).append("ERROR/1:ERROR/");
+    }
+    input.append("\nhay needles\nneed\n");
+    expect2 = "hay needles/need/";
+    std::string test1, test2;
+    matcher.pattern(pattern34);
+    matcher.input(input);
+    while (matcher.find())
+      test1.append(matcher.text()).append("/");
+    matcher.pattern(pattern35);
+    matcher.input(input);
+    matcher.buffer(7); // read the input in blocks of 7 bytes to run the reverse DFA over buffer shifts
+    while (matcher.find())
+      test2.append(matcher.text()).append("/");
+    std::cout << "Found: " << test1.size() << " and " << test2.size() << " bytes" << std::endl;
+    if (test1 != expect1 || test2 != expect2)
+      error("reverse DFA");
+  }
+  //
+  banner("TEST WIDE BITAP");
+  //
+  {
+    Pattern pattern36("[a-f0-9]{32}|[0-9]{4}-[0-9]{2}-[0-9]{2}");
+    std::string input;
+    std::string expect;
+    for (size_t n = 0; n < 100; ++n)
+    {
+      input.append("feed 0123456789abcdef0123456789abcde 2024-1-02 ");
+      if (n % 10 == 0)
+      {
+        input.append("d41d8cd98f00b204e9800998ecf8427e at 2024-01-02\n");
+        expect.append("d41d8cd98f00b204e9800998ecf8427e/2024-01-02/");
+      }
+    }
+    std::string test;
+    matcher.pattern(pattern36);
+    matcher.input(input);
+    while (matcher.find())
+      test.append(matcher.text()).append("/");
+    std::cout << "Found: " << test.size() << " bytes" << std::endl;
+    if (test != expect)
+      error("wide bitap");
+  }
+  //
+  banner("TEST ALLOCATION-FREE MATCHING");
+  //
+  {
+    Pattern pattern41("a(?=b)|b(?=c)|c(?=d)|\\w+(?=;)|\\d+");
+    std::string input;
+    for (size_t n = 0; n < 100; ++n)
+      input.append("abcd xyz; 12 ");
+    CountingAllocator allocator;
+    LookaheadMatcher lookahead_matcher(pattern41, input);
+    lookahead_matcher.set_allocator(&allocator);
+    lookahead_matcher.buffer();
+    size_t count = 0;
+    size_t capacity = lookahead_matcher.capacity();
+    size_t allocated = allocator.allocated;
+    while (lookahead_matcher.find())
+      ++count;
+    std::cout << "Found: " << count << " matches with " << pattern41.lookaheads() << " lookaheads and " << allocator.allocated - allocated << " buffer allocations" << std::endl;
+    if (count != 500 || pattern41.lookaheads() != 4 || capacity < 4 || lookahead_matcher.capacity() != capacity || allocator.allocated != allocated)
+      error("allocation-free matching");
+  }
+  //
+  banner("TEST READ-ONLY BUFFER");
+  //
+  {
+    char data[] = "foo 12 bar 345";
+    std::string test;
+    Matcher readonly_matcher("[a-z]+|[0-9]+", Input(), "R");
+    readonly_matcher.buffer(data, sizeof(data));
+    while (readonly_matcher.find())
+    {
+      test.append(readonly_matcher.text()).append("/");
+      if (std::memcmp(data, "foo 12 bar 345", sizeof(data)) != 0)
+        error("read-only buffer");
+#if defined(WITH_STRING_VIEW)
+      if (readonly_matcher.view() != readonly_matcher.str())
+        error("read-only buffer view");
+#endif
+    }
+    std::cout << "Found: " << test << std::endl;
+    if (test != "foo/12/bar/345/")
+      error("read-only buffer");
+  }
+  //
+  banner("TEST MEMORY-MAPPED FILE");
+  //
+  {
+    // a file size that is a multiple of the page size and one that is not
+    static const size_t sizes[] = { 131072, 100003, 0 };
+    for (const size_t *n = sizes; *n != 0; ++n)
+    {
+      std::string data;
+      while (data.size() < *n)
+        data.append("foo 12 bar 345\n");
+      data.resize(*n);
+      FILE *file = tmpfile();
+      if (file == NULL || fwrite(data.data(), 1, data.size(), file) != data.size())
+        error("memory-mapped file");
+      size_t count[3] = { 0, 0, 0 };
+      matcher.pattern("[a-z]+|[0-9]+");
+      matcher.input(data);
+      while (matcher.find())
+        ++count[0];
+      for (int k = 1; k <= 2; ++k)
+      {
+        rewind(file);
+        Input input(file);
+        size_t size = 0;
+        const char *base = input.mapped(size);
+        if (base != NULL && (size != data.size() || std::memcmp(base, data.data(), size) != 0))
+          error("memory-mapped file");
+        // option R scans the memory-mapped file in place
+        Matcher mapped_matcher("[a-z]+|[0-9]+", input, k == 1 ? "" : "R");
+        std::string test;
+        while (mapped_matcher.find())
+        {
+          if (count[k]++ < 4)
+            test.append(mapped_matcher.text()).append("/");
+        }
+        if (test != "foo/12/bar/345/")
+          error("memory-mapped file");
+      }
+      fclose(file);
+      std::cout << *n << " bytes: " << count[0] << " " << count[1] << " " << count[2] << " matches" << std::endl;
+      if (count[1] != count[0] || count[2] != count[0])
+        error("memory-mapped file");
+    }
+  }
+  //
+  banner("TEST READ-AHEAD INPUT");
+  //
+  {
+    // a small file is not memory mapped but read ahead by a helper thread
+    std::string data;
+    while (data.size() < 60000)
+      data.append("foo 12 bar 345\n");
+    FILE *file = tmpfile();
+    if (file == NULL || fwrite(data.data(), 1, data.size(), file) != data.size())
+      error("read-ahead input");
+    size_t count[3] = { 0, 0, 0 };
+    matcher.pattern("[a-z]+|[0-9]+");
+    matcher.input(data);
+    while (matcher.find())
+      ++count[0];
+    for (int k = 1; k <= 2; ++k)
+    {
+      rewind(file);
+      Input input(file);
+      Matcher read_ahead_matcher("[a-z]+|[0-9]+", input.read_ahead());
+      if (k == 2)
+        read_ahead_matcher.buffer(7);
+      while (read_ahead_matcher.find())
+        ++count[k];
+      if (!read_ahead_matcher.at_end())
+        error("read-ahead input");
+    }
+    fclose(file);
+    std::cout << data.size() << " bytes: " << count[0] << " " << count[1] << " " << count[2] << " matches" << std::endl;
+    if (count[1] != count[0] || count[2] != count[0])
+      error("read-ahead input");
+  }
+  //
+  banner("TEST UTF-16 AND UTF-32 FILE INPUT");
+  //
+  {
+    // ASCII runs, two and three byte UTF-8, surrogate pairs, and a lone low surrogate converted to REFLEX_NONCHAR
+    // from UTF-16 and kept as is from UTF-32
+    std::wstring wdata;
+    std::string data[2];
+    for (int k = 0; data[0].size() < 100000; ++k)
+    {
+      wdata.append(k % 97, L'a').append(L" \u00e9t\u00e9 \u4e2d\u6587 ");
+      wdata.push_back(0x1F600 + k % 64);
+      for (int i = 0; i < 2; ++i)
+      {
+        data[i].append(k % 97, 'a').append(" \xc3\xa9t\xc3\xa9 \xe4\xb8\xad\xe6\x96\x87 ");
+        data[i].append("\xf0\x9f\x98").push_back(static_cast<char>(0x80 + k % 64));
+      }
+      if (k % 1000 == 999)
+      {
+        wdata.push_back(0xDC00);
+        data[0].append(REFLEX_NONCHAR_UTF8);
+        data[1].append("\xed\xb0\x80");
+      }
+    }
+    static const char *encodings[] = { "UTF-16BE", "UTF-16LE", "UTF-32BE", "UTF-32LE" };
+    for (int e = 0; e < 4; ++e)
+    {
+      FILE *file = tmpfile();
+      if (file == NULL)
+        error("utf-16/32 file input");
+      std::string raw;
+      for (size_t i = 0; i <= wdata.size(); ++i)
+      {
+        // a BOM followed by the data
+        int c = i == 0 ? 0xFEFF : static_cast<int>(wdata[i - 1]);
+        int units[2] = { c, -1 };
+        if (e < 2 && c >= 0x10000)
+        {
+          units[0] = 0xD800 + ((c - 0x10000) >> 10);
+          units[1] = 0xDC00 + ((c - 0x10000) & 0x3FF);
+        }
+        for (int u = 0; u < 2 && units[u] >= 0; ++u)
+        {
+          int w = e < 2 ? 2 : 4;
+          for (int j = 0; j < w; ++j)
+            raw.push_back(static_cast<char>(units[u] >> 8 * (e % 2 == 0 ? w - 1 - j : j)));
+        }
+      }
+      if (fwrite(raw.data(), 1, raw.size(), file) != raw.size())
+        error("utf-16/32 file input");
+      static const size_t sizes[] = { 8192, 100, 7 };
+      for (int k = 0; k < 3; ++k)
+      {
+        rewind(file);
+        Input input(file);
+        std::string test;
+        char buf[8192];
+        size_t n;
+        while ((n = input.get(buf, sizes[k])) > 0)
+          test.append(buf, n);
+        if (test != data[e / 2])
+          error("utf-16/32 file input");
+      }
+      fclose(file);
+      std::cout << encodings[e] << ": " << raw.size() << " bytes converted to " << data[e / 2].size() << " bytes of UTF-8" << std::endl;
+    }
+  }
+  //
+  banner("TEST CODE PAGE FILE INPUT");
+  //
+  {
+    // ASCII runs and all 8-bit bytes, compared to the UTF-8 of a custom code page that rotates ASCII letters
+    std::string raw;
+    for (int k = 0; raw.size() < 100000; ++k)
+      for (int c = 0; c < 256; ++c)
+        raw.append(k % 71, 'a' + k % 26).push_back(static_cast<char>(c == 0 ? ' ' : c));
+    unsigned short page[256];
+    for (int c = 0; c < 256; ++c)
+      page[c] = static_cast<unsigned short>(c >= 'a' && c <= 'z' ? 'a' + (c - 'a' + 13) % 26 : c < 0x80 ? c : 0x2400 + c);
+    FILE *file = tmpfile();
+    if (file == NULL || fwrite(raw.data(), 1, raw.size(), file) != raw.size())
+      error("code page file input");
+    static const Input::file_encoding_type encodings[] = { Input::file_encoding::latin, Input::file_encoding::custom, Input::file_encoding::cp1252, Input::file_encoding::ebcdic };
+    for (int e = 0; e < 4; ++e)
+    {
+      std::string data;
+      for (size_t i = 0; i < raw.size(); ++i)
+      {
+        char buf[8];
+        int c = static_cast<unsigned char>(raw[i]);
+        data.append(buf, reflex::utf8(e == 0 ? c : page[c], buf));
+      }
+      static const size_t sizes[] = { 7, 8192, 100 };
+      std::string test[3];
+      for (int k = 0; k < 3; ++k)
+      {
+        rewind(file);
+        Input input(file, encodings[e], page);
+        char buf[8192];
+        size_t n;
+        while ((n = input.get(buf, sizes[k])) > 0)
+          test[k].append(buf, n);
+        if (test[k] != (e < 2 ? data : test[0]))
+          error("code page file input");
+      }
+      std::cout << "Encoding " << encodings[e] << ": " << raw.size() << " bytes converted to " << test[0].size() << " bytes of UTF-8" << std::endl;
+    }
+    fclose(file);
+  }
+  //
+  banner("TEST STREAM INPUT");
+  //
+  {
+    // CRLF pairs at varying positions to straddle blocks, lone CR and a CR at the end
+    std::string data;
+    std::string dos;
+    for (int k = 0; data.size() < 100000; ++k)
+      data.append(k % 37, 'a').append(k % 5 == 0 ? "\r\n" : k % 5 == 1 ? "\r" : "\n");
+    data.push_back('\r');
+    for (size_t i = 0; i < data.size(); ++i)
+      if (data[i] != '\r' || i + 1 >= data.size() || data[i + 1] != '\n')
+        dos.push_back(data[i]);
+    std::istringstream stream(data);
+    Matcher stream_matcher("a+|\\r|\\n", stream);
+    std::string test;
+    while (stream_matcher.scan())
+      test.append(stream_matcher.begin(), stream_matcher.size());
+    if (test != data || !stream.eof())
+      error("stream input");
+    static const size_t sizes[] = { 1, 2, 3, 7, 4096, 100000 };
+    for (int k = 0; k < 6; ++k)
+    {
+      for (int b = 0; b < 2; ++b)
+      {
+        Input input(data);
+        Input::dos_streambuf dos_buf(input);
+        BufferedInput::dos_streambuf buffered_dos_buf(input);
+        std::istream dos_stream(b == 0 ? static_cast<std::streambuf*>(&dos_buf) : static_cast<std::streambuf*>(&buffered_dos_buf));
+        std::string test;
+        char buf[100000];
+        while (dos_stream.read(buf, sizes[k]) || dos_stream.gcount() > 0)
+          test.append(buf, static_cast<size_t>(dos_stream.gcount()));
+        if (test != dos)
+          error("dos stream input");
+      }
+    }
+    std::cout << data.size() << " bytes read from std::istream, " << dos.size() << " bytes after CRLF to LF" << std::endl;
+  }
+  //
+  banner("TEST BUFFER ALLOCATOR");
+  //
+  {
+    // a long line grows the buffer, which reallocates with allocate(), memcpy() and deallocate() by default
+    std::string data;
+    for (int k = 0; k < 4; ++k)
+      data.append("abc ").append(300000 * k, 'x').append(" 123\n");
+    CountingAllocator allocator;
+    {
+      LimitedMatcher allocator_matcher("\\w+|\\W", data);
+      allocator_matcher.set_allocator(&allocator);
+      std::string test;
+      while (allocator_matcher.scan())
+        test.append(allocator_matcher.begin(), allocator_matcher.size());
+      if (test != data || allocator.bytes != allocator_matcher.capacity())
+        error("buffer allocator");
+      allocator_matcher.set_allocator(NULL);
+      if (allocator.bytes != 0)
+        error("buffer allocator");
+    }
+    std::cout << "Allocated " << allocator.allocated << " and deallocated " << allocator.deallocated << " buffers" << std::endl;
+    if (allocator.allocated < 2 || allocator.allocated != allocator.deallocated)
+      error("buffer allocator");
+#if __cplusplus >= 201103L
+    // the default allocator reuses a freed buffer of the same size
+    AbstractMatcher::DefaultAllocator& default_allocator = AbstractMatcher::DefaultAllocator::instance();
+    char *buf = default_allocator.allocate(2 * AbstractMatcher::Const::BLOCK);
+    default_allocator.deallocate(buf, 2 * AbstractMatcher::Const::BLOCK);
+    if (default_allocator.allocate(2 * AbstractMatcher::Const::BLOCK) != buf)
+      error("buffer allocator pool");
+    default_allocator.deallocate(buf, 2 * AbstractMatcher::Const::BLOCK);
+#endif
+  }
+  //
+  banner("TEST RING BUFFER");
+  //
+  {
+    // long lines are kept in the buffer for line(), so the buffer shifts by rotating the ring with large gaps
+    std::string data;
+    for (int k = 0; data.size() < 4000000; ++k)
+      data.append(1000 * (k % 300), 'x').append(" ").append(k % 7 + 1, '0' + k % 10).append(" y\n");
+    std::ostringstream test[2];
+    AbstractMatcher::RingAllocator allocator;
+    for (int k = 0; k < 2; ++k)
+    {
+      Matcher ring_matcher("\\d+", data);
+      if (k == 1)
+        ring_matcher.set_allocator(&allocator);
+      while (ring_matcher.find())
+      {
+        std::string line = ring_matcher.line();
+        test[k] << ring_matcher.text() << " " << ring_matcher.lineno() << " " << ring_matcher.columno() << " " << line.size() << line.substr(line.size() > 10 ? line.size() - 10 : 0) << "\n";
+      }
+    }
+    std::cout << data.size() << " bytes searched with a ring buffer" << std::endl;
+    if (test[1].str() != test[0].str() || test[0].str().empty())
+      error("ring buffer");
+  }
+  //
+  banner("TEST PROFILE-GUIDED FSM CODE");
+  //
+  {
+    // a profile of the start state 0 with hot edges on 'a' and 'b' to test the 'c', 'b', 'a' edges in reverse order
+    static const char *patterns[] = { "ax|by|cz", "[a-z]x|by" };
+    static const char *before[] = { "if (c1 == 'a')", "if (c1 == 'b')" };
+    static const char *after[] = { "if (c1 == 'c')", "if ('a' <= c1 && c1 <= 'z')" };
+    for (int k = 0; k < 2; ++k)
+    {
+      Pattern profiled_pattern(patterns[k], "o;n=PROF");
+      FILE *file = fopen("dump.prof", "w");
+      if (file == NULL)
+        error("cannot write dump.prof");
+      fprintf(file, "FSM PROF %zu\nS 0 100\nE 0 97 90\nE 0 98 10\n", profiled_pattern.nodes());
+      fclose(file);
+      Pattern(patterns[k], "o;n=PROF;f=dump.cpp;u=dump.prof");
+      std::string code = read_file("dump.cpp");
+      // the overlapping [a-z] edge of the second pattern must be tested after the 'b' edge
+      size_t pos = code.find(before[k]);
+      if (pos == std::string::npos || code.find(after[k]) == std::string::npos || code.find(after[k]) < pos)
+        error("profile-guided FSM code");
+    }
+    remove("dump.prof");
+  }
+  //
+  banner("TEST FSM CODE DISPATCH");
+  //
+  {
+    // a few edges are tested in order, more edges with a binary search, many edges with a jump table
+    static const char *patterns[] = { "ax|by|cz", "ax|by|cz|dw|ev|fu|gt|hs", "ax|by|cz|dw|ev|fu|gt|hs|ir|jq|kp|lo|mn|nm|ol|pk" };
+    static const char *dispatch[] = { "if (c1 == 'a') goto", "if (c1 < 'e')", "goto *jump[c1];" };
+    for (int k = 0; k < 3; ++k)
+    {
+      Pattern(patterns[k], "o;f=dump.cpp");
+      if (read_file("dump.cpp").find(dispatch[k]) == std::string::npos)
+        error("FSM code dispatch");
+    }
+  }
+  //
+  banner("TEST LINE BUFFERED INPUT");
+  //
+  {
+    std::string data;
+    for (int k = 0; k < 2000; ++k)
+      data.append(k % 97, 'a' + k % 26).append(" ").append(k % 5 + 1, '0' + k % 10).append("\n");
+    data.append("no newline 123");
+    static const size_t blocks[] = { 7, 100, 0 };
+    for (int k = 0; k < 3; ++k)
+    {
+      LimitedMatcher line_matcher("\\d+|\\n", data);
+      line_matcher.buffer(blocks[k]);
+      line_matcher.line_buffered();
+      std::string test;
+      while (line_matcher.find())
+      {
+        if (!line_matcher.whole_lines(data.size()))
+          error("line buffered input");
+        test.append(line_matcher.text());
+      }
+      Matcher block_matcher("\\d+|\\n", data);
+      block_matcher.buffer(blocks[k]);
+      std::string expected;
+      while (block_matcher.find())
+        expected.append(block_matcher.text());
+      if (test != expected || expected.size() < 4000)
+        error("line buffered input");
+    }
+    std::cout << data.size() << " bytes read in batches of lines" << std::endl;
+  }
+  //
+  banner("TEST BUFFER LIMIT");
+  //
+  {
+    std::string data;
+    for (int k = 0; k < 8; ++k)
+      data.append("abc ").append(20000, 'x').append(" 123\n");
+    static const int policies[] = { Matcher::Const::TRUNCATE, Matcher::Const::DISCARD, Matcher::Const::SIGNAL };
+    for (int k = 0; k < 3; ++k)
+    {
+      LimitedMatcher limited_matcher("\\w+|\\W", data);
+      LimitHandler handler;
+      limited_matcher.set_handler(&handler);
+      limited_matcher.set_limit(8192, policies[k]);
+      std::string test;
+      size_t truncated = 0;
+      size_t capacity = 0;
+      while (limited_matcher.scan())
+      {
+        test.append(limited_matcher.begin(), limited_matcher.size());
+        if (limited_matcher.overflow())
+          ++truncated;
+        if (capacity < limited_matcher.capacity())
+          capacity = limited_matcher.capacity();
+      }
+      std::cout << "Policy " << policies[k] << ": " << truncated << " truncated matches, " << handler.events << " signalled, buffer size " << capacity << std::endl;
+      if (test != data || truncated == 0 || capacity > 8192 || (handler.events > 0) != (k == 2))
+        error("buffer limit");
+    }
+  }
+  //
+  banner("TEST FIND ALL");
+  //
+  {
+    Pattern pattern39("[a-z]+|[0-9]+|\\bx\\b");
+    std::string input;
+    for (size_t n = 0; n < 200; ++n)
+      input.append("foo 12 bar, x=y;\n");
+    std::vector<MatchSpan> spans;
+    matcher.pattern(pattern39);
+    matcher.input(input);
+    matcher.buffer(7);
+    size_t count = matcher.find_all(spans);
+    matcher.input(input);
+    size_t j = 0;
+    while (matcher.find())
+    {
+      if (j >= spans.size() || spans[j].first != matcher.first() || spans[j].size != matcher.size() || spans[j].accept != matcher.accept())
+        error("find all");
+      ++j;
+    }
+    std::cout << "Found: " << count << " matches" << std::endl;
+    if (count != j || count != spans.size())
+      error("find all count");
+  }
+  //
+  banner("TEST PARALLEL FIND ALL");
+  //
+  {
+    Pattern pattern40("(?m)^[0-9]+|ERROR\\w*|x\\b");
+    std::string input;
+    for (size_t n = 0; n < 20000; ++n)
+    {
+      char line[64];
+      snprintf(line, sizeof(line), "%zu %s x\n", n, n % 3 == 0 ? "ERRORS in" : "ok ERROR");
+      input.append(line);
+    }
+    std::vector<MatchSpan> spans1;
+    std::vector<MatchSpan> spans2;
+    std::vector<size_t> lines1;
+    std::vector<size_t> lines2;
+    matcher.pattern(pattern40);
+    matcher.input(input);
+    size_t count1 = matcher.find_all(spans1, 1, &lines1);
+    matcher.input(input);
+    matcher.find();
+    spans2.push_back(MatchSpan(matcher.first(), matcher.size(), matcher.accept()));
+    lines2.push_back(matcher.lineno());
+    size_t count2 = matcher.find_all(spans2, 4, &lines2) + 1;
+    std::cout << "Found: " << count1 << " and " << count2 << " matches" << std::endl;
+    if (count1 != count2 || spans1.size() != spans2.size() || lines1 != lines2 || lines1.back() != 20000)
+      error("parallel find all");
+    for (size_t j = 0; j < spans1.size(); ++j)
+      if (spans1[j].first != spans2[j].first || spans1[j].size != spans2[j].size || spans1[j].accept != spans2[j].accept)
+        error("parallel find all");
+  }
+  //
+  banner("TEST MULTI-STREAM SCANNING");
+  //
+  {
+    Pattern pattern37("[a-z]+|[0-9]+|\\s+|[,;]", "h");
+    Pattern pattern38("(?m)^[a-z]+|[a-z]+|[0-9]+|\\s+|[,;]", "h");
+    Pattern pattern38a("[a-z]+|[0-9]+|\\s+|[,;]"); // without option h the buffers are tokenized with a matcher
+    const char *words[] = { "abc", "12", " ", ",", "x", "\n", "zz9", ";", "" };
+    std::vector<std::string> inputs;
+    for (size_t i = 0; i < 20; ++i)
+    {
+      std::string input;
+      for (size_t j = 0; j < 3 * i; ++j)
+        input.append(words[(i + j * j) % 9]);
+      if (i % 7 == 6)
+        input.append("!stop here");
+      inputs.push_back(input);
+    }
+    std::vector<const char*> data;
+    std::vector<size_t> size;
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+      data.push_back(inputs[i].data());
+      size.push_back(inputs[i].size());
+    }
+    for (int p = 0; p < 3; ++p)
+    {
+      const Pattern& pattern = p == 0 ? pattern37 : p == 1 ? pattern38 : pattern38a;
+      std::vector<MatchSpan> spans[20];
+      size_t count = Matcher::scan_streams(pattern, inputs.size(), &data[0], &size[0], spans);
+      size_t total = 0;
+      for (size_t i = 0; i < inputs.size(); ++i)
+      {
+        Matcher scanner(pattern, inputs[i]);
+        size_t j = 0;
+        while (scanner.scan() != 0)
+        {
+          if (j >= spans[i].size() || spans[i][j].first != scanner.first() || spans[i][j].size != scanner.size() || spans[i][j].accept != scanner.accept())
+            error("multi-stream scanning");
+          ++j;
+        }
+        if (j != spans[i].size())
+          error("multi-stream scanning");
+        total += j;
+      }
+      std::cout << "Scanned: " << count << " tokens" << std::endl;
+      if (count != total)
+        error("multi-stream scanning count");
+    }
+  }
+  //
+  banner("TEST LEXER CHECKPOINTS");
+  //
+  {
+    typedef AbstractLexer<Matcher> Lexer;
+    Pattern pattern39("(?m)(^[a-z]+)|([a-z]+)|(\\()|(\\))|(\\s+)");
+    std::string text = "ab cd (ef\ngh) ij\nkl (mn (op)\nqr) st\nuv\n";
+    std::string edit = text;
+    size_t at = text.find("gh");
+    edit.replace(at, 2, "x\ny z");
+    long delta = static_cast<long>(edit.size() - text.size());
+    std::vector<std::string> tokens[2];
+    std::vector<Lexer::Checkpoint> checkpoints;
+    for (int i = 0; i < 2; ++i)
+    {
+      Lexer lexer(i == 0 ? text : edit, std::cout);
+      lexer.matcher(new Lexer::Matcher(pattern39, lexer.in(), &lexer));
+      std::string token;
+      while (!(token = lex_token(lexer)).empty())
+      {
+        tokens[i].push_back(token);
+        if (i == 0)
+          checkpoints.push_back(lexer.checkpoint());
+      }
+    }
+    // resume from the last checkpoint before the edit and relex until the checkpoints resynchronize
+    size_t k = 0;
+    while (k + 1 < checkpoints.size() && checkpoints[k + 1].offset < at)
+      ++k;
+    Lexer lexer(Input(), std::cout);
+    lexer.matcher(new Lexer::Matcher(pattern39, Input(), &lexer));
+    if (!lexer.restore(checkpoints[k], Input(edit.c_str() + checkpoints[k].bol, edit.size() - checkpoints[k].bol)))
+      error("lexer restore");
+    size_t count = 0;
+    size_t sync = 0;
+    std::string token;
+    while (sync == 0 && !(token = lex_token(lexer)).empty())
+    {
+      ++count;
+      if (k + count >= tokens[1].size() || token != tokens[1][k + count])
+        error("lexer checkpoint relex");
+      Lexer::Checkpoint checkpoint = lexer.checkpoint();
+      if (checkpoint.offset >= at + 5)
+        for (size_t j = k + 1; j < checkpoints.size(); ++j)
+          if (static_cast<long>(checkpoints[j].offset) + delta == static_cast<long>(checkpoint.offset) && static_cast<long>(checkpoints[j].bol) + delta == static_cast<long>(checkpoint.bol) && checkpoints[j].same_state(checkpoint))
+            sync = j;
+    }
+    std::cout << "Relexed " << count << " of " << tokens[1].size() << " tokens" << std::endl;
+    if (sync == 0 || k + count + checkpoints.size() - sync != tokens[1].size() || count + 4 > tokens[1].size())
+      error("lexer checkpoint resync");
+  }
+#if defined(WITH_MATCHER_POOL)
+  //
+  banner("TEST MATCHER POOL");
+  //
+  {
+    Pattern pattern42("\\w+");
+    MatcherPool<Matcher> pool(pattern42, 2);
+    Matcher *m1 = pool.acquire("a bc");
+    Matcher *m2 = pool.acquire("def");
+    Matcher *m3 = pool.acquire("g h i");
+    if (m1 == m2 || m2 == m3 || m1 == m3 || m1->matches() || m2->matches() != 1)
+      error("matcher pool");
+    pool.release(m2);
+    pool.release(m1);
+    pool.release(m3);
+    Matcher *m4 = pool.acquire("x yz");
+    if (m4 != m1 && m4 != m2)
+      error("matcher pool reuse");
+    std::string text;
+    while (m4->find())
+      text.append(m4->text()).push_back('/');
+    std::cout << text << std::endl;
+    if (text != "x/yz/" || m4->lineno() != 1)
+      error("matcher pool reuse");
+    pool.release(m4);
+    std::vector<size_t> counts(4);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < counts.size(); ++i)
+      threads.push_back(std::thread([&pool, &counts, i]() {
+        for (size_t n = 0; n < 1000; ++n)
+        {
+          Matcher *matcher = pool.acquire("one two three");
+          while (matcher->find())
+            ++counts[i];
+          pool.release(matcher);
+        }
+      }));
+    for (size_t i = 0; i < threads.size(); ++i)
+      threads[i].join();
+    for (size_t i = 0; i < counts.size(); ++i)
+      if (counts[i] != 3000)
+        error("matcher pool threads");
+  }
+#endif
+  //
+  banner("TEST COLUMNS OF LONG LINES");
+  //
+  {
+    // tokens on long lines with tabs and UTF-8, the columns are checked against columns counted from the begin of the line
+    std::string text;
+    for (size_t i = 0; i < 30000; ++i)
+      text.append(i % 7 == 0 ? "\t" : "").append(i % 5 == 0 ? "caf\xc3\xa9 " : "token ").append(i % 10000 == 9999 ? "\n" : "");
+    Matcher matcher("\\S+", text);
+    size_t pos = 0;
+    size_t k = 0;
+    size_t count = 0;
+    while (matcher.find())
+    {
+      for (size_t first = matcher.first(); pos < first; ++pos)
+        k = text[pos] == '\n' ? 0 : text[pos] == '\t' ? k + 1 + (~k & 7) : k + ((text[pos] & 0xC0) != 0x80);
+      size_t n = text.compare(pos, 3, "caf") == 0 ? 4 : 5;
+      if (matcher.columno() != k || matcher.columns() != n || matcher.wsize() != n)
+        error("columns of long lines");
+#if defined(WITH_SPAN)
+      if (matcher.columno_end() != k + n - 1)
+        error("columno_end of long lines");
+#endif
+      ++count;
+    }
+    if (count != 30000)
+      error("columns of long lines count");
+  }
+  //
+  banner("TEST BINARY INPUT AND MATCH COUNTS");
+  //
+  {
+    if (is_binary("plain ASCII text, long enough to take the 16 byte loop\n", 55) || is_binary("caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80", 14))
+      error("is_binary text");
+    if (!is_binary("abc\0def", 7) || !is_binary("caf\xe9 latin-1", 12) || !is_binary("\xc0\x80", 2) || !is_binary("\xed\xa0\x80", 3) || !is_binary("\xf4\x90\x80\x80", 4) || !is_binary("0123456789abcdef\x80", 17))
+      error("is_binary binary");
+    if (is_binary("truncated \xe2\x82", 12) || !is_binary("truncated \xe2\x41", 12))
+      error("is_binary truncated UTF-8");
+    std::string text("one two\nthree one one\nfour\none");
+    Matcher matcher("one", text);
+    if (matcher.binary() || matcher.count(1) != 1 || matcher.count() != 3)
+      error("matcher count");
+    matcher.input(text);
+    if (matcher.count(0, true) != 3)
+      error("matcher count lines");
+    matcher.input(text);
+    if (matcher.count(2, true) != 2 || !matcher.find() || matcher.lineno() != 4)
+      error("matcher count lines and find");
+    std::string data("one\0two", 7);
+    matcher.input(data);
+    if (!matcher.binary() || matcher.count() != 1)
+      error("matcher binary");
+  }
+  //
+  banner("TEST PATTERN DIAGNOSTICS");
+  //
+  {
+    Pattern::Diagnostics diag;
+    Pattern pattern("(hello)|(world)|(\\w+\\d\\d)", "y");
+    pattern.diagnostics(diag);
+    std::cout << "Search " << diag.strategy << " with bitap rate " << diag.bitap_rate << " and predict-match rate " << diag.pma_rate << std::endl;
+    if (diag.states.size() != 3 || diag.states[0] == 0 || diag.states[2] <= diag.states[0] || diag.largest.empty())
+      error("pattern diagnostics states");
+    for (size_t i = 1; i < diag.largest.size(); ++i)
+      if (diag.largest[i].positions > diag.largest[i - 1].positions)
+        error("pattern diagnostics largest states");
+    if (diag.bitap_rate <= 0 || diag.bitap_rate >= 1 || diag.pma_rate <= 0 || diag.pma_rate >= 1 || diag.pmh_rate != 1 || diag.prefix_rate != 1)
+      error("pattern diagnostics rates");
+    Pattern("hello\\w+", "y").diagnostics(diag);
+    if (std::string(diag.strategy) != "prefix" || diag.prefix_rate <= 0 || diag.prefix_rate >= 1.0 / 256 / 256 / 256 / 256)
+      error("pattern diagnostics prefix");
+    Pattern("[a-z]{6}\\d", "y").diagnostics(diag);
+    if (std::string(diag.strategy) != "bitap" || diag.bitap_rate >= 1e-6 || diag.pmh_rate <= 0 || diag.pmh_rate >= 1)
+      error("pattern diagnostics bitap");
+    std::string sample(1000, 'a');
+    Pattern("[a-z]{6}\\d", "y").diagnostics(diag, sample.c_str(), sample.size());
+    if (diag.bitap_rate != 0)
+      error("pattern diagnostics sample");
+    Pattern("(hello)|(world)").diagnostics(diag);
+    if (!diag.states.empty() || !diag.largest.empty())
+      error("pattern diagnostics without option y");
+  }
+  //
+  banner("TEST NATIVE CODE");
+  //
+  {
+    const char *regexs[] = { "[a-z_]+|[0-9]+(\\.[0-9]+)?|\\s+|.", "abc|ab|(foo)*x", "[\\x80-\\xff]+|\\w{2,3}", "(?i:Hello)\\s*\\d*" };
+    std::string text;
+    for (size_t i = 0; i < 5000; ++i)
+      text.append(i % 11 == 0 ? "fooFoox 3.14\n" : i % 5 == 0 ? "caf\xc3\xa9 abc ab " : "HeLLo  42 fooxx_y ");
+    size_t jitted = 0;
+    for (size_t r = 0; r < sizeof(regexs) / sizeof(regexs[0]); ++r)
+    {
+      Pattern pattern(regexs[r]);
+      Pattern native(pattern);
+      if (native.jit())
+        ++jitted;
+      for (int method = 0; method < 3; ++method)
+      {
+        std::istringstream stream(text);
+        Matcher matcher(pattern, text);
+        Matcher compiled(native, stream);
+        while (true)
+        {
+          size_t accept = method == 0 ? matcher.scan() : method == 1 ? matcher.find() : matcher.split();
+          size_t taken = method == 0 ? compiled.scan() : method == 1 ? compiled.find() : compiled.split();
+          if (accept != taken || matcher.first() != compiled.first() || matcher.size() != compiled.size())
+            error("native code matches");
+          if (accept == 0)
+            break;
+        }
+      }
+    }
+    std::cout << "Compiled " << jitted << " patterns to native code" << std::endl;
+    Pattern anchored("^\\w+\\>");
+    Pattern lazy("abc", "l");
+    if (anchored.jit() || lazy.jit())
+      error("native code of anchors and lazy DFA");
+  }
+#if __cplusplus >= 202002L
+  //
+  banner("TEST STATIC PATTERN");
+  //
+  {
+    typedef static_pattern<"[a-z_]+|[0-9]+(\\.[0-9]+)?|\\s+|."> Static;
+    std::string text = "pi = 3.14; e=2.718 foo_bar\n\xc3\xa9 42";
+    Pattern pattern("[a-z_]+|[0-9]+(\\.[0-9]+)?|\\s+|.");
+    for (int method = 0; method < 3; ++method)
+    {
+      Matcher matcher(pattern, text);
+      Matcher compiled(Static::pattern(), text);
+      while (true)
+      {
+        size_t accept = method == 0 ? matcher.scan() : method == 1 ? matcher.find() : matcher.split();
+        size_t taken = method == 0 ? compiled.scan() : method == 1 ? compiled.find() : compiled.split();
+        if (accept != taken || matcher.first() != compiled.first() || matcher.size() != compiled.size())
+          error("static pattern matches");
+        if (accept == 0)
+          break;
+      }
+    }
+    std::cout << "Static pattern of " << Static::size << " opcodes" << std::endl;
+    static_assert(static_pattern<"a|b">::opcodes[0] == 0x61610003 && static_pattern<"a|b">::opcodes[1] == 0x62620005, "static pattern opcodes");
+  }
+#endif
+  //
+  banner("TEST LITERAL DELIMITER SPLIT");
+  //
+  {
+    // the delimiters with |\xff are not literal and are split with the DFA, the results are the same with a trailing partial delimiter
+    const char *delims[] = { ",", "::", "\\|", "aba", ",|\\xff", "::|\\xff", "aba|\\xff" };
+    const char *texts[] = { "a,b,,c", ",x,", "", "a::b:c::", "ab:", "x||y|", "a,b,c\nd:e::f|g", "abc", "xabab", "ababa:", "aba" };
+    for (size_t d = 0; d < sizeof(delims) / sizeof(delims[0]); ++d)
+    {
+      Pattern pattern(delims[d]);
+      std::string delim(d == 2 ? "|" : delims[d]);
+      delim = delim.substr(0, delim.find("|\\xff"));
+      for (size_t t = 0; t < sizeof(texts) / sizeof(texts[0]); ++t)
+      {
+        std::string text(texts[t]);
+        std::string expect;
+        size_t k = 0;
+        for (size_t i; (i = text.find(delim, k)) != std::string::npos; k = i + delim.size())
+          expect.append(text, k, i - k).append("/");
+        expect.append(text, k, std::string::npos).append("/");
+        std::istringstream stream(text);
+        Matcher matcher(pattern, text);
+        Matcher interactive(pattern, stream);
+        interactive.interactive();
+        std::string test, same;
+        while (matcher.split())
+          test.append(matcher.text()).append("/");
+        while (interactive.split())
+          same.append(interactive.str()).append("/");
+        if (test != expect || same != expect)
+          error("literal delimiter split results");
+      }
+    }
+    Matcher matcher(",", "ab,c,d");
+    matcher.split();
+    if (matcher.str() != "ab" || matcher.rest() != std::string("c,d"))
+      error("literal delimiter split rest");
+    // delimiters with lookaheads are not literal
+    Pattern lookahead1("x(?=a)");
+    Pattern lookahead2("ab(?=x)");
+    Matcher lookahead_matcher(lookahead1, "1xa2");
+    std::string test;
+    while (lookahead_matcher.split())
+      test.append(lookahead_matcher.text()).append("/");
+    lookahead_matcher.pattern(lookahead2);
+    lookahead_matcher.input("cab abx");
+    while (lookahead_matcher.split())
+      test.append(lookahead_matcher.text()).append("/");
+    if (test != "1/a2/cab /x/")
+      error("lookahead delimiter split results");
+    std::cout << "OK" << std::endl;
+  }
+  //
+  banner("TEST SEGMENTED INPUT");
+  //
+  {
+    std::string text("int x = 42;\n\tfloat y = 3.14;\n");
+    text.append(300, 'z').append(" w\n");
+    Pattern pattern("\\w+|\\d+\\.\\d+|\\s+|.");
+    std::ostringstream expect;
+    Matcher matcher(pattern, text);
+    while (matcher.scan())
+      expect << matcher.text() << ":" << matcher.lineno() << ":" << matcher.columno() << "/";
+    for (size_t n = 1; n <= 64; n = 2 * n + 1)
+    {
+      std::vector<Input::Segment> segments;
+      for (size_t k = 0; k < text.size(); k += n)
+      {
+        Input::Segment segment = { text.data() + k, k + n < text.size() ? n : text.size() - k };
+        segments.push_back(segment);
+      }
+      std::ostringstream test;
+      Matcher segmented(pattern, Input(&segments[0], segments.size()), "R");
+      while (segmented.scan())
+        test << segmented.text() << ":" << segmented.lineno() << ":" << segmented.columno() << "/";
+      if (test.str() != expect.str())
+        error("segmented input scan");
+    }
+    std::string last("ld\n");
+    last.append(300, ' ').append("foo bar");
+    Input::Segment segments[] = { { "hello wor", 9 }, { "", 0 }, { last.data(), last.size() } };
+    Matcher segmented("\\w+", Input(segments, 3), "R");
+    if (!segmented.find() || segmented.str() != "hello" || segmented.begin() != segments[0].data)
+      error("segmented input in place");
+    if (!segmented.find() || segmented.str() != "world" || segmented.lineno() != 1 || segmented.columno() != 6)
+      error("segmented input stitch");
+    if (!segmented.find() || segmented.str() != "foo" || segmented.begin() != segments[2].data + 303 || segmented.lineno() != 2)
+      error("segmented input in place after stitch");
+    if (!segmented.find() || segmented.str() != "bar" || segmented.find())
+      error("segmented input end");
+    std::cout << "OK" << std::endl;
+  }
+  //
+  banner("TEST TOKEN RING");
+  //
+  {
+    std::string text;
+    for (size_t i = 0; i < 80000; ++i)
+      text.append(i % 7 == 0 ? "\tx\xc3\xa9y = 12;\n" : i % 2 == 0 ? "word + 3\n" : "word + 3 ");
+    std::vector<std::string> strs;
+    std::vector<size_t> lines, columns;
+    Matcher matcher("(\\w+)|(\\s+)|(.)", text);
+    while (size_t accept = matcher.scan())
+    {
+      if (accept == 2)
+        continue;
+      strs.push_back(matcher.str());
+      lines.push_back(matcher.lineno());
+      columns.push_back(matcher.columno());
+    }
+    std::istringstream stream(text);
+    BatchLexer lexer(stream);
+    TokenRing<BatchLexer,int,8> ring(lexer);
+    std::vector<TokenRing<BatchLexer,int,8>::Lexeme> lexemes;
+    size_t count = 0;
+    while (ring.next() != 0)
+    {
+      if (count >= strs.size() || ring.str() != strs[count] || ring.lineno() != lines[count] || ring.columno() != columns[count])
+        error("token ring token");
+      lexemes.push_back(ring.lexeme());
+      // the text of a token returned eight tokens ago is still available after the buffer was shifted
+      if (count >= 8 && lexemes[count - 8].str() != strs[count - 8])
+        error("token ring lexeme");
+      ++count;
+    }
+    if (count != strs.size() || ring.next() != 0)
+      error("token ring end");
+    std::cout << "OK" << std::endl;
+  }
+#if defined(WITH_STATS)
+  //
+  banner("TEST MATCHER STATISTICS");
+  //
+  {
+    std::string text;
+    for (size_t i = 0; i < 2000; ++i)
+      text.append(i % 100 == 0 ? "needle42 " : i % 7 == 0 ? "needles " : "hay ");
+    Matcher matcher("needle\\d+", text);
+    size_t count = 0;
+    while (matcher.find())
+      ++count;
+    const AbstractMatcher::Stats& stats = matcher.stats();
+    std::cout << "Found " << count << " with " << stats.advances << " advances skipping " << stats.skipped << " of " << stats.bytes << " bytes, " << stats.rejects << " rejects, " << stats.false_positives << " false positives, " << stats.transitions << " transitions" << std::endl;
+    if (count != 20 || stats.bytes != text.size() || stats.matches != count + 1 || stats.misses != 1)
+      error("matcher statistics matches");
+    if (stats.candidates == 0 || stats.candidates > stats.advances || stats.paths[AbstractMatcher::Stats::PREFIX] != stats.advances || stats.rejects == 0 || stats.skipped == 0 || stats.skipped >= text.size())
+      error("matcher statistics advance");
+    if (stats.transitions == 0 || stats.gets == 0)
+      error("matcher statistics transitions");
+    matcher.reset_stats();
+    if (matcher.stats().matches != 0 || matcher.stats().bytes != 0)
+      error("matcher statistics reset");
+  }
+#endif
   //
   banner("DONE");
   return 0;
@@ -52,5 +52,15 @@ int main()
     std::cout << (char)i;
   std::cout << std::endl;
 
+  Bits wide(60, 200);
+  assert(wide.count() == 141);
+  assert(wide.find_first() == 60 && wide.find_next(127) == 128 && wide.find_next(200) == Bits::npos);
+  wide.erase(64, 191);
+  assert(wide.count() == 13 && wide.find_next(63) == 192);
+  wide.flip(0, 255);
+  assert(wide.count() == 256 - 13 && wide[64] == true && wide[60] == false && wide.find_first() == 0);
+  wide.erase(0, 1000);
+  assert(wide.any() == false && wide.find_first() == Bits::npos);
+
   return 0;
 }
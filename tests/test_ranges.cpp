@@ -3,6 +3,7 @@
 #include <reflex/bits.h>
 #include <reflex/ranges.h>
 #include <reflex/timer.h>
+#include <algorithm>
 #include <bitset>
 #include <map>
 #include <iostream>
@@ -222,6 +223,72 @@ Set of 1 open-ended ranges:
   assert(ichar1.lo() == '0');
   assert(ichar1.hi() == 'z');
 
+  typedef FlatORanges<int> flats;
+
+  flats FA(0, 3), FB(0, 4), FC(0, 5), FD(2, 6), FF(5, 9);
+  flats FG(0, 3);
+  FG.insert(5, 9);
+  flats FH(0, 1);
+  FH.insert(7, 9);
+  flats FI(2, 3);
+  FI.insert(5, 6);
+
+  assert((FC | FF) == flats(0, 9));
+  assert((FC - FF) == flats(0, 4));
+  assert((FC & FF) == flats(5));
+  assert((FB & FF) == flats());
+  assert((FD | FG) == flats(0, 9));
+  assert((FD - FG) == flats(4));
+  assert((FD & FG) == FI);
+  assert((FG - FD) == FH);
+  assert((FI - FD) == flats());
+  assert(FB.contains(FA)   == true);
+  assert(FG.contains(FI)   == true);
+  assert(FD.intersects(FA) == true);
+  assert(FH.intersects(FI) == false);
+
+  flats fvals(100, 200);
+  fvals.insert(300, 400);
+  fvals.insert(200, 300);
+  assert(fvals.size() == 1 && fvals.find(200) != fvals.end() && fvals.find(401) == fvals.end());
+  fvals.erase(250, 350);
+  assert(fvals == flats(100, 249) + flats(351, 400));
+  assert(fvals.lo() == 100 && fvals.hi() == 400);
+
+  // flat ranges and ranges must agree
+  srand(1);
+  for (int run = 0; run < 10000; ++run)
+  {
+    ORanges<int> set1, set2;
+    FlatORanges<int> flat1, flat2;
+    for (int i = 0; i < 8; ++i)
+    {
+      int n = rand() % 64;
+      int m = n + rand() % 4;
+      set1.insert(n, m);
+      flat1.insert(n, m);
+      n = rand() % 64;
+      m = n + rand() % 4;
+      set2.insert(n, m);
+      flat2.insert(n, m);
+    }
+    ORanges<int> set3 = set1 | set2;
+    FlatORanges<int> flat3 = flat1 | flat2;
+    assert(set3.size() == flat3.size() && std::equal(set3.begin(), set3.end(), flat3.begin()));
+    set3 = set1 & set2;
+    flat3 = flat1 & flat2;
+    assert(set3.size() == flat3.size() && std::equal(set3.begin(), set3.end(), flat3.begin()));
+    set3 = set1 - set2;
+    flat3 = flat1 - flat2;
+    assert(set3.size() == flat3.size() && std::equal(set3.begin(), set3.end(), flat3.begin()));
+    assert(set1.intersects(set2) == flat1.intersects(flat2));
+    int n = rand() % 64;
+    int m = n + rand() % 8;
+    bool erased = set1.erase(n, m);
+    assert(erased == flat1.erase(n, m));
+    assert(set1.size() == flat1.size() && std::equal(set1.begin(), set1.end(), flat1.begin()));
+  }
+
   unsigned int seed = 1; // time(0);
   int len1, len2;
   int sum = 0;
@@ -289,6 +356,37 @@ Set of 1 open-ended ranges:
   dt = timer_elapsed(t);
   fprintf(stderr, "elapsed real time = %g ms\n", dt);
 
+  std::cerr << "Random 256 flat o-range insertions timings" << std::endl;
+  timer_start(t);
+  for (int run = 0; run < 5000; ++run)
+  {
+    FlatORanges<int> ints1, ints2;
+    srand(seed);
+    for (int i = 0; i < 256; ++i)
+    {
+      int n = rand() % 1024;
+      ints1.insert(n, n + 3);
+      int m = rand() % 1024;
+      ints2.insert(m, m + 3);
+      sum += ints1.intersects(ints2);
+    }
+    len1 = ints1.size();
+    len2 = ints2.size();
+  }
+  dt = timer_elapsed(t);
+  fprintf(stderr, "%d+%d ranges, elapsed real time = %g ms\n", len1, len2, dt);
+
+  std::cerr << "Raw 0..255 flat o-range insertion timings" << std::endl;
+  timer_start(t);
+  for (int run = 0; run < 10000; ++run)
+  {
+    FlatORanges<int> ints;
+    for (int i = 0; i < 256; ++i)
+      ints.insert(i);
+  }
+  dt = timer_elapsed(t);
+  fprintf(stderr, "elapsed real time = %g ms\n", dt);
+
   std::cerr << "Raw 0..255 bits insertion timings" << std::endl;
   timer_start(t);
   for (int run = 0; run < 10000; ++run)